@@ -1,18 +1,80 @@
 #pragma once
 
 #include <BBMOD/common.hpp>
+#include <BBMOD/Config.hpp>
 #include <BBMOD/Model.hpp>
 #include <BBMOD/Vector3.hpp>
 #include <BBMOD/Quaternion.hpp>
 #include <BBMOD/DualQuaternion.hpp>
+#include <BBMOD/TableOfContents.hpp>
 
 #include <vector>
 #include <string>
 #include <fstream>
 
+/** A section with duration, sampling rate and spaces of an animation. */
+#define BBMOD_SECTION_INFO "INFO"
+
+/** A section with reduced keyframes in parent space, per node. */
+#define BBMOD_SECTION_KEYS "KEYS"
+
+/** A section with transforms of all nodes/bones sampled at each frame. */
+#define BBMOD_SECTION_FRAMES "FRMS"
+
+/** A section with a mask of varying tracks per space, constant tracks stored
+ * once and transforms of varying tracks only at each frame. */
+#define BBMOD_SECTION_TRACKS "TRCK"
+
+/** A section with tracks like in BBMOD_SECTION_TRACKS, but with transforms
+ * encoded using one of BBMOD_TRACK_ encodings per space. */
+#define BBMOD_SECTION_QUANTIZED "QTRK"
+
+/** A section with an index of blocks of frames in BBMOD_SECTION_FRAME_BLOCKS.
+ * Allows to read any range of frames without reading the preceding ones. */
+#define BBMOD_SECTION_FRAME_INDEX "FIDX"
+
+/** A section with blocks of frames, each either stored at fixed stride or
+ * compressed independently on the others. */
+#define BBMOD_SECTION_FRAME_BLOCKS "FBLK"
+
+/** Transforms are stored as 8 floats. */
+#define BBMOD_TRACK_FLOAT 0
+
+/** Rotations are packed into 48 bits using the smallest three method and
+ * translations are quantized to 16 bits per component against per-track
+ * ranges. */
+#define BBMOD_TRACK_QUANTIZED_48 1
+
+/** Same as BBMOD_TRACK_QUANTIZED_48, but rotations are packed into 32 bits. */
+#define BBMOD_TRACK_QUANTIZED_32 2
+
+/** Transforms are stored as 8 half-precision floats. */
+#define BBMOD_TRACK_HALF 3
+
+/** A section with a table of nodes, for which are world-space transforms
+ * stored, followed by their transforms at each frame. */
+#define BBMOD_SECTION_WORLD_SPACE_NODES "WSEL"
+
+/** A section with frames of an animation LOD sampled at a lower rate. Index
+ * of the section is index of the LOD, starting at 0 for half the rate. */
+#define BBMOD_SECTION_LOD "LODT"
+
+/** A section with animation events. */
+#define BBMOD_SECTION_EVENTS "EVNT"
+
+/** A section with a bounding box of the whole animation, followed by bounding
+ * boxes of the animated model at each frame quantized against it. */
+#define BBMOD_SECTION_BOUNDS "ABOX"
+
+/** A section with weights of morph targets at each frame, quantized to 16 bits
+ * against per-track ranges. */
+#define BBMOD_SECTION_MORPH_WEIGHTS "MWGT"
+
 struct SAnimationKey
 {
-	virtual bool Save(std::ofstream& file);
+	virtual ~SAnimationKey() {}
+
+	virtual bool Save(std::ostream& file);
 
 	double Time = 0.0;
 };
@@ -25,9 +87,9 @@ struct SPositionKey : public SAnimationKey
 	{
 	}
 
-	bool Save(std::ofstream& file);
+	bool Save(std::ostream& file);
 
-	static SPositionKey* Load(std::ifstream& file);
+	static SPositionKey* Load(std::istream& file);
 
 	vec3_t Position;
 };
@@ -40,9 +102,9 @@ struct SRotationKey : public SAnimationKey
 	{
 	}
 
-	bool Save(std::ofstream& file);
+	bool Save(std::ostream& file);
 
-	static SRotationKey* Load(std::ifstream& file);
+	static SRotationKey* Load(std::istream& file);
 
 	quat_t Rotation;
 };
@@ -55,32 +117,224 @@ struct SDualQuatKey : public SAnimationKey
 	{
 	}
 
-	bool Save(std::ofstream& file);
+	bool Save(std::ostream& file);
 
-	static SDualQuatKey* Load(std::ifstream& file);
+	static SDualQuatKey* Load(std::istream& file);
 
 	dual_quat_t DualQuat;
 };
 
 struct SAnimationNode
 {
-	bool Save(std::ofstream& file);
+	/** Deletes keys of the node. */
+	~SAnimationNode();
+
+	bool Save(std::ostream& file);
 
-	static SAnimationNode* Load(std::ifstream& file);
+	static SAnimationNode* Load(std::istream& file);
+
+	/** Samples the node's transform at given frame, interpolating between
+	 * the closest keys. */
+	void Sample(double frame, dual_quat_t out) const;
 
 	float Index = 0.0f;
 
 	std::vector<SDualQuatKey*> DualQuatKeys;
 };
 
+/** Statistics of a keyframe reduction. */
+struct SKeyReduction
+{
+	uint32_t KeysBefore = 0;
+
+	uint32_t KeysAfter = 0;
+
+	/** The largest world-space position error of a node over all frames. */
+	float MaxError = 0.0f;
+};
+
+/** The largest error of quantized tracks compared to the float data. */
+struct SQuantizationError
+{
+	float MaxTranslationError = 0.0f;
+
+	/** In degrees. */
+	float MaxRotationError = 0.0f;
+};
+
+/** Describes an animation LOD sampled at a lower rate. */
+struct SAnimationLod
+{
+	/** The full rate divided by this value is the rate of the LOD. */
+	uint32_t Divisor = 1;
+
+	/** Number of frames of the LOD. The last frame is always the last frame
+	 * of the full rate animation. */
+	uint32_t FrameCount = 0;
+
+	/** The largest world-space position error of a node when interpolating
+	 * the LOD, compared to the full rate animation. */
+	float MaxError = 0.0f;
+};
+
+/** Weights of a single morph target at each frame of an animation. */
+struct SMorphTrack
+{
+	/** Index of the mesh in the model. */
+	uint32_t MeshIndex = 0;
+
+	/** Index of the morph target in SMesh::MorphTargets. */
+	uint32_t TargetIndex = 0;
+
+	/** One weight per frame. */
+	std::vector<float> Weights;
+};
+
 struct SAnimation
 {
+	/** Deletes nodes of the animation. */
+	~SAnimation();
+
 	static SAnimation* FromAssimp(struct aiAnimation* animation, SModel* model, const struct SConfig& config);
 
 	bool Save(std::string path, const struct SConfig& config);
 
+	bool Save(std::ostream& file, const struct SConfig& config);
+
 	static SAnimation* Load(std::string path);
 
+	static SAnimation* Load(std::istream& file);
+
+	/**
+	 * Writes a table of contents with sections of the animation's tracks,
+	 * events, bounds and morph target weights only. The header, spaces,
+	 * duration, node and bone counts and the skeleton reference are left out,
+	 * as they are stored by an animation pack.
+	 */
+	bool SaveClip(std::ostream& file, const struct SConfig& config);
+
+	/** Reads sections written with SaveClip at the current position of the
+	 * stream. Spaces, Duration, TicsPerSecond, ModelNodeCount and
+	 * ModelBoneCount must be set beforehand. */
+	bool LoadClip(std::istream& file);
+
+	/** Returns BBMOD_BONE_SPACE_ flags written for the configured animation
+	 * optimization level. */
+	static uint8_t GetSpaces(const struct SConfig& config);
+
+	/** Returns animation nodes indexed by model node index. Unanimated nodes
+	 * are nullptr. */
+	std::vector<SAnimationNode*> GetNodeMap() const;
+
+	/** Samples transforms of all model nodes at given frame. Any of the output
+	 * arrays can be nullptr. */
+	void SampleFrame(
+		const std::vector<SAnimationNode*>& nodeMap,
+		double frame,
+		float* frameParent,
+		float* frameWorld,
+		float* frameBone) const;
+
+	/**
+	 * Samples weights of morph targets animated by morph mesh channels of
+	 * `animation` at each frame and adds them to MorphTracks. Channels are
+	 * matched to meshes of `meshModel` with morph targets by the name of the
+	 * mesh or of a node holding it. Targets with zero weight in all frames
+	 * are skipped.
+	 */
+	void AddMorphTracks(const struct aiAnimation* animation, const SModel* meshModel);
+
+	/** Samples weights of all morph targets of a mesh animated by a morph mesh
+	 * channel at given time in ticks of the channel into `out`, which must
+	 * have one element per morph target. */
+	static void SampleMorphWeights(const struct aiMeshMorphAnim* channel, double time, std::vector<float>& out);
+
+	/** Returns the number of floats stored per frame for given spaces. */
+	static size_t GetFrameSize(uint8_t spaces, uint32_t nodeCount, uint32_t boneCount);
+
+	/** Returns the number of sampled frames. */
+	uint32_t GetFrameCount() const;
+
+	/** Samples transforms in given spaces for every frame into `out`. Frames
+	 * are laid out the same as in a BBANIM file. */
+	void SampleFrames(uint8_t spaces, std::vector<float>& out) const;
+
+	/** Writes transforms in given spaces for every frame. */
+	bool WriteFrames(std::ostream& file, uint8_t spaces) const;
+
+	/** Writes transforms in given spaces, storing tracks which do not change
+	 * over the whole animation only once. */
+	bool WriteTracks(std::ostream& file, uint8_t spaces) const;
+
+	/**
+	 * Reference decoder of data written with WriteTracks. Expands them into
+	 * `out` laid out the same as SampleFrames.
+	 */
+	static bool ReadTracks(
+		std::istream& file,
+		uint8_t spaces,
+		uint32_t nodeCount,
+		uint32_t boneCount,
+		uint32_t frameCount,
+		std::vector<float>& out);
+
+	/** Writes frames split into blocks of FrameBlockSize frames into
+	 * `blocks` and their offsets and sizes into `index`. */
+	bool WriteFrameBlocks(std::ostream& index, std::ostream& blocks, uint8_t spaces) const;
+
+	/** Writes frames sampled at every `divisor`-th frame and the error of
+	 * their interpolation compared to the full rate frames. */
+	bool WriteLod(std::ostream& file, uint8_t spaces, uint32_t divisor, SAnimationLod& lod) const;
+
+	/** Writes a table of WorldSpaceNodes and their world-space transforms
+	 * at each frame. */
+	bool WriteWorldSpaceNodes(std::ostream& file) const;
+
+	/**
+	 * Skins vertices of all meshes of the model at each frame and writes
+	 * the bounding box of the whole animation, followed by bounding boxes
+	 * at each frame quantized to 16 bits per component against it. Boxes
+	 * are rounded outwards, so they always contain all vertices. Dequantized
+	 * boxes are stored into FrameBounds.
+	 */
+	bool WriteBounds(std::ostream& file);
+
+	/** Reads bounding boxes written with WriteBounds into `out`, six floats
+	 * (min. and max. corner) per frame. */
+	static bool ReadBounds(std::istream& file, std::vector<float>& out);
+
+	/** Writes MorphTracks with weights quantized to 16 bits against the range
+	 * of each track. */
+	bool WriteMorphTracks(std::ostream& file) const;
+
+	/** Reads morph target weight tracks written with WriteMorphTracks. */
+	static bool ReadMorphTracks(std::istream& file, std::vector<SMorphTrack>& out);
+
+	/**
+	 * Writes tracks like WriteTracks, but with transforms encoded based on
+	 * Quantization and HalfFloatFrames. The data are decoded back and the
+	 * error against the float data is stored into QuantizationError.
+	 */
+	bool WriteQuantizedTracks(std::ostream& file, uint8_t spaces);
+
+	/** Reference decoder of data written with WriteQuantizedTracks. */
+	static bool ReadQuantizedTracks(
+		std::istream& file,
+		uint8_t spaces,
+		uint32_t nodeCount,
+		uint32_t boneCount,
+		uint32_t frameCount,
+		std::vector<float>& out);
+
+	/**
+	 * Removes keys which can be reconstructed by interpolating neighbouring
+	 * keys within the error tolerances from the config. The first and the
+	 * last key of each track are always kept. Keys of a node and its
+	 * ancestors are then brought back at frames where the world-space
+	 * position error of the node exceeds SConfig::KeyEndEffectorError.
+	 */
+	SKeyReduction ReduceKeys(const struct SConfig& config);
+
 	uint8_t VersionMajor = BBMOD_VERSION_MAJOR;
 
 	uint8_t VersionMinor = BBMOD_VERSION_MINOR;
@@ -96,4 +350,80 @@ struct SAnimation
 	SModel* Model = nullptr;
 
 	uint32_t ModelNodeCount = 0;
+
+	uint32_t ModelBoneCount = 0;
+
+	/** BBMOD_BONE_SPACE_ flags of a loaded animation. */
+	uint8_t Spaces = 0;
+
+	/** Whether keys were reduced and are saved sparsely. */
+	bool IsReduced = false;
+
+	/** Whether constant tracks are saved only once. */
+	bool EliminateConstantTracks = false;
+
+	/** One of BBMOD_QUANTIZE_ values. */
+	uint32_t Quantization = BBMOD_QUANTIZE_NONE;
+
+	/** Whether world-space and bone-space transforms are saved as
+	 * half-precision floats. */
+	bool HalfFloatFrames = false;
+
+	/** Indices of nodes, for which are world-space transforms saved when
+	 * only bone-space transforms are saved for the rest. */
+	std::vector<uint32_t> WorldSpaceNodes;
+
+	/** Names of nodes in WorldSpaceNodes. */
+	std::vector<std::string> WorldSpaceNodeNames;
+
+	/** Number of LODs saved with the animation, the first one at half the
+	 * sampling rate, every next at half the rate of the previous one. */
+	uint32_t LodTiers = 0;
+
+	/** LODs of the animation, filled when saved or loaded. */
+	std::vector<SAnimationLod> Lods;
+
+	/** Number of frames per block of a frame index or 0 to store frames
+	 * without an index. */
+	uint32_t FrameBlockSize = 0;
+
+	/** Whether blocks of a frame index are compressed. */
+	bool CompressFrameBlocks = false;
+
+	/** The error of quantized tracks measured when the animation was saved. */
+	SQuantizationError QuantizationError;
+
+	/** Whether bounding boxes of the animated model at each frame are saved. */
+	bool AnimatedBounds = false;
+
+	/** Bounding boxes of the animated model at each frame, six floats (min.
+	 * and max. corner) per frame. Filled when saved or loaded. */
+	std::vector<float> FrameBounds;
+
+	/** Weights of animated morph targets at each frame. */
+	std::vector<SMorphTrack> MorphTracks;
+
+	/** Hash of the shared skeleton referenced by a loaded animation or 0. */
+	uint64_t SkeletonHash = 0;
+
+	/** File name of the shared skeleton referenced by a loaded animation. */
+	std::string SkeletonName;
+
+private:
+	bool SaveSections(std::ostream& file, uint64_t fileStart, uint8_t spaces);
+
+	/** Adds sections shared by BBANIM files and clips of animation packs. */
+	bool AddClipSections(STableOfContents& toc, uint8_t spaces);
+
+	bool WriteKeys(std::ostream& file) const;
+
+	bool LoadSections(std::istream& file, uint64_t fileStart);
+
+	bool LoadClipSections(std::istream& file, const STableOfContents& toc);
+
+	bool ReadFrames(std::istream& file, uint8_t spaces);
+
+	bool ReadWorldSpaceNodes(std::istream& file);
+
+	void SetFrames(const std::vector<float>& frames, uint8_t spaces);
 };
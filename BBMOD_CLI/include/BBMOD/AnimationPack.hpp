@@ -0,0 +1,115 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+#include <BBMOD/Animation.hpp>
+#include <BBMOD/AnimationStream.hpp>
+#include <BBMOD/TableOfContents.hpp>
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** A section with metadata shared by all clips of an animation pack. */
+#define BBMOD_SECTION_PACK_HEADER "PHDR"
+
+/** A section with a directory of clips of an animation pack, sorted by name. */
+#define BBMOD_SECTION_PACK_DIRECTORY "PDIR"
+
+/** A section with a single clip of an animation pack. */
+#define BBMOD_SECTION_CLIP "CLIP"
+
+/** An entry of the directory of an animation pack. */
+struct SAnimationPackEntry
+{
+	std::string Name;
+
+	/** Index of the BBMOD_SECTION_CLIP section with the clip. */
+	uint32_t Clip = 0;
+
+	double Duration = 0.0;
+
+	double TicsPerSecond = 0.0;
+
+	/** Whether the clip is stored in a compressed container. */
+	bool Compressed = false;
+};
+
+/**
+ * A single file bundling many animation clips of the same model. Metadata
+ * shared by all clips are stored only once in the header and clips are looked
+ * up by name in a sorted directory. Each clip holds only a table of contents
+ * and sections with its tracks (see SAnimation::SaveClip), stored at an
+ * aligned offset, so it can be read in place from an opened or mapped pack.
+ */
+struct SAnimationPack
+{
+	/**
+	 * Serializes an animation and adds it to the pack under given name.
+	 *
+	 * @param animation The animation to add.
+	 * @param name The name of the clip.
+	 * @param config The configuration to serialize the animation with.
+	 * @param error Set to the reason of a failure.
+	 *
+	 * @return False if the name is already used, if the animation does not
+	 * share node count, bone count, spaces, skeleton or names and order of
+	 * nodes and bones with clips already in the pack or if it cannot be
+	 * serialized.
+	 */
+	bool Add(SAnimation* animation, const std::string& name, const struct SConfig& config, std::string& error);
+
+	bool Save(std::string path);
+
+	bool Save(std::ostream& file);
+
+	/** Reads the header and the directory of a pack at the current position
+	 * of the stream. */
+	bool Open(std::istream& file);
+
+	/** Returns index of an entry with given name or -1 if it does not exist. */
+	int32_t Find(const std::string& name) const;
+
+	/** Returns the section with a clip of an entry, for readers which map
+	 * the file into memory. */
+	const SSection* GetClipSection(uint32_t entry) const;
+
+	/** Loads a clip of an entry from the stream passed to Open, with metadata
+	 * taken from the header and the directory. Returns nullptr on failure. */
+	SAnimation* LoadClip(std::istream& file, uint32_t entry) const;
+
+	/** Opens a reader of frames of an entry from the stream passed to Open.
+	 * Returns false on failure or if the clip is compressed. */
+	bool OpenClip(std::istream& file, uint32_t entry, SAnimationStream& out) const;
+
+	uint8_t VersionMajor = BBMOD_VERSION_MAJOR;
+
+	uint8_t VersionMinor = BBMOD_VERSION_MINOR_TOC;
+
+	/** BBMOD_BONE_SPACE_ flags of transforms stored in all clips. */
+	uint8_t Spaces = 0;
+
+	uint32_t ModelNodeCount = 0;
+
+	uint32_t ModelBoneCount = 0;
+
+	/** Hash of the shared skeleton referenced by all clips or 0. */
+	uint64_t SkeletonHash = 0;
+
+	/** File name of the shared skeleton referenced by all clips. */
+	std::string SkeletonName;
+
+	/** Entries of the directory. Sorted by name when the pack is saved or
+	 * loaded. */
+	std::vector<SAnimationPackEntry> Entries;
+
+	STableOfContents TableOfContents;
+
+private:
+	/** Names of nodes and bones of the model of the first clip added, in the
+	 * order of their indices. Not saved into the pack. */
+	std::vector<std::string> RigNames;
+
+	/** Serialized clips, indexed by SAnimationPackEntry::Clip. */
+	std::vector<std::string> Clips;
+};
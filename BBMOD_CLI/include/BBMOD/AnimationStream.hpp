@@ -0,0 +1,149 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+#include <BBMOD/Animation.hpp>
+#include <BBMOD/TableOfContents.hpp>
+
+#include <istream>
+#include <string>
+#include <vector>
+
+/** An event of an animation. */
+struct SAnimationEvent
+{
+	double Frame = 0.0;
+
+	std::string Name;
+};
+
+/**
+ * Reads frames of a BBANIM file on demand, without loading the whole file.
+ * Supports files of version 3.4 and files of version 3.5 with frames stored
+ * either at fixed stride or in blocks listed in a frame index. Only a single
+ * decoded block is kept in memory at a time. Files of version 3.5 with frames
+ * stored otherwise can be opened as well, but only their other sections can
+ * be read.
+ */
+struct SAnimationStream
+{
+	/** Reads the header of a BBANIM file at the current position of the
+	 * stream. The stream must outlive the reader. */
+	bool Open(std::istream& file);
+
+	/**
+	 * Opens sections listed in an already read table of contents, e.g. of a
+	 * clip of an animation pack, which does not have its own header. Spaces,
+	 * Duration, TicsPerSecond, ModelNodeCount and ModelBoneCount must be set
+	 * beforehand. The stream must outlive the reader.
+	 */
+	bool Open(std::istream& file, const STableOfContents& toc);
+
+	/**
+	 * Returns false if frames are stored as tracks or reduced keys, which
+	 * cannot be read in parts. ReadFrames then fails, but events, LODs,
+	 * world-space nodes, bounds and morph target weights can still be read.
+	 */
+	bool HasFrames() const;
+
+	/**
+	 * Reads `count` frames starting at frame `first` into `out`. Each frame
+	 * holds transforms in all spaces from Spaces, laid out the same as in
+	 * SAnimation::SampleFrames. Fails if HasFrames returns false.
+	 */
+	bool ReadFrames(uint32_t first, uint32_t count, std::vector<float>& out);
+
+	/** Reads world-space transforms of WorldSpaceNodes for `count` frames
+	 * starting at frame `first` into `out`. */
+	bool ReadWorldSpaceFrames(uint32_t first, uint32_t count, std::vector<float>& out);
+
+	/** Reads `count` frames of LOD `lod` starting at frame `first` into
+	 * `out`. Frames of LODs store transforms in LodSpaces. */
+	bool ReadLodFrames(uint32_t lod, uint32_t first, uint32_t count, std::vector<float>& out);
+
+	/** Reads the table of animation events. */
+	bool ReadEvents(std::vector<SAnimationEvent>& out);
+
+	/** Reads bounding boxes of the animated model at each frame, six floats
+	 * (min. and max. corner) per frame. */
+	bool ReadBounds(std::vector<float>& out);
+
+	/** Reads weights of animated morph targets at each frame. */
+	bool ReadMorphTracks(std::vector<SMorphTrack>& out);
+
+	uint8_t VersionMinor = 0;
+
+	/** BBMOD_BONE_SPACE_ flags of transforms stored in frames. */
+	uint8_t Spaces = 0;
+
+	double Duration = 0.0;
+
+	double TicsPerSecond = 0.0;
+
+	uint32_t ModelNodeCount = 0;
+
+	uint32_t ModelBoneCount = 0;
+
+	uint32_t FrameCount = 0;
+
+	/** Number of floats per frame. */
+	uint32_t FrameSize = 0;
+
+	/** Number of frames per block or 0 if frames are stored at fixed stride. */
+	uint32_t BlockFrames = 0;
+
+	/** LODs of the animation sampled at lower rates. */
+	std::vector<SAnimationLod> Lods;
+
+	/** BBMOD_BONE_SPACE_ flags of transforms stored in frames of LODs. */
+	uint8_t LodSpaces = 0;
+
+	/** Indices of nodes with world-space transforms stored separately. */
+	std::vector<uint32_t> WorldSpaceNodes;
+
+	/** Names of nodes in WorldSpaceNodes. */
+	std::vector<std::string> WorldSpaceNodeNames;
+
+private:
+	bool LoadBlock(uint32_t index);
+
+	std::istream* File = nullptr;
+
+	uint64_t FileStart = 0;
+
+	/** Offset of frame data from the start of the file or 0 if frames cannot
+	 * be read in parts. */
+	uint64_t FramesOffset = 0;
+
+	/** Offset of world-space transforms of WorldSpaceNodes from the start of
+	 * the file. */
+	uint64_t WorldSpaceOffset = 0;
+
+	/** Offsets of frames of each LOD from the start of the file. */
+	std::vector<uint64_t> LodOffsets;
+
+	/** Offset of the event table from the start of the file. */
+	uint64_t EventsOffset = 0;
+
+	/** Offset of animated bounding boxes from the start of the file or 0. */
+	uint64_t BoundsOffset = 0;
+
+	/** Offset of morph target weight tracks from the start of the file or 0. */
+	uint64_t MorphTracksOffset = 0;
+
+	uint32_t Filter = 0;
+
+	struct SBlock
+	{
+		uint64_t Offset = 0;
+
+		uint32_t StoredSize = 0;
+
+		uint8_t Codec = 0;
+	};
+
+	std::vector<SBlock> Blocks;
+
+	int64_t CachedBlock = -1;
+
+	std::vector<float> Cache;
+};
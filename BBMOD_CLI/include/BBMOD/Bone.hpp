@@ -11,9 +11,9 @@ struct SBone
 	{
 	}
 
-	bool Save(std::ofstream& file);
+	bool Save(std::ostream& file);
 
-	static SBone* Load(std::ifstream& file);
+	static SBone* Load(std::istream& file);
 
 	std::string Name;
 
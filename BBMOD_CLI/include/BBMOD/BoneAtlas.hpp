@@ -0,0 +1,94 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+#include <BBMOD/Animation.hpp>
+#include <BBMOD/Config.hpp>
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** A section with the layout of a bone atlas. */
+#define BBMOD_SECTION_ATLAS_HEADER "AHDR"
+
+/** A section with a table of clips of a bone atlas. */
+#define BBMOD_SECTION_ATLAS_CLIPS "ACLP"
+
+/** A section with texels of a bone atlas. */
+#define BBMOD_SECTION_ATLAS_TEXELS "ATEX"
+
+/** The largest width of a bone atlas in texels, up to which are frames packed
+ * into a single row. */
+#define BBMOD_ATLAS_MAX_WIDTH 2048
+
+/** A clip of a bone atlas. */
+struct SBoneAtlasClip
+{
+	std::string Name;
+
+	/** The first row of the atlas occupied by the clip. */
+	uint32_t StartRow = 0;
+
+	uint32_t FrameCount = 0;
+
+	double TicsPerSecond = 0.0;
+};
+
+/**
+ * Bone-space transforms of all animations of a model baked into a single 2D
+ * texture, from which an instanced vertex shader can fetch them. Each frame
+ * takes two texels per bone, the real and the dual part of its dual
+ * quaternion. Frames are packed into rows, FramesPerRow frames per row, and
+ * each clip starts at a new row. The first texel of bone `b` at frame `f` of
+ * a clip is at column `(f % FramesPerRow) * BoneCount * 2 + b * 2` and row
+ * `StartRow + f / FramesPerRow`.
+ */
+struct SBoneAtlas
+{
+	/** Samples bone-space transforms of an animation at each frame and adds
+	 * them as a new clip. Returns false if the animation has a different bone
+	 * count than other clips. */
+	bool Add(SAnimation* animation, const std::string& name);
+
+	/** Packs frames of all clips into rows of Texels. Called automatically
+	 * from Save. */
+	void Build();
+
+	bool Save(std::string path);
+
+	bool Save(std::ostream& file);
+
+	static SBoneAtlas* Load(std::string path);
+
+	static SBoneAtlas* Load(std::istream& file);
+
+	uint8_t VersionMajor = BBMOD_VERSION_MAJOR;
+
+	uint8_t VersionMinor = BBMOD_VERSION_MINOR_TOC;
+
+	/** One of BBMOD_ATLAS_ values. */
+	uint32_t Format = BBMOD_ATLAS_RGBA32F;
+
+	uint32_t BoneCount = 0;
+
+	uint32_t FramesPerRow = 0;
+
+	/** Width of the atlas in texels. */
+	uint32_t Width = 0;
+
+	/** Height of the atlas in texels. */
+	uint32_t Height = 0;
+
+	/** Hash of the shared skeleton of the baked animations or 0. */
+	uint64_t SkeletonHash = 0;
+
+	std::vector<SBoneAtlasClip> Clips;
+
+	/** Four floats per texel, row by row, starting at the top row. */
+	std::vector<float> Texels;
+
+private:
+	/** Bone-space transforms of clips added since the last Build. */
+	std::vector<std::vector<float>> Frames;
+};
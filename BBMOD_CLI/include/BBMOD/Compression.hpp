@@ -0,0 +1,126 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+#include <BBMOD/Config.hpp>
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+/** A chunk is stored uncompressed. */
+#define BBMOD_CODEC_STORE 0
+
+/** A chunk is compressed with the built-in LZ codec. */
+#define BBMOD_CODEC_LZ 1
+
+/** The magic of compressed container files. */
+#define BBMOD_CONTAINER_MAGIC "BBLZ"
+
+/** The version of compressed container files. */
+#define BBMOD_CONTAINER_VERSION 1
+
+/**
+ * Compresses `size` bytes from `src` with the built-in LZ codec and appends
+ * the result to `dst`.
+ */
+void LZCompress(const uint8_t* src, size_t size, std::vector<uint8_t>& dst);
+
+/**
+ * Decompresses exactly `dstSize` bytes from `src` into `dst`. Returns false if
+ * the compressed data is malformed.
+ */
+bool LZDecompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+/** Applies a BBMOD_FILTER_ to `size` bytes of `data` in place. */
+void FilterEncode(uint8_t* data, size_t size, uint32_t filter);
+
+/** Reverts a BBMOD_FILTER_ applied to `size` bytes of `data` in place. */
+void FilterDecode(uint8_t* data, size_t size, uint32_t filter);
+
+/** An entry of a container's chunk table. */
+struct SChunkInfo
+{
+	uint64_t Offset = 0;
+
+	uint32_t StoredSize = 0;
+
+	uint8_t Codec = BBMOD_CODEC_STORE;
+};
+
+/**
+ * Splits data into chunks of fixed size, compresses them on multiple threads
+ * and writes them into a container with a chunk table. Each chunk can be
+ * decompressed independently on the other.
+ */
+bool WriteContainer(
+	std::ostream& file,
+	const uint8_t* data,
+	size_t size,
+	uint32_t chunkSize,
+	uint32_t filter);
+
+/** Returns true if the stream at its current position starts with a container. */
+bool IsContainer(std::istream& file);
+
+/** Reads data from a container created with WriteContainer. */
+struct SContainerReader
+{
+	/** Reads header and chunk table. The stream must outlive the reader. */
+	bool Open(std::istream& file);
+
+	/** Decompresses a single chunk into `out`. */
+	bool ReadChunk(uint32_t index, std::vector<uint8_t>& out);
+
+	/**
+	 * Reads `size` bytes at position `offset` of the uncompressed data.
+	 * Only the chunks that overlap the range are decompressed.
+	 */
+	bool Read(uint64_t offset, void* dst, size_t size);
+
+	std::istream* File = nullptr;
+
+	/** Position of the container within the stream. */
+	uint64_t Start = 0;
+
+	uint32_t Filter = BBMOD_FILTER_NONE;
+
+	uint32_t ChunkSize = 0;
+
+	uint64_t RawSize = 0;
+
+	std::vector<SChunkInfo> Chunks;
+
+private:
+	bool LoadChunk(uint32_t index);
+
+	int64_t CachedChunk = -1;
+
+	std::vector<uint8_t> Cache;
+};
+
+/**
+ * A read-only, seekable stream buffer over a container. Chunks are decompressed
+ * on demand, so the whole data never have to be in memory at once.
+ */
+struct SContainerStreamBuf : public std::streambuf
+{
+	SContainerStreamBuf(SContainerReader& reader);
+
+protected:
+	int_type underflow() override;
+
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+	bool Fetch(uint64_t position);
+
+	SContainerReader& Reader;
+
+	std::vector<uint8_t> Buffer;
+
+	uint64_t BufferStart = 0;
+};
@@ -4,6 +4,8 @@
 
 #include <assimp/matrix4x4.h>
 
+#include <string>
+
 /** A value used to tell that no normals should be generated
  * if the model doesn't have any. */
 #define BBMOD_NORMALS_NONE 0
@@ -25,6 +27,39 @@
 /** BBANIM includes bone transforms in bone spaces. */
 #define BBMOD_BONE_SPACE_BONE (1 << 2)
 
+/** A value used to tell that no filter is applied before compression. */
+#define BBMOD_FILTER_NONE 0
+
+/** A value used to tell that bytes of 4-byte words are grouped together
+ * before compression. */
+#define BBMOD_FILTER_SHUFFLE 1
+
+/** A value used to tell that bytes of 4-byte words are grouped together and
+ * delta encoded before compression. Works best for streams of floats. */
+#define BBMOD_FILTER_SHUFFLE_DELTA 2
+
+/** A value used to tell that animation tracks are not quantized. */
+#define BBMOD_QUANTIZE_NONE 0
+
+/** A value used to tell that rotations in animation tracks are packed into 48
+ * bits and translations into 16 bits per component. */
+#define BBMOD_QUANTIZE_48 1
+
+/** A value used to tell that rotations in animation tracks are packed into 32
+ * bits and translations into 16 bits per component. */
+#define BBMOD_QUANTIZE_32 2
+
+/** A value used to tell that no bone atlas is saved. */
+#define BBMOD_ATLAS_NONE 0
+
+/** A value used to tell that a bone atlas is saved with four 32-bit floats
+ * per texel. */
+#define BBMOD_ATLAS_RGBA32F 1
+
+/** A value used to tell that a bone atlas is saved with four 16-bit floats
+ * per texel. */
+#define BBMOD_ATLAS_RGBA16F 2
+
 /** Configuration structure. */
 struct SConfig
 {
@@ -111,4 +146,166 @@ struct SConfig
 
 	/** Save unused material properties. */
 	bool SaveUnused = false;
+
+	/** Compress BBMOD and BBANIM files into independently decompressible
+	 * chunks. */
+	bool Compress = false;
+
+	/** Size of a chunk of uncompressed data in bytes. */
+	uint32_t CompressionChunkSize = 256 * 1024;
+
+	/**
+	 * Filter applied to chunks before compression.
+	 *
+	 * @see BBMOD_FILTER_NONE
+	 * @see BBMOD_FILTER_SHUFFLE
+	 * @see BBMOD_FILTER_SHUFFLE_DELTA
+	 */
+	uint32_t CompressionFilter = BBMOD_FILTER_SHUFFLE_DELTA;
+
+	/** Save files with a table of contents, which allows to read their parts
+	 * without decoding the rest. */
+	bool TableOfContents = false;
+
+	/** Remove animation keys which can be reconstructed by interpolation.
+	 * Requires AnimationOptimization 0. */
+	bool ReduceKeys = false;
+
+	/** Maximum translation error of a reduced key. */
+	float KeyTranslationError = 0.001f;
+
+	/** Maximum rotation error of a reduced key in degrees. */
+	float KeyRotationError = 0.1f;
+
+	/** Maximum world-space position error of any node of a reduced
+	 * animation at any frame, including error accumulated from its
+	 * ancestors. */
+	float KeyEndEffectorError = 0.01f;
+
+	/** Save animation tracks which do not change over the whole animation
+	 * (including unanimated nodes) only once instead of at every frame. */
+	bool EliminateConstantTracks = false;
+
+	/**
+	 * Quantization of animation tracks.
+	 *
+	 * @see BBMOD_QUANTIZE_NONE
+	 * @see BBMOD_QUANTIZE_48
+	 * @see BBMOD_QUANTIZE_32
+	 */
+	uint32_t AnimationQuantization = BBMOD_QUANTIZE_NONE;
+
+	/** Save world-space and bone-space animation frames as half-precision
+	 * floats. */
+	bool HalfFloatFrames = false;
+
+	/** Save animation frames in blocks with an index, which allows to read
+	 * any range of frames without reading the whole file. Takes precedence
+	 * over constant track elimination and quantization. */
+	bool FrameIndex = false;
+
+	/** Number of frames in a block of a frame index. */
+	uint32_t FrameBlockSize = 64;
+
+	/** Compress blocks of a frame index independently on each other. */
+	bool CompressFrameBlocks = true;
+
+	/**
+	 * Comma-separated names of nodes, for which are world-space transforms
+	 * saved into animations, e.g. attachment sockets. Names can contain
+	 * wildcards `*` and `?`. When not empty, all other transforms are saved
+	 * only in bone space, regardless of AnimationOptimization.
+	 */
+	std::string WorldSpaceNodes;
+
+	/** Number of animation LODs saved alongside full rate frames. The first
+	 * LOD has half the sampling rate, every next has half the rate of the
+	 * previous one. Tiers sparser than the whole animation are not saved. */
+	uint32_t AnimationLodTiers = 0;
+
+	/** Number of bone LODs computed for animated models. Each LOD maps bones
+	 * with the smallest influence on vertices to their nearest kept
+	 * ancestor. */
+	uint32_t BoneLodCount = 0;
+
+	/** Remove bones without weights and nodes without meshes, which are not
+	 * animated, and bake their transforms into their children. */
+	bool PruneSkeleton = false;
+
+	/** Comma-separated names of nodes which are never removed by pruning,
+	 * e.g. sockets. Names can contain wildcards `*` and `?`. */
+	std::string KeepNodes;
+
+	/** Save the node hierarchy as a flat table in parent-before-child order
+	 * and assign bone indices in the same order. */
+	bool FlatNodeTable = false;
+
+	/**
+	 * Path to a shared skeleton file (.bbskel). If it does not exist, it is
+	 * created from the converted model. Models and animations then reference
+	 * the skeleton instead of having their own. Empty to disable.
+	 */
+	std::string SharedSkeleton;
+
+	/**
+	 * Path to a model (.bbmod) or a skeleton (.bbskel), against which are
+	 * resolved node indices of converted animations. When not empty, meshes
+	 * are not processed and only animations are saved.
+	 */
+	std::string ReferenceModel;
+
+	/**
+	 * If true, then all animations of a model, or of all models in a
+	 * directory, are saved into a single animation pack (.bbpack) instead of
+	 * separate .bbanim files.
+	 */
+	bool AnimationPack = false;
+
+	/**
+	 * If true, then bounding boxes of the animated model at each frame are
+	 * computed by skinning all its vertices and they are saved into
+	 * animations.
+	 */
+	bool AnimatedBounds = false;
+
+	/**
+	 * Format of a bone atlas (.bbatlas), into which are baked bone-space
+	 * transforms of all animations of a model. Use one of BBMOD_ATLAS_
+	 * values.
+	 */
+	uint32_t BoneAtlas = BBMOD_ATLAS_NONE;
+
+	/**
+	 * If true, then positions of all vertices of a model at each frame of its
+	 * animations are baked into a vertex animation texture (.bbvat) and the
+	 * lookup coordinate of each vertex is stored in its second UV channel.
+	 */
+	bool VertexAnimation = false;
+
+	/** If true, then normals are baked into vertex animation textures as
+	 * well. */
+	bool VertexAnimationNormals = false;
+
+	/**
+	 * If true, then morph targets of meshes are saved as sparse quantized
+	 * deltas of vertices which move and animations of their weights are
+	 * saved into animations.
+	 */
+	bool MorphTargets = false;
+
+	/**
+	 * If true, then missing normals and tangents are generated by BBMOD CLI
+	 * on multiple threads instead of by Assimp.
+	 */
+	bool NativeTangentSpace = false;
+
+	/**
+	 * If true, then GLB files are mapped into memory and their meshes are
+	 * converted straight into the model instead of by Assimp's glTF importer.
+	 * Nodes and meshes of such files are not optimized and their missing
+	 * normals and tangents are generated as with NativeTangentSpace. Files
+	 * which use features not supported by the reader are still loaded by
+	 * Assimp. See SGlbFile::CanConvert.
+	 */
+	bool NativeGlb = false;
 };
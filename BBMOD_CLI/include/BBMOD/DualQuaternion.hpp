@@ -42,6 +42,26 @@ static inline void dual_quaternion_from_translation_rotation(dual_quat_t q, cons
 	quaternion_scale(dual, 0.5f);
 }
 
+static inline void dual_quaternion_get_rotation(const dual_quat_t dq, quat_t r)
+{
+	quaternion_copy(dq, r);
+}
+
+static inline void dual_quaternion_get_translation(const dual_quat_t dq, vec3_t t)
+{
+	quat_t real;
+	quaternion_copy(dq, real);
+	quaternion_conjugate(real);
+
+	quat_t dual;
+	quaternion_copy(dq + 4, dual);
+	quaternion_multiply(dual, real);
+
+	t[0] = dual[0] * 2.0f;
+	t[1] = dual[1] * 2.0f;
+	t[2] = dual[2] * 2.0f;
+}
+
 static inline void dual_quaternion_multiply(dual_quat_t _dq1, dual_quat_t _dq2, dual_quat_t _out, uint32_t _outIndex)
 {
 	float _dq1r0 = _dq1[0];
@@ -77,4 +97,80 @@ static inline void dual_quaternion_multiply(dual_quat_t _dq1, dual_quat_t _dq2,
 		+ (_dq2r3 * _dq1d2 + _dq2r2 * _dq1d3 + _dq2r0 * _dq1d1 - _dq2r1 * _dq1d0);
 	_out[_outIndex + 7] = (_dq2d3 * _dq1r3 - _dq2d0 * _dq1r0 - _dq2d1 * _dq1r1 - _dq2d2 * _dq1r2)
 		+ (_dq2r3 * _dq1d3 - _dq2r0 * _dq1d0 - _dq2r1 * _dq1d1 - _dq2r2 * _dq1d2);
-}
\ No newline at end of file
+}
+
+/** Transforms a point `v` by a dual quaternion. */
+static inline void dual_quaternion_transform_point(const float* dq, const float* v, float* out)
+{
+	const float* real = dq;
+	const float* dual = dq + 4;
+
+	// v + 2 * cross(r, cross(r, v) + w * v)
+	float cx = real[1] * v[2] - real[2] * v[1] + real[3] * v[0];
+	float cy = real[2] * v[0] - real[0] * v[2] + real[3] * v[1];
+	float cz = real[0] * v[1] - real[1] * v[0] + real[3] * v[2];
+	float x = v[0] + 2.0f * (real[1] * cz - real[2] * cy);
+	float y = v[1] + 2.0f * (real[2] * cx - real[0] * cz);
+	float z = v[2] + 2.0f * (real[0] * cy - real[1] * cx);
+
+	// 2 * (w * d - dw * r + cross(r, d))
+	out[0] = x + 2.0f * (real[3] * dual[0] - dual[3] * real[0] + real[1] * dual[2] - real[2] * dual[1]);
+	out[1] = y + 2.0f * (real[3] * dual[1] - dual[3] * real[1] + real[2] * dual[0] - real[0] * dual[2]);
+	out[2] = z + 2.0f * (real[3] * dual[2] - dual[3] * real[2] + real[0] * dual[1] - real[1] * dual[0]);
+}
+
+/** Rotates a vector `v` by the real part of a dual quaternion. */
+static inline void dual_quaternion_rotate_vector(const float* dq, const float* v, float* out)
+{
+	float cx = dq[1] * v[2] - dq[2] * v[1] + dq[3] * v[0];
+	float cy = dq[2] * v[0] - dq[0] * v[2] + dq[3] * v[1];
+	float cz = dq[0] * v[1] - dq[1] * v[0] + dq[3] * v[2];
+	float x = v[0] + 2.0f * (dq[1] * cz - dq[2] * cy);
+	float y = v[1] + 2.0f * (dq[2] * cx - dq[0] * cz);
+	float z = v[2] + 2.0f * (dq[0] * cy - dq[1] * cx);
+	out[0] = x;
+	out[1] = y;
+	out[2] = z;
+}
+
+/**
+ * Blends four dual quaternions from array `transforms` at given indices with
+ * given weights and normalizes the result, the same way as the vertex shader
+ * does when skinning (see Transform.xsh). Returns false if all weights are
+ * zero.
+ */
+static inline bool dual_quaternion_blend(const float* transforms, const uint32_t indices[4], const float weights[4], dual_quat_t out)
+{
+	const float* dq0 = transforms + indices[0] * 8;
+
+	for (int k = 0; k < 8; ++k)
+	{
+		out[k] = dq0[k] * weights[0];
+	}
+
+	for (int j = 1; j < 4; ++j)
+	{
+		const float* dq = transforms + indices[j] * 8;
+		float dot = dq0[0] * dq[0] + dq0[1] * dq[1] + dq0[2] * dq[2] + dq0[3] * dq[3];
+		float weight = (dot < 0.0f) ? -weights[j] : weights[j];
+		for (int k = 0; k < 8; ++k)
+		{
+			out[k] += dq[k] * weight;
+		}
+	}
+
+	float length = sqrtf(out[0] * out[0] + out[1] * out[1] + out[2] * out[2] + out[3] * out[3]);
+
+	if (length <= 0.0f)
+	{
+		return false;
+	}
+
+	for (int k = 0; k < 8; ++k)
+	{
+		out[k] /= length;
+	}
+
+	return true;
+}
+
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+
+#include <cstddef>
+#include <string>
+
+/** The magic number at the start of a GLB file ("glTF"). */
+#define BBMOD_GLB_MAGIC 0x46546C67
+
+/** A GLB chunk with the JSON part of the file ("JSON"). */
+#define BBMOD_GLB_CHUNK_JSON 0x4E4F534A
+
+/** A GLB chunk with the binary buffer ("BIN\0"). */
+#define BBMOD_GLB_CHUNK_BIN 0x004E4942
+
+/**
+ * A binary glTF 2.0 file (.glb) read directly from memory. The file is mapped
+ * instead of read and meshes are converted from accessors straight into
+ * vertices of a model, skipping Assimp's own glTF importer and Assimp meshes
+ * altogether. Only materials and animations are converted into an Assimp
+ * scene, so that they can be saved the same way as those of other files.
+ *
+ * Files which use features not supported by the reader are rejected by Open
+ * and FromMemory, so they can be loaded by Assimp instead. These are required
+ * extensions (e.g. Draco or meshopt compression), external or data URI
+ * buffers, sparse accessors, primitive modes other than points, lines and
+ * triangles and meshes shared by nodes with different skins. Configurations
+ * which need Assimp's post-processing the reader does not implement are
+ * rejected by CanConvert.
+ */
+struct SGlbFile
+{
+	~SGlbFile();
+
+	/**
+	 * Maps a GLB file into memory and parses its JSON chunk.
+	 *
+	 * @param path Path to the file.
+	 * @param reason Set to the reason of a failure.
+	 *
+	 * @return The file or nullptr if it cannot be read, is not a GLB 2.0 file
+	 * or uses features not supported by the reader.
+	 */
+	static SGlbFile* Open(const std::string& path, std::string& reason);
+
+	/** Same as Open, but the file is already in memory. The memory must stay
+	 * valid until the file is deleted. */
+	static SGlbFile* FromMemory(const void* data, size_t size, std::string& reason);
+
+	/**
+	 * Checks whether the file can be converted with given configuration. The
+	 * reader implements the left-handed conversion, merging of materials and
+	 * limiting of bone weights the same way as Assimp's post-processing, but
+	 * not pre-transforming vertices, vertex animation textures and morph
+	 * targets. Optimization of nodes and meshes is skipped and missing normals
+	 * and tangents are always generated with GenerateTangentSpace, so these
+	 * options do not reject the file.
+	 *
+	 * @param config The configuration.
+	 * @param animationsOnly True if only animations are converted, in which
+	 * case options of meshes are not checked.
+	 * @param reason Set to the reason why the file cannot be converted.
+	 *
+	 * @return True if the file can be converted.
+	 */
+	bool CanConvert(const struct SConfig& config, bool animationsOnly, std::string& reason) const;
+
+	/**
+	 * Fills an empty scene with materials and animations of the file, the same
+	 * as Assimp's glTF importer followed by post-processing would. Meshes and
+	 * nodes are not added. Everything is copied, so the scene can outlive the
+	 * file.
+	 *
+	 * @param scene The scene to fill.
+	 * @param config A configuration accepted by CanConvert.
+	 * @param error Set to the reason of a failure.
+	 *
+	 * @return False if the file is malformed.
+	 */
+	bool ToAssimp(struct aiScene* scene, const struct SConfig& config, std::string& error) const;
+
+	/**
+	 * Converts nodes, skins and meshes of the file into a model. Vertices are
+	 * read from accessors one by one on multiple threads, without decoding
+	 * whole accessors first.
+	 *
+	 * @param scene The scene filled by ToAssimp, whose animations are used by
+	 * SModel::Prune.
+	 * @param config The configuration used with ToAssimp.
+	 * @param error Set to the reason of a failure.
+	 * @param progress Notified after each converted mesh if not nullptr.
+	 *
+	 * @return The model or nullptr if the file is malformed or if the
+	 * conversion was cancelled through `progress`.
+	 */
+	struct SModel* ToModel(
+		const struct aiScene* scene,
+		const struct SConfig& config,
+		std::string& error,
+		struct SProgress* progress = nullptr) const;
+
+private:
+	SGlbFile() = default;
+
+	/** Parses the header and chunks of the file. */
+	bool Parse(std::string& reason);
+
+	/** Returns false with `reason` set if the file uses unsupported features. */
+	bool CheckSupport(std::string& reason) const;
+
+	/** Returns true if a mesh has morph targets. */
+	bool HasMorphTargets() const;
+
+	/** Start of the file. */
+	const uint8_t* Data = nullptr;
+
+	size_t Size = 0;
+
+	/** True if Data is a view of a mapped file, which must be unmapped. */
+	bool Mapped = false;
+
+	/** Start of the binary chunk or nullptr if there is none. */
+	const uint8_t* Bin = nullptr;
+
+	size_t BinSize = 0;
+
+	/** The parsed JSON chunk. */
+	struct SJsonValue* Json = nullptr;
+};
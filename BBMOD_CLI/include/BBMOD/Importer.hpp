@@ -4,7 +4,9 @@
 #include <BBMOD/Config.hpp>
 #include <BBMOD/Model.hpp>
 #include <BBMOD/Animation.hpp>
+#include <BBMOD/Progress.hpp>
 
+#include <string>
 #include <vector>
 
 /** A code returned on fail, when none of BBMOD_ERR_ is applicable. */
@@ -22,6 +24,20 @@
 /** An error code returned when converted model is not saved. */
 #define BBMOD_ERR_SAVE_FAILED 3
 
+/** An error code returned when model conversion is cancelled. */
+#define BBMOD_ERR_CANCELLED 4
+
+/** A file created by ConvertToBBMODInMemory. */
+struct SMemoryFile
+{
+	/** The name which the file would have if the model was converted to
+	 * disk, e.g. "Character_Walk.bbanim". */
+	std::string Name;
+
+	/** Contents of the file. */
+	std::string Data;
+};
+
 struct SImportResult
 {
 	SModel* Model = nullptr;
@@ -36,4 +52,31 @@ struct SImporter
 	SConfig config;
 };
 
-int ConvertToBBMOD(const char* fin, const char* fout, const SConfig& config);
+/**
+ * Converts a model, or all models in a directory, to BBMOD. Each stage of the
+ * conversion is reported to `progress` if it is not nullptr, which can also
+ * be used to cancel the conversion from another thread.
+ */
+int ConvertToBBMOD(const char* fin, const char* fout, const SConfig& config, SProgress* progress = nullptr);
+
+/**
+ * Converts a model loaded into memory to BBMOD without touching the disk. The
+ * format of the model is detected by Assimp, `hint` is an optional file
+ * extension which helps with formats that cannot be detected, e.g. "obj".
+ * Outputs are appended to `out`: the model, its animations and materials if
+ * SConfig::ExportMaterials is enabled. They are named as if the model was
+ * converted to a file `name`, including its directory, e.g. "dir/Char.bbmod"
+ * and "dir/Char_Walk.bbanim". Formats which reference other files (e.g.
+ * .gltf with a separate .bin) are not supported. Options which require other
+ * files (reference models, shared skeletons, animation packs, bone atlases
+ * and vertex animation textures) are ignored. Returns BBMOD_FAILURE if
+ * `name` is nullptr.
+ */
+int ConvertToBBMODInMemory(
+	const void* data,
+	size_t size,
+	const char* hint,
+	const char* name,
+	const SConfig& config,
+	std::vector<SMemoryFile>& out,
+	SProgress* progress = nullptr);
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+#include <BBMOD/Config.hpp>
+#include <BBMOD/Importer.hpp>
+#include <BBMOD/Progress.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** The number of conversion jobs which can run at once. */
+#define BBMOD_JOB_WORKER_COUNT 2
+
+/** A job with given ID does not exist. */
+#define BBMOD_JOB_NONE -1
+
+/** A job is waiting for a free worker. */
+#define BBMOD_JOB_QUEUED 0
+
+/** A job is being converted. */
+#define BBMOD_JOB_RUNNING 1
+
+/** A job has finished, successfully or not. */
+#define BBMOD_JOB_FINISHED 2
+
+/** A conversion running in the background. */
+struct SJob
+{
+	/** Unique ID of the job, starting at 1. */
+	uint32_t Id = 0;
+
+	/** Path to the converted model or directory. */
+	std::string In;
+
+	/** Path to the output file or directory. */
+	std::string Out;
+
+	/** A copy of the configuration at the time the job was started. */
+	SConfig Config;
+
+	/** Progress of the conversion, including paths to written files. */
+	SProgress Progress;
+
+	/** One of BBMOD_JOB_. */
+	std::atomic<int32_t> Status = { BBMOD_JOB_QUEUED };
+
+	/** The code returned from ConvertToBBMOD, valid when finished. */
+	std::atomic<int32_t> Result = { BBMOD_SUCCESS };
+};
+
+/**
+ * Converts models on a small pool of worker threads, so conversions do not
+ * block the calling thread. Workers are started with the first job and must be
+ * stopped with Stop before the queue is destroyed.
+ */
+struct SJobQueue
+{
+	/** Detaches workers which were not stopped with Stop. Does not wait for
+	 * them, as that would deadlock while a library is being unloaded. */
+	~SJobQueue();
+
+	/**
+	 * Cancels all jobs and waits until workers stop. Queued jobs are finished
+	 * as cancelled. Workers are started again with the next job. Must not be
+	 * called at the same time as Start.
+	 */
+	void Stop();
+
+	/** Queues a conversion and returns the ID of its job. */
+	uint32_t Start(const std::string& in, const std::string& out, const SConfig& config);
+
+	/** Returns a job with given ID or nullptr if it does not exist. */
+	std::shared_ptr<SJob> Find(uint32_t id);
+
+	/**
+	 * Removes a job. A queued job is never started and a running job is
+	 * cancelled, but it keeps its worker until it stops. Returns false if the
+	 * job does not exist.
+	 */
+	bool Remove(uint32_t id);
+
+private:
+	void Work();
+
+	std::mutex Mutex;
+
+	std::condition_variable Condition;
+
+	std::deque<std::shared_ptr<SJob>> Queue;
+
+	std::map<uint32_t, std::shared_ptr<SJob>> Jobs;
+
+	std::vector<std::thread> Workers;
+
+	uint32_t NextId = 1;
+
+	bool Stopping = false;
+};
@@ -8,6 +8,11 @@
 
 #include <vector>
 #include <fstream>
+#include <string>
+
+/** Position and normal deltas of a vertex smaller than this are not stored in
+ * morph targets. */
+#define BBMOD_MORPH_TARGET_EPSILON 0.00001f
 
 struct SVertex
 {
@@ -22,9 +27,9 @@ struct SVertex
 	{
 	}
 	
-	bool Save(std::ofstream& file);
+	bool Save(std::ostream& file);
 
-	static SVertex* Load(std::ifstream& file, SVertexFormat* vertexFormat);
+	static SVertex* Load(std::istream& file, SVertexFormat* vertexFormat);
 
 	SVertexFormat* VertexFormat = nullptr;
 
@@ -49,13 +54,55 @@ struct SVertex
 	int Id = 0;
 };
 
+/**
+ * A morph target (blend shape) of a mesh. Only vertices which move are stored,
+ * with position deltas quantized to 16 bits per component against DeltaMin and
+ * DeltaMax and normal deltas quantized to 8 bits per component for range
+ * [-2, 2].
+ */
+struct SMorphTarget
+{
+	/** Decodes the position delta of the `i`-th stored vertex. */
+	void GetPositionDelta(size_t i, vec3_t out) const;
+
+	/** Decodes the normal delta of the `i`-th stored vertex. */
+	void GetNormalDelta(size_t i, vec3_t out) const;
+
+	std::string Name;
+
+	/** Indices of moved vertices in SMesh::Data, in ascending order. */
+	std::vector<uint32_t> Indices;
+
+	vec3_t DeltaMin = VEC3_ZERO;
+
+	vec3_t DeltaMax = VEC3_ZERO;
+
+	/** Quantized position deltas, three per index. */
+	std::vector<uint16_t> PositionDeltas;
+
+	/** Quantized normal deltas, three per index. Empty if the target does not
+	 * change normals. */
+	std::vector<int8_t> NormalDeltas;
+};
+
 struct SMesh
 {
+	/** Deletes vertices of the mesh and its vertex format, unless it is shared
+	 * with the model. */
+	~SMesh();
+
 	static SMesh* FromAssimp(const struct aiScene* scene, struct aiMesh* mesh, struct SModel* model, const struct SConfig& config);
 
-	bool Save(std::ofstream& file);
+	bool Save(std::ostream& file);
+
+	static SMesh* Load(std::istream& file, SVertexFormat* vertexFormat, struct SModel* model);
 
-	static SMesh* Load(std::ifstream& file, SVertexFormat* vertexFormat, struct SModel* model);
+	/** Writes the name of the mesh and its MorphTargets. */
+	bool WriteMorphTargets(std::ostream& file) const;
+
+	/** Reads the name of the mesh and its MorphTargets written with
+	 * WriteMorphTargets. */
+	bool ReadMorphTargets(std::istream& file);
 
 	struct SModel* Model = nullptr;
 
@@ -70,4 +117,15 @@ struct SMesh
 	vec3_t BboxMin;
 
 	vec3_t BboxMax;
+
+	/** Name of the mesh. Saved only with morph targets. */
+	std::string Name;
+
+	/** Morph targets in the same order as in the source mesh, so they can be
+	 * referenced by index from morph target weight tracks. */
+	std::vector<SMorphTarget> MorphTargets;
+
+	/** Index of the Assimp vertex, from which was created each vertex in
+	 * Data. Not saved. */
+	std::vector<uint32_t> SourceIndices;
 };
@@ -5,14 +5,93 @@
 #include <BBMOD/Node.hpp>
 #include <BBMOD/Bone.hpp>
 #include <BBMOD/Mesh.hpp>
+#include <BBMOD/Progress.hpp>
+#include <BBMOD/TableOfContents.hpp>
 
 #include <vector>
 #include <string>
 #include <map>
+#include <utility>
+
+/** A section of a BBMOD file with a mesh. */
+#define BBMOD_SECTION_MESH "MESH"
+
+/** A section of a BBMOD file with morph targets of the mesh with the same
+ * index. */
+#define BBMOD_SECTION_MORPH_TARGETS "MRPH"
+
+/** A section of a BBMOD file with the node hierarchy. */
+#define BBMOD_SECTION_NODES "NODE"
+
+/** A section of a BBMOD file with the node hierarchy as a flat table. */
+#define BBMOD_SECTION_NODE_TABLE "NTBL"
+
+/** A section of a BBMOD file with the skeleton. */
+#define BBMOD_SECTION_SKELETON "SKEL"
+
+/** A section of a BBMOD or BBANIM file with a reference to a shared
+ * skeleton, which is used instead of the skeleton section. */
+#define BBMOD_SECTION_SKELETON_REFERENCE "SREF"
+
+/** A section of a BBSKEL file with the hash of its content. */
+#define BBMOD_SECTION_HASH "HASH"
+
+/** A section of a BBMOD file with material names. */
+#define BBMOD_SECTION_MATERIALS "MATL"
+
+/** A section of a BBMOD file with bone LODs. */
+#define BBMOD_SECTION_BONE_LODS "BLOD"
+
+/** Load meshes of a model. */
+#define BBMOD_LOAD_MESHES (1 << 0)
+
+/** Load the node hierarchy of a model. */
+#define BBMOD_LOAD_NODES (1 << 1)
+
+/** Load the skeleton of a model. */
+#define BBMOD_LOAD_SKELETON (1 << 2)
+
+/** Load material names of a model. */
+#define BBMOD_LOAD_MATERIALS (1 << 3)
+
+/** Load everything. */
+#define BBMOD_LOAD_ALL \
+	(BBMOD_LOAD_MESHES | BBMOD_LOAD_NODES | BBMOD_LOAD_SKELETON | BBMOD_LOAD_MATERIALS)
+
+/** A bone LOD of a model. */
+struct SBoneLod
+{
+	/** Number of bones which are evaluated at this LOD. */
+	uint32_t KeptCount = 0;
+
+	/** Maps each bone to itself if it is kept, otherwise to its nearest kept
+	 * ancestor. */
+	std::vector<uint32_t> BoneMap;
+
+	/** For each mesh, pairs of bone indices (from, to) which must be replaced
+	 * in its vertices' bone indices at this LOD. Only bones used by the mesh
+	 * are listed. */
+	std::vector<std::vector<std::pair<uint32_t, uint32_t>>> MeshRemaps;
+};
 
 struct SModel
 {
-	static SModel* FromAssimp(const struct aiScene* scene, const SConfig& config);
+	/**
+	 * Converts a scene loaded by Assimp. Conversion of meshes is reported to
+	 * `progress` if it is not nullptr. Returns nullptr if the conversion was
+	 * cancelled through `progress`.
+	 */
+	static SModel* FromAssimp(const struct aiScene* scene, const SConfig& config, SProgress* progress = nullptr);
+
+	/**
+	 * Applies steps which follow the conversion of meshes, nodes and
+	 * materials: pruning, the flat node table and bone LODs. Used by all
+	 * sources of models. Animations of `scene` are used by Prune.
+	 */
+	void FinishConversion(const struct aiScene* scene, const SConfig& config);
+
+	/** Deletes meshes, nodes, bones and the vertex format of the model. */
+	~SModel();
 
 	SBone* FindBoneByName(std::string name) const;
 
@@ -20,9 +99,85 @@ struct SModel
 
 	SNode* FindNodeByName(std::string name, SNode* nodeCurrent) const;
 
-	bool Save(std::string path);
+	/**
+	 * Removes bones without weights and nodes without meshes, which are not
+	 * animated, and bakes their transforms into their children. Subtrees
+	 * without any weighted bones or meshes are removed completely. Nodes
+	 * matching config.KeepNodes or config.WorldSpaceNodes are always kept.
+	 * Bones and nodes are then re-indexed compactly.
+	 */
+	void Prune(const struct aiScene* scene, const SConfig& config);
+
+	/**
+	 * Re-indexes bones in depth-first pre-order of the node hierarchy, so that
+	 * each bone has a greater index than its parent bone. Other nodes get
+	 * indices after bones in the same order.
+	 */
+	void SortNodesTopologically();
+
+	/** Creates a skeleton model with copies of bones, their ancestors and
+	 * descendants, without meshes, which can be shared by multiple models. */
+	SModel* ExtractSkeleton() const;
+
+	/** Saves a skeleton model created with ExtractSkeleton into a BBSKEL
+	 * file. */
+	bool SaveSkeleton(std::string path);
+
+	/** Loads a skeleton from a BBSKEL file. Returns nullptr if the file
+	 * cannot be read or if its hash does not match its content. */
+	static SModel* LoadSkeleton(std::string path);
+
+	/** Computes a hash of the node hierarchy and the skeleton. */
+	uint64_t ComputeSkeletonHash() const;
+
+	/** Returns names of bones whose bind pose differs from a skeleton. */
+	std::vector<std::string> FindBindPoseMismatches(const SModel* skeleton) const;
+
+	/**
+	 * Makes the model reference a shared skeleton instead of having its own.
+	 * Bones are re-indexed to the skeleton's order, bones which the model
+	 * does not have are added and other nodes get the skeleton's indices
+	 * where possible. Nodes which are not in the skeleton are marked as
+	 * unimportant in the skeleton, so animations converted with it skip them.
+	 *
+	 * @param skeleton The shared skeleton.
+	 * @param error Set to the reason of a failure.
+	 *
+	 * @return False if a bone is not in the skeleton or if it has a different
+	 * parent bone.
+	 */
+	bool ApplySkeleton(SModel* skeleton, std::string& error);
+
+	/** Returns false if a node was removed by Prune. */
+	bool NodeIsImportant(std::string name) const;
+
+	/**
+	 * Ranks bones by their largest influence on skinned vertices and computes
+	 * nested bone LODs. Each LOD drops the least important bones of the
+	 * previous one. Bones are never dropped before their descendants and
+	 * root bones are never dropped.
+	 *
+	 * @param count Number of LODs to compute.
+	 */
+	void ComputeBoneLods(uint32_t count);
+
+	bool Save(std::string path, const SConfig& config);
+
+	bool Save(std::ostream& file);
+
+	/**
+	 * Loads a model from a file.
+	 *
+	 * @param path Path to the file.
+	 * @param parts Which parts of the model to load. Use BBMOD_LOAD_ flags.
+	 * Other parts are skipped only if the file has a table of contents.
+	 */
+	static SModel* Load(std::string path, uint32_t parts = BBMOD_LOAD_ALL);
 
-	static SModel* Load(std::string path);
+	static SModel* Load(std::istream& file, uint32_t parts = BBMOD_LOAD_ALL);
+
+	/** Loads a single mesh from a file with a table of contents. */
+	SMesh* LoadMesh(std::istream& file, uint32_t index);
 
 	uint8_t VersionMajor = BBMOD_VERSION_MAJOR;
 
@@ -43,8 +198,47 @@ struct SModel
 
 	std::vector<std::string> MaterialNames;
 
-private:
-	bool NodeIsImportant(std::string name) const;
+	/** Importance of each bone, i.e. the largest product of a vertex weight
+	 * and the vertex's distance from the bone in bind pose, including
+	 * descendants. */
+	std::vector<float> BoneImportance;
+
+	/** Bone LODs, from the closest to the furthest. */
+	std::vector<SBoneLod> BoneLods;
+
+	/** Save the node hierarchy as a flat table instead of a tree. */
+	bool FlatNodeTable = false;
 
+	/** Hash of a shared skeleton, which the model uses instead of its own
+	 * skeleton, or 0. */
+	uint64_t SkeletonHash = 0;
+
+	/** File name of the shared skeleton. */
+	std::string SkeletonName;
+
+	/** Nodes and bones removed by Prune are mapped to false. */
 	std::map<std::string, bool> NodeImportanceMap;
+
+	/** The table of contents of a loaded file. Empty if the file does not
+	 * have one. */
+	STableOfContents TableOfContents;
+
+private:
+	/** Serializes each mesh into its own buffer on multiple threads. Buffers
+	 * are in the same order as Meshes. */
+	bool SaveMeshes(std::vector<std::string>& out) const;
+
+	bool SaveSections(std::ostream& file, uint64_t fileStart);
+
+	bool LoadSections(std::istream& file, uint64_t fileStart, uint32_t parts);
+
+	/**
+	 * Moves bone `i` to index `boneMap[i]` or deletes it if it is -1 and
+	 * updates vertices accordingly. Indices which no bone is moved to are
+	 * left nullptr. Other nodes get indices after bones in
+	 * the order in which they are in `nodes`.
+	 */
+	void Reindex(const std::vector<int32_t>& boneMap, const std::vector<SNode*>& nodes);
+
+	bool WriteSkeleton(std::ostream& file) const;
 };
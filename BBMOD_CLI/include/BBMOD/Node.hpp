@@ -8,13 +8,15 @@
 
 struct SNode
 {
-	SNode() : Transform DUAL_QUATERNION_IDENTITY
+	SNode()
+		: Transform DUAL_QUATERNION_IDENTITY
+		, PrunedTransform DUAL_QUATERNION_IDENTITY
 	{
 	}
 
-	bool Save(std::ofstream& file);
+	bool Save(std::ostream& file);
 
-	static SNode* Load(std::ifstream& file);
+	static SNode* Load(std::istream& file);
 
 	std::string Name;
 
@@ -26,7 +28,72 @@ struct SNode
 
 	dual_quat_t Transform;
 
+	/** Transform of ancestors removed by pruning, which was baked into
+	 * Transform. Animation keys of the node must be multiplied by it as well.
+	 * This is not saved! */
+	dual_quat_t PrunedTransform;
+
 	std::vector<uint32_t> Meshes;
 
 	std::vector<SNode*> Children;
 };
+
+/**
+ * The node hierarchy stored as flat arrays in parent-before-child order. World
+ * transforms of all nodes can be computed in a single forward loop and the
+ * whole table can be read at once.
+ */
+struct SNodeTable
+{
+	/** Flattens a hierarchy in depth-first pre-order. */
+	static SNodeTable FromTree(SNode* root);
+
+	/** Creates a hierarchy from the table. Returns nullptr if it is empty or
+	 * if a node is not preceded by its parent. */
+	SNode* ToTree() const;
+
+	bool Save(std::ostream& file) const;
+
+	/**
+	 * Reads the table and validates it.
+	 *
+	 * @param file The stream to read from.
+	 * @param meshCount Number of meshes of the model. Mesh indices must be
+	 * less than this.
+	 * @param size Maximum number of bytes the table can take, e.g. the size of
+	 * its section. Used to reject corrupt counts before allocating.
+	 */
+	bool Load(std::istream& file, uint32_t meshCount, uint64_t size);
+
+	/** Returns the name of the node at given position. */
+	const char* GetName(uint32_t row) const;
+
+	/** Position of each node's parent in the table or -1 for the root. */
+	std::vector<int32_t> Parents;
+
+	/** Index of each node, as in SNode::Index. */
+	std::vector<uint32_t> Indices;
+
+	/** Is 1 for nodes that are bones. */
+	std::vector<uint8_t> IsBone;
+
+	/** Transform of each node, 8 floats per node. */
+	std::vector<float> Transforms;
+
+	/** Meshes of node `i` are MeshIndices[MeshStarts[i]] ... MeshIndices[MeshStarts[i + 1] - 1]. */
+	std::vector<uint32_t> MeshStarts;
+
+	std::vector<uint32_t> MeshIndices;
+
+	/** Offset of each node's name in Names. */
+	std::vector<uint32_t> NameOffsets;
+
+	/** Null-terminated names of all nodes. */
+	std::string Names;
+};
+
+/**
+ * Checks whether a name matches any of comma-separated patterns. Patterns can
+ * contain wildcards `*` (any sequence of characters) and `?` (any character).
+ */
+bool MatchNamePatterns(const std::string& name, const std::string& patterns);
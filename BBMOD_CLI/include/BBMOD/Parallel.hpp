@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/** Returns the number of worker threads used by ParallelFor. */
+static inline uint32_t GetWorkerCount()
+{
+	uint32_t count = std::thread::hardware_concurrency();
+	return (count > 0) ? count : 1;
+}
+
+/**
+ * Calls `fn(i)` for each `i` in range [0, count) from multiple threads.
+ * Returns when all calls have finished. The order of calls is not defined!
+ */
+template <typename F>
+static inline void ParallelFor(size_t count, F fn)
+{
+	size_t threadCount = std::min<size_t>(count, GetWorkerCount());
+
+	if (threadCount <= 1)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			fn(i);
+		}
+		return;
+	}
+
+	std::atomic<size_t> next(0);
+	std::vector<std::thread> threads;
+
+	for (size_t t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&]() {
+			for (size_t i = next++; i < count; i = next++)
+			{
+				fn(i);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
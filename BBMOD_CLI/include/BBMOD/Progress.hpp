@@ -0,0 +1,84 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** No conversion is running. */
+#define BBMOD_STAGE_NONE 0
+
+/** A file is being loaded and post-processed by Assimp. */
+#define BBMOD_STAGE_LOAD 1
+
+/** Meshes are being converted. */
+#define BBMOD_STAGE_MESHES 2
+
+/** A model is being saved. */
+#define BBMOD_STAGE_SAVE 3
+
+/** Animations are being sampled and saved. */
+#define BBMOD_STAGE_ANIMATIONS 4
+
+/** The conversion has finished. */
+#define BBMOD_STAGE_DONE 5
+
+/**
+ * Progress of a conversion, shared between the thread which converts files
+ * and threads which display it or cancel it. All members can be read and
+ * written from any thread.
+ */
+struct SProgress
+{
+	/** Resets the progress before a new conversion. */
+	void Reset();
+
+	/** Starts conversion of the file at `index` out of `count` files. */
+	void BeginFile(uint32_t index, uint32_t count);
+
+	/** Enters a BBMOD_STAGE_ and resets its fraction to 0. */
+	void SetStage(uint32_t stage);
+
+	/** Sets the fraction of the current stage to `step / count`. */
+	void SetStep(uint32_t step, uint32_t count);
+
+	/** Requests the conversion to stop at the next possible occasion. */
+	void Cancel() { Cancelled = true; }
+
+	/** Returns true if the conversion should stop. */
+	bool IsCancelled() const { return Cancelled; }
+
+	/** Returns the progress of all files, in range [0, 1]. */
+	float GetTotal() const;
+
+	/** Returns the name of a BBMOD_STAGE_. */
+	static const char* GetStageName(uint32_t stage);
+
+	/** Records a file written by the conversion. */
+	void AddOutput(const std::string& path);
+
+	/** Returns paths to all files written by the conversion so far. */
+	std::vector<std::string> GetOutputs() const;
+
+	/** The current BBMOD_STAGE_. */
+	std::atomic<uint32_t> Stage = { BBMOD_STAGE_NONE };
+
+	/** Fraction of the current stage, in range [0, 1]. */
+	std::atomic<float> Fraction = { 0.0f };
+
+	/** The index of the file being converted. */
+	std::atomic<uint32_t> FileIndex = { 0 };
+
+	/** The number of files to convert. */
+	std::atomic<uint32_t> FileCount = { 1 };
+
+	/** Set to true to stop the conversion. */
+	std::atomic<bool> Cancelled = { false };
+
+private:
+	mutable std::mutex OutputsMutex;
+
+	std::vector<std::string> Outputs;
+};
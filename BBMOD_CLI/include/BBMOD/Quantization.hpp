@@ -0,0 +1,36 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+#include <BBMOD/Quaternion.hpp>
+
+/** Converts a float to a half-precision float. */
+uint16_t FloatToHalf(float value);
+
+/** Converts a half-precision float to a float. */
+float HalfToFloat(uint16_t value);
+
+/**
+ * Packs a unit quaternion into 48 bits using the smallest three method.
+ * Stores index of the largest component in 2 bits and the remaining
+ * components in 15 bits each.
+ */
+void QuaternionPack48(const quat_t q, uint8_t out[6]);
+
+/** Unpacks a quaternion packed with QuaternionPack48. */
+void QuaternionUnpack48(const uint8_t in[6], quat_t q);
+
+/**
+ * Packs a unit quaternion into 32 bits using the smallest three method.
+ * Stores index of the largest component in 2 bits and the remaining
+ * components in 10 bits each.
+ */
+void QuaternionPack32(const quat_t q, uint8_t out[4]);
+
+/** Unpacks a quaternion packed with QuaternionPack32. */
+void QuaternionUnpack32(const uint8_t in[4], quat_t q);
+
+/** Quantizes a value from range [min, max] to 16 bits. */
+uint16_t QuantizeRange16(float value, float min, float max);
+
+/** Reverts QuantizeRange16. */
+float DequantizeRange16(uint16_t value, float min, float max);
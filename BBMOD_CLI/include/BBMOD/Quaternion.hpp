@@ -89,8 +89,8 @@ static inline void quaternion_normalize(quat_t q)
 
 static inline void quaternion_slerp(quat_t q1, const quat_t q2, float f)
 {
-	static quat_t _q1;
-	static quat_t _q2;
+	quat_t _q1;
+	quat_t _q2;
 
 	quaternion_copy(q1, _q1);
 	quaternion_copy(q2, _q2);
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** Sections are aligned to this many bytes from the start of the file. */
+#define BBMOD_SECTION_ALIGNMENT 16
+
+/** An entry of a table of contents. */
+struct SSection
+{
+	/** A four character code identifying the content of the section. */
+	char Tag[4] = { 0, 0, 0, 0 };
+
+	/** Index of the section among sections with the same tag. */
+	uint32_t Index = 0;
+
+	/** Offset of the section from the start of the file. */
+	uint64_t Offset = 0;
+
+	/** Size of the section in bytes. */
+	uint64_t Size = 0;
+};
+
+/**
+ * A table of contents of a file, which lists offsets and sizes of its
+ * sections. This allows to read only some parts of a file without decoding
+ * the rest.
+ */
+struct STableOfContents
+{
+	/** Adds a new section with given data. Sections are written in order in
+	 * which they were added. */
+	void Add(const char* tag, uint32_t index, std::string data);
+
+	/**
+	 * Writes the table of contents followed by data of all sections.
+	 *
+	 * @param file The stream to write to.
+	 * @param fileStart Position of the start of the file within the stream.
+	 */
+	bool Save(std::ostream& file, uint64_t fileStart);
+
+	/**
+	 * Reads the table of contents. The stream is left at the end of the
+	 * table.
+	 *
+	 * @param file The stream to read from.
+	 * @param fileStart Position of the start of the file within the stream.
+	 */
+	bool Load(std::istream& file, uint64_t fileStart);
+
+	/** Returns a section with given tag and index or nullptr if it does not exist. */
+	const SSection* Find(const char* tag, uint32_t index = 0) const;
+
+	/** Returns number of sections with given tag. */
+	uint32_t Count(const char* tag) const;
+
+	/** Moves the stream to the start of a section. Returns false if the
+	 * section does not exist. */
+	bool Seek(std::istream& file, const char* tag, uint32_t index = 0) const;
+
+	/** Reads the whole section into `out`. */
+	bool Read(std::istream& file, const char* tag, uint32_t index, std::string& out) const;
+
+	uint64_t FileStart = 0;
+
+	std::vector<SSection> Sections;
+
+private:
+	std::vector<std::string> Data;
+};
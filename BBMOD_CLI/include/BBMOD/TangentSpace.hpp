@@ -0,0 +1,34 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+#include <BBMOD/Config.hpp>
+#include <BBMOD/Mesh.hpp>
+
+/** Size of a cell of the grid used to find shared positions when generating
+ * smooth normals, relative to the diagonal of the mesh bounding box. */
+#define BBMOD_TANGENT_SPACE_EPSILON 0.00001f
+
+/**
+ * Generates normals of a triangle list mesh. Flat normals are normals of
+ * faces. Smooth normals are sums of area-weighted normals of all faces which
+ * share a position, found by hashing positions snapped to a grid.
+ */
+void GenerateNormals(SMesh* mesh, bool smooth, bool invertWinding);
+
+/**
+ * Generates tangents and bitangent signs of a triangle list mesh with normals
+ * and texture coordinates. Tangents of faces are projected onto the normal
+ * of each corner, weighted by the angle of the corner and summed over corners
+ * with exactly the same position, normal, texture coordinate and handedness.
+ * This is similar to, but not an implementation of MikkTSpace, so results
+ * may differ slightly from tangents of normal map bakers. The bitangent is then
+ * `BitangentSign * cross(Normal, Tangent)`.
+ */
+void GenerateTangents(SMesh* mesh);
+
+/**
+ * Generates normals and tangents of a mesh which were not present in its
+ * source mesh, as told by `hasNormals` and `hasTangents`. Used instead of
+ * Assimp's post-processing when SConfig::NativeTangentSpace is enabled.
+ */
+void GenerateTangentSpace(SMesh* mesh, bool hasNormals, bool hasTangents, const SConfig& config);
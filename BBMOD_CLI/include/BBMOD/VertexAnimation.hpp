@@ -0,0 +1,146 @@
+#pragma once
+
+#include <BBMOD/common.hpp>
+#include <BBMOD/Animation.hpp>
+#include <BBMOD/Vector3.hpp>
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** A section with the layout of a vertex animation texture. */
+#define BBMOD_SECTION_VAT_HEADER "VHDR"
+
+/** A section with a table of meshes of a vertex animation texture. */
+#define BBMOD_SECTION_VAT_MESHES "VMSH"
+
+/** A section with a table of clips of a vertex animation texture. */
+#define BBMOD_SECTION_VAT_CLIPS "VCLP"
+
+/** A section with quantized vertex positions of a vertex animation texture. */
+#define BBMOD_SECTION_VAT_POSITIONS "VPOS"
+
+/** A section with quantized vertex normals of a vertex animation texture. */
+#define BBMOD_SECTION_VAT_NORMALS "VNRM"
+
+/** The largest width of a vertex animation texture in texels. */
+#define BBMOD_VAT_MAX_WIDTH 2048
+
+/** A clip of a vertex animation texture. */
+struct SVertexAnimationClip
+{
+	std::string Name;
+
+	/** The first row of the texture occupied by the clip. */
+	uint32_t StartRow = 0;
+
+	uint32_t FrameCount = 0;
+
+	double TicsPerSecond = 0.0;
+
+	/** Bounding box of all vertices over the whole clip, against which are
+	 * positions quantized. */
+	vec3_t BoundsMin = VEC3_ZERO;
+
+	vec3_t BoundsMax = VEC3_ZERO;
+};
+
+/** A range of texels of a vertex animation texture occupied by a mesh. */
+struct SVertexAnimationMesh
+{
+	uint32_t FirstTexel = 0;
+
+	uint32_t TexelCount = 0;
+};
+
+/**
+ * Model-space positions and optionally normals of all vertices of a model
+ * baked at each frame of its animations, including skinning and morph target
+ * animation, so playback costs a single texture fetch per vertex. Vertices
+ * created from the same source vertex share a texel. Each frame takes
+ * RowsPerFrame rows and each clip starts at a new row.
+ *
+ * Positions are stored as RGBA16 unorm quantized against bounds of the clip,
+ * normals as RGBA8 unorm. The lookup coordinate of each vertex is stored in
+ * its second texture coordinate as the normalized column and the row within
+ * a frame, so the row of frame `f` of a clip is
+ * `StartRow + f * RowsPerFrame + Texture2.y`.
+ */
+struct SVertexAnimationTexture
+{
+	/** Assigns texels to vertices of all meshes of a model and writes their
+	 * lookup coordinates into their Texture2. Must be called before Add. */
+	void Layout(SModel* model);
+
+	/**
+	 * Evaluates vertices at each frame of an animation and adds them as a
+	 * new clip. Morph target weights are read from morph mesh channels of
+	 * `aiAnimation`, which can be nullptr.
+	 */
+	bool Add(
+		const struct aiScene* scene,
+		const struct aiAnimation* aiAnimation,
+		SAnimation* animation,
+		const std::string& name);
+
+	/** Quantizes positions and normals of all clips into texels. Called
+	 * automatically from Save. */
+	void Build();
+
+	bool Save(std::string path);
+
+	bool Save(std::ostream& file);
+
+	static SVertexAnimationTexture* Load(std::string path);
+
+	static SVertexAnimationTexture* Load(std::istream& file);
+
+	/** Decodes position of a texel at frame `frame` of a clip. */
+	void GetPosition(uint32_t clip, uint32_t frame, uint32_t texel, vec3_t out) const;
+
+	uint8_t VersionMajor = BBMOD_VERSION_MAJOR;
+
+	uint8_t VersionMinor = BBMOD_VERSION_MINOR_TOC;
+
+	/** Whether normals are baked as well. */
+	bool HasNormals = false;
+
+	/** Number of texels per frame. */
+	uint32_t TexelCount = 0;
+
+	/** Width of the texture in texels. */
+	uint32_t Width = 0;
+
+	/** Height of the texture in texels. */
+	uint32_t Height = 0;
+
+	uint32_t RowsPerFrame = 0;
+
+	std::vector<SVertexAnimationMesh> Meshes;
+
+	std::vector<SVertexAnimationClip> Clips;
+
+	/** Quantized positions, four values per texel, row by row. */
+	std::vector<uint16_t> Positions;
+
+	/** Quantized normals, four values per texel, row by row. Empty if
+	 * HasNormals is false. */
+	std::vector<uint8_t> Normals;
+
+private:
+	SModel* Model = nullptr;
+
+	/** For each texel, the mesh and the index of its first vertex in Data. */
+	std::vector<std::pair<uint32_t, uint32_t>> Texels;
+
+	/** Name of the node holding each mesh, used for meshes without bones. */
+	std::vector<std::string> MeshNodes;
+
+	/** Evaluated positions and normals of clips added since the last Build,
+	 * three floats per texel per frame. */
+	std::vector<std::vector<float>> ClipPositions;
+
+	std::vector<std::vector<float>> ClipNormals;
+};
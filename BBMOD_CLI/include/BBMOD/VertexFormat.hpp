@@ -4,9 +4,9 @@
 
 struct SVertexFormat
 {
-	bool Save(std::ofstream& file);
+	bool Save(std::ostream& file);
 
-	static SVertexFormat* Load(std::ifstream& file, uint8_t versionMinor);
+	static SVertexFormat* Load(std::istream& file, uint8_t versionMinor);
 
 	bool Vertices = true;
 
@@ -8,6 +8,9 @@
 /** The minor version of created BBMOD files. */
 #define BBMOD_VERSION_MINOR 4
 
+/** The minor version of created BBMOD files with a table of contents. */
+#define BBMOD_VERSION_MINOR_TOC 5
+
 #define pr_pointlist 1
 #define pr_linelist 2
 #define pr_linestrip 3
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdio>
 
 #define TC_RESET 0
@@ -30,16 +31,67 @@
 #define TC2(v1, v2) \
 	"\x1B[" TC_STRINGIFY(v1) ";" TC_STRINGIFY(v2) "m"
 
+/** Moves the cursor to the start of the line and erases it. */
+#define TC_CLEAR_LINE "\r\x1B[2K"
+
+/** Whether a line printed with PRINT_PROGRESS is on the screen. It is only
+ * ever set by the CLI when the standard output is a terminal. */
+inline std::atomic<bool> gProgressLineShown(false);
+
+/** Erases the progress line if it is on the screen, so messages can be printed
+ * over it. */
+inline void ClearProgressLine()
+{
+	if (gProgressLineShown.exchange(false))
+	{
+		printf(TC_CLEAR_LINE);
+	}
+}
+
 #define PRINT_SUCCESS(fmt, ...) \
-	printf(TC2(TC_B_GREEN, TC_F_BLACK) " Success: " TC1(TC_RESET) " " fmt "\n", ##__VA_ARGS__)
+	do \
+	{ \
+		ClearProgressLine(); \
+		printf(TC2(TC_B_GREEN, TC_F_BLACK) " Success: " TC1(TC_RESET) " " fmt "\n", ##__VA_ARGS__); \
+	} \
+	while (false)
 
 #define PRINT_INFO(fmt, ...) \
-	printf(TC2(TC_B_CYAN, TC_F_BLACK) " Info: " TC1(TC_RESET) " " fmt "\n", ##__VA_ARGS__)
+	do \
+	{ \
+		ClearProgressLine(); \
+		printf(TC2(TC_B_CYAN, TC_F_BLACK) " Info: " TC1(TC_RESET) " " fmt "\n", ##__VA_ARGS__); \
+	} \
+	while (false)
 
 #define PRINT_WARNING(fmt, ...) \
-	printf(TC2(TC_B_YELLOW, TC_F_BLACK) " Warning: " TC1(TC_RESET) " " fmt "\n", ##__VA_ARGS__)
+	do \
+	{ \
+		ClearProgressLine(); \
+		printf(TC2(TC_B_YELLOW, TC_F_BLACK) " Warning: " TC1(TC_RESET) " " fmt "\n", ##__VA_ARGS__); \
+	} \
+	while (false)
 
 #define PRINT_ERROR(fmt, ...) \
-	printf(TC2(TC_B_RED, TC_F_BLACK) " Error: " TC1(TC_RESET) " " fmt "\n", ##__VA_ARGS__)
+	do \
+	{ \
+		ClearProgressLine(); \
+		printf(TC2(TC_B_RED, TC_F_BLACK) " Error: " TC1(TC_RESET) " " fmt "\n", ##__VA_ARGS__); \
+	} \
+	while (false)
+
+/** Prints a line which is replaced by the next message. Must be used only when
+ * the standard output is a terminal. */
+#define PRINT_PROGRESS(fmt, ...) \
+	do \
+	{ \
+		printf(TC_CLEAR_LINE TC2(TC_B_WHITE, TC_F_BLACK) " Progress: " TC1(TC_RESET) " " fmt, ##__VA_ARGS__); \
+		fflush(stdout); \
+		gProgressLineShown = true; \
+	} \
+	while (false)
 
 bool InitTerminal();
+
+/** Returns true if the standard output is an interactive terminal. */
+bool IsTerminal();
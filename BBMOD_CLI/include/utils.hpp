@@ -9,6 +9,12 @@
 #define FILE_READ_DATA(f, d) \
 	(f).read(reinterpret_cast<char*>(&(d)), sizeof(d))
 
+#define FILE_WRITE_ARRAY(f, a, n) \
+	(f).write(reinterpret_cast<const char*>(a), sizeof(*(a)) * (n))
+
+#define FILE_READ_ARRAY(f, a, n) \
+	(f).read(reinterpret_cast<char*>(a), sizeof(*(a)) * (n))
+
 #define FILE_WRITE_VEC2(f, v) \
 	do \
 	{ \
@@ -1,8 +1,13 @@
 #include <BBMOD/Animation.hpp>
+#include <BBMOD/AnimationStream.hpp>
+#include <BBMOD/Compression.hpp>
 #include <BBMOD/Config.hpp>
 #include <BBMOD/Model.hpp>
 #include <BBMOD/Math.hpp>
+#include <BBMOD/Mesh.hpp>
 #include <BBMOD/Matrix.hpp>
+#include <BBMOD/Parallel.hpp>
+#include <BBMOD/Quantization.hpp>
 #include <terminal.hpp>
 
 #include <assimp/anim.h>
@@ -10,16 +15,20 @@
 #include <assimp/quaternion.h>
 
 #include <utils.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
 #include <iostream>
+#include <sstream>
 #include <stack>
 
-bool SAnimationKey::Save(std::ofstream& file)
+bool SAnimationKey::Save(std::ostream& file)
 {
 	FILE_WRITE_DATA(file, Time);
 	return true;
 }
 
-bool SPositionKey::Save(std::ofstream& file)
+bool SPositionKey::Save(std::ostream& file)
 {
 	if (!SAnimationKey::Save(file))
 	{
@@ -29,7 +38,7 @@ bool SPositionKey::Save(std::ofstream& file)
 	return true;
 }
 
-SPositionKey* SPositionKey::Load(std::ifstream& file)
+SPositionKey* SPositionKey::Load(std::istream& file)
 {
 	SPositionKey* positionKey = new SPositionKey();
 	FILE_READ_DATA(file, positionKey->Time);
@@ -37,7 +46,7 @@ SPositionKey* SPositionKey::Load(std::ifstream& file)
 	return positionKey;
 }
 
-bool SRotationKey::Save(std::ofstream& file)
+bool SRotationKey::Save(std::ostream& file)
 {
 	if (!SAnimationKey::Save(file))
 	{
@@ -47,7 +56,7 @@ bool SRotationKey::Save(std::ofstream& file)
 	return true;
 }
 
-SRotationKey* SRotationKey::Load(std::ifstream& file)
+SRotationKey* SRotationKey::Load(std::istream& file)
 {
 	SRotationKey* rotationKey = new SRotationKey();
 	FILE_READ_DATA(file, rotationKey->Time);
@@ -55,7 +64,7 @@ SRotationKey* SRotationKey::Load(std::ifstream& file)
 	return rotationKey;
 }
 
-bool SDualQuatKey::Save(std::ofstream& file)
+bool SDualQuatKey::Save(std::ostream& file)
 {
 	if (!SAnimationKey::Save(file))
 	{
@@ -65,7 +74,7 @@ bool SDualQuatKey::Save(std::ofstream& file)
 	return true;
 }
 
-SDualQuatKey* SDualQuatKey::Load(std::ifstream& file)
+SDualQuatKey* SDualQuatKey::Load(std::istream& file)
 {
 	SDualQuatKey* dualQuatKey = new SDualQuatKey();
 	FILE_READ_DATA(file, dualQuatKey->Time);
@@ -73,7 +82,15 @@ SDualQuatKey* SDualQuatKey::Load(std::ifstream& file)
 	return dualQuatKey;
 }
 
-bool SAnimationNode::Save(std::ofstream& file)
+SAnimationNode::~SAnimationNode()
+{
+	for (SDualQuatKey* key : DualQuatKeys)
+	{
+		delete key;
+	}
+}
+
+bool SAnimationNode::Save(std::ostream& file)
 {
 	FILE_WRITE_DATA(file, Index);
 
@@ -91,7 +108,7 @@ bool SAnimationNode::Save(std::ofstream& file)
 	return true;
 }
 
-SAnimationNode* SAnimationNode::Load(std::ifstream& file)
+SAnimationNode* SAnimationNode::Load(std::istream& file)
 {
 	SAnimationNode* animationNode = new SAnimationNode();
 	FILE_READ_DATA(file, animationNode->Index);
@@ -108,6 +125,26 @@ SAnimationNode* SAnimationNode::Load(std::ifstream& file)
 	return animationNode;
 }
 
+static void CollectNodesByIndex(SNode* node, std::vector<SNode*>& nodes)
+{
+	if ((uint32_t)node->Index < nodes.size())
+	{
+		nodes[(uint32_t)node->Index] = node;
+	}
+	for (SNode* child : node->Children)
+	{
+		CollectNodesByIndex(child, nodes);
+	}
+}
+
+SAnimation::~SAnimation()
+{
+	for (SAnimationNode* animationNode : AnimationNodes)
+	{
+		delete animationNode;
+	}
+}
+
 SAnimation* SAnimation::FromAssimp(aiAnimation* aiAnimation, SModel* model, const SConfig& config)
 {
 	SAnimation* animation = new SAnimation();
@@ -123,16 +160,60 @@ SAnimation* SAnimation::FromAssimp(aiAnimation* aiAnimation, SModel* model, cons
 	}
 	animation->TicsPerSecond = config.SamplingRate;
 
+	animation->EliminateConstantTracks = config.EliminateConstantTracks;
+	animation->Quantization = config.AnimationQuantization;
+	animation->HalfFloatFrames = config.HalfFloatFrames;
+	animation->LodTiers = config.AnimationLodTiers;
+	animation->FrameBlockSize = config.FrameIndex ? std::max<uint32_t>(config.FrameBlockSize, 1) : 0;
+	animation->CompressFrameBlocks = config.CompressFrameBlocks;
+	animation->AnimatedBounds = (config.AnimatedBounds && !model->Meshes.empty());
+
+	if (!config.WorldSpaceNodes.empty())
+	{
+		std::vector<SNode*> nodes(model->NodeCount, nullptr);
+		CollectNodesByIndex(model->RootNode, nodes);
+
+		for (SNode* node : nodes)
+		{
+			if (node && MatchNamePatterns(node->Name, config.WorldSpaceNodes))
+			{
+				animation->WorldSpaceNodes.push_back((uint32_t)node->Index);
+				animation->WorldSpaceNodeNames.push_back(node->Name);
+			}
+		}
+	}
+
+	if (config.TableOfContents
+		|| !config.WorldSpaceNodes.empty()
+		|| config.AnimationLodTiers > 0
+		|| config.ReduceKeys
+		|| config.EliminateConstantTracks
+		|| config.AnimationQuantization != BBMOD_QUANTIZE_NONE
+		|| config.HalfFloatFrames
+		|| config.FrameIndex
+		|| animation->AnimatedBounds
+		|| model->SkeletonHash != 0)
+	{
+		animation->VersionMinor = BBMOD_VERSION_MINOR_TOC;
+	}
+
 	for (uint32_t i = 0; i < aiAnimation->mNumChannels; ++i)
 	{
 		aiNodeAnim* channel = aiAnimation->mChannels[i];
 
-		SAnimationNode* animationNode = new SAnimationNode();
 		SNode* node = model->FindNodeByName(channel->mNodeName.C_Str(), model->RootNode);
 		if (!node)
 		{
+			if (!model->NodeIsImportant(channel->mNodeName.C_Str()))
+			{
+				// Removed by pruning
+				continue;
+			}
+			delete animation;
 			return nullptr;
 		}
+
+		SAnimationNode* animationNode = new SAnimationNode();
 		animationNode->Index = node->Index;
 
 		std::vector<SPositionKey*> positionKeys;
@@ -219,11 +300,23 @@ SAnimation* SAnimation::FromAssimp(aiAnimation* aiAnimation, SModel* model, cons
 			SDualQuatKey* key = new SDualQuatKey();
 			key->Time = at;
 
-			dual_quaternion_from_translation_rotation(key->DualQuat, position, rotation);
+			dual_quat_t transform;
+			dual_quaternion_from_translation_rotation(transform, position, rotation);
+			dual_quaternion_multiply(transform, node->PrunedTransform, key->DualQuat, 0);
 
 			animationNode->DualQuatKeys.push_back(key);
 		}
 
+		for (SPositionKey* positionKey : positionKeys)
+		{
+			delete positionKey;
+		}
+
+		for (SRotationKey* rotationKey : rotationKeys)
+		{
+			delete rotationKey;
+		}
+
 		animation->AnimationNodes.push_back(animationNode);
 	}
 
@@ -239,216 +332,2031 @@ bool SAnimation::Save(std::string path, const SConfig& config)
 		return false;
 	}
 
-	file.write("BBANIM", sizeof(char) * 7);
-	FILE_WRITE_DATA(file, VersionMajor);
-	FILE_WRITE_DATA(file, VersionMinor);
-	unsigned char spaces = 0;
-	if (config.AnimationOptimization == 0) { spaces = spaces | BBMOD_BONE_SPACE_PARENT; }
-	if (config.AnimationOptimization == 1) { spaces = spaces | BBMOD_BONE_SPACE_WORLD; }
-	if (config.AnimationOptimization == 2) { spaces = spaces | BBMOD_BONE_SPACE_WORLD | BBMOD_BONE_SPACE_BONE; }
-	FILE_WRITE_DATA(file, spaces);
-	FILE_WRITE_DATA(file, Duration);
-	FILE_WRITE_DATA(file, TicsPerSecond);
+	if (config.Compress)
+	{
+		std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
 
-	uint32_t modelNodeCount = Model->NodeCount;
-	FILE_WRITE_DATA(file, modelNodeCount);
+		if (!Save(stream, config))
+		{
+			return false;
+		}
 
-	uint32_t modelBoneCount = Model->BoneCount;
-	FILE_WRITE_DATA(file, modelBoneCount);
+		const std::string data = stream.str();
+
+		if (!WriteContainer(file, reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+			config.CompressionChunkSize, config.CompressionFilter))
+		{
+			return false;
+		}
+	}
+	else if (!Save(file, config))
+	{
+		return false;
+	}
+
+	file.flush();
+	file.close();
+
+	return true;
+}
+
+/** Interpolates between two keys, returning translation and rotation. */
+static void InterpolateKeys(const SDualQuatKey* a, const SDualQuatKey* b, float factor, vec3_t t, quat_t r)
+{
+	vec3_t tb;
+	dual_quaternion_get_translation(a->DualQuat, t);
+	dual_quaternion_get_translation(b->DualQuat, tb);
+	vec3_lerp(t, tb, factor);
+
+	quat_t rb;
+	dual_quaternion_get_rotation(a->DualQuat, r);
+	dual_quaternion_get_rotation(b->DualQuat, rb);
+	quaternion_slerp(r, rb, factor);
+}
+
+void SAnimationNode::Sample(double frame, dual_quat_t out) const
+{
+	auto upper = std::upper_bound(DualQuatKeys.begin(), DualQuatKeys.end(), frame,
+		[](double value, const SDualQuatKey* key) { return value < key->Time; });
+
+	if (upper == DualQuatKeys.begin())
+	{
+		dual_quaternion_copy(DualQuatKeys.front()->DualQuat, out);
+		return;
+	}
+
+	const SDualQuatKey* previous = *(upper - 1);
+
+	if (upper == DualQuatKeys.end() || previous->Time == frame)
+	{
+		dual_quaternion_copy(previous->DualQuat, out);
+		return;
+	}
+
+	const SDualQuatKey* next = *upper;
+	float factor = (float)((frame - previous->Time) / (next->Time - previous->Time));
 
-	uint32_t nodeSize = modelNodeCount * 8;
-	uint32_t boneSize = modelBoneCount * 8;
-	float* frameParent = new float[nodeSize];
-	float* frameWorld = new float[nodeSize];
-	float* frameBone = new float[boneSize];
+	vec3_t t;
+	quat_t r;
+	InterpolateKeys(previous, next, factor, t, r);
+	dual_quaternion_from_translation_rotation(out, t, r);
+}
 
-	for (double frame = 0.0; frame < Duration; ++frame)
+/** Returns the largest distance from a node to any of its descendants. */
+static float ComputeReach(SNode* node, std::vector<float>& reach)
+{
+	float result = 0.0f;
+	for (SNode* child : node->Children)
 	{
-		std::stack<SNode*> stackNodes;
-		std::stack<float*> stackDualQuat;
+		vec3_t t;
+		dual_quaternion_get_translation(child->Transform, t);
+		float length = sqrtf(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+		result = std::max(result, length + ComputeReach(child, reach));
+	}
+	if ((uint32_t)node->Index < reach.size())
+	{
+		reach[(uint32_t)node->Index] = result;
+	}
+	return result;
+}
 
-		stackNodes.push(Model->RootNode);
-		
-		float* dqIdentity = dual_quaternion_create();
-		stackDualQuat.push(dqIdentity);
+/** Checks whether keys between `first` and `last` can be reproduced by
+ * interpolating between these two within given tolerances. */
+static bool KeysAreReproduced(
+	const std::vector<SDualQuatKey*>& keys,
+	size_t first,
+	size_t last,
+	float reach,
+	const SConfig& config)
+{
+	const SDualQuatKey* a = keys[first];
+	const SDualQuatKey* b = keys[last];
+	float rotationError = config.KeyRotationError * (float)M_PI / 180.0f;
 
-		while (!stackNodes.empty())
+	for (size_t i = first + 1; i < last; ++i)
+	{
+		const SDualQuatKey* key = keys[i];
+		float factor = (float)((key->Time - a->Time) / (b->Time - a->Time));
+
+		vec3_t t;
+		quat_t r;
+		InterpolateKeys(a, b, factor, t, r);
+
+		vec3_t tKey;
+		quat_t rKey;
+		dual_quaternion_get_translation(key->DualQuat, tKey);
+		dual_quaternion_get_rotation(key->DualQuat, rKey);
+
+		float dx = t[0] - tKey[0];
+		float dy = t[1] - tKey[1];
+		float dz = t[2] - tKey[2];
+		float translationDelta = sqrtf(dx * dx + dy * dy + dz * dz);
+
+		quaternion_normalize(rKey);
+		float dot = std::min(fabsf(quaternion_dot(r, rKey)), 1.0f);
+		float rotationDelta = 2.0f * acosf(dot);
+
+		// Rotation error moves descendants by up to reach * angle
+		if (translationDelta > config.KeyTranslationError
+			|| rotationDelta > rotationError
+			|| translationDelta + reach * rotationDelta > config.KeyEndEffectorError)
 		{
-			SNode* node = stackNodes.top();
-			stackNodes.pop();
+			return false;
+		}
+	}
 
-			float* top = stackDualQuat.top();
-			stackDualQuat.pop();
-			dual_quat_t dq;
-			dual_quaternion_copy(top, dq);
-			delete top;
+	return true;
+}
 
-			float nodeIndex = node->Index;
+/** Stores the index of the parent of each node into `parents`, -1 for the
+ * root. */
+static void CollectParents(SNode* node, int32_t parent, std::vector<int32_t>& parents)
+{
+	int32_t index = (int32_t)node->Index;
+	if ((uint32_t)index < parents.size())
+	{
+		parents[index] = parent;
+	}
+	for (SNode* child : node->Children)
+	{
+		CollectParents(child, index, parents);
+	}
+}
 
-			SAnimationNode* nodeData = nullptr;
+/** Marks keys in `keep` which are interpolated at given frame. Returns true if
+ * any of them was not marked yet. */
+static bool KeepKeysAt(const std::vector<SDualQuatKey*>& keys, double frame, std::vector<bool>& keep)
+{
+	auto upper = std::upper_bound(keys.begin(), keys.end(), frame,
+		[](double value, const SDualQuatKey* key) { return value < key->Time; });
 
-			for (SAnimationNode* animationNode : AnimationNodes)
-			{
-				if (animationNode->Index == nodeIndex)
-				{
-					nodeData = animationNode;
-					break;
-				}
-			}
+	size_t next = (size_t)(upper - keys.begin());
+	bool added = false;
 
-			dual_quat_t transform;
+	if (next > 0 && !keep[next - 1])
+	{
+		keep[next - 1] = true;
+		added = true;
+	}
 
-			if (nodeData != nullptr)
-			{
-				SDualQuatKey* key = nodeData->DualQuatKeys.at((uint32_t)frame);
-				dual_quaternion_copy(key->DualQuat, transform);
-			}
-			else
-			{
-				dual_quaternion_copy(node->Transform, transform);
-			}
+	if (next < keys.size() && !keep[next])
+	{
+		keep[next] = true;
+		added = true;
+	}
 
-			// Parent space
-			memcpy(&frameParent[(uint32_t)nodeIndex * 8], transform, sizeof(float) * 8);
+	return added;
+}
 
-			// World space
-			dual_quat_t dqNew;
-			dual_quaternion_multiply(transform, dq, dqNew, 0);
+SKeyReduction SAnimation::ReduceKeys(const SConfig& config)
+{
+	SKeyReduction result;
 
-			memcpy(&frameWorld[(uint32_t)nodeIndex * 8], dqNew, sizeof(float) * 8);
+	std::vector<float> reach(Model->NodeCount, 0.0f);
+	ComputeReach(Model->RootNode, reach);
 
-			// Bone space
-			if (node->IsBone)
-			{
-				dual_quat_t finalTransform;
-				dual_quat_t& offset = Model->Skeleton[(uint32_t)nodeIndex]->Offset;
-				dual_quaternion_multiply(offset, dqNew, finalTransform, 0);
-				memcpy(&frameBone[(uint32_t)nodeIndex * 8], finalTransform, sizeof(float) * 8);
-			}
+	std::vector<int32_t> parents(Model->NodeCount, -1);
+	CollectParents(Model->RootNode, -1, parents);
+
+	// Reference world-space transforms
+	uint32_t frameCount = GetFrameCount();
+	size_t nodeSize = (size_t)Model->NodeCount * 8;
+	std::vector<float> worldBefore(frameCount * nodeSize);
+	std::vector<SAnimationNode*> nodeMap = GetNodeMap();
+
+	ParallelFor(frameCount, [&](size_t frame) {
+		SampleFrame(nodeMap, (double)frame, nullptr, &worldBefore[frame * nodeSize], nullptr);
+	});
+
+	for (SAnimationNode* animationNode : AnimationNodes)
+	{
+		result.KeysBefore += (uint32_t)animationNode->DualQuatKeys.size();
+	}
+
+	// All keys stay in sourceKeys until the reduction is done, so removed
+	// keys can be brought back
+	std::vector<std::vector<SDualQuatKey*>> sourceKeys(AnimationNodes.size());
+	std::vector<std::vector<bool>> keep(AnimationNodes.size());
+
+	ParallelFor(AnimationNodes.size(), [&](size_t n) {
+		const std::vector<SDualQuatKey*>& keys = AnimationNodes[n]->DualQuatKeys;
+		size_t keyCount = keys.size();
+		sourceKeys[n] = keys;
+		keep[n].assign(keyCount, true);
+		if (keyCount <= 2)
+		{
+			return;
+		}
+
+		float nodeReach = reach[(uint32_t)AnimationNodes[n]->Index];
+		std::fill(keep[n].begin(), keep[n].end(), false);
+		keep[n][0] = true;
+		keep[n][keyCount - 1] = true;
 
-			for (SNode* child : node->Children)
+		size_t anchor = 0;
+		while (anchor < keyCount - 1)
+		{
+			size_t last = anchor + 1;
+			while (last + 1 < keyCount
+				&& KeysAreReproduced(keys, anchor, last + 1, nodeReach, config))
 			{
-				stackNodes.push(child);
-				float* dqChild = dual_quaternion_create();
-				dual_quaternion_copy(dqNew, dqChild);
-				stackDualQuat.push(dqChild);
+				++last;
 			}
+			keep[n][last] = true;
+			anchor = last;
 		}
+	});
 
-		if (spaces & BBMOD_BONE_SPACE_PARENT)
+	// Animation node of each model node
+	std::vector<int32_t> animationIndex(Model->NodeCount, -1);
+	for (size_t n = 0; n < AnimationNodes.size(); ++n)
+	{
+		uint32_t index = (uint32_t)AnimationNodes[n]->Index;
+		if (index < animationIndex.size())
+		{
+			animationIndex[index] = (int32_t)n;
+		}
+	}
+
+	// Errors of ancestors add up down the hierarchy, so the world-space error
+	// of each node is measured and keys of the node and its ancestors are
+	// brought back at frames where it exceeds the end effector tolerance
+	std::vector<float> errors(frameCount * (size_t)Model->NodeCount);
+
+	while (true)
+	{
+		for (size_t n = 0; n < AnimationNodes.size(); ++n)
 		{
-			for (uint32_t f = 0; f < nodeSize; ++f)
+			std::vector<SDualQuatKey*>& keys = AnimationNodes[n]->DualQuatKeys;
+			keys.clear();
+			for (size_t i = 0; i < sourceKeys[n].size(); ++i)
 			{
-				float v = frameParent[f];
-				FILE_WRITE_DATA(file, v);
+				if (keep[n][i])
+				{
+					keys.push_back(sourceKeys[n][i]);
+				}
 			}
 		}
 
-		if (spaces & BBMOD_BONE_SPACE_WORLD)
+		ParallelFor(frameCount, [&](size_t frame) {
+			std::vector<float> worldAfter(nodeSize);
+			SampleFrame(nodeMap, (double)frame, nullptr, worldAfter.data(), nullptr);
+
+			for (uint32_t i = 0; i < Model->NodeCount; ++i)
+			{
+				vec3_t before;
+				vec3_t after;
+				dual_quaternion_get_translation(&worldBefore[frame * nodeSize + i * 8], before);
+				dual_quaternion_get_translation(&worldAfter[i * 8], after);
+				float dx = before[0] - after[0];
+				float dy = before[1] - after[1];
+				float dz = before[2] - after[2];
+				errors[frame * Model->NodeCount + i] = sqrtf(dx * dx + dy * dy + dz * dz);
+			}
+		});
+
+		bool added = false;
+		result.MaxError = 0.0f;
+
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
 		{
-			for (uint32_t f = 0; f < nodeSize; ++f)
+			for (uint32_t i = 0; i < Model->NodeCount; ++i)
 			{
-				float v = frameWorld[f];
-				FILE_WRITE_DATA(file, v);
+				float error = errors[frame * Model->NodeCount + i];
+				result.MaxError = std::max(result.MaxError, error);
+
+				if (error <= config.KeyEndEffectorError)
+				{
+					continue;
+				}
+
+				for (int32_t j = (int32_t)i; j != -1; j = parents[j])
+				{
+					int32_t n = animationIndex[j];
+					if (n != -1 && KeepKeysAt(sourceKeys[n], (double)frame, keep[n]))
+					{
+						added = true;
+					}
+				}
 			}
 		}
 
-		if (spaces & BBMOD_BONE_SPACE_BONE)
+		if (!added)
+		{
+			break;
+		}
+	}
+
+	for (size_t n = 0; n < AnimationNodes.size(); ++n)
+	{
+		for (size_t i = 0; i < sourceKeys[n].size(); ++i)
 		{
-			for (uint32_t f = 0; f < boneSize; ++f)
+			if (!keep[n][i])
 			{
-				float v = frameBone[f];
-				FILE_WRITE_DATA(file, v);
+				delete sourceKeys[n][i];
 			}
 		}
+		result.KeysAfter += (uint32_t)AnimationNodes[n]->DualQuatKeys.size();
 	}
 
-	delete[] frameParent;
-	delete[] frameWorld;
-	delete[] frameBone;
+	IsReduced = true;
 
-	uint32_t eventCount = 0;
-	FILE_WRITE_DATA(file, eventCount);
+	return result;
+}
 
-	file.flush();
-	file.close();
+uint8_t SAnimation::GetSpaces(const SConfig& config)
+{
+	if (!config.WorldSpaceNodes.empty())
+	{
+		// World space is stored only for selected nodes
+		return BBMOD_BONE_SPACE_BONE;
+	}
 
-	return true;
+	uint8_t spaces = 0;
+	if (config.AnimationOptimization == 0) { spaces = spaces | BBMOD_BONE_SPACE_PARENT; }
+	if (config.AnimationOptimization == 1) { spaces = spaces | BBMOD_BONE_SPACE_WORLD; }
+	if (config.AnimationOptimization == 2) { spaces = spaces | BBMOD_BONE_SPACE_WORLD | BBMOD_BONE_SPACE_BONE; }
+	return spaces;
 }
 
-SAnimation* SAnimation::Load(std::string path)
+std::vector<SAnimationNode*> SAnimation::GetNodeMap() const
 {
-	std::ifstream file(path, std::ios::in | std::ios::binary);
-
-	if (!file.is_open())
+	std::vector<SAnimationNode*> nodeMap(Model->NodeCount, nullptr);
+	for (SAnimationNode* animationNode : AnimationNodes)
 	{
-		return nullptr;
+		if (animationNode && (uint32_t)animationNode->Index < nodeMap.size())
+		{
+			nodeMap[(uint32_t)animationNode->Index] = animationNode;
+		}
 	}
+	return nodeMap;
+}
 
-	char header[7];
-	file.read(header, 7);
+static void SampleNode(
+	const SAnimation* animation,
+	const std::vector<SAnimationNode*>& nodeMap,
+	SNode* node,
+	dual_quat_t dq,
+	double frame,
+	float* frameParent,
+	float* frameWorld,
+	float* frameBone)
+{
+	uint32_t nodeIndex = (uint32_t)node->Index;
+	SAnimationNode* nodeData = nodeMap[nodeIndex];
 
-	bool hasMinorVersion = false;
+	dual_quat_t transform;
 
-	if (std::strcmp(header, "bbanim") == 0)
+	if (nodeData != nullptr)
 	{
+		nodeData->Sample(frame, transform);
 	}
-	else if (std::strcmp(header, "BBANIM") == 0)
+	else
 	{
-		hasMinorVersion = true;
+		dual_quaternion_copy(node->Transform, transform);
 	}
-	else
+
+	// Parent space
+	if (frameParent)
 	{
-		file.close();
-		return nullptr;
+		memcpy(&frameParent[nodeIndex * 8], transform, sizeof(float) * 8);
 	}
 
-	uint8_t versionMajor;
-	FILE_READ_DATA(file, versionMajor);
+	// World space
+	dual_quat_t dqNew;
+	dual_quaternion_multiply(transform, dq, dqNew, 0);
 
-	if (versionMajor != BBMOD_VERSION_MAJOR)
+	if (frameWorld)
 	{
-		file.close();
-		return nullptr;
+		memcpy(&frameWorld[nodeIndex * 8], dqNew, sizeof(float) * 8);
+	}
+
+	// Bone space
+	if (frameBone && node->IsBone)
+	{
+		dual_quat_t finalTransform;
+		dual_quat_t& offset = animation->Model->Skeleton[nodeIndex]->Offset;
+		dual_quaternion_multiply(offset, dqNew, finalTransform, 0);
+		memcpy(&frameBone[nodeIndex * 8], finalTransform, sizeof(float) * 8);
+	}
+
+	for (SNode* child : node->Children)
+	{
+		SampleNode(animation, nodeMap, child, dqNew, frame, frameParent, frameWorld, frameBone);
 	}
+}
+
+void SAnimation::SampleFrame(
+	const std::vector<SAnimationNode*>& nodeMap,
+	double frame,
+	float* frameParent,
+	float* frameWorld,
+	float* frameBone) const
+{
+	dual_quat_t dqIdentity = DUAL_QUATERNION_IDENTITY;
+	SampleNode(this, nodeMap, Model->RootNode, dqIdentity, frame, frameParent, frameWorld, frameBone);
+}
+
+size_t SAnimation::GetFrameSize(uint8_t spaces, uint32_t nodeCount, uint32_t boneCount)
+{
+	size_t size = 0;
+	if (spaces & BBMOD_BONE_SPACE_PARENT) { size += (size_t)nodeCount * 8; }
+	if (spaces & BBMOD_BONE_SPACE_WORLD) { size += (size_t)nodeCount * 8; }
+	if (spaces & BBMOD_BONE_SPACE_BONE) { size += (size_t)boneCount * 8; }
+	return size;
+}
+
+void SAnimation::AddMorphTracks(const aiAnimation* animation, const SModel* meshModel)
+{
+	uint32_t frameCount = GetFrameCount();
+	double ticksPerFrame = (Duration > 0.0) ? animation->mDuration / Duration : 0.0;
 
-	uint8_t versionMinor = 0;
-	if (hasMinorVersion)
+	for (uint32_t c = 0; c < animation->mNumMorphMeshChannels; ++c)
 	{
-		FILE_READ_DATA(file, versionMinor);
-		if (versionMinor != BBMOD_VERSION_MINOR)
+		const aiMeshMorphAnim* channel = animation->mMorphMeshChannels[c];
+		std::string name = channel->mName.C_Str();
+
+		// Channels are named either after the mesh or after its node
+		std::vector<uint32_t> meshes;
+
+		for (uint32_t m = 0; m < meshModel->Meshes.size(); ++m)
 		{
-			file.close();
-			return nullptr;
+			if (!meshModel->Meshes[m]->MorphTargets.empty() && meshModel->Meshes[m]->Name == name)
+			{
+				meshes.push_back(m);
+			}
 		}
-	}
 
-	SAnimation* animation = new SAnimation();
-	animation->VersionMajor = versionMajor;
-	animation->VersionMinor = versionMinor;
-	FILE_READ_DATA(file, animation->Duration);
-	FILE_READ_DATA(file, animation->TicsPerSecond);
+		SNode* node = (meshes.empty() && meshModel->RootNode)
+			? meshModel->FindNodeByName(name, meshModel->RootNode)
+			: nullptr;
+
+		if (node)
+		{
+			for (uint32_t m : node->Meshes)
+			{
+				if (m < meshModel->Meshes.size() && !meshModel->Meshes[m]->MorphTargets.empty())
+				{
+					meshes.push_back(m);
+				}
+			}
+		}
+
+		for (uint32_t m : meshes)
+		{
+			uint32_t targetCount = (uint32_t)meshModel->Meshes[m]->MorphTargets.size();
+			std::vector<SMorphTrack> tracks(targetCount);
+			std::vector<float> weights(targetCount);
+
+			for (uint32_t t = 0; t < targetCount; ++t)
+			{
+				tracks[t].MeshIndex = m;
+				tracks[t].TargetIndex = t;
+				tracks[t].Weights.resize(frameCount);
+			}
 
-	uint32_t modelNodeCount;
-	FILE_READ_DATA(file, modelNodeCount);
+			for (uint32_t frame = 0; frame < frameCount; ++frame)
+			{
+				SampleMorphWeights(channel, frame * ticksPerFrame, weights);
+				for (uint32_t t = 0; t < targetCount; ++t)
+				{
+					tracks[t].Weights[frame] = weights[t];
+				}
+			}
 
-	animation->ModelNodeCount = modelNodeCount;
+			for (SMorphTrack& track : tracks)
+			{
+				bool animated = std::any_of(track.Weights.begin(), track.Weights.end(),
+					[](float weight) { return weight != 0.0f; });
+				if (animated)
+				{
+					MorphTracks.push_back(std::move(track));
+				}
+			}
+		}
+	}
 
-	for (uint32_t i = 0; i < modelNodeCount; ++i)
+	if (!MorphTracks.empty())
 	{
-		animation->AnimationNodes.push_back(nullptr);
+		VersionMinor = BBMOD_VERSION_MINOR_TOC;
 	}
+}
 
-	uint32_t affectedNodeCount;
-	FILE_READ_DATA(file, affectedNodeCount);
+void SAnimation::SampleMorphWeights(const aiMeshMorphAnim* channel, double time, std::vector<float>& out)
+{
+	std::fill(out.begin(), out.end(), 0.0f);
 
-	for (uint32_t i = 0; i < affectedNodeCount; ++i)
+	if (channel->mNumKeys == 0)
 	{
-		SAnimationNode* animationNode = SAnimationNode::Load(file);
-		animation->AnimationNodes[(uint32_t)animationNode->Index] = animationNode;
+		return;
 	}
 
-	file.close();
+	uint32_t k = 0;
+	while (k + 1 < channel->mNumKeys && channel->mKeys[k + 1].mTime <= time)
+	{
+		++k;
+	}
 
-	return animation;
+	const aiMeshMorphKey& a = channel->mKeys[k];
+	const aiMeshMorphKey& b = channel->mKeys[std::min(k + 1, channel->mNumKeys - 1)];
+	double factor = (b.mTime > a.mTime) ? (time - a.mTime) / (b.mTime - a.mTime) : 0.0;
+	factor = std::min(std::max(factor, 0.0), 1.0);
+
+	for (uint32_t j = 0; j < a.mNumValuesAndWeights; ++j)
+	{
+		if (a.mValues[j] < out.size())
+		{
+			out[a.mValues[j]] += (float)(a.mWeights[j] * (1.0 - factor));
+		}
+	}
+
+	for (uint32_t j = 0; j < b.mNumValuesAndWeights; ++j)
+	{
+		if (b.mValues[j] < out.size())
+		{
+			out[b.mValues[j]] += (float)(b.mWeights[j] * factor);
+		}
+	}
+}
+
+uint32_t SAnimation::GetFrameCount() const
+{
+	return (uint32_t)ceil(Duration);
+}
+
+void SAnimation::SampleFrames(uint8_t spaces, std::vector<float>& out) const
+{
+	uint32_t nodeSize = Model->NodeCount * 8;
+	size_t frameSize = GetFrameSize(spaces, Model->NodeCount, Model->BoneCount);
+	out.resize(frameSize * GetFrameCount());
+
+	std::vector<SAnimationNode*> nodeMap = GetNodeMap();
+
+	ParallelFor(GetFrameCount(), [&](size_t frame) {
+		float* data = &out[frame * frameSize];
+		float* frameParent = nullptr;
+		float* frameWorld = nullptr;
+		float* frameBone = nullptr;
+
+		if (spaces & BBMOD_BONE_SPACE_PARENT)
+		{
+			frameParent = data;
+			data += nodeSize;
+		}
+
+		if (spaces & BBMOD_BONE_SPACE_WORLD)
+		{
+			frameWorld = data;
+			data += nodeSize;
+		}
+
+		if (spaces & BBMOD_BONE_SPACE_BONE)
+		{
+			frameBone = data;
+		}
+
+		SampleFrame(nodeMap, (double)frame, frameParent, frameWorld, frameBone);
+	});
+}
+
+bool SAnimation::WriteFrames(std::ostream& file, uint8_t spaces) const
+{
+	std::vector<float> frames;
+	SampleFrames(spaces, frames);
+	FILE_WRITE_ARRAY(file, frames.data(), frames.size());
+	return file.good();
+}
+
+/** Lists sizes (in number of transforms) of each space stored in a frame. */
+static std::vector<uint32_t> GetSpaceSizes(uint8_t spaces, uint32_t nodeCount, uint32_t boneCount)
+{
+	std::vector<uint32_t> sizes;
+	if (spaces & BBMOD_BONE_SPACE_PARENT) { sizes.push_back(nodeCount); }
+	if (spaces & BBMOD_BONE_SPACE_WORLD) { sizes.push_back(nodeCount); }
+	if (spaces & BBMOD_BONE_SPACE_BONE) { sizes.push_back(boneCount); }
+	return sizes;
+}
+
+/** Returns a mask with 1 for tracks which differ in at least one frame. */
+static std::vector<uint8_t> FindVaryingTracks(const std::vector<float>& frames, size_t frameSize, uint32_t frameCount)
+{
+	std::vector<uint8_t> mask(frameSize / 8, 0);
+
+	ParallelFor(mask.size(), [&](size_t track) {
+		const float* first = &frames[track * 8];
+		for (uint32_t frame = 1; frame < frameCount; ++frame)
+		{
+			if (std::memcmp(first, &frames[frame * frameSize + track * 8], sizeof(float) * 8) != 0)
+			{
+				mask[track] = 1;
+				break;
+			}
+		}
+	});
+
+	return mask;
+}
+
+bool SAnimation::WriteTracks(std::ostream& file, uint8_t spaces) const
+{
+	std::vector<float> frames;
+	SampleFrames(spaces, frames);
+
+	uint32_t frameCount = GetFrameCount();
+	size_t frameSize = GetFrameSize(spaces, Model->NodeCount, Model->BoneCount);
+	std::vector<uint32_t> sizes = GetSpaceSizes(spaces, Model->NodeCount, Model->BoneCount);
+
+	std::vector<uint8_t> mask = FindVaryingTracks(frames, frameSize, frameCount);
+
+	size_t track = 0;
+	for (uint32_t size : sizes)
+	{
+		FILE_WRITE_DATA(file, size);
+		file.write(reinterpret_cast<const char*>(&mask[track]), size);
+
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			if (!mask[track + i] && frameCount > 0)
+			{
+				FILE_WRITE_ARRAY(file, &frames[(track + i) * 8], 8);
+			}
+		}
+
+		track += size;
+	}
+
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		for (size_t i = 0; i < mask.size(); ++i)
+		{
+			if (mask[i])
+			{
+				FILE_WRITE_ARRAY(file, &frames[frame * frameSize + i * 8], 8);
+			}
+		}
+	}
+
+	return file.good();
+}
+
+bool SAnimation::ReadTracks(
+	std::istream& file,
+	uint8_t spaces,
+	uint32_t nodeCount,
+	uint32_t boneCount,
+	uint32_t frameCount,
+	std::vector<float>& out)
+{
+	size_t frameSize = GetFrameSize(spaces, nodeCount, boneCount);
+	std::vector<uint32_t> sizes = GetSpaceSizes(spaces, nodeCount, boneCount);
+	std::vector<uint8_t> mask;
+
+	out.resize(frameSize * frameCount);
+
+	for (uint32_t expected : sizes)
+	{
+		uint32_t size;
+		FILE_READ_DATA(file, size);
+
+		if (!file || size != expected)
+		{
+			return false;
+		}
+
+		size_t track = mask.size();
+		mask.resize(track + size);
+		file.read(reinterpret_cast<char*>(&mask[track]), size);
+
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			if (!mask[track + i] && frameCount > 0)
+			{
+				float transform[8];
+				FILE_READ_ARRAY(file, transform, 8);
+				for (uint32_t frame = 0; frame < frameCount; ++frame)
+				{
+					std::memcpy(&out[frame * frameSize + (track + i) * 8], transform, sizeof(transform));
+				}
+			}
+		}
+	}
+
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		for (size_t i = 0; i < mask.size(); ++i)
+		{
+			if (mask[i])
+			{
+				FILE_READ_ARRAY(file, &out[frame * frameSize + i * 8], 8);
+			}
+		}
+	}
+
+	return file.good();
+}
+
+/** Returns a BBMOD_TRACK_ encoding used for a space. */
+static uint8_t GetTrackEncoding(uint8_t space, uint32_t quantization, bool halfFloat)
+{
+	if (space != BBMOD_BONE_SPACE_PARENT && halfFloat)
+	{
+		return BBMOD_TRACK_HALF;
+	}
+	if (quantization == BBMOD_QUANTIZE_48)
+	{
+		return BBMOD_TRACK_QUANTIZED_48;
+	}
+	if (quantization == BBMOD_QUANTIZE_32)
+	{
+		return BBMOD_TRACK_QUANTIZED_32;
+	}
+	return BBMOD_TRACK_FLOAT;
+}
+
+/** Returns size of a transform with given BBMOD_TRACK_ encoding in bytes. */
+static size_t GetEncodedSize(uint8_t encoding)
+{
+	switch (encoding)
+	{
+	case BBMOD_TRACK_QUANTIZED_48:
+		return 6 + 3 * sizeof(uint16_t);
+	case BBMOD_TRACK_QUANTIZED_32:
+		return 4 + 3 * sizeof(uint16_t);
+	case BBMOD_TRACK_HALF:
+		return 8 * sizeof(uint16_t);
+	default:
+		return 8 * sizeof(float);
+	}
+}
+
+static bool IsQuantized(uint8_t encoding)
+{
+	return (encoding == BBMOD_TRACK_QUANTIZED_48
+		|| encoding == BBMOD_TRACK_QUANTIZED_32);
+}
+
+/** Encodes a dual quaternion. `range` holds min and max of its translation. */
+static void EncodeTransform(const float* dq, uint8_t encoding, const float* range, uint8_t* out)
+{
+	if (encoding == BBMOD_TRACK_HALF)
+	{
+		for (uint32_t i = 0; i < 8; ++i)
+		{
+			uint16_t half = FloatToHalf(dq[i]);
+			std::memcpy(out + i * sizeof(half), &half, sizeof(half));
+		}
+		return;
+	}
+
+	if (!IsQuantized(encoding))
+	{
+		std::memcpy(out, dq, sizeof(float) * 8);
+		return;
+	}
+
+	quat_t r;
+	vec3_t t;
+	dual_quaternion_get_rotation(dq, r);
+	dual_quaternion_get_translation(dq, t);
+
+	if (encoding == BBMOD_TRACK_QUANTIZED_48)
+	{
+		QuaternionPack48(r, out);
+		out += 6;
+	}
+	else
+	{
+		QuaternionPack32(r, out);
+		out += 4;
+	}
+
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		uint16_t value = QuantizeRange16(t[i], range[i], range[3 + i]);
+		std::memcpy(out + i * sizeof(value), &value, sizeof(value));
+	}
+}
+
+static void DecodeTransform(const uint8_t* in, uint8_t encoding, const float* range, float* dq)
+{
+	if (encoding == BBMOD_TRACK_HALF)
+	{
+		for (uint32_t i = 0; i < 8; ++i)
+		{
+			uint16_t half;
+			std::memcpy(&half, in + i * sizeof(half), sizeof(half));
+			dq[i] = HalfToFloat(half);
+		}
+		return;
+	}
+
+	if (!IsQuantized(encoding))
+	{
+		std::memcpy(dq, in, sizeof(float) * 8);
+		return;
+	}
+
+	quat_t r;
+	vec3_t t;
+
+	if (encoding == BBMOD_TRACK_QUANTIZED_48)
+	{
+		QuaternionUnpack48(in, r);
+		in += 6;
+	}
+	else
+	{
+		QuaternionUnpack32(in, r);
+		in += 4;
+	}
+
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		uint16_t value;
+		std::memcpy(&value, in + i * sizeof(value), sizeof(value));
+		t[i] = DequantizeRange16(value, range[i], range[3 + i]);
+	}
+
+	dual_quaternion_from_translation_rotation(dq, t, r);
+}
+
+bool SAnimation::WriteQuantizedTracks(std::ostream& file, uint8_t spaces)
+{
+	std::vector<float> frames;
+	SampleFrames(spaces, frames);
+
+	uint32_t frameCount = GetFrameCount();
+	size_t frameSize = GetFrameSize(spaces, Model->NodeCount, Model->BoneCount);
+	std::vector<uint32_t> sizes = GetSpaceSizes(spaces, Model->NodeCount, Model->BoneCount);
+	std::vector<uint8_t> mask = EliminateConstantTracks
+		? FindVaryingTracks(frames, frameSize, frameCount)
+		: std::vector<uint8_t>(frameSize / 8, 1);
+
+	// Encoding and translation range of each track
+	std::vector<uint8_t> encodings;
+	std::vector<float> ranges(mask.size() * 6, 0.0f);
+
+	const uint8_t spaceFlags[] = {
+		BBMOD_BONE_SPACE_PARENT, BBMOD_BONE_SPACE_WORLD, BBMOD_BONE_SPACE_BONE
+	};
+	for (uint8_t space : spaceFlags)
+	{
+		if (spaces & space)
+		{
+			encodings.push_back(GetTrackEncoding(space, Quantization, HalfFloatFrames));
+		}
+	}
+
+	std::vector<uint8_t> trackEncodings;
+	for (size_t s = 0; s < sizes.size(); ++s)
+	{
+		trackEncodings.insert(trackEncodings.end(), sizes[s], encodings[s]);
+	}
+
+	ParallelFor(mask.size(), [&](size_t track) {
+		if (!mask[track] || !IsQuantized(trackEncodings[track]) || frameCount == 0)
+		{
+			return;
+		}
+		float* range = &ranges[track * 6];
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			vec3_t t;
+			dual_quaternion_get_translation(&frames[frame * frameSize + track * 8], t);
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				range[i] = (frame == 0) ? t[i] : std::min(range[i], t[i]);
+				range[3 + i] = (frame == 0) ? t[i] : std::max(range[3 + i], t[i]);
+			}
+		}
+	});
+
+	std::ostringstream stream(std::ios::out | std::ios::binary);
+
+	size_t track = 0;
+	for (size_t s = 0; s < sizes.size(); ++s)
+	{
+		uint32_t size = sizes[s];
+		FILE_WRITE_DATA(stream, size);
+		FILE_WRITE_DATA(stream, encodings[s]);
+		stream.write(reinterpret_cast<const char*>(&mask[track]), size);
+
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			if (!mask[track + i] && frameCount > 0)
+			{
+				FILE_WRITE_ARRAY(stream, &frames[(track + i) * 8], 8);
+			}
+			else if (mask[track + i] && IsQuantized(encodings[s]))
+			{
+				FILE_WRITE_ARRAY(stream, &ranges[(track + i) * 6], 6);
+			}
+		}
+
+		track += size;
+	}
+
+	std::vector<uint8_t> encoded(frameSize / 8 * GetEncodedSize(BBMOD_TRACK_FLOAT));
+
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		uint8_t* out = encoded.data();
+		for (size_t i = 0; i < mask.size(); ++i)
+		{
+			if (mask[i])
+			{
+				EncodeTransform(&frames[frame * frameSize + i * 8], trackEncodings[i], &ranges[i * 6], out);
+				out += GetEncodedSize(trackEncodings[i]);
+			}
+		}
+		stream.write(reinterpret_cast<const char*>(encoded.data()), out - encoded.data());
+	}
+
+	const std::string data = stream.str();
+
+	// Verify the round-trip error against the float data
+	std::istringstream input(data, std::ios::in | std::ios::binary);
+	std::vector<float> decoded;
+
+	if (!ReadQuantizedTracks(input, spaces, Model->NodeCount, Model->BoneCount, frameCount, decoded))
+	{
+		return false;
+	}
+
+	QuantizationError = SQuantizationError();
+
+	for (size_t i = 0; i < frames.size(); i += 8)
+	{
+		quat_t r1;
+		quat_t r2;
+		vec3_t t1;
+		vec3_t t2;
+		dual_quaternion_get_rotation(&frames[i], r1);
+		dual_quaternion_get_rotation(&decoded[i], r2);
+		dual_quaternion_get_translation(&frames[i], t1);
+		dual_quaternion_get_translation(&decoded[i], t2);
+
+		float dx = t1[0] - t2[0];
+		float dy = t1[1] - t2[1];
+		float dz = t1[2] - t2[2];
+		QuantizationError.MaxTranslationError = std::max(
+			QuantizationError.MaxTranslationError, sqrtf(dx * dx + dy * dy + dz * dz));
+
+		// Angle between rotations from the chord length, which is precise
+		// also for small angles unlike acos of their dot product
+		quaternion_normalize(r1);
+		quaternion_normalize(r2);
+		float sign = (quaternion_dot(r1, r2) < 0.0f) ? -1.0f : 1.0f;
+		double chord = 0.0;
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			double d = (double)r1[j] - (double)(sign * r2[j]);
+			chord += d * d;
+		}
+		double angle = 4.0 * asin(std::min(sqrt(chord) * 0.5, 1.0));
+		QuantizationError.MaxRotationError = std::max(
+			QuantizationError.MaxRotationError, (float)(angle * 180.0 / M_PI));
+	}
+
+	file.write(data.data(), data.size());
+
+	return file.good();
+}
+
+bool SAnimation::ReadQuantizedTracks(
+	std::istream& file,
+	uint8_t spaces,
+	uint32_t nodeCount,
+	uint32_t boneCount,
+	uint32_t frameCount,
+	std::vector<float>& out)
+{
+	size_t frameSize = GetFrameSize(spaces, nodeCount, boneCount);
+	std::vector<uint32_t> sizes = GetSpaceSizes(spaces, nodeCount, boneCount);
+	std::vector<uint8_t> mask;
+	std::vector<uint8_t> trackEncodings;
+	std::vector<float> ranges(frameSize / 8 * 6, 0.0f);
+
+	out.resize(frameSize * frameCount);
+
+	for (uint32_t expected : sizes)
+	{
+		uint32_t size;
+		uint8_t encoding;
+		FILE_READ_DATA(file, size);
+		FILE_READ_DATA(file, encoding);
+
+		if (!file || size != expected || encoding > BBMOD_TRACK_HALF)
+		{
+			return false;
+		}
+
+		size_t track = mask.size();
+		mask.resize(track + size);
+		trackEncodings.resize(track + size, encoding);
+		file.read(reinterpret_cast<char*>(&mask[track]), size);
+
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			if (!mask[track + i] && frameCount > 0)
+			{
+				float transform[8];
+				FILE_READ_ARRAY(file, transform, 8);
+				for (uint32_t frame = 0; frame < frameCount; ++frame)
+				{
+					std::memcpy(&out[frame * frameSize + (track + i) * 8], transform, sizeof(transform));
+				}
+			}
+			else if (mask[track + i] && IsQuantized(encoding))
+			{
+				FILE_READ_ARRAY(file, &ranges[(track + i) * 6], 6);
+			}
+		}
+	}
+
+	uint8_t encoded[8 * sizeof(float)];
+
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		for (size_t i = 0; i < mask.size(); ++i)
+		{
+			if (!mask[i])
+			{
+				continue;
+			}
+
+			file.read(reinterpret_cast<char*>(encoded), GetEncodedSize(trackEncodings[i]));
+			float* dq = &out[frame * frameSize + i * 8];
+			DecodeTransform(encoded, trackEncodings[i], &ranges[i * 6], dq);
+
+			// Keep rotations in the same hemisphere as in the previous frame,
+			// so they can be interpolated
+			if (frame > 0 && trackEncodings[i] != BBMOD_TRACK_FLOAT
+				&& quaternion_dot(dq, dq - frameSize) < 0.0f)
+			{
+				for (uint32_t j = 0; j < 8; ++j)
+				{
+					dq[j] = -dq[j];
+				}
+			}
+		}
+	}
+
+	return file.good();
+}
+
+bool SAnimation::WriteFrameBlocks(std::ostream& index, std::ostream& blocks, uint8_t spaces) const
+{
+	std::vector<float> frames;
+	SampleFrames(spaces, frames);
+
+	uint32_t frameCount = GetFrameCount();
+	uint32_t frameSize = (uint32_t)GetFrameSize(spaces, Model->NodeCount, Model->BoneCount);
+	uint32_t blockCount = (frameCount + FrameBlockSize - 1) / FrameBlockSize;
+	uint32_t filter = CompressFrameBlocks ? BBMOD_FILTER_SHUFFLE_DELTA : BBMOD_FILTER_NONE;
+
+	std::vector<std::vector<uint8_t>> payloads(blockCount);
+	std::vector<uint8_t> codecs(blockCount, BBMOD_CODEC_STORE);
+
+	ParallelFor(blockCount, [&](size_t i) {
+		size_t start = i * FrameBlockSize * frameSize;
+		size_t end = std::min<size_t>((i + 1) * FrameBlockSize, frameCount) * frameSize;
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(&frames[start]);
+		size_t rawSize = (end - start) * sizeof(float);
+
+		std::vector<uint8_t>& payload = payloads[i];
+		payload.assign(data, data + rawSize);
+
+		if (!CompressFrameBlocks)
+		{
+			return;
+		}
+
+		FilterEncode(payload.data(), rawSize, filter);
+
+		std::vector<uint8_t> compressed;
+		LZCompress(payload.data(), rawSize, compressed);
+
+		if (compressed.size() < rawSize)
+		{
+			payload = std::move(compressed);
+			codecs[i] = BBMOD_CODEC_LZ;
+		}
+	});
+
+	FILE_WRITE_DATA(index, FrameBlockSize);
+	FILE_WRITE_DATA(index, frameSize);
+	FILE_WRITE_DATA(index, frameCount);
+	FILE_WRITE_DATA(index, filter);
+	FILE_WRITE_DATA(index, blockCount);
+
+	uint64_t offset = 0;
+
+	for (uint32_t i = 0; i < blockCount; ++i)
+	{
+		uint32_t storedSize = (uint32_t)payloads[i].size();
+		FILE_WRITE_DATA(index, offset);
+		FILE_WRITE_DATA(index, storedSize);
+		FILE_WRITE_DATA(index, codecs[i]);
+		offset += storedSize;
+
+		blocks.write(reinterpret_cast<const char*>(payloads[i].data()), storedSize);
+	}
+
+	return index.good() && blocks.good();
+}
+
+bool SAnimation::WriteWorldSpaceNodes(std::ostream& file) const
+{
+	uint32_t count = (uint32_t)WorldSpaceNodes.size();
+	FILE_WRITE_DATA(file, count);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		FILE_WRITE_DATA(file, WorldSpaceNodes[i]);
+		file.write(WorldSpaceNodeNames[i].c_str(), WorldSpaceNodeNames[i].size() + 1);
+	}
+
+	std::vector<float> frames;
+	SampleFrames(BBMOD_BONE_SPACE_WORLD, frames);
+
+	size_t frameSize = GetFrameSize(BBMOD_BONE_SPACE_WORLD, Model->NodeCount, Model->BoneCount);
+
+	for (uint32_t frame = 0; frame < GetFrameCount(); ++frame)
+	{
+		for (uint32_t nodeIndex : WorldSpaceNodes)
+		{
+			FILE_WRITE_ARRAY(file, &frames[frame * frameSize + nodeIndex * 8], 8);
+		}
+	}
+
+	return file.good();
+}
+
+bool SAnimation::WriteBounds(std::ostream& file)
+{
+	uint32_t frameCount = GetFrameCount();
+	uint32_t nodeCount = Model->NodeCount;
+	uint32_t boneCount = Model->BoneCount;
+
+	std::vector<SNode*> nodes(nodeCount, nullptr);
+	CollectNodesByIndex(Model->RootNode, nodes);
+
+	// Vertices of skinned meshes are transformed by bones, vertices of other
+	// meshes by world transforms of nodes they are attached to. Data are
+	// flattened into arrays to keep the loop over vertices tight.
+	std::vector<float> positions;
+	std::vector<uint32_t> bones;
+	std::vector<float> weights;
+	std::vector<float> rigidPositions;
+	std::vector<uint32_t> rigidNodes;
+	std::vector<bool> skinned(Model->Meshes.size(), false);
+
+	for (SNode* node : nodes)
+	{
+		if (!node)
+		{
+			continue;
+		}
+
+		for (uint32_t meshIndex : node->Meshes)
+		{
+			SMesh* mesh = Model->Meshes[meshIndex];
+
+			if (mesh->VertexFormat->Bones && boneCount > 0)
+			{
+				if (skinned[meshIndex])
+				{
+					continue;
+				}
+				skinned[meshIndex] = true;
+
+				for (SVertex* vertex : mesh->Data)
+				{
+					positions.insert(positions.end(), vertex->Position, vertex->Position + 3);
+					for (int i = 0; i < 4; ++i)
+					{
+						bones.push_back(std::min<uint32_t>((uint32_t)vertex->Bones[i], boneCount - 1));
+						weights.push_back(vertex->Weights[i]);
+					}
+				}
+			}
+			else
+			{
+				for (SVertex* vertex : mesh->Data)
+				{
+					rigidPositions.insert(rigidPositions.end(), vertex->Position, vertex->Position + 3);
+					rigidNodes.push_back((uint32_t)node->Index);
+				}
+			}
+		}
+	}
+
+	size_t skinnedCount = weights.size() / 4;
+	size_t rigidCount = rigidNodes.size();
+
+	std::vector<float> boxes((size_t)frameCount * 6, 0.0f);
+	std::vector<SAnimationNode*> nodeMap = GetNodeMap();
+
+	ParallelFor(frameCount, [&](size_t frame) {
+		std::vector<float> frameWorld((size_t)nodeCount * 8);
+		std::vector<float> frameBone((size_t)boneCount * 8);
+		SampleFrame(nodeMap, (double)frame, nullptr, frameWorld.data(), frameBone.data());
+
+		float boxMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float boxMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		float v[3];
+
+		for (size_t i = 0; i < skinnedCount; ++i)
+		{
+			// Blend like in the vertex shader, see Transform.xsh
+			dual_quat_t blend;
+
+			if (dual_quaternion_blend(frameBone.data(), &bones[i * 4], &weights[i * 4], blend))
+			{
+				dual_quaternion_transform_point(blend, &positions[i * 3], v);
+			}
+			else
+			{
+				std::memcpy(v, &positions[i * 3], sizeof(v));
+			}
+
+			for (int k = 0; k < 3; ++k)
+			{
+				boxMin[k] = std::min(boxMin[k], v[k]);
+				boxMax[k] = std::max(boxMax[k], v[k]);
+			}
+		}
+
+		for (size_t i = 0; i < rigidCount; ++i)
+		{
+			dual_quaternion_transform_point(&frameWorld[rigidNodes[i] * 8], &rigidPositions[i * 3], v);
+
+			for (int k = 0; k < 3; ++k)
+			{
+				boxMin[k] = std::min(boxMin[k], v[k]);
+				boxMax[k] = std::max(boxMax[k], v[k]);
+			}
+		}
+
+		if (skinnedCount + rigidCount > 0)
+		{
+			std::memcpy(&boxes[frame * 6], boxMin, sizeof(boxMin));
+			std::memcpy(&boxes[frame * 6 + 3], boxMax, sizeof(boxMax));
+		}
+	});
+
+	float boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+	float boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			boundsMin[k] = (frame == 0) ? boxes[k] : std::min(boundsMin[k], boxes[frame * 6 + k]);
+			boundsMax[k] = (frame == 0) ? boxes[3 + k] : std::max(boundsMax[k], boxes[frame * 6 + 3 + k]);
+		}
+	}
+
+	FILE_WRITE_DATA(file, frameCount);
+	FILE_WRITE_ARRAY(file, boundsMin, 3);
+	FILE_WRITE_ARRAY(file, boundsMax, 3);
+
+	FrameBounds.resize(boxes.size());
+
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		uint16_t quantized[6];
+
+		for (int k = 0; k < 6; ++k)
+		{
+			int axis = k % 3;
+			float range = boundsMax[axis] - boundsMin[axis];
+			float t = (range > 0.0f) ? (boxes[frame * 6 + k] - boundsMin[axis]) / range * 65535.0f : 0.0f;
+			t = (k < 3) ? floorf(t) : ceilf(t);
+			quantized[k] = (uint16_t)std::min(std::max(t, 0.0f), 65535.0f);
+			FrameBounds[frame * 6 + k] = boundsMin[axis] + (float)quantized[k] / 65535.0f * range;
+		}
+
+		FILE_WRITE_ARRAY(file, quantized, 6);
+	}
+
+	return file.good();
+}
+
+bool SAnimation::ReadBounds(std::istream& file, std::vector<float>& out)
+{
+	uint32_t frameCount;
+	float boundsMin[3];
+	float boundsMax[3];
+
+	FILE_READ_DATA(file, frameCount);
+	FILE_READ_ARRAY(file, boundsMin, 3);
+	FILE_READ_ARRAY(file, boundsMax, 3);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	std::vector<uint16_t> quantized((size_t)frameCount * 6);
+	FILE_READ_ARRAY(file, quantized.data(), quantized.size());
+
+	out.resize(quantized.size());
+
+	for (size_t i = 0; i < quantized.size(); ++i)
+	{
+		int axis = i % 3;
+		float range = boundsMax[axis] - boundsMin[axis];
+		out[i] = boundsMin[axis] + (float)quantized[i] / 65535.0f * range;
+	}
+
+	return file.good();
+}
+
+bool SAnimation::WriteMorphTracks(std::ostream& file) const
+{
+	uint32_t trackCount = (uint32_t)MorphTracks.size();
+	uint32_t frameCount = GetFrameCount();
+	FILE_WRITE_DATA(file, trackCount);
+	FILE_WRITE_DATA(file, frameCount);
+
+	for (const SMorphTrack& track : MorphTracks)
+	{
+		float weightMin = *std::min_element(track.Weights.begin(), track.Weights.end());
+		float weightMax = *std::max_element(track.Weights.begin(), track.Weights.end());
+
+		FILE_WRITE_DATA(file, track.MeshIndex);
+		FILE_WRITE_DATA(file, track.TargetIndex);
+		FILE_WRITE_DATA(file, weightMin);
+		FILE_WRITE_DATA(file, weightMax);
+
+		std::vector<uint16_t> quantized(frameCount, 0);
+		for (uint32_t frame = 0; frame < frameCount && frame < track.Weights.size(); ++frame)
+		{
+			quantized[frame] = QuantizeRange16(track.Weights[frame], weightMin, weightMax);
+		}
+		FILE_WRITE_ARRAY(file, quantized.data(), quantized.size());
+	}
+
+	return file.good();
+}
+
+bool SAnimation::ReadMorphTracks(std::istream& file, std::vector<SMorphTrack>& out)
+{
+	uint32_t trackCount;
+	uint32_t frameCount;
+	FILE_READ_DATA(file, trackCount);
+	FILE_READ_DATA(file, frameCount);
+
+	out.clear();
+
+	std::vector<uint16_t> quantized(frameCount);
+
+	for (uint32_t i = 0; i < trackCount && file.good(); ++i)
+	{
+		SMorphTrack track;
+		float weightMin;
+		float weightMax;
+		FILE_READ_DATA(file, track.MeshIndex);
+		FILE_READ_DATA(file, track.TargetIndex);
+		FILE_READ_DATA(file, weightMin);
+		FILE_READ_DATA(file, weightMax);
+		FILE_READ_ARRAY(file, quantized.data(), quantized.size());
+
+		track.Weights.resize(frameCount);
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			track.Weights[frame] = DequantizeRange16(quantized[frame], weightMin, weightMax);
+		}
+
+		out.push_back(std::move(track));
+	}
+
+	return file.good();
+}
+
+bool SAnimation::ReadWorldSpaceNodes(std::istream& file)
+{
+	uint32_t count;
+	FILE_READ_DATA(file, count);
+
+	WorldSpaceNodes.resize(count);
+	WorldSpaceNodeNames.resize(count);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		FILE_READ_DATA(file, WorldSpaceNodes[i]);
+		std::getline(file, WorldSpaceNodeNames[i], '\0');
+	}
+
+	return file.good();
+}
+
+bool SAnimation::WriteLod(std::ostream& file, uint8_t spaces, uint32_t divisor, SAnimationLod& lod) const
+{
+	uint32_t frameCount = GetFrameCount();
+	uint32_t lastFrame = (frameCount > 0) ? frameCount - 1 : 0;
+
+	lod.Divisor = divisor;
+	lod.FrameCount = (lastFrame + divisor - 1) / divisor + 1;
+	lod.MaxError = 0.0f;
+
+	// An animation with keys only at frames of the LOD, which is then
+	// interpolated the same way as at runtime
+	SAnimation tier;
+	tier.Model = Model;
+	tier.Duration = Duration;
+
+	for (SAnimationNode* animationNode : AnimationNodes)
+	{
+		SAnimationNode* tierNode = new SAnimationNode();
+		tierNode->Index = animationNode->Index;
+
+		for (uint32_t i = 0; i < lod.FrameCount; ++i)
+		{
+			SDualQuatKey* key = new SDualQuatKey();
+			key->Time = (double)std::min(i * divisor, lastFrame);
+			animationNode->Sample(key->Time, key->DualQuat);
+			tierNode->DualQuatKeys.push_back(key);
+		}
+
+		tier.AnimationNodes.push_back(tierNode);
+	}
+
+	std::vector<SAnimationNode*> nodeMap = GetNodeMap();
+	std::vector<SAnimationNode*> tierNodeMap = tier.GetNodeMap();
+	size_t nodeSize = (size_t)Model->NodeCount * 8;
+	std::vector<float> errors(frameCount, 0.0f);
+
+	ParallelFor(frameCount, [&](size_t frame) {
+		std::vector<float> full(nodeSize);
+		std::vector<float> reduced(nodeSize);
+		SampleFrame(nodeMap, (double)frame, nullptr, full.data(), nullptr);
+		tier.SampleFrame(tierNodeMap, (double)frame, nullptr, reduced.data(), nullptr);
+
+		for (size_t i = 0; i < nodeSize; i += 8)
+		{
+			vec3_t a;
+			vec3_t b;
+			dual_quaternion_get_translation(&full[i], a);
+			dual_quaternion_get_translation(&reduced[i], b);
+			float dx = a[0] - b[0];
+			float dy = a[1] - b[1];
+			float dz = a[2] - b[2];
+			errors[frame] = std::max(errors[frame], sqrtf(dx * dx + dy * dy + dz * dz));
+		}
+	});
+
+	for (float error : errors)
+	{
+		lod.MaxError = std::max(lod.MaxError, error);
+	}
+
+	FILE_WRITE_DATA(file, lod.Divisor);
+	FILE_WRITE_DATA(file, lod.MaxError);
+	FILE_WRITE_DATA(file, lod.FrameCount);
+
+	uint32_t nodeCount = Model->NodeCount;
+	uint32_t boneCount = Model->BoneCount;
+	std::vector<float> frameParent(nodeSize);
+	std::vector<float> frameWorld(nodeSize);
+	std::vector<float> frameBone((size_t)boneCount * 8);
+
+	for (uint32_t i = 0; i < lod.FrameCount; ++i)
+	{
+		double frame = (double)std::min(i * divisor, lastFrame);
+		SampleFrame(nodeMap, frame, frameParent.data(), frameWorld.data(), frameBone.data());
+
+		if (spaces & BBMOD_BONE_SPACE_PARENT)
+		{
+			FILE_WRITE_ARRAY(file, frameParent.data(), (size_t)nodeCount * 8);
+		}
+
+		if (spaces & BBMOD_BONE_SPACE_WORLD)
+		{
+			FILE_WRITE_ARRAY(file, frameWorld.data(), (size_t)nodeCount * 8);
+		}
+
+		if (spaces & BBMOD_BONE_SPACE_BONE)
+		{
+			FILE_WRITE_ARRAY(file, frameBone.data(), (size_t)boneCount * 8);
+		}
+	}
+
+	return file.good();
+}
+
+bool SAnimation::Save(std::ostream& file, const SConfig& config)
+{
+	uint64_t fileStart = (uint64_t)file.tellp();
+
+	file.write("BBANIM", sizeof(char) * 7);
+	FILE_WRITE_DATA(file, VersionMajor);
+	FILE_WRITE_DATA(file, VersionMinor);
+	unsigned char spaces = GetSpaces(config);
+
+	if (VersionMinor >= BBMOD_VERSION_MINOR_TOC)
+	{
+		return SaveSections(file, fileStart, spaces);
+	}
+
+	FILE_WRITE_DATA(file, spaces);
+	FILE_WRITE_DATA(file, Duration);
+	FILE_WRITE_DATA(file, TicsPerSecond);
+
+	uint32_t modelNodeCount = Model->NodeCount;
+	FILE_WRITE_DATA(file, modelNodeCount);
+
+	uint32_t modelBoneCount = Model->BoneCount;
+	FILE_WRITE_DATA(file, modelBoneCount);
+
+	if (!WriteFrames(file, spaces))
+	{
+		return false;
+	}
+
+	uint32_t eventCount = 0;
+	FILE_WRITE_DATA(file, eventCount);
+
+	return file.good();
+}
+
+bool SAnimation::SaveSections(std::ostream& file, uint64_t fileStart, uint8_t spaces)
+{
+	STableOfContents toc;
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_DATA(stream, spaces);
+		FILE_WRITE_DATA(stream, Duration);
+		FILE_WRITE_DATA(stream, TicsPerSecond);
+		uint32_t modelNodeCount = Model->NodeCount;
+		FILE_WRITE_DATA(stream, modelNodeCount);
+		uint32_t modelBoneCount = Model->BoneCount;
+		FILE_WRITE_DATA(stream, modelBoneCount);
+		toc.Add(BBMOD_SECTION_INFO, 0, stream.str());
+	}
+
+	if (!AddClipSections(toc, spaces))
+	{
+		return false;
+	}
+
+	if (Model->SkeletonHash != 0)
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_DATA(stream, Model->SkeletonHash);
+		FILE_WRITE_DATA(stream, Model->BoneCount);
+		stream.write(Model->SkeletonName.c_str(), Model->SkeletonName.size() + 1);
+		toc.Add(BBMOD_SECTION_SKELETON_REFERENCE, 0, stream.str());
+	}
+
+	return toc.Save(file, fileStart);
+}
+
+bool SAnimation::SaveClip(std::ostream& file, const SConfig& config)
+{
+	uint64_t fileStart = (uint64_t)file.tellp();
+	STableOfContents toc;
+	return AddClipSections(toc, GetSpaces(config))
+		&& toc.Save(file, fileStart);
+}
+
+bool SAnimation::AddClipSections(STableOfContents& toc, uint8_t spaces)
+{
+	uint8_t frameSpaces = spaces;
+
+	if (IsReduced && (spaces & BBMOD_BONE_SPACE_PARENT))
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!WriteKeys(stream))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_KEYS, 0, stream.str());
+		frameSpaces &= ~BBMOD_BONE_SPACE_PARENT;
+	}
+
+	if (frameSpaces != 0 && FrameBlockSize > 0)
+	{
+		std::ostringstream index(std::ios::out | std::ios::binary);
+		std::ostringstream blocks(std::ios::out | std::ios::binary);
+		if (!WriteFrameBlocks(index, blocks, frameSpaces))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_FRAME_INDEX, 0, index.str());
+		toc.Add(BBMOD_SECTION_FRAME_BLOCKS, 0, blocks.str());
+	}
+	else if (frameSpaces != 0 && (Quantization != BBMOD_QUANTIZE_NONE || HalfFloatFrames))
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!WriteQuantizedTracks(stream, frameSpaces))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_QUANTIZED, 0, stream.str());
+	}
+	else if (frameSpaces != 0 && EliminateConstantTracks)
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!WriteTracks(stream, frameSpaces))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_TRACKS, 0, stream.str());
+	}
+	else if (frameSpaces != 0)
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!WriteFrames(stream, frameSpaces))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_FRAMES, 0, stream.str());
+	}
+
+	Lods.clear();
+
+	uint32_t frameCount = GetFrameCount();
+	uint32_t lastFrame = (frameCount > 0) ? frameCount - 1 : 0;
+
+	for (uint32_t i = 0; i < LodTiers; ++i)
+	{
+		// Tiers with a divisor past the last frame would only hold the first
+		// and the last frame again (and 2u << 31 overflows to 0)
+		if (i >= 31 || (2u << i) > lastFrame)
+		{
+			break;
+		}
+		uint32_t divisor = 2u << i;
+
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		SAnimationLod lod;
+		if (!WriteLod(stream, spaces, divisor, lod))
+		{
+			return false;
+		}
+		Lods.push_back(lod);
+		toc.Add(BBMOD_SECTION_LOD, i, stream.str());
+	}
+
+	if (!WorldSpaceNodes.empty())
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!WriteWorldSpaceNodes(stream))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_WORLD_SPACE_NODES, 0, stream.str());
+	}
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		uint32_t eventCount = 0;
+		FILE_WRITE_DATA(stream, eventCount);
+		toc.Add(BBMOD_SECTION_EVENTS, 0, stream.str());
+	}
+
+	if (AnimatedBounds)
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!WriteBounds(stream))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_BOUNDS, 0, stream.str());
+	}
+
+	if (!MorphTracks.empty())
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!WriteMorphTracks(stream))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_MORPH_WEIGHTS, 0, stream.str());
+	}
+
+	return true;
+}
+
+bool SAnimation::WriteKeys(std::ostream& file) const
+{
+	std::vector<SNode*> nodes(Model->NodeCount, nullptr);
+	CollectNodesByIndex(Model->RootNode, nodes);
+
+	std::vector<SAnimationNode*> nodeMap = GetNodeMap();
+
+	for (uint32_t i = 0; i < Model->NodeCount; ++i)
+	{
+		SAnimationNode* animationNode = nodeMap[i];
+
+		if (animationNode)
+		{
+			uint32_t keyCount = (uint32_t)animationNode->DualQuatKeys.size();
+			FILE_WRITE_DATA(file, keyCount);
+
+			for (SDualQuatKey* key : animationNode->DualQuatKeys)
+			{
+				uint32_t frame = (uint32_t)key->Time;
+				FILE_WRITE_DATA(file, frame);
+				FILE_WRITE_DUAL_QUAT(file, key->DualQuat);
+			}
+		}
+		else
+		{
+			// A static node, stored once
+			dual_quat_t transform = DUAL_QUATERNION_IDENTITY;
+			if (nodes[i])
+			{
+				dual_quaternion_copy(nodes[i]->Transform, transform);
+			}
+
+			uint32_t keyCount = 1;
+			FILE_WRITE_DATA(file, keyCount);
+			uint32_t frame = 0;
+			FILE_WRITE_DATA(file, frame);
+			FILE_WRITE_DUAL_QUAT(file, transform);
+		}
+	}
+
+	return file.good();
+}
+
+SAnimation* SAnimation::Load(std::string path)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+
+	if (!file.is_open())
+	{
+		return nullptr;
+	}
+
+	if (IsContainer(file))
+	{
+		SContainerReader reader;
+
+		if (!reader.Open(file))
+		{
+			return nullptr;
+		}
+
+		SContainerStreamBuf buffer(reader);
+		std::istream stream(&buffer);
+		return Load(stream);
+	}
+
+	return Load(file);
+}
+
+SAnimation* SAnimation::Load(std::istream& file)
+{
+	uint64_t fileStart = (uint64_t)file.tellg();
+
+	char header[7];
+	file.read(header, 7);
+
+	if (std::strcmp(header, "BBANIM") != 0)
+	{
+		return nullptr;
+	}
+
+	uint8_t versionMajor;
+	FILE_READ_DATA(file, versionMajor);
+
+	if (versionMajor != BBMOD_VERSION_MAJOR)
+	{
+		return nullptr;
+	}
+
+	uint8_t versionMinor;
+	FILE_READ_DATA(file, versionMinor);
+
+	if (versionMinor != BBMOD_VERSION_MINOR
+		&& versionMinor != BBMOD_VERSION_MINOR_TOC)
+	{
+		return nullptr;
+	}
+
+	SAnimation* animation = new SAnimation();
+	animation->VersionMajor = versionMajor;
+	animation->VersionMinor = versionMinor;
+
+	if (versionMinor >= BBMOD_VERSION_MINOR_TOC)
+	{
+		if (!animation->LoadSections(file, fileStart))
+		{
+			return nullptr;
+		}
+		return animation;
+	}
+
+	FILE_READ_DATA(file, animation->Spaces);
+	FILE_READ_DATA(file, animation->Duration);
+	FILE_READ_DATA(file, animation->TicsPerSecond);
+	FILE_READ_DATA(file, animation->ModelNodeCount);
+	FILE_READ_DATA(file, animation->ModelBoneCount);
+
+	if (!animation->ReadFrames(file, animation->Spaces))
+	{
+		return nullptr;
+	}
+
+	return animation;
+}
+
+bool SAnimation::LoadSections(std::istream& file, uint64_t fileStart)
+{
+	STableOfContents toc;
+
+	if (!toc.Load(file, fileStart)
+		|| !toc.Seek(file, BBMOD_SECTION_INFO))
+	{
+		return false;
+	}
+
+	FILE_READ_DATA(file, Spaces);
+	FILE_READ_DATA(file, Duration);
+	FILE_READ_DATA(file, TicsPerSecond);
+	FILE_READ_DATA(file, ModelNodeCount);
+	FILE_READ_DATA(file, ModelBoneCount);
+
+	if (!file || !LoadClipSections(file, toc))
+	{
+		return false;
+	}
+
+	if (toc.Seek(file, BBMOD_SECTION_SKELETON_REFERENCE))
+	{
+		uint32_t boneCount;
+		FILE_READ_DATA(file, SkeletonHash);
+		FILE_READ_DATA(file, boneCount);
+		std::getline(file, SkeletonName, '\0');
+	}
+
+	return file.good();
+}
+
+bool SAnimation::LoadClip(std::istream& file)
+{
+	STableOfContents toc;
+	return toc.Load(file, (uint64_t)file.tellg())
+		&& LoadClipSections(file, toc);
+}
+
+bool SAnimation::LoadClipSections(std::istream& file, const STableOfContents& toc)
+{
+	uint8_t frameSpaces = Spaces;
+
+	if (toc.Seek(file, BBMOD_SECTION_KEYS))
+	{
+		for (uint32_t i = 0; i < ModelNodeCount; ++i)
+		{
+			SAnimationNode* animationNode = new SAnimationNode();
+			animationNode->Index = (float)i;
+
+			uint32_t keyCount;
+			FILE_READ_DATA(file, keyCount);
+
+			for (uint32_t j = 0; j < keyCount; ++j)
+			{
+				SDualQuatKey* key = new SDualQuatKey();
+				uint32_t frame;
+				FILE_READ_DATA(file, frame);
+				key->Time = (double)frame;
+				FILE_READ_DUAL_QUAT(file, key->DualQuat);
+				animationNode->DualQuatKeys.push_back(key);
+			}
+
+			AnimationNodes.push_back(animationNode);
+		}
+
+		IsReduced = true;
+		frameSpaces &= ~BBMOD_BONE_SPACE_PARENT;
+	}
+
+	if (frameSpaces != 0 && toc.Find(BBMOD_SECTION_FRAME_INDEX))
+	{
+		SAnimationStream stream;
+		stream.Spaces = Spaces;
+		stream.Duration = Duration;
+		stream.TicsPerSecond = TicsPerSecond;
+		stream.ModelNodeCount = ModelNodeCount;
+		stream.ModelBoneCount = ModelBoneCount;
+		std::vector<float> frames;
+		if (!stream.Open(file, toc) || !stream.ReadFrames(0, stream.FrameCount, frames))
+		{
+			return false;
+		}
+		FrameBlockSize = stream.BlockFrames;
+		SetFrames(frames, frameSpaces);
+	}
+	else if (frameSpaces != 0 && toc.Seek(file, BBMOD_SECTION_QUANTIZED))
+	{
+		std::vector<float> frames;
+		if (!ReadQuantizedTracks(file, frameSpaces, ModelNodeCount, ModelBoneCount, GetFrameCount(), frames))
+		{
+			return false;
+		}
+		SetFrames(frames, frameSpaces);
+	}
+	else if (frameSpaces != 0 && toc.Seek(file, BBMOD_SECTION_TRACKS))
+	{
+		std::vector<float> frames;
+		if (!ReadTracks(file, frameSpaces, ModelNodeCount, ModelBoneCount, GetFrameCount(), frames))
+		{
+			return false;
+		}
+		EliminateConstantTracks = true;
+		SetFrames(frames, frameSpaces);
+	}
+	else if (frameSpaces != 0)
+	{
+		if (!toc.Seek(file, BBMOD_SECTION_FRAMES)
+			|| !ReadFrames(file, frameSpaces))
+		{
+			return false;
+		}
+	}
+
+	if (toc.Seek(file, BBMOD_SECTION_WORLD_SPACE_NODES)
+		&& !ReadWorldSpaceNodes(file))
+	{
+		return false;
+	}
+
+	Lods.clear();
+
+	for (uint32_t i = 0; toc.Seek(file, BBMOD_SECTION_LOD, i); ++i)
+	{
+		SAnimationLod lod;
+		FILE_READ_DATA(file, lod.Divisor);
+		FILE_READ_DATA(file, lod.MaxError);
+		FILE_READ_DATA(file, lod.FrameCount);
+		Lods.push_back(lod);
+	}
+
+	LodTiers = (uint32_t)Lods.size();
+
+	FrameBounds.clear();
+	AnimatedBounds = toc.Seek(file, BBMOD_SECTION_BOUNDS);
+
+	if (AnimatedBounds && !ReadBounds(file, FrameBounds))
+	{
+		return false;
+	}
+
+	MorphTracks.clear();
+
+	if (toc.Seek(file, BBMOD_SECTION_MORPH_WEIGHTS)
+		&& !ReadMorphTracks(file, MorphTracks))
+	{
+		return false;
+	}
+
+	return file.good();
+}
+
+bool SAnimation::ReadFrames(std::istream& file, uint8_t spaces)
+{
+	std::vector<float> frames(GetFrameSize(spaces, ModelNodeCount, ModelBoneCount) * GetFrameCount());
+	FILE_READ_ARRAY(file, frames.data(), frames.size());
+
+	if (!file)
+	{
+		return false;
+	}
+
+	SetFrames(frames, spaces);
+
+	return true;
+}
+
+void SAnimation::SetFrames(const std::vector<float>& frames, uint8_t spaces)
+{
+	if (!(spaces & BBMOD_BONE_SPACE_PARENT))
+	{
+		// Transforms in parent space cannot be restored
+		return;
+	}
+
+	size_t frameSize = GetFrameSize(spaces, ModelNodeCount, ModelBoneCount);
+
+	for (uint32_t i = 0; i < ModelNodeCount; ++i)
+	{
+		SAnimationNode* animationNode = new SAnimationNode();
+		animationNode->Index = (float)i;
+
+		for (uint32_t frame = 0; frame < GetFrameCount(); ++frame)
+		{
+			SDualQuatKey* key = new SDualQuatKey();
+			key->Time = (double)frame;
+			dual_quaternion_copy(&frames[frame * frameSize + i * 8], key->DualQuat);
+			animationNode->DualQuatKeys.push_back(key);
+		}
+
+		AnimationNodes.push_back(animationNode);
+	}
 }
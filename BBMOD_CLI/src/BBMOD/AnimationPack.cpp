@@ -0,0 +1,338 @@
+#include <BBMOD/AnimationPack.hpp>
+#include <BBMOD/Compression.hpp>
+#include <BBMOD/Config.hpp>
+#include <BBMOD/Model.hpp>
+#include <utils.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+static void CollectNodeNames(SNode* node, std::vector<std::string>& names)
+{
+	if ((uint32_t)node->Index < names.size())
+	{
+		names[(uint32_t)node->Index] = node->Name;
+	}
+	for (SNode* child : node->Children)
+	{
+		CollectNodeNames(child, names);
+	}
+}
+
+/** Returns names of nodes followed by names of bones of a model, both in the
+ * order of their indices. */
+static std::vector<std::string> GetRigNames(SModel* model)
+{
+	std::vector<std::string> names(model->NodeCount + model->BoneCount);
+	if (model->RootNode)
+	{
+		CollectNodeNames(model->RootNode, names);
+	}
+	for (SBone* bone : model->Skeleton)
+	{
+		if (bone && (uint32_t)bone->Index < model->BoneCount)
+		{
+			names[model->NodeCount + (uint32_t)bone->Index] = bone->Name;
+		}
+	}
+	return names;
+}
+
+bool SAnimationPack::Add(SAnimation* animation, const std::string& name, const SConfig& config, std::string& error)
+{
+	if (!animation->Model)
+	{
+		error = "The animation does not have a model.";
+		return false;
+	}
+
+	if (Find(name) != -1)
+	{
+		error = "A clip with the same name is already in the pack.";
+		return false;
+	}
+
+	SModel* model = animation->Model;
+	uint8_t spaces = SAnimation::GetSpaces(config);
+	std::vector<std::string> rigNames = GetRigNames(model);
+
+	if (Entries.empty())
+	{
+		Spaces = spaces;
+		ModelNodeCount = model->NodeCount;
+		ModelBoneCount = model->BoneCount;
+		SkeletonHash = model->SkeletonHash;
+		SkeletonName = model->SkeletonName;
+		RigNames = rigNames;
+	}
+	else if (spaces != Spaces
+		|| model->NodeCount != ModelNodeCount
+		|| model->BoneCount != ModelBoneCount
+		|| model->SkeletonHash != SkeletonHash)
+	{
+		error = "It does not have the same node count, bone count or skeleton as other clips in the pack.";
+		return false;
+	}
+	else if (rigNames != RigNames)
+	{
+		// Clips are indexed by node and bone, so rigs must match name by name
+		// even when they are not bound to a shared skeleton
+		error = "Its nodes or bones have different names or order than in other clips in the pack.";
+		return false;
+	}
+
+	std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+
+	if (!animation->SaveClip(stream, config))
+	{
+		error = "Failed to serialize the clip.";
+		return false;
+	}
+
+	std::string data = stream.str();
+
+	if (config.Compress)
+	{
+		std::stringstream container(std::ios::in | std::ios::out | std::ios::binary);
+
+		if (!WriteContainer(container, reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+			config.CompressionChunkSize, config.CompressionFilter))
+		{
+			error = "Failed to compress the clip.";
+			return false;
+		}
+
+		data = container.str();
+	}
+
+	SAnimationPackEntry entry;
+	entry.Name = name;
+	entry.Clip = (uint32_t)Clips.size();
+	entry.Duration = animation->Duration;
+	entry.TicsPerSecond = animation->TicsPerSecond;
+	entry.Compressed = config.Compress;
+
+	// Keep entries sorted, so they can be found with a binary search
+	auto it = std::lower_bound(Entries.begin(), Entries.end(), name,
+		[](const SAnimationPackEntry& e, const std::string& n) { return e.Name < n; });
+	Entries.insert(it, entry);
+
+	Clips.push_back(std::move(data));
+
+	return true;
+}
+
+bool SAnimationPack::Save(std::string path)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary);
+
+	if (!file.is_open() || !Save(file))
+	{
+		return false;
+	}
+
+	file.flush();
+	file.close();
+
+	return true;
+}
+
+bool SAnimationPack::Save(std::ostream& file)
+{
+	uint64_t fileStart = (uint64_t)file.tellp();
+
+	file.write("BBPACK", sizeof(char) * 7);
+	FILE_WRITE_DATA(file, VersionMajor);
+	FILE_WRITE_DATA(file, VersionMinor);
+
+	TableOfContents = STableOfContents();
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_DATA(stream, Spaces);
+		FILE_WRITE_DATA(stream, ModelNodeCount);
+		FILE_WRITE_DATA(stream, ModelBoneCount);
+		FILE_WRITE_DATA(stream, SkeletonHash);
+		stream.write(SkeletonName.c_str(), SkeletonName.size() + 1);
+		TableOfContents.Add(BBMOD_SECTION_PACK_HEADER, 0, stream.str());
+	}
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		uint32_t entryCount = (uint32_t)Entries.size();
+		FILE_WRITE_DATA(stream, entryCount);
+
+		for (const SAnimationPackEntry& entry : Entries)
+		{
+			stream.write(entry.Name.c_str(), entry.Name.size() + 1);
+			FILE_WRITE_DATA(stream, entry.Clip);
+			FILE_WRITE_DATA(stream, entry.Duration);
+			FILE_WRITE_DATA(stream, entry.TicsPerSecond);
+			uint8_t compressed = entry.Compressed ? 1 : 0;
+			FILE_WRITE_DATA(stream, compressed);
+		}
+
+		TableOfContents.Add(BBMOD_SECTION_PACK_DIRECTORY, 0, stream.str());
+	}
+
+	for (uint32_t i = 0; i < Clips.size(); ++i)
+	{
+		TableOfContents.Add(BBMOD_SECTION_CLIP, i, Clips[i]);
+	}
+
+	return TableOfContents.Save(file, fileStart);
+}
+
+bool SAnimationPack::Open(std::istream& file)
+{
+	uint64_t fileStart = (uint64_t)file.tellg();
+
+	char header[7];
+	file.read(header, 7);
+	FILE_READ_DATA(file, VersionMajor);
+	FILE_READ_DATA(file, VersionMinor);
+
+	if (!file
+		|| std::strcmp(header, "BBPACK") != 0
+		|| VersionMajor != BBMOD_VERSION_MAJOR
+		|| VersionMinor != BBMOD_VERSION_MINOR_TOC)
+	{
+		return false;
+	}
+
+	if (!TableOfContents.Load(file, fileStart)
+		|| !TableOfContents.Seek(file, BBMOD_SECTION_PACK_HEADER))
+	{
+		return false;
+	}
+
+	FILE_READ_DATA(file, Spaces);
+	FILE_READ_DATA(file, ModelNodeCount);
+	FILE_READ_DATA(file, ModelBoneCount);
+	FILE_READ_DATA(file, SkeletonHash);
+	std::getline(file, SkeletonName, '\0');
+
+	if (!file || !TableOfContents.Seek(file, BBMOD_SECTION_PACK_DIRECTORY))
+	{
+		return false;
+	}
+
+	uint32_t entryCount;
+	FILE_READ_DATA(file, entryCount);
+
+	Entries.clear();
+	Clips.clear();
+
+	for (uint32_t i = 0; i < entryCount && file; ++i)
+	{
+		SAnimationPackEntry entry;
+		std::getline(file, entry.Name, '\0');
+		FILE_READ_DATA(file, entry.Clip);
+		FILE_READ_DATA(file, entry.Duration);
+		FILE_READ_DATA(file, entry.TicsPerSecond);
+		uint8_t compressed;
+		FILE_READ_DATA(file, compressed);
+		entry.Compressed = (compressed != 0);
+		Entries.push_back(entry);
+	}
+
+	if (!file)
+	{
+		return false;
+	}
+
+	// Lookups rely on the directory being sorted
+	std::sort(Entries.begin(), Entries.end(),
+		[](const SAnimationPackEntry& a, const SAnimationPackEntry& b) { return a.Name < b.Name; });
+
+	return true;
+}
+
+int32_t SAnimationPack::Find(const std::string& name) const
+{
+	auto it = std::lower_bound(Entries.begin(), Entries.end(), name,
+		[](const SAnimationPackEntry& e, const std::string& n) { return e.Name < n; });
+
+	if (it == Entries.end() || it->Name != name)
+	{
+		return -1;
+	}
+
+	return (int32_t)(it - Entries.begin());
+}
+
+const SSection* SAnimationPack::GetClipSection(uint32_t entry) const
+{
+	if (entry >= Entries.size())
+	{
+		return nullptr;
+	}
+	return TableOfContents.Find(BBMOD_SECTION_CLIP, Entries[entry].Clip);
+}
+
+SAnimation* SAnimationPack::LoadClip(std::istream& file, uint32_t entry) const
+{
+	if (entry >= Entries.size()
+		|| !TableOfContents.Seek(file, BBMOD_SECTION_CLIP, Entries[entry].Clip))
+	{
+		return nullptr;
+	}
+
+	std::unique_ptr<SAnimation> animation = std::make_unique<SAnimation>();
+	animation->VersionMinor = BBMOD_VERSION_MINOR_TOC;
+	animation->Name = Entries[entry].Name;
+	animation->Spaces = Spaces;
+	animation->Duration = Entries[entry].Duration;
+	animation->TicsPerSecond = Entries[entry].TicsPerSecond;
+	animation->ModelNodeCount = ModelNodeCount;
+	animation->ModelBoneCount = ModelBoneCount;
+	animation->SkeletonHash = SkeletonHash;
+	animation->SkeletonName = SkeletonName;
+
+	if (Entries[entry].Compressed)
+	{
+		SContainerReader reader;
+
+		if (!reader.Open(file))
+		{
+			return nullptr;
+		}
+
+		SContainerStreamBuf buffer(reader);
+		std::istream stream(&buffer);
+		if (!animation->LoadClip(stream))
+		{
+			return nullptr;
+		}
+	}
+	else if (!animation->LoadClip(file))
+	{
+		return nullptr;
+	}
+
+	return animation.release();
+}
+
+bool SAnimationPack::OpenClip(std::istream& file, uint32_t entry, SAnimationStream& out) const
+{
+	STableOfContents toc;
+
+	if (entry >= Entries.size()
+		|| Entries[entry].Compressed
+		|| !TableOfContents.Seek(file, BBMOD_SECTION_CLIP, Entries[entry].Clip)
+		|| !toc.Load(file, (uint64_t)file.tellg()))
+	{
+		return false;
+	}
+
+	out.Spaces = Spaces;
+	out.Duration = Entries[entry].Duration;
+	out.TicsPerSecond = Entries[entry].TicsPerSecond;
+	out.ModelNodeCount = ModelNodeCount;
+	out.ModelBoneCount = ModelBoneCount;
+
+	return out.Open(file, toc);
+}
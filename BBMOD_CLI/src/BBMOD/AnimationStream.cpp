@@ -0,0 +1,390 @@
+#include <BBMOD/AnimationStream.hpp>
+#include <BBMOD/Animation.hpp>
+#include <BBMOD/Compression.hpp>
+#include <BBMOD/Config.hpp>
+#include <utils.hpp>
+
+#include <cmath>
+#include <cstring>
+
+bool SAnimationStream::Open(std::istream& file)
+{
+	File = &file;
+	FileStart = (uint64_t)file.tellg();
+	Blocks.clear();
+	FramesOffset = 0;
+	BoundsOffset = 0;
+	MorphTracksOffset = 0;
+	CachedBlock = -1;
+
+	char header[7];
+	file.read(header, 7);
+
+	if (!file || std::strcmp(header, "BBANIM") != 0)
+	{
+		return false;
+	}
+
+	uint8_t versionMajor;
+	FILE_READ_DATA(file, versionMajor);
+	FILE_READ_DATA(file, VersionMinor);
+
+	if (versionMajor != BBMOD_VERSION_MAJOR
+		|| (VersionMinor != BBMOD_VERSION_MINOR && VersionMinor != BBMOD_VERSION_MINOR_TOC))
+	{
+		return false;
+	}
+
+	STableOfContents toc;
+
+	if (VersionMinor >= BBMOD_VERSION_MINOR_TOC
+		&& (!toc.Load(file, FileStart) || !toc.Seek(file, BBMOD_SECTION_INFO)))
+	{
+		return false;
+	}
+
+	FILE_READ_DATA(file, Spaces);
+	FILE_READ_DATA(file, Duration);
+	FILE_READ_DATA(file, TicsPerSecond);
+	FILE_READ_DATA(file, ModelNodeCount);
+	FILE_READ_DATA(file, ModelBoneCount);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	if (VersionMinor < BBMOD_VERSION_MINOR_TOC)
+	{
+		FrameCount = (uint32_t)ceil(Duration);
+		BlockFrames = 0;
+		FrameSize = (uint32_t)SAnimation::GetFrameSize(Spaces, ModelNodeCount, ModelBoneCount);
+		FramesOffset = (uint64_t)file.tellg() - FileStart;
+		EventsOffset = FramesOffset + (uint64_t)FrameCount * FrameSize * sizeof(float);
+		return true;
+	}
+
+	return Open(file, toc);
+}
+
+bool SAnimationStream::Open(std::istream& file, const STableOfContents& toc)
+{
+	File = &file;
+	FileStart = toc.FileStart;
+	Blocks.clear();
+	FramesOffset = 0;
+	BoundsOffset = 0;
+	MorphTracksOffset = 0;
+	CachedBlock = -1;
+	VersionMinor = BBMOD_VERSION_MINOR_TOC;
+
+	FrameCount = (uint32_t)ceil(Duration);
+	BlockFrames = 0;
+	LodSpaces = Spaces;
+
+	if (toc.Find(BBMOD_SECTION_KEYS))
+	{
+		Spaces &= ~BBMOD_BONE_SPACE_PARENT;
+	}
+
+	FrameSize = (uint32_t)SAnimation::GetFrameSize(Spaces, ModelNodeCount, ModelBoneCount);
+
+	const SSection* events = toc.Find(BBMOD_SECTION_EVENTS);
+	EventsOffset = events ? events->Offset : 0;
+
+	const SSection* bounds = toc.Find(BBMOD_SECTION_BOUNDS);
+	BoundsOffset = bounds ? bounds->Offset : 0;
+
+	const SSection* morphTracks = toc.Find(BBMOD_SECTION_MORPH_WEIGHTS);
+	MorphTracksOffset = morphTracks ? morphTracks->Offset : 0;
+
+	Lods.clear();
+	LodOffsets.clear();
+
+	for (uint32_t i = 0; toc.Seek(file, BBMOD_SECTION_LOD, i); ++i)
+	{
+		SAnimationLod lod;
+		FILE_READ_DATA(file, lod.Divisor);
+		FILE_READ_DATA(file, lod.MaxError);
+		FILE_READ_DATA(file, lod.FrameCount);
+
+		if (!file)
+		{
+			return false;
+		}
+
+		Lods.push_back(lod);
+		LodOffsets.push_back((uint64_t)file.tellg() - FileStart);
+	}
+
+	WorldSpaceNodes.clear();
+	WorldSpaceNodeNames.clear();
+
+	if (toc.Seek(file, BBMOD_SECTION_WORLD_SPACE_NODES))
+	{
+		uint32_t count;
+		FILE_READ_DATA(file, count);
+
+		WorldSpaceNodes.resize(count);
+		WorldSpaceNodeNames.resize(count);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			FILE_READ_DATA(file, WorldSpaceNodes[i]);
+			std::getline(file, WorldSpaceNodeNames[i], '\0');
+		}
+
+		if (!file)
+		{
+			return false;
+		}
+
+		WorldSpaceOffset = (uint64_t)file.tellg() - FileStart;
+	}
+
+	if (Spaces == 0)
+	{
+		return true;
+	}
+
+	if (const SSection* frames = toc.Find(BBMOD_SECTION_FRAMES))
+	{
+		FramesOffset = frames->Offset;
+		return true;
+	}
+
+	const SSection* blocks = toc.Find(BBMOD_SECTION_FRAME_BLOCKS);
+
+	if (!blocks || !toc.Seek(file, BBMOD_SECTION_FRAME_INDEX))
+	{
+		// Tracks with constant or quantized data and reduced keys cannot be
+		// read in parts, but the other sections still can
+		return true;
+	}
+
+	FramesOffset = blocks->Offset;
+
+	uint32_t frameSize;
+	uint32_t frameCount;
+	uint32_t blockCount;
+	FILE_READ_DATA(file, BlockFrames);
+	FILE_READ_DATA(file, frameSize);
+	FILE_READ_DATA(file, frameCount);
+	FILE_READ_DATA(file, Filter);
+	FILE_READ_DATA(file, blockCount);
+
+	if (!file || frameSize != FrameSize || frameCount != FrameCount || BlockFrames == 0)
+	{
+		return false;
+	}
+
+	Blocks.resize(blockCount);
+
+	for (SBlock& block : Blocks)
+	{
+		FILE_READ_DATA(file, block.Offset);
+		FILE_READ_DATA(file, block.StoredSize);
+		FILE_READ_DATA(file, block.Codec);
+	}
+
+	return file.good();
+}
+
+bool SAnimationStream::HasFrames() const
+{
+	return (FramesOffset != 0 || FrameSize == 0);
+}
+
+bool SAnimationStream::LoadBlock(uint32_t index)
+{
+	if (CachedBlock == (int64_t)index)
+	{
+		return true;
+	}
+
+	if (index >= Blocks.size())
+	{
+		return false;
+	}
+
+	const SBlock& block = Blocks[index];
+	uint32_t frames = std::min(BlockFrames, FrameCount - index * BlockFrames);
+	size_t rawSize = (size_t)frames * FrameSize * sizeof(float);
+
+	std::vector<uint8_t> stored(block.StoredSize);
+	File->clear();
+	File->seekg((std::streamoff)(FileStart + FramesOffset + block.Offset));
+	File->read(reinterpret_cast<char*>(stored.data()), stored.size());
+
+	if (!*File)
+	{
+		return false;
+	}
+
+	Cache.resize((size_t)frames * FrameSize);
+	uint8_t* raw = reinterpret_cast<uint8_t*>(Cache.data());
+
+	if (block.Codec == BBMOD_CODEC_LZ)
+	{
+		if (!LZDecompress(stored.data(), stored.size(), raw, rawSize))
+		{
+			CachedBlock = -1;
+			return false;
+		}
+	}
+	else if (stored.size() == rawSize)
+	{
+		std::memcpy(raw, stored.data(), rawSize);
+	}
+	else
+	{
+		CachedBlock = -1;
+		return false;
+	}
+
+	FilterDecode(raw, rawSize, Filter);
+	CachedBlock = index;
+
+	return true;
+}
+
+bool SAnimationStream::ReadFrames(uint32_t first, uint32_t count, std::vector<float>& out)
+{
+	if (!File || (uint64_t)first + count > FrameCount)
+	{
+		return false;
+	}
+
+	out.resize((size_t)count * FrameSize);
+
+	if (count == 0 || FrameSize == 0)
+	{
+		return true;
+	}
+
+	if (!HasFrames())
+	{
+		return false;
+	}
+
+	if (BlockFrames == 0)
+	{
+		File->clear();
+		File->seekg((std::streamoff)(FileStart + FramesOffset + (uint64_t)first * FrameSize * sizeof(float)));
+		FILE_READ_ARRAY(*File, out.data(), out.size());
+		return File->good();
+	}
+
+	uint32_t frame = first;
+	uint32_t end = first + count;
+
+	while (frame < end)
+	{
+		uint32_t block = frame / BlockFrames;
+
+		if (!LoadBlock(block))
+		{
+			return false;
+		}
+
+		uint32_t blockStart = block * BlockFrames;
+		uint32_t blockEnd = std::min(blockStart + BlockFrames, end);
+		std::memcpy(
+			&out[(size_t)(frame - first) * FrameSize],
+			&Cache[(size_t)(frame - blockStart) * FrameSize],
+			sizeof(float) * FrameSize * (blockEnd - frame));
+		frame = blockEnd;
+	}
+
+	return true;
+}
+
+bool SAnimationStream::ReadWorldSpaceFrames(uint32_t first, uint32_t count, std::vector<float>& out)
+{
+	if (!File || WorldSpaceNodes.empty() || (uint64_t)first + count > FrameCount)
+	{
+		return false;
+	}
+
+	size_t frameSize = WorldSpaceNodes.size() * 8;
+	out.resize(frameSize * count);
+
+	File->clear();
+	File->seekg((std::streamoff)(FileStart + WorldSpaceOffset + (uint64_t)first * frameSize * sizeof(float)));
+	FILE_READ_ARRAY(*File, out.data(), out.size());
+
+	return File->good();
+}
+
+bool SAnimationStream::ReadLodFrames(uint32_t lod, uint32_t first, uint32_t count, std::vector<float>& out)
+{
+	if (!File || lod >= Lods.size() || (uint64_t)first + count > Lods[lod].FrameCount)
+	{
+		return false;
+	}
+
+	size_t frameSize = SAnimation::GetFrameSize(LodSpaces, ModelNodeCount, ModelBoneCount);
+	out.resize(frameSize * count);
+
+	File->clear();
+	File->seekg((std::streamoff)(FileStart + LodOffsets[lod] + (uint64_t)first * frameSize * sizeof(float)));
+	FILE_READ_ARRAY(*File, out.data(), out.size());
+
+	return File->good();
+}
+
+bool SAnimationStream::ReadEvents(std::vector<SAnimationEvent>& out)
+{
+	out.clear();
+
+	if (!File || EventsOffset == 0)
+	{
+		return false;
+	}
+
+	File->clear();
+	File->seekg((std::streamoff)(FileStart + EventsOffset));
+
+	uint32_t eventCount;
+	FILE_READ_DATA(*File, eventCount);
+
+	for (uint32_t i = 0; i < eventCount && *File; ++i)
+	{
+		SAnimationEvent event;
+		FILE_READ_DATA(*File, event.Frame);
+		std::getline(*File, event.Name, '\0');
+		out.push_back(event);
+	}
+
+	return File->good();
+}
+
+bool SAnimationStream::ReadBounds(std::vector<float>& out)
+{
+	out.clear();
+
+	if (!File || BoundsOffset == 0)
+	{
+		return false;
+	}
+
+	File->clear();
+	File->seekg((std::streamoff)(FileStart + BoundsOffset));
+
+	return SAnimation::ReadBounds(*File, out);
+}
+
+bool SAnimationStream::ReadMorphTracks(std::vector<SMorphTrack>& out)
+{
+	out.clear();
+
+	if (!File || MorphTracksOffset == 0)
+	{
+		return false;
+	}
+
+	File->clear();
+	File->seekg((std::streamoff)(FileStart + MorphTracksOffset));
+
+	return SAnimation::ReadMorphTracks(*File, out);
+}
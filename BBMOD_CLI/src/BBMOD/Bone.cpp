@@ -1,14 +1,14 @@
 #include <BBMOD/Bone.hpp>
 #include <utils.hpp>
 
-bool SBone::Save(std::ofstream& file)
+bool SBone::Save(std::ostream& file)
 {
 	FILE_WRITE_DATA(file, Index);
 	FILE_WRITE_DUAL_QUAT(file, Offset);
 	return true;
 }
 
-SBone* SBone::Load(std::ifstream& file)
+SBone* SBone::Load(std::istream& file)
 {
 	SBone* bone = new SBone();
 	FILE_READ_DATA(file, bone->Index);
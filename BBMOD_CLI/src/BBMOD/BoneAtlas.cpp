@@ -0,0 +1,265 @@
+#include <BBMOD/BoneAtlas.hpp>
+#include <BBMOD/Model.hpp>
+#include <BBMOD/Quantization.hpp>
+#include <BBMOD/TableOfContents.hpp>
+#include <utils.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+bool SBoneAtlas::Add(SAnimation* animation, const std::string& name)
+{
+	SModel* model = animation->Model;
+
+	if (!model || model->BoneCount == 0)
+	{
+		return false;
+	}
+
+	if (Clips.empty())
+	{
+		BoneCount = model->BoneCount;
+		SkeletonHash = model->SkeletonHash;
+	}
+	else if (model->BoneCount != BoneCount)
+	{
+		return false;
+	}
+
+	SBoneAtlasClip clip;
+	clip.Name = name;
+	clip.FrameCount = animation->GetFrameCount();
+	clip.TicsPerSecond = animation->TicsPerSecond;
+	Clips.push_back(clip);
+
+	Frames.emplace_back();
+	animation->SampleFrames(BBMOD_BONE_SPACE_BONE, Frames.back());
+
+	return true;
+}
+
+void SBoneAtlas::Build()
+{
+	if (Frames.size() != Clips.size())
+	{
+		// Already built or loaded
+		return;
+	}
+
+	uint32_t frameWidth = BoneCount * 2;
+	uint32_t maxFrameCount = 1;
+
+	for (const SBoneAtlasClip& clip : Clips)
+	{
+		maxFrameCount = std::max(maxFrameCount, clip.FrameCount);
+	}
+
+	FramesPerRow = std::max<uint32_t>(BBMOD_ATLAS_MAX_WIDTH / std::max<uint32_t>(frameWidth, 1), 1);
+	FramesPerRow = std::min(FramesPerRow, maxFrameCount);
+	Width = FramesPerRow * frameWidth;
+	Height = 0;
+
+	for (SBoneAtlasClip& clip : Clips)
+	{
+		clip.StartRow = Height;
+		Height += (clip.FrameCount + FramesPerRow - 1) / FramesPerRow;
+	}
+
+	Texels.assign((size_t)Width * Height * 4, 0.0f);
+
+	size_t frameSize = (size_t)BoneCount * 8;
+
+	for (size_t i = 0; i < Clips.size(); ++i)
+	{
+		const SBoneAtlasClip& clip = Clips[i];
+
+		for (uint32_t f = 0; f < clip.FrameCount; ++f)
+		{
+			size_t row = clip.StartRow + f / FramesPerRow;
+			size_t column = (f % FramesPerRow) * frameWidth;
+			std::memcpy(&Texels[(row * Width + column) * 4], &Frames[i][f * frameSize], frameSize * sizeof(float));
+		}
+	}
+
+	Frames.clear();
+}
+
+bool SBoneAtlas::Save(std::string path)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary);
+
+	if (!file.is_open() || !Save(file))
+	{
+		return false;
+	}
+
+	file.flush();
+	file.close();
+
+	return true;
+}
+
+bool SBoneAtlas::Save(std::ostream& file)
+{
+	Build();
+
+	uint64_t fileStart = (uint64_t)file.tellp();
+
+	file.write("BBATLS", sizeof(char) * 7);
+	FILE_WRITE_DATA(file, VersionMajor);
+	FILE_WRITE_DATA(file, VersionMinor);
+
+	STableOfContents toc;
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_DATA(stream, Format);
+		FILE_WRITE_DATA(stream, Width);
+		FILE_WRITE_DATA(stream, Height);
+		FILE_WRITE_DATA(stream, BoneCount);
+		FILE_WRITE_DATA(stream, FramesPerRow);
+		FILE_WRITE_DATA(stream, SkeletonHash);
+		toc.Add(BBMOD_SECTION_ATLAS_HEADER, 0, stream.str());
+	}
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		uint32_t clipCount = (uint32_t)Clips.size();
+		FILE_WRITE_DATA(stream, clipCount);
+
+		for (const SBoneAtlasClip& clip : Clips)
+		{
+			stream.write(clip.Name.c_str(), clip.Name.size() + 1);
+			FILE_WRITE_DATA(stream, clip.StartRow);
+			FILE_WRITE_DATA(stream, clip.FrameCount);
+			FILE_WRITE_DATA(stream, clip.TicsPerSecond);
+		}
+
+		toc.Add(BBMOD_SECTION_ATLAS_CLIPS, 0, stream.str());
+	}
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+
+		if (Format == BBMOD_ATLAS_RGBA16F)
+		{
+			std::vector<uint16_t> halfs(Texels.size());
+			for (size_t i = 0; i < Texels.size(); ++i)
+			{
+				halfs[i] = FloatToHalf(Texels[i]);
+			}
+			FILE_WRITE_ARRAY(stream, halfs.data(), halfs.size());
+		}
+		else
+		{
+			FILE_WRITE_ARRAY(stream, Texels.data(), Texels.size());
+		}
+
+		toc.Add(BBMOD_SECTION_ATLAS_TEXELS, 0, stream.str());
+	}
+
+	return toc.Save(file, fileStart);
+}
+
+SBoneAtlas* SBoneAtlas::Load(std::string path)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+
+	if (!file.is_open())
+	{
+		return nullptr;
+	}
+
+	return Load(file);
+}
+
+SBoneAtlas* SBoneAtlas::Load(std::istream& file)
+{
+	uint64_t fileStart = (uint64_t)file.tellg();
+
+	char header[7];
+	file.read(header, 7);
+
+	uint8_t versionMajor;
+	uint8_t versionMinor;
+	FILE_READ_DATA(file, versionMajor);
+	FILE_READ_DATA(file, versionMinor);
+
+	if (!file
+		|| std::strcmp(header, "BBATLS") != 0
+		|| versionMajor != BBMOD_VERSION_MAJOR
+		|| versionMinor != BBMOD_VERSION_MINOR_TOC)
+	{
+		return nullptr;
+	}
+
+	STableOfContents toc;
+
+	if (!toc.Load(file, fileStart)
+		|| !toc.Seek(file, BBMOD_SECTION_ATLAS_HEADER))
+	{
+		return nullptr;
+	}
+
+	SBoneAtlas* atlas = new SBoneAtlas();
+	atlas->VersionMajor = versionMajor;
+	atlas->VersionMinor = versionMinor;
+
+	FILE_READ_DATA(file, atlas->Format);
+	FILE_READ_DATA(file, atlas->Width);
+	FILE_READ_DATA(file, atlas->Height);
+	FILE_READ_DATA(file, atlas->BoneCount);
+	FILE_READ_DATA(file, atlas->FramesPerRow);
+	FILE_READ_DATA(file, atlas->SkeletonHash);
+
+	if (!file || !toc.Seek(file, BBMOD_SECTION_ATLAS_CLIPS))
+	{
+		delete atlas;
+		return nullptr;
+	}
+
+	uint32_t clipCount;
+	FILE_READ_DATA(file, clipCount);
+
+	for (uint32_t i = 0; i < clipCount && file; ++i)
+	{
+		SBoneAtlasClip clip;
+		std::getline(file, clip.Name, '\0');
+		FILE_READ_DATA(file, clip.StartRow);
+		FILE_READ_DATA(file, clip.FrameCount);
+		FILE_READ_DATA(file, clip.TicsPerSecond);
+		atlas->Clips.push_back(clip);
+	}
+
+	if (!file || !toc.Seek(file, BBMOD_SECTION_ATLAS_TEXELS))
+	{
+		delete atlas;
+		return nullptr;
+	}
+
+	atlas->Texels.resize((size_t)atlas->Width * atlas->Height * 4);
+
+	if (atlas->Format == BBMOD_ATLAS_RGBA16F)
+	{
+		std::vector<uint16_t> halfs(atlas->Texels.size());
+		FILE_READ_ARRAY(file, halfs.data(), halfs.size());
+		for (size_t i = 0; i < halfs.size(); ++i)
+		{
+			atlas->Texels[i] = HalfToFloat(halfs[i]);
+		}
+	}
+	else
+	{
+		FILE_READ_ARRAY(file, atlas->Texels.data(), atlas->Texels.size());
+	}
+
+	if (!file)
+	{
+		delete atlas;
+		return nullptr;
+	}
+
+	return atlas;
+}
@@ -0,0 +1,592 @@
+#include <BBMOD/Compression.hpp>
+#include <BBMOD/Parallel.hpp>
+#include <utils.hpp>
+
+#include <cstring>
+
+/** Minimum length of a match. */
+#define LZ_MIN_MATCH 4
+
+/** Maximum distance of a match. */
+#define LZ_MAX_OFFSET 65535
+
+/** Number of bits used by the match finder's hash table. */
+#define LZ_HASH_LOG 16
+
+/** Number of trailing bytes which are always encoded as literals. */
+#define LZ_LAST_LITERALS 5
+
+static inline uint32_t Read32(const uint8_t* p)
+{
+	uint32_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint32_t Hash32(uint32_t v)
+{
+	return (v * 2654435761u) >> (32 - LZ_HASH_LOG);
+}
+
+static inline void WriteLength(std::vector<uint8_t>& dst, size_t length)
+{
+	while (length >= 255)
+	{
+		dst.push_back(255);
+		length -= 255;
+	}
+	dst.push_back((uint8_t)length);
+}
+
+static inline bool ReadLength(const uint8_t* src, size_t srcSize, size_t& ip, size_t& length)
+{
+	uint8_t b;
+	do
+	{
+		if (ip >= srcSize)
+		{
+			return false;
+		}
+		b = src[ip++];
+		length += b;
+	}
+	while (b == 255);
+	return true;
+}
+
+static void EmitSequence(
+	std::vector<uint8_t>& dst,
+	const uint8_t* literals,
+	size_t literalCount,
+	size_t offset,
+	size_t matchLength)
+{
+	size_t matchCode = (matchLength >= LZ_MIN_MATCH) ? matchLength - LZ_MIN_MATCH : 0;
+
+	uint8_t token = (uint8_t)((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15));
+	dst.push_back(token);
+
+	if (literalCount >= 15)
+	{
+		WriteLength(dst, literalCount - 15);
+	}
+	dst.insert(dst.end(), literals, literals + literalCount);
+
+	if (matchLength == 0)
+	{
+		// Last sequence, literals only
+		return;
+	}
+
+	dst.push_back((uint8_t)(offset & 0xFF));
+	dst.push_back((uint8_t)(offset >> 8));
+
+	if (matchCode >= 15)
+	{
+		WriteLength(dst, matchCode - 15);
+	}
+}
+
+void LZCompress(const uint8_t* src, size_t size, std::vector<uint8_t>& dst)
+{
+	std::vector<int64_t> table((size_t)1 << LZ_HASH_LOG, -1);
+
+	size_t anchor = 0;
+	size_t ip = 0;
+	size_t searchLimit = (size > LZ_LAST_LITERALS + LZ_MIN_MATCH) ? size - LZ_LAST_LITERALS - LZ_MIN_MATCH : 0;
+	size_t matchLimit = (size > LZ_LAST_LITERALS) ? size - LZ_LAST_LITERALS : 0;
+
+	while (ip < searchLimit)
+	{
+		uint32_t sequence = Read32(src + ip);
+		uint32_t h = Hash32(sequence);
+		int64_t ref = table[h];
+		table[h] = (int64_t)ip;
+
+		if (ref < 0
+			|| ip - (size_t)ref > LZ_MAX_OFFSET
+			|| Read32(src + ref) != sequence)
+		{
+			++ip;
+			continue;
+		}
+
+		size_t length = LZ_MIN_MATCH;
+		while (ip + length < matchLimit && src[ref + length] == src[ip + length])
+		{
+			++length;
+		}
+
+		EmitSequence(dst, src + anchor, ip - anchor, ip - (size_t)ref, length);
+
+		ip += length;
+		anchor = ip;
+	}
+
+	EmitSequence(dst, src + anchor, size - anchor, 0, 0);
+}
+
+bool LZDecompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+	size_t ip = 0;
+	size_t op = 0;
+
+	while (true)
+	{
+		if (ip >= srcSize)
+		{
+			return false;
+		}
+
+		uint8_t token = src[ip++];
+
+		// Literals
+		size_t literalCount = token >> 4;
+		if (literalCount == 15 && !ReadLength(src, srcSize, ip, literalCount))
+		{
+			return false;
+		}
+
+		if (literalCount > srcSize - ip || literalCount > dstSize - op)
+		{
+			return false;
+		}
+
+		std::memcpy(dst + op, src + ip, literalCount);
+		ip += literalCount;
+		op += literalCount;
+
+		if (op == dstSize)
+		{
+			return (ip == srcSize);
+		}
+
+		// Match
+		if (srcSize - ip < 2)
+		{
+			return false;
+		}
+
+		size_t offset = (size_t)src[ip] | ((size_t)src[ip + 1] << 8);
+		ip += 2;
+
+		if (offset == 0 || offset > op)
+		{
+			return false;
+		}
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !ReadLength(src, srcSize, ip, matchLength))
+		{
+			return false;
+		}
+		matchLength += LZ_MIN_MATCH;
+
+		if (matchLength > dstSize - op)
+		{
+			return false;
+		}
+
+		// Byte by byte, since the match can overlap with the output
+		const uint8_t* match = dst + op - offset;
+		for (size_t i = 0; i < matchLength; ++i)
+		{
+			dst[op + i] = match[i];
+		}
+		op += matchLength;
+	}
+}
+
+void FilterEncode(uint8_t* data, size_t size, uint32_t filter)
+{
+	if (filter == BBMOD_FILTER_NONE)
+	{
+		return;
+	}
+
+	size_t wordCount = size / 4;
+	std::vector<uint8_t> shuffled(wordCount * 4);
+
+	for (size_t i = 0; i < wordCount; ++i)
+	{
+		for (size_t b = 0; b < 4; ++b)
+		{
+			shuffled[b * wordCount + i] = data[i * 4 + b];
+		}
+	}
+
+	if (filter == BBMOD_FILTER_SHUFFLE_DELTA)
+	{
+		for (size_t b = 0; b < 4; ++b)
+		{
+			uint8_t* plane = &shuffled[b * wordCount];
+			uint8_t previous = 0;
+			for (size_t i = 0; i < wordCount; ++i)
+			{
+				uint8_t current = plane[i];
+				plane[i] = (uint8_t)(current - previous);
+				previous = current;
+			}
+		}
+	}
+
+	std::memcpy(data, shuffled.data(), shuffled.size());
+}
+
+void FilterDecode(uint8_t* data, size_t size, uint32_t filter)
+{
+	if (filter == BBMOD_FILTER_NONE)
+	{
+		return;
+	}
+
+	size_t wordCount = size / 4;
+
+	if (filter == BBMOD_FILTER_SHUFFLE_DELTA)
+	{
+		for (size_t b = 0; b < 4; ++b)
+		{
+			uint8_t* plane = &data[b * wordCount];
+			uint8_t previous = 0;
+			for (size_t i = 0; i < wordCount; ++i)
+			{
+				previous = (uint8_t)(previous + plane[i]);
+				plane[i] = previous;
+			}
+		}
+	}
+
+	std::vector<uint8_t> shuffled(data, data + wordCount * 4);
+
+	for (size_t i = 0; i < wordCount; ++i)
+	{
+		for (size_t b = 0; b < 4; ++b)
+		{
+			data[i * 4 + b] = shuffled[b * wordCount + i];
+		}
+	}
+}
+
+bool WriteContainer(
+	std::ostream& file,
+	const uint8_t* data,
+	size_t size,
+	uint32_t chunkSize,
+	uint32_t filter)
+{
+	if (chunkSize == 0)
+	{
+		return false;
+	}
+
+	uint32_t chunkCount = (uint32_t)((size + chunkSize - 1) / chunkSize);
+
+	std::vector<std::vector<uint8_t>> payloads(chunkCount);
+	std::vector<uint8_t> codecs(chunkCount, BBMOD_CODEC_STORE);
+
+	ParallelFor(chunkCount, [&](size_t i) {
+		size_t start = i * chunkSize;
+		size_t rawSize = std::min<size_t>(chunkSize, size - start);
+
+		std::vector<uint8_t> raw(data + start, data + start + rawSize);
+		FilterEncode(raw.data(), rawSize, filter);
+
+		std::vector<uint8_t>& payload = payloads[i];
+		LZCompress(raw.data(), rawSize, payload);
+
+		if (payload.size() < rawSize)
+		{
+			codecs[i] = BBMOD_CODEC_LZ;
+		}
+		else
+		{
+			payload = std::move(raw);
+		}
+	});
+
+	file.write(BBMOD_CONTAINER_MAGIC, sizeof(char) * 5);
+	uint8_t version = BBMOD_CONTAINER_VERSION;
+	FILE_WRITE_DATA(file, version);
+	uint8_t filterByte = (uint8_t)filter;
+	FILE_WRITE_DATA(file, filterByte);
+	FILE_WRITE_DATA(file, chunkSize);
+	uint64_t rawSize = (uint64_t)size;
+	FILE_WRITE_DATA(file, rawSize);
+	FILE_WRITE_DATA(file, chunkCount);
+
+	// Header + chunk table (offset, stored size, codec)
+	uint64_t offset = 5 + 1 + 1 + 4 + 8 + 4 + (uint64_t)chunkCount * (8 + 4 + 1);
+
+	for (uint32_t i = 0; i < chunkCount; ++i)
+	{
+		uint32_t storedSize = (uint32_t)payloads[i].size();
+		FILE_WRITE_DATA(file, offset);
+		FILE_WRITE_DATA(file, storedSize);
+		FILE_WRITE_DATA(file, codecs[i]);
+		offset += storedSize;
+	}
+
+	for (const std::vector<uint8_t>& payload : payloads)
+	{
+		file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+	}
+
+	return file.good();
+}
+
+bool IsContainer(std::istream& file)
+{
+	char magic[5] = { 0 };
+	std::streampos position = file.tellg();
+	file.read(magic, 5);
+	bool result = (file.gcount() == 5 && std::memcmp(magic, BBMOD_CONTAINER_MAGIC, 5) == 0);
+	file.clear();
+	file.seekg(position);
+	return result;
+}
+
+bool SContainerReader::Open(std::istream& file)
+{
+	File = &file;
+	Start = (uint64_t)file.tellg();
+
+	char magic[5];
+	file.read(magic, 5);
+	if (!file || std::memcmp(magic, BBMOD_CONTAINER_MAGIC, 5) != 0)
+	{
+		return false;
+	}
+
+	uint8_t version;
+	FILE_READ_DATA(file, version);
+	if (version != BBMOD_CONTAINER_VERSION)
+	{
+		return false;
+	}
+
+	uint8_t filter;
+	FILE_READ_DATA(file, filter);
+	Filter = filter;
+
+	FILE_READ_DATA(file, ChunkSize);
+	FILE_READ_DATA(file, RawSize);
+
+	uint32_t chunkCount;
+	FILE_READ_DATA(file, chunkCount);
+
+	if (!file || ChunkSize == 0
+		|| (uint64_t)chunkCount != (RawSize + ChunkSize - 1) / ChunkSize)
+	{
+		return false;
+	}
+
+	Chunks.resize(chunkCount);
+
+	for (SChunkInfo& chunk : Chunks)
+	{
+		FILE_READ_DATA(file, chunk.Offset);
+		FILE_READ_DATA(file, chunk.StoredSize);
+		FILE_READ_DATA(file, chunk.Codec);
+	}
+
+	CachedChunk = -1;
+
+	return file.good();
+}
+
+bool SContainerReader::ReadChunk(uint32_t index, std::vector<uint8_t>& out)
+{
+	if (index >= Chunks.size())
+	{
+		return false;
+	}
+
+	const SChunkInfo& chunk = Chunks[index];
+	uint64_t start = (uint64_t)index * ChunkSize;
+	size_t rawSize = (size_t)std::min<uint64_t>(ChunkSize, RawSize - start);
+
+	std::vector<uint8_t> stored(chunk.StoredSize);
+	File->clear();
+	File->seekg((std::streamoff)(Start + chunk.Offset));
+	File->read(reinterpret_cast<char*>(stored.data()), stored.size());
+
+	if (!*File)
+	{
+		return false;
+	}
+
+	out.resize(rawSize);
+
+	switch (chunk.Codec)
+	{
+	case BBMOD_CODEC_STORE:
+		if (stored.size() != rawSize)
+		{
+			return false;
+		}
+		std::memcpy(out.data(), stored.data(), rawSize);
+		break;
+
+	case BBMOD_CODEC_LZ:
+		if (!LZDecompress(stored.data(), stored.size(), out.data(), rawSize))
+		{
+			return false;
+		}
+		break;
+
+	default:
+		return false;
+	}
+
+	FilterDecode(out.data(), rawSize, Filter);
+
+	return true;
+}
+
+bool SContainerReader::LoadChunk(uint32_t index)
+{
+	if (CachedChunk == (int64_t)index)
+	{
+		return true;
+	}
+
+	CachedChunk = -1;
+
+	if (!ReadChunk(index, Cache))
+	{
+		return false;
+	}
+
+	CachedChunk = index;
+	return true;
+}
+
+bool SContainerReader::Read(uint64_t offset, void* dst, size_t size)
+{
+	if (offset + size > RawSize)
+	{
+		return false;
+	}
+
+	uint8_t* out = static_cast<uint8_t*>(dst);
+
+	while (size > 0)
+	{
+		uint32_t index = (uint32_t)(offset / ChunkSize);
+		if (!LoadChunk(index))
+		{
+			return false;
+		}
+
+		size_t inChunk = (size_t)(offset - (uint64_t)index * ChunkSize);
+		size_t count = std::min(size, Cache.size() - inChunk);
+		std::memcpy(out, Cache.data() + inChunk, count);
+
+		out += count;
+		offset += count;
+		size -= count;
+	}
+
+	return true;
+}
+
+SContainerStreamBuf::SContainerStreamBuf(SContainerReader& reader)
+	: Reader(reader)
+{
+	setg(nullptr, nullptr, nullptr);
+}
+
+bool SContainerStreamBuf::Fetch(uint64_t position)
+{
+	if (position >= Reader.RawSize)
+	{
+		Buffer.clear();
+		BufferStart = position;
+		setg(nullptr, nullptr, nullptr);
+		return false;
+	}
+
+	uint32_t index = (uint32_t)(position / Reader.ChunkSize);
+	uint64_t chunkStart = (uint64_t)index * Reader.ChunkSize;
+
+	if (Buffer.empty() || BufferStart != chunkStart)
+	{
+		if (!Reader.ReadChunk(index, Buffer))
+		{
+			Buffer.clear();
+			setg(nullptr, nullptr, nullptr);
+			return false;
+		}
+		BufferStart = chunkStart;
+	}
+
+	char* begin = reinterpret_cast<char*>(Buffer.data());
+	setg(begin, begin + (position - chunkStart), begin + Buffer.size());
+	return true;
+}
+
+SContainerStreamBuf::int_type SContainerStreamBuf::underflow()
+{
+	if (gptr() < egptr())
+	{
+		return traits_type::to_int_type(*gptr());
+	}
+
+	uint64_t position = BufferStart + (eback() ? (uint64_t)(gptr() - eback()) : 0);
+
+	if (!Fetch(position))
+	{
+		return traits_type::eof();
+	}
+
+	return traits_type::to_int_type(*gptr());
+}
+
+SContainerStreamBuf::pos_type SContainerStreamBuf::seekoff(
+	off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+	if (!(which & std::ios_base::in))
+	{
+		return pos_type(off_type(-1));
+	}
+
+	int64_t current = (int64_t)BufferStart + (eback() ? (int64_t)(gptr() - eback()) : 0);
+	int64_t position;
+
+	switch (dir)
+	{
+	case std::ios_base::beg:
+		position = off;
+		break;
+
+	case std::ios_base::cur:
+		position = current + off;
+		break;
+
+	default:
+		position = (int64_t)Reader.RawSize + off;
+		break;
+	}
+
+	return seekpos(pos_type(position), which);
+}
+
+SContainerStreamBuf::pos_type SContainerStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+	int64_t position = (int64_t)(off_type)pos;
+
+	if (!(which & std::ios_base::in)
+		|| position < 0
+		|| (uint64_t)position > Reader.RawSize)
+	{
+		return pos_type(off_type(-1));
+	}
+
+	if (!Fetch((uint64_t)position))
+	{
+		// At the end of data
+		BufferStart = (uint64_t)position;
+	}
+
+	return pos;
+}
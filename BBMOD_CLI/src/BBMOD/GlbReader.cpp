@@ -0,0 +1,2525 @@
+#include <BBMOD/GlbReader.hpp>
+#include <BBMOD/Model.hpp>
+#include <BBMOD/Parallel.hpp>
+#include <BBMOD/TangentSpace.hpp>
+
+#include <assimp/material.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+#define BBMOD_JSON_NULL 0
+#define BBMOD_JSON_BOOL 1
+#define BBMOD_JSON_NUMBER 2
+#define BBMOD_JSON_STRING 3
+#define BBMOD_JSON_ARRAY 4
+#define BBMOD_JSON_OBJECT 5
+
+/** Maximum nesting of JSON arrays and objects. */
+#define BBMOD_JSON_MAX_DEPTH 256
+
+#define BBMOD_GLTF_BYTE 5120
+#define BBMOD_GLTF_UNSIGNED_BYTE 5121
+#define BBMOD_GLTF_SHORT 5122
+#define BBMOD_GLTF_UNSIGNED_SHORT 5123
+#define BBMOD_GLTF_UNSIGNED_INT 5125
+#define BBMOD_GLTF_FLOAT 5126
+
+#define BBMOD_GLTF_POINTS 0
+#define BBMOD_GLTF_LINES 1
+#define BBMOD_GLTF_TRIANGLES 4
+
+static_assert(sizeof(aiVector3D) == sizeof(float) * 3, "Accessors are decoded straight into aiVector3D!");
+
+////////////////////////////////////////////////////////////////////////////////
+// JSON
+
+/** A value parsed from JSON. */
+struct SJsonValue
+{
+	/** Returns a member of an object or nullptr if it does not exist. */
+	const SJsonValue* Find(const char* key) const
+	{
+		for (const auto& member : Object)
+		{
+			if (member.first == key)
+			{
+				return &member.second;
+			}
+		}
+		return nullptr;
+	}
+
+	/** Returns a member of an object if it is an array, otherwise nullptr. */
+	const SJsonValue* FindArray(const char* key) const
+	{
+		const SJsonValue* value = Find(key);
+		return (value && value->Type == BBMOD_JSON_ARRAY) ? value : nullptr;
+	}
+
+	/** Returns a member of an object if it is an object, otherwise nullptr. */
+	const SJsonValue* FindObject(const char* key) const
+	{
+		const SJsonValue* value = Find(key);
+		return (value && value->Type == BBMOD_JSON_OBJECT) ? value : nullptr;
+	}
+
+	double GetNumber(const char* key, double defaultValue) const
+	{
+		const SJsonValue* value = Find(key);
+		return (value && value->Type == BBMOD_JSON_NUMBER) ? value->Number : defaultValue;
+	}
+
+	/** Returns the value as an integer or `defaultValue` if it is not a
+	 * number or if it is out of range. */
+	int64_t AsInteger(int64_t defaultValue = -1) const
+	{
+		return (Type == BBMOD_JSON_NUMBER && std::fabs(Number) < 9.0e18) ? (int64_t)Number : defaultValue;
+	}
+
+	int64_t GetInteger(const char* key, int64_t defaultValue) const
+	{
+		const SJsonValue* value = Find(key);
+		return value ? value->AsInteger(defaultValue) : defaultValue;
+	}
+
+	bool GetBool(const char* key, bool defaultValue) const
+	{
+		const SJsonValue* value = Find(key);
+		return (value && value->Type == BBMOD_JSON_BOOL) ? value->Boolean : defaultValue;
+	}
+
+	std::string GetString(const char* key, const std::string& defaultValue = "") const
+	{
+		const SJsonValue* value = Find(key);
+		return (value && value->Type == BBMOD_JSON_STRING) ? value->String : defaultValue;
+	}
+
+	/** Reads up to `count` numbers of an array member into `out`. Returns
+	 * false if the member is not an array. */
+	bool GetNumbers(const char* key, float* out, size_t count) const
+	{
+		const SJsonValue* value = FindArray(key);
+		if (!value)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < count && i < value->Array.size(); ++i)
+		{
+			out[i] = (float)std::min(std::max(value->Array[i].Number, (double)-FLT_MAX), (double)FLT_MAX);
+		}
+		return true;
+	}
+
+	/** One of BBMOD_JSON_. */
+	uint32_t Type = BBMOD_JSON_NULL;
+
+	bool Boolean = false;
+
+	double Number = 0.0;
+
+	std::string String;
+
+	std::vector<SJsonValue> Array;
+
+	/** Members of an object in the order in which they were parsed. */
+	std::vector<std::pair<std::string, SJsonValue>> Object;
+};
+
+/** Parses JSON text into a SJsonValue. */
+struct SJsonParser
+{
+	SJsonParser(const char* begin, const char* end)
+		: Current(begin)
+		, End(end)
+	{
+	}
+
+	bool Parse(SJsonValue& out)
+	{
+		// Not allowed by glTF, but written by some tools anyway
+		if (End - Current >= 3 && std::memcmp(Current, "\xEF\xBB\xBF", 3) == 0)
+		{
+			Current += 3;
+		}
+
+		SkipWhitespace();
+		if (!ParseValue(out, 0))
+		{
+			return false;
+		}
+		SkipWhitespace();
+
+		if (Current != End)
+		{
+			Error = "Unexpected data after the root value";
+			return false;
+		}
+		return true;
+	}
+
+	const char* Current;
+
+	const char* End;
+
+	std::string Error;
+
+private:
+	void SkipWhitespace()
+	{
+		while (Current < End
+			&& (*Current == ' ' || *Current == '\t' || *Current == '\n' || *Current == '\r'))
+		{
+			++Current;
+		}
+	}
+
+	bool Consume(char c)
+	{
+		if (Current < End && *Current == c)
+		{
+			++Current;
+			return true;
+		}
+		return false;
+	}
+
+	bool Fail(const std::string& error)
+	{
+		Error = error;
+		return false;
+	}
+
+	bool ParseValue(SJsonValue& out, uint32_t depth)
+	{
+		if (depth > BBMOD_JSON_MAX_DEPTH)
+		{
+			return Fail("JSON is nested too deep");
+		}
+
+		if (Current >= End)
+		{
+			return Fail("Unexpected end of JSON");
+		}
+
+		switch (*Current)
+		{
+		case '{':
+			++Current;
+			out.Type = BBMOD_JSON_OBJECT;
+			SkipWhitespace();
+			if (Consume('}'))
+			{
+				return true;
+			}
+			while (true)
+			{
+				SkipWhitespace();
+				std::string key;
+				if (!ParseString(key))
+				{
+					return false;
+				}
+				SkipWhitespace();
+				if (!Consume(':'))
+				{
+					return Fail("Expected ':' after key \"" + key + "\"");
+				}
+				SkipWhitespace();
+				out.Object.emplace_back(std::move(key), SJsonValue());
+				if (!ParseValue(out.Object.back().second, depth + 1))
+				{
+					return false;
+				}
+				SkipWhitespace();
+				if (Consume(','))
+				{
+					continue;
+				}
+				if (Consume('}'))
+				{
+					return true;
+				}
+				return Fail("Expected ',' or '}' in an object");
+			}
+
+		case '[':
+			++Current;
+			out.Type = BBMOD_JSON_ARRAY;
+			SkipWhitespace();
+			if (Consume(']'))
+			{
+				return true;
+			}
+			while (true)
+			{
+				SkipWhitespace();
+				out.Array.emplace_back();
+				if (!ParseValue(out.Array.back(), depth + 1))
+				{
+					return false;
+				}
+				SkipWhitespace();
+				if (Consume(','))
+				{
+					continue;
+				}
+				if (Consume(']'))
+				{
+					return true;
+				}
+				return Fail("Expected ',' or ']' in an array");
+			}
+
+		case '"':
+			out.Type = BBMOD_JSON_STRING;
+			return ParseString(out.String);
+
+		case 't':
+			out.Type = BBMOD_JSON_BOOL;
+			out.Boolean = true;
+			return ParseLiteral("true");
+
+		case 'f':
+			out.Type = BBMOD_JSON_BOOL;
+			out.Boolean = false;
+			return ParseLiteral("false");
+
+		case 'n':
+			out.Type = BBMOD_JSON_NULL;
+			return ParseLiteral("null");
+
+		default:
+			out.Type = BBMOD_JSON_NUMBER;
+			return ParseNumber(out.Number);
+		}
+	}
+
+	bool ParseLiteral(const char* literal)
+	{
+		size_t length = std::strlen(literal);
+		if ((size_t)(End - Current) < length || std::memcmp(Current, literal, length) != 0)
+		{
+			return Fail("Invalid literal in JSON");
+		}
+		Current += length;
+		return true;
+	}
+
+	bool ParseNumber(double& out)
+	{
+		std::from_chars_result result = std::from_chars(Current, End, out);
+		if (result.ec != std::errc())
+		{
+			return Fail("Invalid number in JSON");
+		}
+		Current = result.ptr;
+		return true;
+	}
+
+	bool ParseHex(uint32_t& out)
+	{
+		if (End - Current < 4)
+		{
+			return Fail("Invalid escape sequence in JSON");
+		}
+		std::from_chars_result result = std::from_chars(Current, Current + 4, out, 16);
+		if (result.ec != std::errc() || result.ptr != Current + 4)
+		{
+			return Fail("Invalid escape sequence in JSON");
+		}
+		Current += 4;
+		return true;
+	}
+
+	static void AppendUtf8(std::string& out, uint32_t codepoint)
+	{
+		if (codepoint < 0x80)
+		{
+			out += (char)codepoint;
+		}
+		else if (codepoint < 0x800)
+		{
+			out += (char)(0xC0 | (codepoint >> 6));
+			out += (char)(0x80 | (codepoint & 0x3F));
+		}
+		else if (codepoint < 0x10000)
+		{
+			out += (char)(0xE0 | (codepoint >> 12));
+			out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+			out += (char)(0x80 | (codepoint & 0x3F));
+		}
+		else
+		{
+			out += (char)(0xF0 | (codepoint >> 18));
+			out += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+			out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+			out += (char)(0x80 | (codepoint & 0x3F));
+		}
+	}
+
+	bool ParseString(std::string& out)
+	{
+		if (!Consume('"'))
+		{
+			return Fail("Expected a string in JSON");
+		}
+
+		while (Current < End)
+		{
+			// Copy characters up to the next quote or escape at once
+			const char* start = Current;
+			while (Current < End && *Current != '"' && *Current != '\\')
+			{
+				if ((unsigned char)*Current < 0x20)
+				{
+					return Fail("Control character in a JSON string");
+				}
+				++Current;
+			}
+			out.append(start, Current);
+
+			if (Current >= End)
+			{
+				break;
+			}
+
+			if (*Current++ == '"')
+			{
+				return true;
+			}
+
+			if (Current >= End)
+			{
+				break;
+			}
+
+			switch (*Current++)
+			{
+			case '"': out += '"'; break;
+			case '\\': out += '\\'; break;
+			case '/': out += '/'; break;
+			case 'b': out += '\b'; break;
+			case 'f': out += '\f'; break;
+			case 'n': out += '\n'; break;
+			case 'r': out += '\r'; break;
+			case 't': out += '\t'; break;
+
+			case 'u':
+				{
+					uint32_t codepoint;
+					if (!ParseHex(codepoint))
+					{
+						return false;
+					}
+
+					// Characters outside of the BMP are encoded as surrogate pairs
+					if (codepoint >= 0xD800 && codepoint <= 0xDBFF
+						&& End - Current >= 2 && Current[0] == '\\' && Current[1] == 'u')
+					{
+						Current += 2;
+						uint32_t low;
+						if (!ParseHex(low))
+						{
+							return false;
+						}
+						if (low >= 0xDC00 && low <= 0xDFFF)
+						{
+							codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+						}
+						else
+						{
+							AppendUtf8(out, codepoint);
+							codepoint = low;
+						}
+					}
+
+					AppendUtf8(out, codepoint);
+				}
+				break;
+
+			default:
+				return Fail("Invalid escape sequence in JSON");
+			}
+		}
+
+		return Fail("Unterminated string in JSON");
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Accessors
+
+/** A view of an accessor's elements in the binary chunk. */
+struct SGlbAccessor
+{
+	/** The first element or nullptr if all elements are zero. */
+	const uint8_t* Data = nullptr;
+
+	/** Distance between elements in bytes. */
+	size_t Stride = 0;
+
+	size_t Count = 0;
+
+	/** One of BBMOD_GLTF_ component types. */
+	uint32_t ComponentType = 0;
+
+	/** Number of components of each element. */
+	uint32_t Components = 0;
+
+	bool Normalized = false;
+};
+
+static uint32_t GetComponentSize(uint32_t componentType)
+{
+	switch (componentType)
+	{
+	case BBMOD_GLTF_BYTE:
+	case BBMOD_GLTF_UNSIGNED_BYTE:
+		return 1;
+
+	case BBMOD_GLTF_SHORT:
+	case BBMOD_GLTF_UNSIGNED_SHORT:
+		return 2;
+
+	case BBMOD_GLTF_UNSIGNED_INT:
+	case BBMOD_GLTF_FLOAT:
+		return 4;
+
+	default:
+		return 0;
+	}
+}
+
+static uint32_t GetComponentCount(const std::string& type)
+{
+	if (type == "SCALAR") return 1;
+	if (type == "VEC2") return 2;
+	if (type == "VEC3") return 3;
+	if (type == "VEC4") return 4;
+	if (type == "MAT2") return 4;
+	if (type == "MAT3") return 9;
+	if (type == "MAT4") return 16;
+	return 0;
+}
+
+static inline float NormalizeComponent(int8_t value) { return std::max(value / 127.0f, -1.0f); }
+
+static inline float NormalizeComponent(uint8_t value) { return value / 255.0f; }
+
+static inline float NormalizeComponent(int16_t value) { return std::max(value / 32767.0f, -1.0f); }
+
+static inline float NormalizeComponent(uint16_t value) { return value / 65535.0f; }
+
+static inline float NormalizeComponent(uint32_t value) { return (float)(value / 4294967295.0); }
+
+static inline float NormalizeComponent(float value) { return value; }
+
+template <typename T>
+static void ReadFloatsAs(const SGlbAccessor& accessor, uint32_t components, float* out, size_t outStride)
+{
+	for (size_t i = 0; i < accessor.Count; ++i, out += outStride)
+	{
+		const uint8_t* element = accessor.Data + i * accessor.Stride;
+		for (uint32_t c = 0; c < components; ++c)
+		{
+			T value;
+			std::memcpy(&value, element + c * sizeof(T), sizeof(T));
+			out[c] = accessor.Normalized ? NormalizeComponent(value) : (float)value;
+		}
+	}
+}
+
+/**
+ * Decodes the first `components` components of each element of an accessor
+ * into floats. Elements are written `outStride` floats apart, other floats are
+ * not touched. Components which the accessor does not have are not written
+ * either.
+ */
+static void ReadFloats(const SGlbAccessor& accessor, uint32_t components, float* out, size_t outStride)
+{
+	components = std::min(components, accessor.Components);
+
+	if (!accessor.Data)
+	{
+		for (size_t i = 0; i < accessor.Count; ++i, out += outStride)
+		{
+			std::fill(out, out + components, 0.0f);
+		}
+		return;
+	}
+
+	switch (accessor.ComponentType)
+	{
+	case BBMOD_GLTF_BYTE: ReadFloatsAs<int8_t>(accessor, components, out, outStride); break;
+	case BBMOD_GLTF_UNSIGNED_BYTE: ReadFloatsAs<uint8_t>(accessor, components, out, outStride); break;
+	case BBMOD_GLTF_SHORT: ReadFloatsAs<int16_t>(accessor, components, out, outStride); break;
+	case BBMOD_GLTF_UNSIGNED_SHORT: ReadFloatsAs<uint16_t>(accessor, components, out, outStride); break;
+	case BBMOD_GLTF_UNSIGNED_INT: ReadFloatsAs<uint32_t>(accessor, components, out, outStride); break;
+	case BBMOD_GLTF_FLOAT: ReadFloatsAs<float>(accessor, components, out, outStride); break;
+	}
+}
+
+template <typename T>
+static void ReadUintsAs(const SGlbAccessor& accessor, uint32_t components, uint32_t* out)
+{
+	for (size_t i = 0; i < accessor.Count; ++i)
+	{
+		const uint8_t* element = accessor.Data + i * accessor.Stride;
+		for (uint32_t c = 0; c < components; ++c)
+		{
+			T value;
+			std::memcpy(&value, element + c * sizeof(T), sizeof(T));
+			*out++ = (uint32_t)value;
+		}
+	}
+}
+
+/** Decodes `components` components of each element of an unsigned integer
+ * accessor into `out`, which must have room for `Count * components` values.
+ * Returns false if the accessor does not have unsigned integers. */
+static bool ReadUints(const SGlbAccessor& accessor, uint32_t components, uint32_t* out)
+{
+	if (accessor.Components < components)
+	{
+		return false;
+	}
+
+	if (!accessor.Data)
+	{
+		std::fill(out, out + accessor.Count * components, 0);
+		return true;
+	}
+
+	switch (accessor.ComponentType)
+	{
+	case BBMOD_GLTF_UNSIGNED_BYTE: ReadUintsAs<uint8_t>(accessor, components, out); return true;
+	case BBMOD_GLTF_UNSIGNED_SHORT: ReadUintsAs<uint16_t>(accessor, components, out); return true;
+	case BBMOD_GLTF_UNSIGNED_INT: ReadUintsAs<uint32_t>(accessor, components, out); return true;
+	default: return false;
+	}
+}
+
+/** Returns a view of element `index` of an accessor, which can be decoded
+ * with ReadFloats and ReadUints without decoding the whole accessor. */
+static SGlbAccessor GetElement(const SGlbAccessor& accessor, size_t index)
+{
+	SGlbAccessor element = accessor;
+	element.Count = 1;
+	if (element.Data)
+	{
+		element.Data += index * element.Stride;
+	}
+	return element;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Conversion
+
+/** State of a conversion of a GLB file. */
+struct SGlbContext
+{
+	const SJsonValue* Json = nullptr;
+
+	const uint8_t* Bin = nullptr;
+
+	size_t BinSize = 0;
+
+	/** Names of nodes, which are also names of bones. */
+	std::vector<std::string> NodeNames;
+
+	/** Each primitive of each mesh as a pair of a mesh index and a primitive
+	 * index. Each becomes a mesh of the model, in this order. */
+	std::vector<std::pair<uint32_t, uint32_t>> Primitives;
+
+	/** Primitives of glTF mesh `i` are Primitives[MeshOffsets[i]] ...
+	 * Primitives[MeshOffsets[i + 1] - 1]. */
+	std::vector<uint32_t> MeshOffsets;
+
+	/** Index of the skin used with each glTF mesh or -1. */
+	std::vector<int64_t> MeshSkins;
+};
+
+/** A weight of a joint of a skin on a vertex. */
+struct SGlbWeight
+{
+	uint32_t Vertex;
+
+	uint32_t Joint;
+
+	float Weight;
+};
+
+/** Returns an item of a top-level array or nullptr if it does not exist. */
+static const SJsonValue* GetItem(const SJsonValue& json, const char* key, int64_t index)
+{
+	const SJsonValue* array = json.FindArray(key);
+	if (!array || index < 0 || (uint64_t)index >= array->Array.size())
+	{
+		return nullptr;
+	}
+	return &array->Array[index];
+}
+
+static size_t GetCount(const SJsonValue& json, const char* key)
+{
+	const SJsonValue* array = json.FindArray(key);
+	return array ? array->Array.size() : 0;
+}
+
+static bool GetAccessor(const SGlbContext& context, int64_t index, SGlbAccessor& out, std::string& error)
+{
+	const SJsonValue* accessor = GetItem(*context.Json, "accessors", index);
+	if (!accessor)
+	{
+		error = "Accessor " + std::to_string(index) + " does not exist";
+		return false;
+	}
+
+	out.ComponentType = (uint32_t)accessor->GetInteger("componentType", 0);
+	out.Components = GetComponentCount(accessor->GetString("type"));
+	out.Normalized = accessor->GetBool("normalized", false);
+
+	int64_t count = accessor->GetInteger("count", -1);
+	size_t elementSize = (size_t)GetComponentSize(out.ComponentType) * out.Components;
+
+	if (count < 0 || elementSize == 0)
+	{
+		error = "Accessor " + std::to_string(index) + " is invalid";
+		return false;
+	}
+
+	out.Count = (size_t)count;
+	out.Stride = elementSize;
+	out.Data = nullptr;
+
+	int64_t viewIndex = accessor->GetInteger("bufferView", -1);
+	if (viewIndex < 0)
+	{
+		// Accessors without a buffer view are initialized with zeros
+		return true;
+	}
+
+	const SJsonValue* view = GetItem(*context.Json, "bufferViews", viewIndex);
+	if (!view || view->GetInteger("buffer", 0) != 0 || !context.Bin)
+	{
+		error = "Buffer view " + std::to_string(viewIndex) + " is invalid";
+		return false;
+	}
+
+	int64_t viewOffset = view->GetInteger("byteOffset", 0);
+	int64_t viewLength = view->GetInteger("byteLength", -1);
+	int64_t viewStride = view->GetInteger("byteStride", 0);
+	int64_t offset = accessor->GetInteger("byteOffset", 0);
+
+	if (viewOffset < 0 || viewLength < 0 || viewStride < 0 || offset < 0
+		|| (uint64_t)viewOffset > context.BinSize
+		|| (uint64_t)viewLength > context.BinSize - (uint64_t)viewOffset)
+	{
+		error = "Buffer view " + std::to_string(viewIndex) + " is out of bounds";
+		return false;
+	}
+
+	if (viewStride > 0)
+	{
+		out.Stride = (size_t)viewStride;
+	}
+
+	if (out.Count > 0
+		&& (out.Count > (size_t)viewLength
+			|| (uint64_t)offset + (out.Count - 1) * (uint64_t)out.Stride + elementSize > (uint64_t)viewLength))
+	{
+		error = "Accessor " + std::to_string(index) + " is out of bounds";
+		return false;
+	}
+
+	out.Data = context.Bin + viewOffset + offset;
+	return true;
+}
+
+/** Finds a vertex attribute of a primitive. Returns false if it does not
+ * exist or if it is invalid, in which case `error` is set as well. */
+static bool GetAttribute(
+	const SGlbContext& context,
+	const SJsonValue& primitive,
+	const std::string& name,
+	size_t vertexCount,
+	SGlbAccessor& out,
+	std::string& error)
+{
+	const SJsonValue* attributes = primitive.FindObject("attributes");
+	int64_t index = attributes ? attributes->GetInteger(name.c_str(), -1) : -1;
+
+	if (index < 0 || !GetAccessor(context, index, out, error))
+	{
+		return false;
+	}
+
+	if (out.Count != vertexCount)
+	{
+		error = "Attribute " + name + " has a different number of vertices than POSITION";
+		return false;
+	}
+
+	return true;
+}
+
+static aiMatrix4x4 MatrixFromColumnMajor(const float* m)
+{
+	return aiMatrix4x4(
+		m[0], m[4], m[8], m[12],
+		m[1], m[5], m[9], m[13],
+		m[2], m[6], m[10], m[14],
+		m[3], m[7], m[11], m[15]);
+}
+
+static aiMatrix4x4 GetNodeTransform(const SJsonValue& node)
+{
+	float matrix[16];
+	if (node.FindArray("matrix"))
+	{
+		std::fill(matrix, matrix + 16, 0.0f);
+		matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1.0f;
+		node.GetNumbers("matrix", matrix, 16);
+		return MatrixFromColumnMajor(matrix);
+	}
+
+	float translation[3] = { 0.0f, 0.0f, 0.0f };
+	float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	float scale[3] = { 1.0f, 1.0f, 1.0f };
+
+	node.GetNumbers("translation", translation, 3);
+	node.GetNumbers("rotation", rotation, 4);
+	node.GetNumbers("scale", scale, 3);
+
+	return aiMatrix4x4(
+		aiVector3D(scale[0], scale[1], scale[2]),
+		aiQuaternion(rotation[3], rotation[0], rotation[1], rotation[2]),
+		aiVector3D(translation[0], translation[1], translation[2]));
+}
+
+/** Mirrors a transform along the Z axis, same as
+ * aiProcess_ConvertToLeftHanded. */
+static void MakeLeftHanded(aiMatrix4x4& matrix)
+{
+	matrix.a3 = -matrix.a3;
+	matrix.b3 = -matrix.b3;
+	matrix.c1 = -matrix.c1;
+	matrix.c2 = -matrix.c2;
+	matrix.c4 = -matrix.c4;
+	matrix.d3 = -matrix.d3;
+}
+
+static void DecomposeNoScaling(const aiMatrix4x4& matrix, dual_quat_t out)
+{
+	aiQuaternion aiRot;
+	aiVector3D aiPos;
+	matrix.DecomposeNoScaling(aiRot, aiPos);
+
+	quat_t rot = { aiRot.x, aiRot.y, aiRot.z, aiRot.w };
+	vec3_t pos = { aiPos.x, aiPos.y, aiPos.z };
+
+	dual_quaternion_from_translation_rotation(out, pos, rot);
+}
+
+/** Sets a texture of a material to the URI of a texture's image. Embedded
+ * images are not extracted, so their textures are skipped. */
+static void AddTexture(
+	const SGlbContext& context,
+	const SJsonValue* textureInfo,
+	aiMaterial* material,
+	aiTextureType type)
+{
+	if (!textureInfo)
+	{
+		return;
+	}
+
+	const SJsonValue* texture = GetItem(*context.Json, "textures", textureInfo->GetInteger("index", -1));
+	const SJsonValue* image = texture ? GetItem(*context.Json, "images", texture->GetInteger("source", -1)) : nullptr;
+	std::string uri = image ? image->GetString("uri") : "";
+
+	if (uri.empty() || uri.rfind("data:", 0) == 0)
+	{
+		return;
+	}
+
+	aiString path(uri);
+	material->AddProperty(&path, AI_MATKEY_TEXTURE(type, 0));
+}
+
+/** Creates a material. Material `json` can be nullptr for the default
+ * material. */
+static aiMaterial* ConvertMaterial(const SGlbContext& context, const SJsonValue* json)
+{
+	aiMaterial* material = new aiMaterial();
+
+	aiString name(json ? json->GetString("name") : AI_DEFAULT_MATERIAL_NAME);
+	material->AddProperty(&name, AI_MATKEY_NAME);
+
+	float baseColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	const SJsonValue* pbr = json ? json->FindObject("pbrMetallicRoughness") : nullptr;
+
+	if (pbr)
+	{
+		pbr->GetNumbers("baseColorFactor", baseColor, 4);
+	}
+
+	aiColor4D color(baseColor[0], baseColor[1], baseColor[2], baseColor[3]);
+	material->AddProperty(&color, 1, AI_MATKEY_COLOR_DIFFUSE);
+	material->AddProperty(&color, 1, AI_MATKEY_BASE_COLOR);
+	material->AddProperty(&baseColor[3], 1, AI_MATKEY_OPACITY);
+
+	if (pbr)
+	{
+		AddTexture(context, pbr->FindObject("baseColorTexture"), material, aiTextureType_DIFFUSE);
+		AddTexture(context, pbr->FindObject("baseColorTexture"), material, aiTextureType_BASE_COLOR);
+		AddTexture(context, pbr->FindObject("metallicRoughnessTexture"), material, aiTextureType_UNKNOWN);
+	}
+
+	if (json)
+	{
+		AddTexture(context, json->FindObject("normalTexture"), material, aiTextureType_NORMALS);
+		AddTexture(context, json->FindObject("occlusionTexture"), material, aiTextureType_LIGHTMAP);
+		AddTexture(context, json->FindObject("emissiveTexture"), material, aiTextureType_EMISSIVE);
+	}
+
+	return material;
+}
+
+static const SJsonValue& GetPrimitive(const SGlbContext& context, size_t index)
+{
+	const std::pair<uint32_t, uint32_t>& primitive = context.Primitives[index];
+	const SJsonValue& mesh = context.Json->FindArray("meshes")->Array[primitive.first];
+	return mesh.FindArray("primitives")->Array[primitive.second];
+}
+
+/** Returns the name of the mesh created from a primitive. */
+static std::string GetPrimitiveName(const SGlbContext& context, size_t index)
+{
+	const std::pair<uint32_t, uint32_t>& primitive = context.Primitives[index];
+	const SJsonValue& mesh = context.Json->FindArray("meshes")->Array[primitive.first];
+
+	// Same as Assimp's glTF importer
+	std::string name = mesh.GetString("name");
+	if (name.empty())
+	{
+		name = "meshes_" + std::to_string(primitive.first);
+	}
+	if (mesh.FindArray("primitives")->Array.size() > 1)
+	{
+		name += "-" + std::to_string(primitive.second);
+	}
+	return name;
+}
+
+/** Returns the skin used with a primitive or nullptr if it is not skinned. */
+static const SJsonValue* GetPrimitiveSkin(const SGlbContext& context, size_t index)
+{
+	return GetItem(*context.Json, "skins", context.MeshSkins[context.Primitives[index].first]);
+}
+
+/** Returns properties of a material which Assimp compares when looking for
+ * redundant materials, i.e. all but its name. */
+static std::string GetMaterialKey(const aiMaterial* material)
+{
+	std::string key;
+	for (uint32_t i = 0; i < material->mNumProperties; ++i)
+	{
+		const aiMaterialProperty* property = material->mProperties[i];
+		if (property->mKey.data[0] == '?')
+		{
+			continue;
+		}
+		key.append(property->mKey.data, property->mKey.length + 1);
+		key.append((const char*)&property->mSemantic, sizeof(property->mSemantic));
+		key.append((const char*)&property->mIndex, sizeof(property->mIndex));
+		key.append(property->mData, property->mDataLength);
+	}
+	return key;
+}
+
+/**
+ * Converts materials of the file, followed by the default material if a
+ * primitive does not have one. With `optimize`, materials which are not used
+ * are removed and materials which differ from a previous one only in their
+ * name are merged into it, same as with aiProcess_RemoveRedundantMaterials.
+ *
+ * @param materials Set to the materials, which must be deleted by the caller.
+ * @param primitiveMaterials Set to the index of the material of each
+ * primitive in `materials`.
+ */
+static void ConvertMaterials(
+	const SGlbContext& context,
+	bool optimize,
+	std::vector<aiMaterial*>& materials,
+	std::vector<uint32_t>& primitiveMaterials)
+{
+	size_t materialCount = GetCount(*context.Json, "materials");
+	bool usesDefault = false;
+
+	primitiveMaterials.resize(context.Primitives.size());
+
+	for (size_t i = 0; i < context.Primitives.size(); ++i)
+	{
+		int64_t index = GetPrimitive(context, i).GetInteger("material", -1);
+		if (index < 0 || (size_t)index >= materialCount)
+		{
+			index = (int64_t)materialCount;
+			usesDefault = true;
+		}
+		primitiveMaterials[i] = (uint32_t)index;
+	}
+
+	std::vector<aiMaterial*> converted;
+
+	for (size_t i = 0; i < materialCount; ++i)
+	{
+		converted.push_back(ConvertMaterial(context, &context.Json->FindArray("materials")->Array[i]));
+	}
+
+	if (usesDefault)
+	{
+		converted.push_back(ConvertMaterial(context, nullptr));
+	}
+
+	if (!optimize)
+	{
+		materials.swap(converted);
+		return;
+	}
+
+	std::vector<bool> used(converted.size(), false);
+
+	for (uint32_t index : primitiveMaterials)
+	{
+		used[index] = true;
+	}
+
+	std::vector<uint32_t> materialMap(converted.size(), 0);
+	std::vector<std::string> keys(converted.size());
+
+	for (size_t i = 0; i < converted.size(); ++i)
+	{
+		if (!used[i])
+		{
+			delete converted[i];
+			continue;
+		}
+
+		keys[i] = GetMaterialKey(converted[i]);
+
+		for (size_t j = 0; j < i; ++j)
+		{
+			if (used[j] && keys[j] == keys[i])
+			{
+				materialMap[i] = materialMap[j];
+				delete converted[i];
+				converted[i] = nullptr;
+				break;
+			}
+		}
+
+		if (converted[i])
+		{
+			materialMap[i] = (uint32_t)materials.size();
+			materials.push_back(converted[i]);
+		}
+	}
+
+	for (uint32_t& index : primitiveMaterials)
+	{
+		index = materialMap[index];
+	}
+}
+
+/** Reads the inverse bind matrix of a joint of a skin. Joints of skins
+ * without inverse bind matrices have the identity. */
+static bool GetBindMatrix(
+	const SGlbContext& context,
+	const SJsonValue& skin,
+	uint32_t joint,
+	aiMatrix4x4& out,
+	std::string& error)
+{
+	out = aiMatrix4x4();
+
+	int64_t index = skin.GetInteger("inverseBindMatrices", -1);
+	if (index < 0)
+	{
+		return true;
+	}
+
+	SGlbAccessor accessor;
+	if (!GetAccessor(context, index, accessor, error))
+	{
+		return false;
+	}
+
+	const SJsonValue* joints = skin.FindArray("joints");
+	if (accessor.Components != 16 || !joints || accessor.Count < joints->Array.size())
+	{
+		error = "Inverse bind matrices of a skin are invalid";
+		return false;
+	}
+
+	float matrix[16];
+	ReadFloats(GetElement(accessor, joint), 16, matrix, 16);
+	out = MatrixFromColumnMajor(matrix);
+	return true;
+}
+
+/**
+ * Reads weights of joints on vertices of a primitive the same way as Assimp's
+ * glTF importer followed by aiProcess_LimitBoneWeights: each joint without
+ * weights gets a zero weight on the first vertex, only the four largest
+ * weights of a vertex are kept and renormalized and joints which lose all
+ * their weights this way are not bones of the mesh.
+ *
+ * @param weights Set to the weights, ordered by vertices and then by joints.
+ * @param bones Set to joints which are bones of the mesh, in ascending order.
+ *
+ * @return False with `error` set if the primitive or its skin is malformed.
+ */
+static bool ReadWeights(
+	const SGlbContext& context,
+	size_t index,
+	size_t vertexCount,
+	std::vector<SGlbWeight>& weights,
+	std::vector<uint32_t>& bones,
+	std::string& error)
+{
+	weights.clear();
+	bones.clear();
+
+	const SJsonValue* skin = GetPrimitiveSkin(context, index);
+	const SJsonValue* joints = skin ? skin->FindArray("joints") : nullptr;
+	size_t jointCount = joints ? joints->Array.size() : 0;
+
+	if (jointCount == 0)
+	{
+		return true;
+	}
+
+	for (size_t j = 0; j < jointCount; ++j)
+	{
+		int64_t node = joints->Array[j].AsInteger();
+		if (node < 0 || (size_t)node >= context.NodeNames.size())
+		{
+			error = "Joint " + std::to_string(j) + " of a skin does not exist";
+			return false;
+		}
+	}
+
+	const SJsonValue& primitive = GetPrimitive(context, index);
+
+	for (uint32_t s = 0; ; ++s)
+	{
+		SGlbAccessor jointsAccessor;
+		SGlbAccessor weightsAccessor;
+
+		if (!GetAttribute(context, primitive, "JOINTS_" + std::to_string(s), vertexCount, jointsAccessor, error)
+			|| !GetAttribute(context, primitive, "WEIGHTS_" + std::to_string(s), vertexCount, weightsAccessor, error))
+		{
+			if (!error.empty())
+			{
+				return false;
+			}
+			break;
+		}
+
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			uint32_t vertexJoints[4];
+			float vertexWeights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+			if (!ReadUints(GetElement(jointsAccessor, v), 4, vertexJoints))
+			{
+				error = "Mesh \"" + GetPrimitiveName(context, index) + "\" has invalid joints";
+				return false;
+			}
+			ReadFloats(GetElement(weightsAccessor, v), 4, vertexWeights, 4);
+
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				if (vertexWeights[c] <= 0.0f)
+				{
+					continue;
+				}
+
+				if (vertexJoints[c] >= jointCount)
+				{
+					error = "Mesh \"" + GetPrimitiveName(context, index) + "\" has a joint out of bounds";
+					return false;
+				}
+
+				weights.push_back({ (uint32_t)v, vertexJoints[c], vertexWeights[c] });
+			}
+		}
+	}
+
+	// Assimp expects each bone to have at least one weight
+	std::vector<bool> hasWeights(jointCount, false);
+
+	for (const SGlbWeight& weight : weights)
+	{
+		hasWeights[weight.Joint] = true;
+	}
+
+	for (size_t j = 0; j < jointCount; ++j)
+	{
+		if (!hasWeights[j])
+		{
+			weights.push_back({ 0, (uint32_t)j, 0.0f });
+		}
+	}
+
+	std::stable_sort(weights.begin(), weights.end(), [](const SGlbWeight& a, const SGlbWeight& b) {
+		return (a.Vertex < b.Vertex) || (a.Vertex == b.Vertex && a.Joint < b.Joint);
+	});
+
+	// Limit weights of each vertex
+	bool limited = false;
+	size_t end = 0;
+
+	for (size_t first = 0; first < weights.size(); )
+	{
+		size_t last = first;
+		while (last < weights.size() && weights[last].Vertex == weights[first].Vertex)
+		{
+			++last;
+		}
+
+		size_t count = last - first;
+
+		if (count > 4)
+		{
+			std::stable_sort(weights.begin() + first, weights.begin() + last, [](const SGlbWeight& a, const SGlbWeight& b) {
+				return a.Weight > b.Weight;
+			});
+
+			count = 4;
+
+			float sum = 0.0f;
+			for (size_t i = first; i < first + count; ++i)
+			{
+				sum += weights[i].Weight;
+			}
+			if (sum != 0.0f)
+			{
+				float invSum = 1.0f / sum;
+				for (size_t i = first; i < first + count; ++i)
+				{
+					weights[i].Weight *= invSum;
+				}
+			}
+
+			// Bones of a vertex are in the order of bones of the mesh
+			std::stable_sort(weights.begin() + first, weights.begin() + first + count, [](const SGlbWeight& a, const SGlbWeight& b) {
+				return a.Joint < b.Joint;
+			});
+
+			limited = true;
+		}
+
+		if (end != first)
+		{
+			std::copy(weights.begin() + first, weights.begin() + first + count, weights.begin() + end);
+		}
+
+		end += count;
+		first = last;
+	}
+
+	weights.resize(end);
+
+	std::fill(hasWeights.begin(), hasWeights.end(), !limited);
+
+	for (const SGlbWeight& weight : weights)
+	{
+		hasWeights[weight.Joint] = true;
+	}
+
+	for (size_t j = 0; j < jointCount; ++j)
+	{
+		if (hasWeights[j])
+		{
+			bones.push_back((uint32_t)j);
+		}
+	}
+
+	return true;
+}
+
+/** Encodes color into a single integer as ARGB, same as SMesh::FromAssimp. */
+static inline uint32_t EncodeColor(const float* color)
+{
+	return (uint32_t)(
+		((uint32_t)(color[3] * 255.0f) << 24) |
+		((uint32_t)(color[2] * 255.0f) << 16) |
+		((uint32_t)(color[1] * 255.0f) << 8) |
+		((uint32_t)(color[0] * 255.0f)));
+}
+
+/** Reads texture coordinates of a vertex and flips them the same way as
+ * Assimp's glTF importer, its post-processing and SMesh::FromAssimp. */
+static void ReadTextureCoords(const SGlbAccessor& accessor, size_t vertex, const SConfig& config, vec2_t out)
+{
+	float texture[2] = { 0.0f, 0.0f };
+	ReadFloats(GetElement(accessor, vertex), 2, texture, 2);
+
+	// Flipped by Assimp's glTF importer and back by aiProcess_FlipUVs, which
+	// is a part of aiProcess_ConvertToLeftHanded
+	texture[1] = 1.0f - texture[1];
+	if (config.LeftHanded)
+	{
+		texture[1] = 1.0f - texture[1];
+	}
+
+	if (config.FlipTextureHorizontally)
+	{
+		texture[0] = 1.0f - texture[0];
+	}
+	if (config.FlipTextureVertically)
+	{
+		texture[1] = 1.0f - texture[1];
+	}
+
+	out[0] = texture[0];
+	out[1] = texture[1];
+}
+
+/**
+ * Converts a primitive straight into a mesh of a model, without decoding
+ * whole accessors. Bones of the primitive must already be in the skeleton of
+ * the model. The mesh is the same as one created by SMesh::FromAssimp from a
+ * scene loaded by Assimp.
+ *
+ * @return The mesh or nullptr on failure, in which case `error` is set.
+ */
+static SMesh* ConvertPrimitive(
+	const SGlbContext& context,
+	size_t index,
+	uint32_t materialIndex,
+	SModel* model,
+	const SConfig& config,
+	std::string& error)
+{
+	const SJsonValue& primitive = GetPrimitive(context, index);
+	std::string name = GetPrimitiveName(context, index);
+
+	SGlbAccessor positions;
+	const SJsonValue* attributes = primitive.FindObject("attributes");
+	int64_t positionIndex = attributes ? attributes->GetInteger("POSITION", -1) : -1;
+
+	if (positionIndex < 0)
+	{
+		error = "Mesh \"" + name + "\" does not have positions";
+		return nullptr;
+	}
+
+	if (!GetAccessor(context, positionIndex, positions, error))
+	{
+		return nullptr;
+	}
+
+	size_t vertexCount = positions.Count;
+
+	if (positions.Components != 3 || vertexCount == 0 || vertexCount > UINT32_MAX)
+	{
+		error = "Mesh \"" + name + "\" has invalid positions";
+		return nullptr;
+	}
+
+	// Faces
+	int64_t mode = primitive.GetInteger("mode", BBMOD_GLTF_TRIANGLES);
+	uint32_t faceSize = (mode == BBMOD_GLTF_POINTS) ? 1 : ((mode == BBMOD_GLTF_LINES) ? 2 : 3);
+
+	SGlbAccessor indices;
+	int64_t indicesIndex = primitive.GetInteger("indices", -1);
+	size_t indexCount = vertexCount;
+
+	if (indicesIndex >= 0)
+	{
+		if (!GetAccessor(context, indicesIndex, indices, error))
+		{
+			return nullptr;
+		}
+
+		indexCount = indices.Count;
+
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			uint32_t vertex;
+			if (!ReadUints(GetElement(indices, i), 1, &vertex))
+			{
+				error = "Mesh \"" + name + "\" has invalid indices";
+				return nullptr;
+			}
+			if (vertex >= vertexCount)
+			{
+				error = "Mesh \"" + name + "\" has an index out of bounds";
+				return nullptr;
+			}
+		}
+	}
+
+	size_t faceCount = indexCount / faceSize;
+
+	if (faceCount == 0 || faceCount > UINT32_MAX)
+	{
+		error = "Mesh \"" + name + "\" does not have any faces";
+		return nullptr;
+	}
+
+	// Attributes
+	SGlbAccessor normals;
+	SGlbAccessor tangents;
+	SGlbAccessor textureCoords;
+	SGlbAccessor textureCoords2;
+	SGlbAccessor colors;
+
+	bool hasNormals = GetAttribute(context, primitive, "NORMAL", vertexCount, normals, error);
+	// Bitangents are computed from tangents' W, which requires normals
+	bool hasTangents = hasNormals
+		&& GetAttribute(context, primitive, "TANGENT", vertexCount, tangents, error)
+		&& tangents.Components == 4;
+	bool hasTextureCoords = GetAttribute(context, primitive, "TEXCOORD_0", vertexCount, textureCoords, error);
+	bool hasTextureCoords2 = hasTextureCoords
+		&& GetAttribute(context, primitive, "TEXCOORD_1", vertexCount, textureCoords2, error);
+	bool hasColors = GetAttribute(context, primitive, "COLOR_0", vertexCount, colors, error);
+
+	std::vector<SGlbWeight> weights;
+	std::vector<uint32_t> bones;
+
+	if (!error.empty()
+		|| (!config.DisableBones && !ReadWeights(context, index, vertexCount, weights, bones, error)))
+	{
+		return nullptr;
+	}
+
+	// Same as SMesh::FromAssimp
+	bool triangles = (faceSize == 3);
+
+	SVertexFormat* vertexFormat = new SVertexFormat();
+	vertexFormat->Vertices = true;
+	// Missing normals and tangents are always generated natively, since
+	// there is no Assimp mesh to run its post-processing on
+	bool genNormals = config.GenNormals != BBMOD_NORMALS_NONE && triangles;
+	vertexFormat->Normals = (hasNormals || genNormals) && !config.DisableNormals;
+	vertexFormat->TextureCoords = hasTextureCoords && !config.DisableTextureCoords;
+	vertexFormat->TextureCoords2 = hasTextureCoords2 && !config.DisableTextureCoords && !config.DisableTextureCoords2;
+	vertexFormat->Colors = hasColors && !config.DisableVertexColors;
+	bool genTangents = vertexFormat->Normals && vertexFormat->TextureCoords && triangles;
+	vertexFormat->TangentW = (hasTangents || genTangents) && !(config.DisableNormals || config.DisableTangentW);
+	vertexFormat->Bones = !bones.empty();
+	vertexFormat->Ids = false;
+
+	SMesh* mesh = new SMesh();
+	mesh->Model = model;
+	mesh->Name = name;
+	mesh->PrimitiveType = (faceSize == 1) ? pr_pointlist : ((faceSize == 2) ? pr_linelist : pr_trianglelist);
+	mesh->VertexFormat = vertexFormat;
+	mesh->MaterialIndex = materialIndex;
+
+	// Bone of each joint and where weights of each vertex start
+	std::vector<float> jointBones;
+	std::vector<uint32_t> weightOffsets;
+
+	if (vertexFormat->Bones)
+	{
+		const SJsonValue* joints = GetPrimitiveSkin(context, index)->FindArray("joints");
+		jointBones.resize(joints->Array.size(), 0.0f);
+
+		for (uint32_t joint : bones)
+		{
+			jointBones[joint] = model->FindBoneByName(context.NodeNames[joints->Array[joint].AsInteger()])->Index;
+		}
+
+		weightOffsets.resize(vertexCount + 1, 0);
+
+		for (const SGlbWeight& weight : weights)
+		{
+			++weightOffsets[weight.Vertex + 1];
+		}
+
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			weightOffsets[v + 1] += weightOffsets[v];
+		}
+	}
+
+	// aiProcess_ConvertToLeftHanded flips the winding order of faces
+	bool reverse = (config.LeftHanded != config.InvertWinding);
+	bool bboxFound = false;
+
+	mesh->Data.reserve(faceCount * faceSize);
+	mesh->SourceIndices.reserve(faceCount * faceSize);
+
+	for (size_t f = 0; f < faceCount; ++f)
+	{
+		for (uint32_t c = 0; c < faceSize; ++c)
+		{
+			size_t corner = f * faceSize + (reverse ? faceSize - 1 - c : c);
+			uint32_t idx = (uint32_t)corner;
+
+			if (indicesIndex >= 0)
+			{
+				ReadUints(GetElement(indices, corner), 1, &idx);
+			}
+
+			SVertex* vertex = new SVertex();
+			vertex->VertexFormat = vertexFormat;
+
+			// Vertex
+			ReadFloats(GetElement(positions, idx), 3, vertex->Position, 3);
+			if (config.LeftHanded)
+			{
+				vertex->Position[2] = -vertex->Position[2];
+			}
+
+			for (int i = 0; i < 3; ++i)
+			{
+				mesh->BboxMin[i] = bboxFound ? fminf(mesh->BboxMin[i], vertex->Position[i]) : vertex->Position[i];
+				mesh->BboxMax[i] = bboxFound ? fmaxf(mesh->BboxMax[i], vertex->Position[i]) : vertex->Position[i];
+			}
+			bboxFound = true;
+
+			// Normal
+			aiVector3D normal;
+			if (vertexFormat->Normals)
+			{
+				if (hasNormals)
+				{
+					ReadFloats(GetElement(normals, idx), 3, &normal.x, 3);
+					if (config.LeftHanded)
+					{
+						normal.z = -normal.z;
+					}
+				}
+				if (config.FlipNormals)
+				{
+					normal *= -1.0f;
+				}
+				vertex->Normal[0] = normal.x;
+				vertex->Normal[1] = normal.y;
+				vertex->Normal[2] = normal.z;
+			}
+
+			// Texture
+			if (vertexFormat->TextureCoords)
+			{
+				ReadTextureCoords(textureCoords, idx, config, vertex->Texture);
+			}
+
+			// Texture2
+			if (vertexFormat->TextureCoords2)
+			{
+				ReadTextureCoords(textureCoords2, idx, config, vertex->Texture2);
+			}
+
+			// Color
+			if (vertexFormat->Colors)
+			{
+				float color[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+				ReadFloats(GetElement(colors, idx), 4, color, 4);
+				vertex->Color = EncodeColor(color);
+			}
+
+			if (vertexFormat->TangentW)
+			{
+				if (hasTangents)
+				{
+					float tangentW[4];
+					aiVector3D sourceNormal;
+					ReadFloats(GetElement(tangents, idx), 4, tangentW, 4);
+					ReadFloats(GetElement(normals, idx), 3, &sourceNormal.x, 3);
+
+					aiVector3D tangent(tangentW[0], tangentW[1], tangentW[2]);
+					aiVector3D bitangent = (sourceNormal ^ tangent) * tangentW[3];
+
+					if (config.LeftHanded)
+					{
+						tangent.z = -tangent.z;
+						bitangent.z = -bitangent.z;
+					}
+
+					// Tangent
+					vertex->Tangent[0] = tangent.x;
+					vertex->Tangent[1] = tangent.y;
+					vertex->Tangent[2] = tangent.z;
+
+					// Bitangent sign
+					vertex->BitangentSign = ((normal ^ tangent) * bitangent < 0.0f) ? -1.0f : 1.0f;
+				}
+				else
+				{
+					vertex->BitangentSign = 1.0f;
+				}
+			}
+
+			if (vertexFormat->Bones)
+			{
+				// Bone indices and vertex weights
+				for (uint32_t w = weightOffsets[idx], j = 0; w < weightOffsets[idx + 1] && j < 4; ++w, ++j)
+				{
+					vertex->Bones[j] = jointBones[weights[w].Joint];
+					vertex->Weights[j] = weights[w].Weight;
+				}
+			}
+
+			mesh->Data.push_back(vertex);
+			mesh->SourceIndices.push_back(idx);
+		}
+	}
+
+	GenerateTangentSpace(mesh, hasNormals, hasTangents, config);
+
+	return mesh;
+}
+
+/** Creates a node of a model the same way as SModel::FromAssimp would from a
+ * node with given transform. */
+static SNode* CreateNode(SModel* model, const std::string& name, aiMatrix4x4 transform, bool isRoot, const SConfig& config)
+{
+	SNode* node = new SNode();
+	node->Name = name;
+
+	if (SBone* bone = model->FindBoneByName(node->Name))
+	{
+		node->Index = (float)bone->Index;
+		node->IsBone = true;
+	}
+	else
+	{
+		node->Index = (float)model->NodeCount++;
+		node->IsBone = false;
+	}
+
+	if (config.LeftHanded)
+	{
+		MakeLeftHanded(transform);
+	}
+
+	if (isRoot && config.ConvertToZUp)
+	{
+		// Same as ConvertToZUp in Importer.cpp
+		aiMatrix4x4 matrixZUp(
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, -1.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
+		transform *= matrixZUp;
+	}
+
+	DecomposeNoScaling(transform, node->Transform);
+
+	return node;
+}
+
+/** Converts a node and its descendants and adds it to the children of
+ * `parent` or makes it the root node of the model if `parent` is nullptr. */
+static bool ConvertNode(
+	const SGlbContext& context,
+	int64_t index,
+	SNode* parent,
+	SModel* model,
+	const SConfig& config,
+	std::vector<bool>& visited,
+	std::string& error)
+{
+	const SJsonValue* json = GetItem(*context.Json, "nodes", index);
+
+	if (!json || visited[index])
+	{
+		error = "Node " + std::to_string(index) + " does not exist or has multiple parents";
+		return false;
+	}
+
+	visited[index] = true;
+
+	SNode* node = CreateNode(model, context.NodeNames[index], GetNodeTransform(*json), !parent, config);
+
+	if (parent)
+	{
+		parent->Children.push_back(node);
+	}
+	else
+	{
+		model->RootNode = node;
+	}
+
+	int64_t meshIndex = json->GetInteger("mesh", -1);
+
+	if (meshIndex >= 0)
+	{
+		if ((size_t)meshIndex + 1 >= context.MeshOffsets.size())
+		{
+			error = "Mesh " + std::to_string(meshIndex) + " does not exist";
+			return false;
+		}
+
+		for (uint32_t i = context.MeshOffsets[meshIndex]; i < context.MeshOffsets[meshIndex + 1]; ++i)
+		{
+			node->Meshes.push_back(i);
+		}
+	}
+
+	const SJsonValue* children = json->FindArray("children");
+
+	for (size_t i = 0; children && i < children->Array.size(); ++i)
+	{
+		if (!ConvertNode(context, children->Array[i].AsInteger(), node, model, config, visited, error))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** Reads keyframe times and values of an animation sampler. Values of cubic
+ * spline samplers are read without their tangents. */
+static bool ReadSampler(
+	const SGlbContext& context,
+	const SJsonValue& sampler,
+	uint32_t components,
+	std::vector<float>& times,
+	std::vector<float>& values,
+	std::string& error)
+{
+	SGlbAccessor input;
+	SGlbAccessor output;
+
+	if (!GetAccessor(context, sampler.GetInteger("input", -1), input, error)
+		|| !GetAccessor(context, sampler.GetInteger("output", -1), output, error))
+	{
+		return false;
+	}
+
+	bool cubic = (sampler.GetString("interpolation") == "CUBICSPLINE");
+	size_t stride = cubic ? 3 : 1;
+
+	if (input.Components != 1 || output.Components != components || output.Count < input.Count * stride)
+	{
+		error = "An animation sampler is invalid";
+		return false;
+	}
+
+	times.resize(input.Count);
+	ReadFloats(input, 1, times.data(), 1);
+
+	std::vector<float> data(output.Count * components, 0.0f);
+	ReadFloats(output, components, data.data(), components);
+
+	values.resize(input.Count * components);
+
+	for (size_t i = 0; i < input.Count; ++i)
+	{
+		size_t source = (i * stride + (cubic ? 1 : 0)) * components;
+		std::copy(&data[source], &data[source] + components, &values[i * components]);
+	}
+
+	return true;
+}
+
+static aiAnimation* ConvertAnimation(
+	const SGlbContext& context,
+	const SJsonValue& json,
+	std::string& error)
+{
+	const SJsonValue* samplers = json.FindArray("samplers");
+	const SJsonValue* channels = json.FindArray("channels");
+
+	// Samplers of translation, rotation and scale of each animated node, in
+	// the order in which nodes first appear in channels
+	std::vector<int64_t> nodes;
+	std::map<int64_t, std::vector<int64_t>> nodeSamplers;
+
+	for (size_t i = 0; channels && i < channels->Array.size(); ++i)
+	{
+		const SJsonValue& channel = channels->Array[i];
+		const SJsonValue* target = channel.FindObject("target");
+		int64_t node = target ? target->GetInteger("node", -1) : -1;
+		std::string path = target ? target->GetString("path") : "";
+
+		int32_t slot = (path == "translation") ? 0 : ((path == "rotation") ? 1 : ((path == "scale") ? 2 : -1));
+
+		// Weights of morph targets are not read
+		if (node < 0 || slot < 0)
+		{
+			continue;
+		}
+
+		if ((size_t)node >= context.NodeNames.size())
+		{
+			error = "An animation channel targets a node which does not exist";
+			return nullptr;
+		}
+
+		auto it = nodeSamplers.find(node);
+		if (it == nodeSamplers.end())
+		{
+			nodes.push_back(node);
+			it = nodeSamplers.emplace(node, std::vector<int64_t>(3, -1)).first;
+		}
+		it->second[slot] = channel.GetInteger("sampler", -1);
+	}
+
+	aiAnimation* animation = new aiAnimation();
+	animation->mName = json.GetString("name");
+	// Same as Assimp's glTF importer
+	animation->mTicksPerSecond = 1000.0;
+	if (!nodes.empty())
+	{
+		animation->mChannels = new aiNodeAnim*[nodes.size()];
+	}
+
+	double duration = 0.0;
+	std::vector<float> times;
+	std::vector<float> values;
+
+	for (int64_t node : nodes)
+	{
+		const std::vector<int64_t>& slots = nodeSamplers[node];
+
+		aiNodeAnim* channel = new aiNodeAnim();
+		channel->mNodeName = context.NodeNames[node];
+		animation->mChannels[animation->mNumChannels++] = channel;
+
+		// Transforms which are not animated have a single key with the
+		// node's transform, as in Assimp's glTF importer
+		aiVector3D scaling;
+		aiQuaternion rotation;
+		aiVector3D position;
+		GetNodeTransform(*GetItem(*context.Json, "nodes", node)).Decompose(scaling, rotation, position);
+
+		for (uint32_t slot = 0; slot < 3; ++slot)
+		{
+			uint32_t components = (slot == 1) ? 4 : 3;
+			times.clear();
+			values.clear();
+
+			if (slots[slot] >= 0)
+			{
+				if (!samplers || (size_t)slots[slot] >= samplers->Array.size())
+				{
+					error = "An animation channel uses a sampler which does not exist";
+					delete animation;
+					return nullptr;
+				}
+				if (!ReadSampler(context, samplers->Array[slots[slot]], components, times, values, error))
+				{
+					delete animation;
+					return nullptr;
+				}
+			}
+
+			if (times.empty())
+			{
+				times.push_back(0.0f);
+				if (slot == 0)
+				{
+					values = { position.x, position.y, position.z };
+				}
+				else if (slot == 1)
+				{
+					values = { rotation.x, rotation.y, rotation.z, rotation.w };
+				}
+				else
+				{
+					values = { scaling.x, scaling.y, scaling.z };
+				}
+			}
+
+			uint32_t keyCount = (uint32_t)times.size();
+			duration = std::max(duration, times.back() * 1000.0);
+
+			if (slot == 1)
+			{
+				channel->mNumRotationKeys = keyCount;
+				channel->mRotationKeys = new aiQuatKey[keyCount];
+				for (uint32_t k = 0; k < keyCount; ++k)
+				{
+					const float* v = &values[k * 4];
+					channel->mRotationKeys[k].mTime = times[k] * 1000.0;
+					channel->mRotationKeys[k].mValue = aiQuaternion(v[3], v[0], v[1], v[2]);
+				}
+			}
+			else
+			{
+				aiVectorKey* keys = new aiVectorKey[keyCount];
+				for (uint32_t k = 0; k < keyCount; ++k)
+				{
+					const float* v = &values[k * 3];
+					keys[k].mTime = times[k] * 1000.0;
+					keys[k].mValue = aiVector3D(v[0], v[1], v[2]);
+				}
+
+				if (slot == 0)
+				{
+					channel->mNumPositionKeys = keyCount;
+					channel->mPositionKeys = keys;
+				}
+				else
+				{
+					channel->mNumScalingKeys = keyCount;
+					channel->mScalingKeys = keys;
+				}
+			}
+		}
+	}
+
+	animation->mDuration = duration;
+	return animation;
+}
+
+/** Mirrors keys of an animation along the Z axis, same as
+ * aiProcess_ConvertToLeftHanded. */
+static void MakeLeftHanded(aiAnimation* animation)
+{
+	for (uint32_t i = 0; i < animation->mNumChannels; ++i)
+	{
+		aiNodeAnim* channel = animation->mChannels[i];
+
+		for (uint32_t k = 0; k < channel->mNumPositionKeys; ++k)
+		{
+			channel->mPositionKeys[k].mValue.z *= -1.0f;
+		}
+
+		for (uint32_t k = 0; k < channel->mNumRotationKeys; ++k)
+		{
+			channel->mRotationKeys[k].mValue.x *= -1.0f;
+			channel->mRotationKeys[k].mValue.y *= -1.0f;
+		}
+	}
+}
+
+/** Finds names of nodes, primitives of meshes and skins used with meshes of
+ * a context with the file's JSON set. */
+static void InitContext(SGlbContext& context)
+{
+	const SJsonValue* nodes = context.Json->FindArray("nodes");
+	size_t nodeCount = nodes ? nodes->Array.size() : 0;
+
+	for (size_t i = 0; i < nodeCount; ++i)
+	{
+		std::string name = nodes->Array[i].GetString("name");
+		// Same as Assimp's glTF importer
+		context.NodeNames.push_back(name.empty() ? ("nodes_" + std::to_string(i)) : name);
+	}
+
+	const SJsonValue* meshes = context.Json->FindArray("meshes");
+	size_t meshCount = meshes ? meshes->Array.size() : 0;
+
+	context.MeshOffsets.push_back(0);
+
+	for (size_t i = 0; i < meshCount; ++i)
+	{
+		const SJsonValue* primitives = meshes->Array[i].FindArray("primitives");
+		size_t primitiveCount = primitives ? primitives->Array.size() : 0;
+
+		for (size_t p = 0; p < primitiveCount; ++p)
+		{
+			context.Primitives.emplace_back((uint32_t)i, (uint32_t)p);
+		}
+		context.MeshOffsets.push_back((uint32_t)context.Primitives.size());
+	}
+
+	// CheckSupport guarantees that each mesh is used with a single skin
+	context.MeshSkins.resize(meshCount, -1);
+
+	for (size_t i = 0; i < nodeCount; ++i)
+	{
+		int64_t mesh = nodes->Array[i].GetInteger("mesh", -1);
+		if (mesh >= 0 && (size_t)mesh < meshCount)
+		{
+			int64_t skin = nodes->Array[i].GetInteger("skin", -1);
+			if (skin >= 0)
+			{
+				context.MeshSkins[mesh] = skin;
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SGlbFile
+
+SGlbFile::~SGlbFile()
+{
+	if (Mapped && Data)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(Data);
+#else
+		munmap((void*)Data, Size);
+#endif
+	}
+
+	delete Json;
+}
+
+SGlbFile* SGlbFile::Open(const std::string& path, std::string& reason)
+{
+	SGlbFile* file = new SGlbFile();
+
+#ifdef _WIN32
+	HANDLE handle = CreateFileW(fs::path(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (handle != INVALID_HANDLE_VALUE)
+	{
+		LARGE_INTEGER size;
+		if (GetFileSizeEx(handle, &size) && size.QuadPart > 0)
+		{
+			HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping)
+			{
+				// The view keeps the mapping alive
+				file->Data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				file->Size = (size_t)size.QuadPart;
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(handle);
+	}
+#else
+	int descriptor = open(path.c_str(), O_RDONLY);
+
+	if (descriptor != -1)
+	{
+		struct stat status;
+		if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+		{
+			void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (data != MAP_FAILED)
+			{
+				file->Data = (const uint8_t*)data;
+				file->Size = (size_t)status.st_size;
+			}
+		}
+		close(descriptor);
+	}
+#endif
+
+	if (!file->Data)
+	{
+		reason = "Could not map the file into memory";
+		delete file;
+		return nullptr;
+	}
+
+	file->Mapped = true;
+
+	if (!file->Parse(reason))
+	{
+		delete file;
+		return nullptr;
+	}
+
+	return file;
+}
+
+SGlbFile* SGlbFile::FromMemory(const void* data, size_t size, std::string& reason)
+{
+	SGlbFile* file = new SGlbFile();
+	file->Data = (const uint8_t*)data;
+	file->Size = size;
+
+	if (!file->Parse(reason))
+	{
+		delete file;
+		return nullptr;
+	}
+
+	return file;
+}
+
+bool SGlbFile::Parse(std::string& reason)
+{
+	if (!Data || Size < 20)
+	{
+		reason = "The file is not a GLB file";
+		return false;
+	}
+
+	uint32_t header[3];
+	std::memcpy(header, Data, sizeof(header));
+
+	if (header[0] != BBMOD_GLB_MAGIC)
+	{
+		reason = "The file is not a GLB file";
+		return false;
+	}
+
+	if (header[1] != 2)
+	{
+		reason = "Only GLB version 2 is supported";
+		return false;
+	}
+
+	size_t length = std::min<size_t>(header[2], Size);
+	size_t offset = 12;
+	const char* json = nullptr;
+	size_t jsonSize = 0;
+
+	while (offset + 8 <= length)
+	{
+		uint32_t chunk[2];
+		std::memcpy(chunk, Data + offset, sizeof(chunk));
+		offset += 8;
+
+		if (chunk[0] > length - offset)
+		{
+			reason = "The file is truncated";
+			return false;
+		}
+
+		if (chunk[1] == BBMOD_GLB_CHUNK_JSON && !json)
+		{
+			json = (const char*)(Data + offset);
+			jsonSize = chunk[0];
+		}
+		else if (chunk[1] == BBMOD_GLB_CHUNK_BIN && !Bin)
+		{
+			Bin = Data + offset;
+			BinSize = chunk[0];
+		}
+
+		// Other chunks must be ignored
+		offset += ((size_t)chunk[0] + 3) & ~(size_t)3;
+	}
+
+	if (!json)
+	{
+		reason = "The file does not have a JSON chunk";
+		return false;
+	}
+
+	Json = new SJsonValue();
+	SJsonParser parser(json, json + jsonSize);
+
+	if (!parser.Parse(*Json))
+	{
+		reason = parser.Error;
+		return false;
+	}
+
+	if (Json->Type != BBMOD_JSON_OBJECT)
+	{
+		reason = "The JSON chunk is not an object";
+		return false;
+	}
+
+	return CheckSupport(reason);
+}
+
+bool SGlbFile::CheckSupport(std::string& reason) const
+{
+	const SJsonValue* asset = Json->FindObject("asset");
+
+	if (!asset || asset->GetString("version").rfind("2.", 0) != 0)
+	{
+		reason = "Only glTF 2.0 is supported";
+		return false;
+	}
+
+	if (const SJsonValue* extensions = Json->FindArray("extensionsRequired"))
+	{
+		if (!extensions->Array.empty())
+		{
+			reason = "Required extension \"" + extensions->Array[0].String + "\" is not supported";
+			return false;
+		}
+	}
+
+	if (const SJsonValue* buffers = Json->FindArray("buffers"))
+	{
+		for (size_t i = 0; i < buffers->Array.size(); ++i)
+		{
+			if (buffers->Array[i].Find("uri") || i > 0)
+			{
+				reason = "Buffers which are not embedded in the file are not supported";
+				return false;
+			}
+		}
+	}
+
+	if (const SJsonValue* accessors = Json->FindArray("accessors"))
+	{
+		for (const SJsonValue& accessor : accessors->Array)
+		{
+			if (accessor.Find("sparse"))
+			{
+				reason = "Sparse accessors are not supported";
+				return false;
+			}
+		}
+	}
+
+	if (const SJsonValue* meshes = Json->FindArray("meshes"))
+	{
+		for (const SJsonValue& mesh : meshes->Array)
+		{
+			const SJsonValue* primitives = mesh.FindArray("primitives");
+			for (size_t i = 0; primitives && i < primitives->Array.size(); ++i)
+			{
+				int64_t mode = primitives->Array[i].GetInteger("mode", BBMOD_GLTF_TRIANGLES);
+				if (mode != BBMOD_GLTF_POINTS && mode != BBMOD_GLTF_LINES && mode != BBMOD_GLTF_TRIANGLES)
+				{
+					reason = "Primitive mode " + std::to_string(mode) + " is not supported";
+					return false;
+				}
+			}
+		}
+	}
+
+	// Bones are stored in meshes, so a mesh can be used with a single skin only
+	std::map<int64_t, int64_t> meshSkins;
+
+	if (const SJsonValue* nodes = Json->FindArray("nodes"))
+	{
+		for (const SJsonValue& node : nodes->Array)
+		{
+			int64_t mesh = node.GetInteger("mesh", -1);
+			int64_t skin = node.GetInteger("skin", -1);
+
+			if (mesh < 0 || skin < 0)
+			{
+				continue;
+			}
+
+			auto it = meshSkins.find(mesh);
+			if (it != meshSkins.end() && it->second != skin)
+			{
+				reason = "Meshes used with multiple skins are not supported";
+				return false;
+			}
+			meshSkins[mesh] = skin;
+		}
+	}
+
+	return true;
+}
+
+bool SGlbFile::HasMorphTargets() const
+{
+	if (const SJsonValue* meshes = Json->FindArray("meshes"))
+	{
+		for (const SJsonValue& mesh : meshes->Array)
+		{
+			const SJsonValue* primitives = mesh.FindArray("primitives");
+			for (size_t i = 0; primitives && i < primitives->Array.size(); ++i)
+			{
+				const SJsonValue* targets = primitives->Array[i].FindArray("targets");
+				if (targets && !targets->Array.empty())
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+bool SGlbFile::CanConvert(const SConfig& config, bool animationsOnly, std::string& reason) const
+{
+	if (animationsOnly)
+	{
+		return true;
+	}
+
+	if (config.PreTransform)
+	{
+		reason = "Pre-transforming vertices is not supported";
+		return false;
+	}
+
+	if (config.VertexAnimation)
+	{
+		reason = "Vertex animation textures are not supported";
+		return false;
+	}
+
+	if (config.MorphTargets && HasMorphTargets())
+	{
+		reason = "Morph targets are not supported";
+		return false;
+	}
+
+	return true;
+}
+
+bool SGlbFile::ToAssimp(aiScene* scene, const SConfig& config, std::string& error) const
+{
+	SGlbContext context;
+	context.Json = Json;
+	context.Bin = Bin;
+	context.BinSize = BinSize;
+	InitContext(context);
+
+	// Materials
+	std::vector<aiMaterial*> materials;
+	std::vector<uint32_t> primitiveMaterials;
+	ConvertMaterials(context, config.OptimizeMaterials, materials, primitiveMaterials);
+
+	if (!materials.empty())
+	{
+		scene->mNumMaterials = (uint32_t)materials.size();
+		scene->mMaterials = new aiMaterial*[materials.size()];
+		std::copy(materials.begin(), materials.end(), scene->mMaterials);
+	}
+
+	// Animations
+	const SJsonValue* animations = Json->FindArray("animations");
+
+	if (animations && !animations->Array.empty())
+	{
+		scene->mAnimations = new aiAnimation*[animations->Array.size()];
+
+		for (const SJsonValue& json : animations->Array)
+		{
+			aiAnimation* animation = ConvertAnimation(context, json, error);
+			if (!animation)
+			{
+				return false;
+			}
+			if (animation->mNumChannels == 0)
+			{
+				delete animation;
+				continue;
+			}
+			if (config.LeftHanded)
+			{
+				MakeLeftHanded(animation);
+			}
+			scene->mAnimations[scene->mNumAnimations++] = animation;
+		}
+
+		if (scene->mNumAnimations == 0)
+		{
+			delete[] scene->mAnimations;
+			scene->mAnimations = nullptr;
+		}
+	}
+
+	return true;
+}
+
+SModel* SGlbFile::ToModel(const aiScene* scene, const SConfig& config, std::string& error, SProgress* progress) const
+{
+	SGlbContext context;
+	context.Json = Json;
+	context.Bin = Bin;
+	context.BinSize = BinSize;
+	InitContext(context);
+
+	std::unique_ptr<SModel> model(new SModel());
+	size_t primitiveCount = context.Primitives.size();
+
+	// Materials are converted only to find which are merged
+	std::vector<aiMaterial*> materials;
+	std::vector<uint32_t> primitiveMaterials;
+	ConvertMaterials(context, config.OptimizeMaterials, materials, primitiveMaterials);
+
+	for (aiMaterial* material : materials)
+	{
+		model->MaterialNames.push_back(material->GetName().C_Str());
+		delete material;
+	}
+
+	// Collect all bones, in the same order as SModel::FromAssimp
+	if (!config.DisableBones)
+	{
+		std::vector<std::vector<uint32_t>> primitiveBones(primitiveCount);
+		std::vector<std::string> errors(primitiveCount);
+
+		// Weights are read again by ConvertPrimitive, so that they are not
+		// kept in memory for all primitives at once
+		ParallelFor(primitiveCount, [&](size_t i) {
+			const SJsonValue* attributes = GetPrimitive(context, i).FindObject("attributes");
+			SGlbAccessor positions;
+			std::string positionsError;
+			std::vector<SGlbWeight> weights;
+
+			// Invalid positions are reported by ConvertPrimitive
+			if (attributes
+				&& GetAccessor(context, attributes->GetInteger("POSITION", -1), positions, positionsError))
+			{
+				ReadWeights(context, i, positions.Count, weights, primitiveBones[i], errors[i]);
+			}
+		});
+
+		for (size_t i = 0; i < primitiveCount; ++i)
+		{
+			if (!errors[i].empty())
+			{
+				error = errors[i];
+				return nullptr;
+			}
+
+			const SJsonValue* skin = GetPrimitiveSkin(context, i);
+
+			for (uint32_t joint : primitiveBones[i])
+			{
+				const std::string& name = context.NodeNames[skin->FindArray("joints")->Array[joint].AsInteger()];
+
+				if (model->FindBoneByName(name))
+				{
+					continue;
+				}
+
+				aiMatrix4x4 offset;
+				if (!GetBindMatrix(context, *skin, joint, offset, error))
+				{
+					return nullptr;
+				}
+				if (config.LeftHanded)
+				{
+					MakeLeftHanded(offset);
+				}
+
+				SBone* bone = new SBone();
+				bone->Name = name;
+				bone->Index = (float)model->BoneCount++;
+				DecomposeNoScaling(offset, bone->Offset);
+				model->Skeleton.push_back(bone);
+			}
+		}
+
+		model->NodeCount = model->BoneCount;
+	}
+
+	// Primitives are independent on each other and only read the skeleton,
+	// so they are converted on multiple threads
+	model->Meshes.resize(primitiveCount, nullptr);
+
+	std::vector<std::string> errors(primitiveCount);
+	std::atomic<uint32_t> meshesDone(0);
+	std::atomic<bool> failed(false);
+
+	ParallelFor(primitiveCount, [&](size_t i) {
+		if (failed || (progress && progress->IsCancelled()))
+		{
+			return;
+		}
+		model->Meshes[i] = ConvertPrimitive(context, i, primitiveMaterials[i], model.get(), config, errors[i]);
+		if (!model->Meshes[i])
+		{
+			failed = true;
+		}
+		if (progress)
+		{
+			progress->SetStep(++meshesDone, (uint32_t)primitiveCount);
+		}
+	});
+
+	if (progress && progress->IsCancelled())
+	{
+		error = "Cancelled";
+		return nullptr;
+	}
+
+	for (const std::string& meshError : errors)
+	{
+		if (!meshError.empty())
+		{
+			error = meshError;
+			return nullptr;
+		}
+	}
+
+	// Nodes
+	std::vector<int64_t> roots;
+	size_t nodeCount = context.NodeNames.size();
+	const SJsonValue* scenes = Json->FindArray("scenes");
+
+	if (scenes && !scenes->Array.empty())
+	{
+		const SJsonValue* sceneJson = GetItem(*Json, "scenes", Json->GetInteger("scene", 0));
+		const SJsonValue* sceneNodes = sceneJson ? sceneJson->FindArray("nodes") : nullptr;
+
+		for (size_t i = 0; sceneNodes && i < sceneNodes->Array.size(); ++i)
+		{
+			roots.push_back(sceneNodes->Array[i].AsInteger());
+		}
+	}
+	else
+	{
+		// Without scenes, all nodes without a parent are used
+		std::vector<bool> isChild(nodeCount, false);
+
+		for (size_t i = 0; i < nodeCount; ++i)
+		{
+			const SJsonValue* children = Json->FindArray("nodes")->Array[i].FindArray("children");
+			for (size_t c = 0; children && c < children->Array.size(); ++c)
+			{
+				int64_t child = children->Array[c].AsInteger();
+				if (child >= 0 && (size_t)child < nodeCount)
+				{
+					isChild[child] = true;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < nodeCount; ++i)
+		{
+			if (!isChild[i])
+			{
+				roots.push_back((int64_t)i);
+			}
+		}
+	}
+
+	if (roots.empty())
+	{
+		error = "The scene does not have any nodes";
+		return nullptr;
+	}
+
+	std::vector<bool> visited(nodeCount, false);
+	SNode* parent = nullptr;
+
+	if (roots.size() > 1)
+	{
+		// Same as Assimp's glTF importer
+		model->RootNode = CreateNode(model.get(), "ROOT", aiMatrix4x4(), true, config);
+		parent = model->RootNode;
+	}
+
+	for (int64_t root : roots)
+	{
+		if (!ConvertNode(context, root, parent, model.get(), config, visited, error))
+		{
+			return nullptr;
+		}
+	}
+
+	model->FinishConversion(scene, config);
+
+	return model.release();
+}
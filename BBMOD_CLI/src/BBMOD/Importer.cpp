@@ -1,18 +1,27 @@
 #include <BBMOD/Importer.hpp>
 #include <BBMOD/Model.hpp>
 #include <BBMOD/Animation.hpp>
+#include <BBMOD/AnimationPack.hpp>
+#include <BBMOD/BoneAtlas.hpp>
+#include <BBMOD/Compression.hpp>
+#include <BBMOD/GlbReader.hpp>
+#include <BBMOD/VertexAnimation.hpp>
 #include <terminal.hpp>
 
 #include <assimp/Importer.hpp>
+#include <assimp/ProgressHandler.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <string>
 #include <regex>
+#include <sstream>
 #include <vector>
 
 namespace fs = std::filesystem;
@@ -90,9 +99,731 @@ static void LogNode(std::ofstream& log, SModel* model, SNode* node, uint32_t ind
 	}
 }
 
-std::vector<const aiMaterialProperty*> g_unusedProps;
+/** Forwards progress of loading and post-processing a file from Assimp to
+ * SProgress and aborts loading when the conversion is cancelled. */
+struct SAssimpProgressHandler : public Assimp::ProgressHandler
+{
+	SAssimpProgressHandler(SProgress* progress)
+		: Progress(progress)
+	{
+	}
+
+	bool Update(float percentage) override
+	{
+		if (percentage >= 0.0f)
+		{
+			Progress->Fraction = std::min(percentage, 1.0f);
+		}
+		return !Progress->IsCancelled();
+	}
+
+	SProgress* Progress;
+};
+
+/** Returns true if the conversion was cancelled through `progress`, which
+ * can be nullptr. */
+static bool IsCancelled(const SProgress* progress)
+{
+	if (progress && progress->IsCancelled())
+	{
+		PRINT_WARNING("Conversion cancelled!");
+		return true;
+	}
+	return false;
+}
+
+/** Records a file written by the conversion to `progress`, which can be
+ * nullptr. */
+static void AddOutput(SProgress* progress, const std::string& path)
+{
+	if (progress)
+	{
+		progress->AddOutput(path);
+	}
+}
+
+/** Stores serialized data of a file in `out`, compressed into a container
+ * if SConfig::Compress is enabled. */
+static bool StoreFileData(const std::string& data, const SConfig& config, std::string& out)
+{
+	if (!config.Compress)
+	{
+		out = data;
+		return true;
+	}
+
+	std::ostringstream stream(std::ios::out | std::ios::binary);
+
+	if (!WriteContainer(stream, reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+		config.CompressionChunkSize, config.CompressionFilter))
+	{
+		return false;
+	}
 
-int ConvertToBBMOD(const char* fin, const char* fout, const SConfig& config)
+	out = stream.str();
+	return true;
+}
+
+/** Converts all animations of a scene and saves them to .bbanim files next to
+ * `fout`, or adds them to `pack` if it is not nullptr, or appends them to
+ * `memory` if it is not nullptr. Animations are also
+ * baked into `atlas` and `vat` if they are not nullptr. Morph target weights
+ * are resolved against meshes of `meshModel`, which can be nullptr. Each
+ * converted animation is reported to `progress`, which can be nullptr. */
+static int ConvertAnimations(
+	const aiScene* scene,
+	SModel* model,
+	const SModel* meshModel,
+	const char* fout,
+	const SConfig& config,
+	std::ostream& log,
+	SAnimationPack* pack,
+	SBoneAtlas* atlas,
+	SVertexAnimationTexture* vat,
+	std::vector<SMemoryFile>* memory,
+	SProgress* progress)
+{
+	uint32_t numOfAnimations = scene->mNumAnimations;
+
+	if (progress)
+	{
+		progress->SetStage(BBMOD_STAGE_ANIMATIONS);
+	}
+
+	bool parentSpace = (SAnimation::GetSpaces(config) & BBMOD_BONE_SPACE_PARENT);
+
+	if (numOfAnimations > 0 && config.ReduceKeys && !parentSpace)
+	{
+		PRINT_WARNING("Keyframe reduction requires animation optimization level 0 and no world-space nodes, animations will not be reduced!");
+	}
+
+	if (numOfAnimations > 0 && config.FrameIndex
+		&& (config.EliminateConstantTracks
+			|| config.AnimationQuantization != BBMOD_QUANTIZE_NONE
+			|| config.HalfFloatFrames))
+	{
+		PRINT_WARNING("Animation frames are saved with a frame index, constant tracks will not be eliminated and frames will not be quantized!");
+	}
+
+	if (numOfAnimations > 0 && config.AnimatedBounds && model->Meshes.empty())
+	{
+		PRINT_WARNING("Animated bounds require a model with meshes, they will not be saved!");
+	}
+
+	if (numOfAnimations > 0)
+	{
+		bool reduceKeys = (config.ReduceKeys && parentSpace);
+		bool quantize = (!config.FrameIndex
+			&& (config.AnimationQuantization != BBMOD_QUANTIZE_NONE || config.HalfFloatFrames));
+
+		log << "Animations:" << std::endl;
+		log << "===========" << std::endl;
+
+		for (uint32_t i = 0; i < numOfAnimations; ++i)
+		{
+			if (IsCancelled(progress))
+			{
+				return BBMOD_ERR_CANCELLED;
+			}
+
+			// Deleted once saved, added to the pack or baked
+			std::unique_ptr<SAnimation> animation(SAnimation::FromAssimp(scene->mAnimations[i], model, config));
+
+			if (!animation)
+			{
+				PRINT_ERROR("Failed to convert an animation to BBANIM!");
+				return BBMOD_ERR_CONVERSION_FAILED;
+			}
+
+			if (config.MorphTargets && meshModel)
+			{
+				animation->AddMorphTracks(scene->mAnimations[i], meshModel);
+			}
+
+			log << i << ": " << animation->Name;
+
+			if (!config.WorldSpaceNodes.empty() && animation->WorldSpaceNodes.empty())
+			{
+				PRINT_WARNING("No node matches \"%s\", world-space transforms will not be saved!",
+					config.WorldSpaceNodes.c_str());
+			}
+
+			if (reduceKeys)
+			{
+				SKeyReduction reduction = animation->ReduceKeys(config);
+				float ratio = (reduction.KeysBefore > 0)
+					? (float)reduction.KeysAfter / (float)reduction.KeysBefore
+					: 1.0f;
+
+				log << ", keys " << reduction.KeysBefore << " -> " << reduction.KeysAfter
+					<< " (" << (ratio * 100.0f) << "%)"
+					<< ", max. error " << reduction.MaxError;
+			}
+
+			std::string fname = GetAnimationFilename(animation.get(), i, fout, config.Prefix);
+
+			if (pack)
+			{
+				// Clips of different models often have the same name
+				fname = fs::path(fname).stem().string();
+				if (pack->Find(fname) != -1)
+				{
+					fname = fs::path(fout).stem().string() + "_" + fname;
+				}
+				if (pack->Find(fname) != -1)
+				{
+					fname += "_" + std::to_string(i);
+				}
+
+				std::string error;
+				if (!pack->Add(animation.get(), fname, config, error))
+				{
+					PRINT_ERROR("Could not add animation \"%s\" to the pack: %s",
+						animation->Name.c_str(), error.c_str());
+					return BBMOD_ERR_CONVERSION_FAILED;
+				}
+
+				log << ", packed as \"" << fname << "\"";
+			}
+			else if (memory)
+			{
+				std::ostringstream stream(std::ios::out | std::ios::binary);
+				SMemoryFile file;
+				file.Name = fname;
+
+				if (!animation->Save(stream, config) || !StoreFileData(stream.str(), config, file.Data))
+				{
+					PRINT_ERROR("Could not save animation \"%s\"!", animation->Name.c_str());
+					return BBMOD_ERR_SAVE_FAILED;
+				}
+
+				memory->push_back(std::move(file));
+			}
+			else if (!animation->Save(fname, config))
+			{
+				PRINT_ERROR("Could not save an animation to \"%s\"!", fname.c_str());
+				return BBMOD_ERR_SAVE_FAILED;
+			}
+
+			if (atlas && model->BoneCount > 0
+				&& !atlas->Add(animation.get(), fs::path(fname).stem().string()))
+			{
+				PRINT_ERROR("Animation \"%s\" could not be baked into the bone atlas!", animation->Name.c_str());
+				return BBMOD_ERR_CONVERSION_FAILED;
+			}
+
+			if (vat && !vat->Add(scene, scene->mAnimations[i], animation.get(), fs::path(fname).stem().string()))
+			{
+				PRINT_ERROR("Animation \"%s\" could not be baked into the vertex animation texture!", animation->Name.c_str());
+				return BBMOD_ERR_CONVERSION_FAILED;
+			}
+
+			if (quantize)
+			{
+				const SQuantizationError& error = animation->QuantizationError;
+
+				log << ", quantization error " << error.MaxTranslationError
+					<< " (translation), " << error.MaxRotationError << " deg (rotation)";
+
+				if (error.MaxTranslationError > config.KeyTranslationError
+					|| error.MaxRotationError > config.KeyRotationError)
+				{
+					PRINT_WARNING(
+						"Quantization error of animation \"%s\" (%f, %f deg) is larger than the key error tolerance!",
+						animation->Name.c_str(), error.MaxTranslationError, error.MaxRotationError);
+				}
+			}
+
+			if (!animation->FrameBounds.empty())
+			{
+				const std::vector<float>& bounds = animation->FrameBounds;
+				float volume = 0.0f;
+				for (size_t f = 0; f < bounds.size(); f += 6)
+				{
+					volume = std::max(volume,
+						(bounds[f + 3] - bounds[f]) * (bounds[f + 4] - bounds[f + 1]) * (bounds[f + 5] - bounds[f + 2]));
+				}
+				log << ", max. bounds volume " << volume;
+			}
+
+			if (!animation->MorphTracks.empty())
+			{
+				log << ", " << animation->MorphTracks.size() << " morph target track(s)";
+			}
+
+			for (const SAnimationLod& lod : animation->Lods)
+			{
+				log << ", LOD 1/" << lod.Divisor << " error " << lod.MaxError;
+			}
+
+			log << std::endl;
+
+			if (pack)
+			{
+				PRINT_SUCCESS("Animation \"%s\" added to the pack!", fname.c_str());
+			}
+			else if (memory)
+			{
+				PRINT_SUCCESS("Animation \"%s\" converted!", memory->back().Name.c_str());
+			}
+			else
+			{
+				PRINT_SUCCESS("Animation saved to \"%s\"!", fname.c_str());
+				AddOutput(progress, fname);
+			}
+
+			if (progress)
+			{
+				progress->SetStep(i + 1, numOfAnimations);
+			}
+		}
+
+		log << std::endl;
+	}
+
+	return BBMOD_SUCCESS;
+}
+
+/** Saves a bone atlas with all animations of a model next to `fout`. */
+static int SaveBoneAtlas(SBoneAtlas* atlas, const char* fout, const SConfig& config, SProgress* progress)
+{
+	if (!atlas)
+	{
+		return BBMOD_SUCCESS;
+	}
+
+	int result = BBMOD_SUCCESS;
+
+	if (!atlas->Clips.empty())
+	{
+		std::string fname = fs::path(fout).replace_extension(".bbatlas").string();
+		atlas->Format = config.BoneAtlas;
+
+		if (atlas->Save(fname))
+		{
+			PRINT_SUCCESS("Bone atlas %dx%d saved to \"%s\"!", (int)atlas->Width, (int)atlas->Height, fname.c_str());
+			AddOutput(progress, fname);
+		}
+		else
+		{
+			PRINT_ERROR("Could not save bone atlas to \"%s\"!", fname.c_str());
+			result = BBMOD_ERR_SAVE_FAILED;
+		}
+	}
+
+	return result;
+}
+
+/** Saves a vertex animation texture with all animations of a model next to
+ * `fout`. */
+static int SaveVertexAnimation(SVertexAnimationTexture* vat, const char* fout, SProgress* progress)
+{
+	if (!vat)
+	{
+		return BBMOD_SUCCESS;
+	}
+
+	int result = BBMOD_SUCCESS;
+
+	if (!vat->Clips.empty())
+	{
+		std::string fname = fs::path(fout).replace_extension(".bbvat").string();
+
+		if (vat->Save(fname))
+		{
+			PRINT_SUCCESS("Vertex animation texture %dx%d saved to \"%s\"!", (int)vat->Width, (int)vat->Height, fname.c_str());
+			AddOutput(progress, fname);
+		}
+		else
+		{
+			PRINT_ERROR("Could not save vertex animation texture to \"%s\"!", fname.c_str());
+			result = BBMOD_ERR_SAVE_FAILED;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * Loads a model or a skeleton, against which are resolved node indices in the
+ * animation-only mode. If a model references a shared skeleton, the skeleton
+ * is loaded from the same directory instead.
+ */
+static SModel* LoadReferenceModel(const std::string& path)
+{
+	if (fs::path(path).extension() == ".bbskel")
+	{
+		SModel* skeleton = SModel::LoadSkeleton(path);
+		if (skeleton)
+		{
+			skeleton->SkeletonName = fs::path(path).filename().string();
+		}
+		return skeleton;
+	}
+
+	SModel* model = SModel::Load(path, BBMOD_LOAD_NODES | BBMOD_LOAD_SKELETON);
+
+	if (model && model->SkeletonHash != 0)
+	{
+		fs::path skeletonPath = fs::path(path).parent_path() / model->SkeletonName;
+		SModel* skeleton = SModel::LoadSkeleton(skeletonPath.string());
+		if (!skeleton || skeleton->SkeletonHash != model->SkeletonHash)
+		{
+			delete skeleton;
+			delete model;
+			return nullptr;
+		}
+		skeleton->SkeletonName = model->SkeletonName;
+		delete model;
+		return skeleton;
+	}
+
+	return model;
+}
+
+/** Returns Assimp post-processing flags for given configuration. When
+ * `animationsOnly` is true, all mesh processing is skipped. */
+static int GetImportFlags(const SConfig& config, bool animationsOnly)
+{
+	int flags = (0
+		| aiProcess_PopulateArmatureData
+		| aiProcess_Triangulate
+		| aiProcess_LimitBoneWeights
+		| aiProcess_GenUVCoords
+		);
+
+	// With NativeTangentSpace, normals and tangents are generated in
+	// SModel::FromAssimp instead
+	if (!config.NativeTangentSpace)
+	{
+		flags |= aiProcess_CalcTangentSpace;
+
+		if (config.GenNormals == BBMOD_NORMALS_FLAT)
+		{
+			flags |= aiProcess_GenNormals;
+		}
+		else if (config.GenNormals >= BBMOD_NORMALS_SMOOTH)
+		{
+			flags |= aiProcess_GenSmoothNormals;
+		}
+	}
+
+	if (config.OptimizeMaterials)
+	{
+		flags |= aiProcess_RemoveRedundantMaterials;
+	}
+
+	if (config.OptimizeNodes)
+	{
+		flags |= aiProcess_OptimizeGraph;
+	}
+
+	if (config.OptimizeMeshes)
+	{
+		flags |= aiProcess_OptimizeMeshes;
+	}
+
+	if (config.LeftHanded)
+	{
+		flags |= aiProcess_ConvertToLeftHanded;
+	}
+
+	if (config.PreTransform)
+	{
+		flags |= aiProcess_PreTransformVertices;
+	}
+
+	if (config.ApplyScale)
+	{
+		flags |= aiProcess_GlobalScale;
+	}
+
+	if (animationsOnly)
+	{
+		// Only animations are converted, skip all mesh processing
+		flags &= (aiProcess_ConvertToLeftHanded | aiProcess_GlobalScale);
+	}
+
+	return flags;
+}
+
+/** Returns true if a path has the .glb extension. */
+static bool IsGlb(const std::string& path)
+{
+	std::string extension = std::filesystem::path(path).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(),
+		[](unsigned char c) { return (char)std::tolower(c); });
+	return (extension == ".glb");
+}
+
+/** Reads materials and animations of a GLB file into a new scene. Returns
+ * nullptr with `reason` set and deletes the file if it should be loaded by
+ * Assimp instead. */
+static aiScene* ReadGlb(
+	std::unique_ptr<SGlbFile>& glb, const SConfig& config, bool animationsOnly, std::string& reason)
+{
+	if (!glb->CanConvert(config, animationsOnly, reason))
+	{
+		glb.reset();
+		return nullptr;
+	}
+
+	std::unique_ptr<aiScene> scene = std::make_unique<aiScene>();
+	if (!glb->ToAssimp(scene.get(), config, reason))
+	{
+		glb.reset();
+		return nullptr;
+	}
+
+	return scene.release();
+}
+
+/** Tells which options are applied differently to GLB files read natively. */
+static void PrintNativeGlbInfo(const SConfig& config)
+{
+	bool optimize = (config.OptimizeNodes || config.OptimizeMeshes);
+
+	if (optimize && !config.NativeTangentSpace)
+	{
+		PRINT_INFO("GLB files are read natively, their nodes and meshes are not optimized and missing normals and tangents are generated as with -nts.");
+	}
+	else if (optimize)
+	{
+		PRINT_INFO("GLB files are read natively, their nodes and meshes are not optimized.");
+	}
+	else if (!config.NativeTangentSpace)
+	{
+		PRINT_INFO("GLB files are read natively, their missing normals and tangents are generated as with -nts.");
+	}
+}
+
+/** Rotates the root node of a scene from Y-up to Z-up. */
+static void ConvertToZUp(const aiScene* scene)
+{
+	aiMatrix4x4 matrixZUp(
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, -1.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	);
+	scene->mRootNode->mTransformation *= matrixZUp;
+}
+
+/** Writes a material in the BBMAT format into `bbmat`. */
+static void WriteMaterial(aiMaterial* mat, const SConfig& config, std::ostream& bbmat)
+{
+	std::vector<const aiMaterialProperty*> unusedProps;
+
+	aiColor3D matColor(1.0f, 1.0f, 1.0f);
+	mat->Get(AI_MATKEY_COLOR_DIFFUSE, matColor);
+
+	float matOpacity = 1.0f;
+	mat->Get(AI_MATKEY_OPACITY, matOpacity);
+
+	std::string matBaseOpacity;
+	std::string matNormalRoughness;
+	std::string matMetallicAO;
+	std::string matSpecularColor;
+	std::string matNormalSmoothness;
+	std::string matEmissive;
+	std::string matSubsurface;
+	std::string matLightmap;
+
+	const aiMaterialProperty* prop;
+
+	// Try to get the diffuse texture
+	if (aiGetMaterialProperty(mat, AI_MATKEY_TEXTURE_DIFFUSE(0), &prop) == AI_SUCCESS
+		&& prop->mType == aiPTI_String)
+	{
+		aiString s;
+		aiGetMaterialString(mat, prop->mKey.data, prop->mSemantic, prop->mIndex, &s);
+		std::string str(s.C_Str());
+		if (str[0] != '*')
+		{
+			std::replace(str.begin(), str.end(), '\\', '/');
+			matBaseOpacity = str;
+		}
+	}
+
+	// Try to get other textures from their naming conventions
+	for (int j = 0; j < mat->mNumProperties; ++j)
+	{
+		prop = mat->mProperties[j];
+
+		if (prop->mKey != aiString(_AI_MATKEY_TEXTURE_BASE)
+			&& (prop->mSemantic != aiTextureType_DIFFUSE || prop->mIndex != 0))
+		{
+			unusedProps.push_back(prop);
+			continue;
+		}
+
+		aiString s;
+		aiGetMaterialString(mat, prop->mKey.data, prop->mSemantic, prop->mIndex, &s);
+
+		std::string str(s.C_Str());
+		std::replace(str.begin(), str.end(), '\\', '/');
+
+		std::string strLower(str);
+		std::transform(strLower.begin(), strLower.end(), strLower.begin(),
+			[](unsigned char c){ return std::tolower(c); });
+		std::string fname = fs::path(strLower).filename().string();
+
+		if (fname.rfind("normalroughness") != std::string::npos)
+		{
+			matNormalRoughness = str;
+		}
+		else if (fname.rfind("metallicao") != std::string::npos)
+		{
+			matMetallicAO = str;
+		}
+		else if (fname.rfind("normalsmoothness") != std::string::npos)
+		{
+			matNormalSmoothness = str;
+		}
+		else if (fname.rfind("specular") != std::string::npos)
+		{
+			matSpecularColor = str;
+		}
+		else if (fname.rfind("emissive") != std::string::npos)
+		{
+			matEmissive = str;
+		}
+		else if (fname.rfind("subsurface") != std::string::npos)
+		{
+			matSubsurface = str;
+		}
+		else if (fname.rfind("lightmap") != std::string::npos)
+		{
+			matLightmap = str;
+		}
+		else
+		{
+			unusedProps.push_back(prop);
+		}
+	}
+
+	bbmat << "{\n";
+	bbmat << "    \"__MaterialName\": \"BBMOD_MATERIAL_DEFAULT" << (!matLightmap.empty() ? "_LIGHTMAP" : "") << "\",\n";
+	bbmat << "    \"RenderQueue\": \"Default\"";
+
+	bbmat << ",\n    \"BaseOpacityMultiplier\": {\n";
+	bbmat << "        \"Red\": " << matColor.r * 255.0f << ",\n";
+	bbmat << "        \"Green\": " << matColor.g * 255.0f  << ",\n";
+	bbmat << "        \"Blue\": " << matColor.b * 255.0f  << ",\n";
+	bbmat << "        \"Alpha\": " << matOpacity << "\n";
+	bbmat << "    }";
+
+	bbmat << ",\n    \"Shaders\": {\n";
+	bbmat << "        \"Shadows\": \"BBMOD_SHADER_DEFAULT_DEPTH\",\n";
+	bbmat << "        \"DepthOnly\": \"BBMOD_SHADER_DEFAULT_DEPTH\",\n";
+	bbmat << "        \"Id\": \"BBMOD_SHADER_INSTANCE_ID\"\n";
+	bbmat << "    }";
+
+	if (!matBaseOpacity.empty()
+		|| !matNormalRoughness.empty()
+		|| !matMetallicAO.empty()
+		|| !matNormalSmoothness.empty()
+		|| !matSpecularColor.empty()
+		|| !matEmissive.empty()
+		|| !matSubsurface.empty()
+		|| !matLightmap.empty())
+	{
+		bbmat << ",\n    \"__Textures\": {";
+
+		bool hasPrev = false;
+		if (!matBaseOpacity.empty())
+		{
+			bbmat << "\n        \"BaseOpacity\": \"" << matBaseOpacity << "\"";
+			hasPrev = true;
+		}
+
+		if (!matNormalRoughness.empty())
+		{
+			if (hasPrev) { bbmat << ","; }
+			bbmat << "\n        \"NormalRoughness\": \"" << matNormalRoughness << "\"";
+			hasPrev = true;
+		}
+
+		if (!matMetallicAO.empty())
+		{
+			if (hasPrev) { bbmat << ","; }
+			bbmat << "\n        \"MetallicAO\": \"" << matMetallicAO << "\"";
+			hasPrev = true;
+		}
+		
+		if (!matNormalSmoothness.empty())
+		{
+			if (hasPrev) { bbmat << ","; }
+			bbmat << "\n        \"NormalSmoothness\": \"" << matNormalSmoothness << "\"";
+			hasPrev = true;
+		}
+
+		if (!matSpecularColor.empty())
+		{
+			if (hasPrev) { bbmat << ","; }
+			bbmat << "\n        \"SpecularColor\": \"" << matSpecularColor << "\"";
+			hasPrev = true;
+		}
+
+		if (!matEmissive.empty())
+		{
+			if (hasPrev) { bbmat << ","; }
+			bbmat << "\n        \"Emissive\": \"" << matEmissive << "\"";
+			hasPrev = true;
+		}
+
+		if (!matSubsurface.empty())
+		{
+			if (hasPrev) { bbmat << ","; }
+			bbmat << "\n        \"Subsurface\": \"" << matSubsurface << "\"";
+			hasPrev = true;
+		}
+
+		if (!matLightmap.empty())
+		{
+			if (hasPrev) { bbmat << ","; }
+			bbmat << "\n        \"Lightmap\": \"" << matLightmap << "\"";
+			hasPrev = true;
+		}
+
+		bbmat << "\n    }";
+	}
+
+	if (config.SaveUnused
+		&& !unusedProps.empty())
+	{
+		bbmat << ",\n    \"__Unused\": [";
+
+		bool hasPrev = false;
+		for (const aiMaterialProperty* prop : unusedProps)
+		{
+			if (prop->mType != aiPTI_String) continue;
+
+			if (hasPrev) { bbmat << ","; }
+
+			bbmat << "\n        {\"Key\": \"" << prop->mKey.C_Str() << "\""
+				<< ", \"Semantic\": " << prop->mSemantic
+				<< ", \"Index\": " << prop->mIndex
+				<< ", \"Value\": ";
+
+			aiString s;
+			aiGetMaterialString(mat, prop->mKey.data, prop->mSemantic, prop->mIndex, &s);
+			std::string ss(s.C_Str());
+			std::replace(ss.begin(), ss.end(), '\\', '/');
+			bbmat << "\"" << ss.c_str() << "\"";
+
+			bbmat << "}";
+
+			hasPrev = true;
+		}
+
+		bbmat << "\n    ]";
+	}
+
+	bbmat << "\n}\n";
+}
+
+int ConvertToBBMOD(const char* fin, const char* fout, const SConfig& config, SProgress* progress)
 {
 	std::vector<fs::path> files;
 
@@ -110,11 +841,69 @@ int ConvertToBBMOD(const char* fin, const char* fout, const SConfig& config)
 		files.push_back(pathIn);
 	}
 
-	fs::path pathOut(fout);
-	bool foutIsDirectory = fs::is_directory(pathOut);
+	fs::path pathOut(fout);
+	bool foutIsDirectory = fs::is_directory(pathOut);
+
+	// Animation-only mode
+	std::unique_ptr<SModel> reference;
+
+	if (!config.ReferenceModel.empty())
+	{
+		reference.reset(LoadReferenceModel(config.ReferenceModel));
+
+		if (!reference)
+		{
+			PRINT_ERROR("Could not load reference model \"%s\"!", config.ReferenceModel.c_str());
+			return BBMOD_ERR_LOAD_FAILED;
+		}
+	}
+
+	if (reference && config.VertexAnimation)
+	{
+		PRINT_WARNING("Vertex animation textures require meshes, they will not be baked in the animation-only mode!");
+	}
+
+	if (reference && config.MorphTargets)
+	{
+		PRINT_WARNING("Morph target weights require meshes, they will not be saved in the animation-only mode!");
+	}
+
+	// Animation pack
+	std::unique_ptr<SAnimationPack> pack;
+	fs::path pathPack(fout);
+
+	if (config.AnimationPack)
+	{
+		pack = std::make_unique<SAnimationPack>();
+
+		if (foutIsDirectory)
+		{
+			fs::path name = pathIn.filename().empty()
+				? pathIn.parent_path().filename()
+				: pathIn.filename();
+			pathPack /= name;
+		}
+		pathPack.replace_extension(".bbpack");
+	}
+
+	// Printed only for the first GLB file read natively
+	bool nativeGlbInfo = false;
 
-	for (const fs::path& file : files)
+	for (size_t fileIndex = 0; fileIndex < files.size(); ++fileIndex)
 	{
+		const fs::path& file = files[fileIndex];
+
+		std::error_code errorCode;
+		if (reference && fs::equivalent(file, config.ReferenceModel, errorCode))
+		{
+			continue;
+		}
+
+		if (progress)
+		{
+			progress->BeginFile((uint32_t)fileIndex, (uint32_t)files.size());
+		}
+
 		std::string finCurrent = file.string();
 		fs::path pathInCurrent(file);
 		fs::path pathOutCurrent(fout);
@@ -128,94 +917,247 @@ int ConvertToBBMOD(const char* fin, const char* fout, const SConfig& config)
 		std::string pathOutCurrentStr = pathOutCurrent.string();
 		const char* foutCurrent = pathOutCurrentStr.c_str();
 
-		std::ofstream log(GetFilename(foutCurrent, "log", ".txt", config.Prefix), std::ios::out);
+		std::ofstream log;
 
-		Assimp::Importer* importer = new Assimp::Importer();
-		importer->SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
+		std::unique_ptr<SBoneAtlas> atlas;
 
-		int flags = (0
-			| aiProcess_PopulateArmatureData
-			| aiProcess_Triangulate
-			| aiProcess_CalcTangentSpace
-			| aiProcess_LimitBoneWeights
-			| aiProcess_GenUVCoords
-			);
-
-		if (config.GenNormals == BBMOD_NORMALS_FLAT)
+		if (config.BoneAtlas != BBMOD_ATLAS_NONE)
 		{
-			flags |= aiProcess_GenNormals;
+			atlas = std::make_unique<SBoneAtlas>();
 		}
-		else if (config.GenNormals >= BBMOD_NORMALS_SMOOTH)
+
+		if (!reference)
 		{
-			flags |= aiProcess_GenSmoothNormals;
+			log.open(GetFilename(foutCurrent, "log", ".txt", config.Prefix), std::ios::out);
 		}
 
-		if (config.OptimizeMaterials)
+		const aiScene* scene = nullptr;
+
+		// Meshes of GLB files read natively are converted straight from the
+		// file, the scene holds only their materials and animations
+		std::unique_ptr<SGlbFile> glb;
+		std::unique_ptr<aiScene> glbScene;
+
+		if (config.NativeGlb && IsGlb(finCurrent))
 		{
-			flags |= aiProcess_RemoveRedundantMaterials;
+			std::string reason;
+			glb.reset(SGlbFile::Open(finCurrent, reason));
+			if (glb)
+			{
+				glbScene.reset(ReadGlb(glb, config, reference != nullptr, reason));
+				scene = glbScene.get();
+			}
+			if (scene && !reference && !nativeGlbInfo)
+			{
+				PrintNativeGlbInfo(config);
+				nativeGlbInfo = true;
+			}
+			if (!scene)
+			{
+				PRINT_WARNING("Cannot read \"%s\" natively (%s), falling back to Assimp!",
+					finCurrent.c_str(), reason.c_str());
+			}
 		}
 
-		if (config.OptimizeNodes)
+		// Owns the scene when the file is loaded by Assimp
+		std::unique_ptr<Assimp::Importer> importer;
+
+		if (!scene && !IsCancelled(progress))
 		{
-			flags |= aiProcess_OptimizeGraph;
+			importer = std::make_unique<Assimp::Importer>();
+			importer->SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
+
+			if (progress)
+			{
+				// The importer takes ownership of the handler
+				importer->SetProgressHandler(new SAssimpProgressHandler(progress));
+			}
+
+			if (reference)
+			{
+				importer->SetPropertyBool(AI_CONFIG_IMPORT_FBX_READ_ALL_GEOMETRY_LAYERS, false);
+				importer->SetPropertyBool(AI_CONFIG_IMPORT_FBX_READ_MATERIALS, false);
+				importer->SetPropertyBool(AI_CONFIG_IMPORT_FBX_READ_TEXTURES, false);
+				importer->SetPropertyBool(AI_CONFIG_IMPORT_FBX_READ_CAMERAS, false);
+				importer->SetPropertyBool(AI_CONFIG_IMPORT_FBX_READ_LIGHTS, false);
+				importer->SetPropertyBool(AI_CONFIG_IMPORT_FBX_READ_WEIGHTS, false);
+			}
+
+			scene = importer->ReadFile(finCurrent, GetImportFlags(config, reference != nullptr));
 		}
 
-		if (config.OptimizeMeshes)
+		if (!scene)
 		{
-			flags |= aiProcess_OptimizeMeshes;
+			if (IsCancelled(progress))
+			{
+				return BBMOD_ERR_CANCELLED;
+			}
+			PRINT_ERROR("Failed to load model \"%s\"!", finCurrent.c_str());
+			return BBMOD_ERR_LOAD_FAILED;
 		}
 
-		if (config.LeftHanded)
+		if (config.ConvertToZUp && !glb)
 		{
-			flags |= aiProcess_ConvertToLeftHanded;
+			// The GLB reader rotates its root node itself
+			ConvertToZUp(scene);
 		}
 
-		if (config.PreTransform)
+		if (reference)
 		{
-			flags |= aiProcess_PreTransformVertices;
+			for (uint32_t i = 0; i < scene->mNumAnimations; ++i)
+			{
+				aiAnimation* animation = scene->mAnimations[i];
+				for (uint32_t j = 0; j < animation->mNumChannels; ++j)
+				{
+					const char* name = animation->mChannels[j]->mNodeName.C_Str();
+					if (!reference->FindNodeByName(name, reference->RootNode)
+						&& reference->NodeIsImportant(name))
+					{
+						PRINT_WARNING("Node \"%s\" is not in the reference model, its animation will be skipped!", name);
+						reference->NodeImportanceMap[name] = false;
+					}
+				}
+			}
+
+			int result = ConvertAnimations(scene, reference.get(), nullptr, foutCurrent, config, log, pack.get(), atlas.get(), nullptr, nullptr, progress);
+			if (result == BBMOD_SUCCESS)
+			{
+				result = SaveBoneAtlas(atlas.get(), foutCurrent, config, progress);
+			}
+			if (result != BBMOD_SUCCESS)
+			{
+				return result;
+			}
+
+			continue;
 		}
 
-		if (config.ApplyScale)
+		// Write BBMOD
+		if (progress)
 		{
-			flags |= aiProcess_GlobalScale;
+			progress->SetStage(BBMOD_STAGE_MESHES);
 		}
 
-		const aiScene* scene = importer->ReadFile(finCurrent, flags);
+		std::string error;
+		std::unique_ptr<SModel> model(glb
+			? glb->ToModel(scene, config, error, progress)
+			: SModel::FromAssimp(scene, config, progress));
 
-		if (!scene)
+		if (IsCancelled(progress))
 		{
-			delete importer;
-			PRINT_ERROR("Failed to load model \"%s\"!", finCurrent.c_str());
-			return BBMOD_ERR_LOAD_FAILED;
+			return BBMOD_ERR_CANCELLED;
 		}
 
-		if (config.ConvertToZUp)
+		if (!model)
 		{
-			aiMatrix4x4 matrixZUp(
-				1.0f, 0.0f, 0.0f, 0.0f,
-				0.0f, 0.0f, -1.0f, 0.0f,
-				0.0f, 1.0f, 0.0f, 0.0f,
-				0.0f, 0.0f, 0.0f, 1.0f
-			);
-			scene->mRootNode->mTransformation *= matrixZUp;
+			if (!error.empty())
+			{
+				PRINT_ERROR("Failed to convert the model \"%s\" to BBMOD: %s", finCurrent.c_str(), error.c_str());
+			}
+			else
+			{
+				PRINT_ERROR("Failed to convert the model \"%s\" to BBMOD!", finCurrent.c_str());
+			}
+			return BBMOD_ERR_CONVERSION_FAILED;
 		}
 
-		// Write BBMOD
-		SModel* model = SModel::FromAssimp(scene, config);
+		// The file is no longer needed, only the scene is
+		glb.reset();
 
-		if (!model)
+		// Shared skeleton
+		std::unique_ptr<SModel> skeleton;
+
+		if (!config.SharedSkeleton.empty() && model->BoneCount > 0)
 		{
-			PRINT_ERROR("Failed to convert the model \"%s\" to BBMOD!", finCurrent.c_str());
-			return BBMOD_ERR_CONVERSION_FAILED;
+			skeleton.reset(SModel::LoadSkeleton(config.SharedSkeleton));
+
+			if (skeleton)
+			{
+				PRINT_INFO("Using skeleton \"%s\".", config.SharedSkeleton.c_str());
+
+				std::vector<std::string> mismatches = model->FindBindPoseMismatches(skeleton.get());
+				if (!mismatches.empty())
+				{
+					PRINT_WARNING("Bind pose of %d bone(s) differs from the skeleton, e.g. \"%s\"!",
+						(int)mismatches.size(), mismatches[0].c_str());
+				}
+			}
+			else if (fs::exists(config.SharedSkeleton))
+			{
+				PRINT_ERROR("Could not load skeleton \"%s\"!", config.SharedSkeleton.c_str());
+				return BBMOD_ERR_LOAD_FAILED;
+			}
+			else
+			{
+				skeleton.reset(model->ExtractSkeleton());
+
+				if (!skeleton->SaveSkeleton(config.SharedSkeleton))
+				{
+					PRINT_ERROR("Could not save skeleton to \"%s\"!", config.SharedSkeleton.c_str());
+					return BBMOD_ERR_SAVE_FAILED;
+				}
+
+				PRINT_SUCCESS("Skeleton saved to \"%s\"!", config.SharedSkeleton.c_str());
+				AddOutput(progress, config.SharedSkeleton);
+			}
+
+			skeleton->SkeletonName = fs::path(config.SharedSkeleton).filename().string();
+
+			std::string error;
+			if (!model->ApplySkeleton(skeleton.get(), error))
+			{
+				PRINT_ERROR("Model \"%s\" is not compatible with skeleton \"%s\": %s",
+					finCurrent.c_str(), config.SharedSkeleton.c_str(), error.c_str());
+				return BBMOD_ERR_CONVERSION_FAILED;
+			}
+		}
+		else if (!config.SharedSkeleton.empty())
+		{
+			PRINT_WARNING("Model \"%s\" does not have any bones, skeleton \"%s\" will not be used!",
+				finCurrent.c_str(), config.SharedSkeleton.c_str());
+		}
+
+		// Vertex animation texture
+		std::unique_ptr<SVertexAnimationTexture> vat;
+
+		if (config.VertexAnimation && !config.DisableBones && scene->mNumAnimations > 0)
+		{
+			if (model->Meshes.empty())
+			{
+				PRINT_WARNING("Model \"%s\" does not have any meshes, vertex animation texture will not be baked!",
+					finCurrent.c_str());
+			}
+			else
+			{
+				for (SMesh* mesh : model->Meshes)
+				{
+					if (mesh->VertexFormat->TextureCoords2)
+					{
+						PRINT_WARNING("Model \"%s\" has a second UV channel, it will be replaced with vertex animation texture coordinates!",
+							finCurrent.c_str());
+						break;
+					}
+				}
+
+				vat = std::make_unique<SVertexAnimationTexture>();
+				vat->HasNormals = config.VertexAnimationNormals;
+				vat->Layout(model.get());
+			}
+		}
+
+		if (progress)
+		{
+			progress->SetStage(BBMOD_STAGE_SAVE);
 		}
 
-		if (!model->Save(foutCurrent))
+		if (!model->Save(foutCurrent, config))
 		{
 			PRINT_ERROR("Could not save model \"%s\" to \"%s\"!", finCurrent.c_str(), foutCurrent);
 			return BBMOD_ERR_SAVE_FAILED;
 		}
 
 		PRINT_SUCCESS("Model \"%s\" saved to \"%s\"!", finCurrent.c_str(), foutCurrent);
+		AddOutput(progress, foutCurrent);
 
 		/*log << "Vertex format:" << std::endl;
 		log << "==============" << std::endl;
@@ -229,11 +1171,34 @@ int ConvertToBBMOD(const char* fin, const char* fout, const SConfig& config)
 		if (vformat->Ids) { log << "Ids" << std::endl; }
 		log << std::endl;*/
 
+		if (skeleton)
+		{
+			log << "Skeleton:" << std::endl;
+			log << "=========" << std::endl;
+			log << config.SharedSkeleton << " (hash " << std::hex << skeleton->SkeletonHash << std::dec
+				<< ", " << skeleton->BoneCount << " bones)" << std::endl;
+			log << std::endl;
+		}
+
 		log << "Nodes:" << std::endl;
 		log << "======" << std::endl;
-		LogNode(log, model, model->RootNode, 0);
+		LogNode(log, model.get(), model->RootNode, 0);
 		log << std::endl;
 
+		if (config.PruneSkeleton)
+		{
+			log << "Pruned nodes:" << std::endl;
+			log << "=============" << std::endl;
+			for (const auto& pair : model->NodeImportanceMap)
+			{
+				if (!pair.second)
+				{
+					log << pair.first << std::endl;
+				}
+			}
+			log << std::endl;
+		}
+
 		if (model->BoneCount > 128)
 		{
 			PRINT_WARNING(
@@ -251,6 +1216,17 @@ int ConvertToBBMOD(const char* fin, const char* fout, const SConfig& config)
 				<< "make your game incompatible with some devices!" << std::endl << std::endl;
 		}
 
+		if (!model->BoneLods.empty())
+		{
+			log << "Bone LODs:" << std::endl;
+			log << "==========" << std::endl;
+			for (uint32_t i = 0; i < model->BoneLods.size(); ++i)
+			{
+				log << (i + 1) << ": " << model->BoneLods[i].KeptCount << "/" << model->BoneCount << " bones" << std::endl;
+			}
+			log << std::endl;
+		}
+
 		log << "Materials:" << std::endl;
 		log << "==========" << std::endl;
 		for (uint32_t i = 0; i < model->MaterialNames.size(); ++i)
@@ -262,30 +1238,18 @@ int ConvertToBBMOD(const char* fin, const char* fout, const SConfig& config)
 		// Write animations
 		if (!config.DisableBones)
 		{
-			uint32_t numOfAnimations = scene->mNumAnimations;
-
-			if (numOfAnimations > 0)
+			int result = ConvertAnimations(scene, skeleton ? skeleton.get() : model.get(), model.get(), foutCurrent, config, log, pack.get(), atlas.get(), vat.get(), nullptr, progress);
+			if (result == BBMOD_SUCCESS)
 			{
-				for (uint32_t i = 0; i < numOfAnimations; ++i)
-				{
-					SAnimation* animation = SAnimation::FromAssimp(scene->mAnimations[i], model, config);
-			
-					if (!animation)
-					{
-						PRINT_ERROR("Failed to convert an animation to BBANIM!");
-						return BBMOD_ERR_CONVERSION_FAILED;
-					}
-
-					std::string fname = GetAnimationFilename(animation, i, foutCurrent, config.Prefix);
-		
-					if (!animation->Save(fname, config))
-					{
-						PRINT_ERROR("Could not save an animation to \"%s\"!", fname.c_str());
-						return BBMOD_ERR_SAVE_FAILED;
-					}
-
-					PRINT_SUCCESS("Animation saved to \"%s\"!", fname.c_str());
-				}
+				result = SaveBoneAtlas(atlas.get(), foutCurrent, config, progress);
+			}
+			if (result == BBMOD_SUCCESS)
+			{
+				result = SaveVertexAnimation(vat.get(), foutCurrent, progress);
+			}
+			if (result != BBMOD_SUCCESS)
+			{
+				return result;
 			}
 		}
 
@@ -298,226 +1262,217 @@ int ConvertToBBMOD(const char* fin, const char* fout, const SConfig& config)
 				const char* matName = mat->GetName().C_Str();
 				std::string matFout = GetFilename(foutCurrent, matName, ".bbmat", config.Prefix);
 
-				aiColor3D matColor(1.0f, 1.0f, 1.0f);
-				mat->Get(AI_MATKEY_COLOR_DIFFUSE, matColor);
+				std::ofstream bbmat(matFout, std::ios::out);
+				WriteMaterial(mat, config, bbmat);
 
-				float matOpacity = 1.0f;
-				mat->Get(AI_MATKEY_OPACITY, matOpacity);
+				PRINT_SUCCESS("Material saved to \"%s\"!", matFout.c_str());
+				AddOutput(progress, matFout);
 
-				std::string matBaseOpacity;
-				std::string matNormalRoughness;
-				std::string matMetallicAO;
-				std::string matSpecularColor;
-				std::string matNormalSmoothness;
-				std::string matEmissive;
-				std::string matSubsurface;
-				std::string matLightmap;
+				bbmat.flush();
+				bbmat.close();
+			}
+		}
 
-				const aiMaterialProperty* prop;
+		log.flush();
+		log.close();
+	}
 
-				// Try to get the diffuse texture
-				if (aiGetMaterialProperty(mat, AI_MATKEY_TEXTURE_DIFFUSE(0), &prop) == AI_SUCCESS
-					&& prop->mType == aiPTI_String)
-				{
-					aiString s;
-					aiGetMaterialString(mat, prop->mKey.data, prop->mSemantic, prop->mIndex, &s);
-					std::string str(s.C_Str());
-					if (str[0] != '*')
-					{
-						std::replace(str.begin(), str.end(), '\\', '/');
-						matBaseOpacity = str;
-					}
-				}
+	if (pack)
+	{
+		if (pack->Entries.empty())
+		{
+			PRINT_WARNING("No animations were converted, animation pack will not be saved!");
+		}
+		else if (!pack->Save(pathPack.string()))
+		{
+			PRINT_ERROR("Could not save animation pack to \"%s\"!", pathPack.string().c_str());
+			return BBMOD_ERR_SAVE_FAILED;
+		}
+		else
+		{
+			PRINT_SUCCESS("Animation pack with %d animation(s) saved to \"%s\"!",
+				(int)pack->Entries.size(), pathPack.string().c_str());
+			AddOutput(progress, pathPack.string());
+		}
+	}
 
-				// Try to get other textures from their naming conventions
-				for (int j = 0; j < mat->mNumProperties; ++j)
-				{
-					prop = mat->mProperties[j];
+	if (progress)
+	{
+		progress->SetStage(BBMOD_STAGE_DONE);
+	}
 
-					if (prop->mKey != aiString(_AI_MATKEY_TEXTURE_BASE)
-						&& (prop->mSemantic != aiTextureType_DIFFUSE || prop->mIndex != 0))
-					{
-						g_unusedProps.push_back(prop);
-						continue;
-					}
+	return BBMOD_SUCCESS;
+}
 
-					aiString s;
-					aiGetMaterialString(mat, prop->mKey.data, prop->mSemantic, prop->mIndex, &s);
+int ConvertToBBMODInMemory(
+	const void* data,
+	size_t size,
+	const char* hint,
+	const char* name,
+	const SConfig& config,
+	std::vector<SMemoryFile>& out,
+	SProgress* progress)
+{
+	if (!name)
+	{
+		PRINT_ERROR("Name of the model converted in memory not specified!");
+		return BBMOD_FAILURE;
+	}
 
-					std::string str(s.C_Str());
-					std::replace(str.begin(), str.end(), '\\', '/');
+	if (!config.ReferenceModel.empty()
+		|| !config.SharedSkeleton.empty()
+		|| config.AnimationPack
+		|| config.BoneAtlas != BBMOD_ATLAS_NONE
+		|| config.VertexAnimation)
+	{
+		PRINT_WARNING("Reference models, shared skeletons, animation packs, bone atlases and vertex animation textures are not supported when converting in memory, they will be ignored!");
+	}
 
-					std::string strLower(str);
-					std::transform(strLower.begin(), strLower.end(), strLower.begin(),
-						[](unsigned char c){ return std::tolower(c); });
-					std::string fname = fs::path(strLower).filename().string();
+	if (progress)
+	{
+		progress->BeginFile(0, 1);
+	}
 
-					if (fname.rfind("normalroughness") != std::string::npos)
-					{
-						matNormalRoughness = str;
-					}
-					else if (fname.rfind("metallicao") != std::string::npos)
-					{
-						matMetallicAO = str;
-					}
-					else if (fname.rfind("normalsmoothness") != std::string::npos)
-					{
-						matNormalSmoothness = str;
-					}
-					else if (fname.rfind("specular") != std::string::npos)
-					{
-						matSpecularColor = str;
-					}
-					else if (fname.rfind("emissive") != std::string::npos)
-					{
-						matEmissive = str;
-					}
-					else if (fname.rfind("subsurface") != std::string::npos)
-					{
-						matSubsurface = str;
-					}
-					else if (fname.rfind("lightmap") != std::string::npos)
-					{
-						matLightmap = str;
-					}
-					else
-					{
-						g_unusedProps.push_back(prop);
-					}
-				}
+	// Outputs are named as if the model was converted next to a file `name`
+	std::string fout = std::string(name) + ".bbmod";
 
-				std::ofstream bbmat(matFout, std::ios::out);
+	Assimp::Importer importer;
+	importer.SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
 
-				bbmat << "{\n";
-				bbmat << "    \"__MaterialName\": \"BBMOD_MATERIAL_DEFAULT" << (!matLightmap.empty() ? "_LIGHTMAP" : "") << "\",\n";
-				bbmat << "    \"RenderQueue\": \"Default\"";
-
-				bbmat << ",\n    \"BaseOpacityMultiplier\": {\n";
-				bbmat << "        \"Red\": " << matColor.r * 255.0f << ",\n";
-				bbmat << "        \"Green\": " << matColor.g * 255.0f  << ",\n";
-				bbmat << "        \"Blue\": " << matColor.b * 255.0f  << ",\n";
-				bbmat << "        \"Alpha\": " << matOpacity << "\n";
-				bbmat << "    }";
-
-				bbmat << ",\n    \"Shaders\": {\n";
-				bbmat << "        \"Shadows\": \"BBMOD_SHADER_DEFAULT_DEPTH\",\n";
-				bbmat << "        \"DepthOnly\": \"BBMOD_SHADER_DEFAULT_DEPTH\",\n";
-				bbmat << "        \"Id\": \"BBMOD_SHADER_INSTANCE_ID\"\n";
-				bbmat << "    }";
-
-				if (!matBaseOpacity.empty()
-					|| !matNormalRoughness.empty()
-					|| !matMetallicAO.empty()
-					|| !matNormalSmoothness.empty()
-					|| !matSpecularColor.empty()
-					|| !matEmissive.empty()
-					|| !matSubsurface.empty()
-					|| !matLightmap.empty())
-				{
-					bbmat << ",\n    \"__Textures\": {";
+	if (progress)
+	{
+		// The importer takes ownership of the handler
+		importer.SetProgressHandler(new SAssimpProgressHandler(progress));
+	}
 
-					bool hasPrev = false;
-					if (!matBaseOpacity.empty())
-					{
-						bbmat << "\n        \"BaseOpacity\": \"" << matBaseOpacity << "\"";
-						hasPrev = true;
-					}
+	int flags = GetImportFlags(config, false);
+	const aiScene* scene = nullptr;
 
-					if (!matNormalRoughness.empty())
-					{
-						if (hasPrev) { bbmat << ","; }
-						bbmat << "\n        \"NormalRoughness\": \"" << matNormalRoughness << "\"";
-						hasPrev = true;
-					}
+	std::unique_ptr<SGlbFile> glb;
+	std::unique_ptr<aiScene> glbScene;
 
-					if (!matMetallicAO.empty())
-					{
-						if (hasPrev) { bbmat << ","; }
-						bbmat << "\n        \"MetallicAO\": \"" << matMetallicAO << "\"";
-						hasPrev = true;
-					}
-					
-					if (!matNormalSmoothness.empty())
-					{
-						if (hasPrev) { bbmat << ","; }
-						bbmat << "\n        \"NormalSmoothness\": \"" << matNormalSmoothness << "\"";
-						hasPrev = true;
-					}
+	if (config.NativeGlb && hint && std::string(hint) == "glb")
+	{
+		std::string reason;
+		glb.reset(SGlbFile::FromMemory(data, size, reason));
+		if (glb)
+		{
+			glbScene.reset(ReadGlb(glb, config, false, reason));
+			scene = glbScene.get();
+		}
+		if (scene)
+		{
+			PrintNativeGlbInfo(config);
+		}
+		if (!scene)
+		{
+			PRINT_WARNING("Cannot read \"%s\" natively (%s), falling back to Assimp!", name, reason.c_str());
+		}
+	}
 
-					if (!matSpecularColor.empty())
-					{
-						if (hasPrev) { bbmat << ","; }
-						bbmat << "\n        \"SpecularColor\": \"" << matSpecularColor << "\"";
-						hasPrev = true;
-					}
+	if (!scene && !IsCancelled(progress))
+	{
+		scene = importer.ReadFileFromMemory(data, size, flags, hint ? hint : "");
+	}
 
-					if (!matEmissive.empty())
-					{
-						if (hasPrev) { bbmat << ","; }
-						bbmat << "\n        \"Emissive\": \"" << matEmissive << "\"";
-						hasPrev = true;
-					}
+	if (!scene)
+	{
+		if (IsCancelled(progress))
+		{
+			return BBMOD_ERR_CANCELLED;
+		}
+		PRINT_ERROR("Failed to load model \"%s\" from memory: %s", name, importer.GetErrorString());
+		return BBMOD_ERR_LOAD_FAILED;
+	}
 
-					if (!matSubsurface.empty())
-					{
-						if (hasPrev) { bbmat << ","; }
-						bbmat << "\n        \"Subsurface\": \"" << matSubsurface << "\"";
-						hasPrev = true;
-					}
+	if (config.ConvertToZUp && !glb)
+	{
+		// The GLB reader rotates its root node itself
+		ConvertToZUp(scene);
+	}
 
-					if (!matLightmap.empty())
-					{
-						if (hasPrev) { bbmat << ","; }
-						bbmat << "\n        \"Lightmap\": \"" << matLightmap << "\"";
-						hasPrev = true;
-					}
+	if (progress)
+	{
+		progress->SetStage(BBMOD_STAGE_MESHES);
+	}
 
-					bbmat << "\n    }";
-				}
+	std::string error;
+	std::unique_ptr<SModel> model(glb
+		? glb->ToModel(scene, config, error, progress)
+		: SModel::FromAssimp(scene, config, progress));
 
-				if (config.SaveUnused
-					&& !g_unusedProps.empty())
-				{
-					bbmat << ",\n    \"__Unused\": [";
+	if (IsCancelled(progress))
+	{
+		return BBMOD_ERR_CANCELLED;
+	}
 
-					bool hasPrev = false;
-					for (const aiMaterialProperty* prop : g_unusedProps)
-					{
-						if (prop->mType != aiPTI_String) continue;
+	if (!model)
+	{
+		if (!error.empty())
+		{
+			PRINT_ERROR("Failed to convert the model \"%s\" to BBMOD: %s", name, error.c_str());
+		}
+		else
+		{
+			PRINT_ERROR("Failed to convert the model \"%s\" to BBMOD!", name);
+		}
+		return BBMOD_ERR_CONVERSION_FAILED;
+	}
 
-						if (hasPrev) { bbmat << ","; }
+	glb.reset();
 
-						bbmat << "\n        {\"Key\": \"" << prop->mKey.C_Str() << "\""
-							<< ", \"Semantic\": " << prop->mSemantic
-							<< ", \"Index\": " << prop->mIndex
-							<< ", \"Value\": ";
+	if (progress)
+	{
+		progress->SetStage(BBMOD_STAGE_SAVE);
+	}
 
-						aiString s;
-						aiGetMaterialString(mat, prop->mKey.data, prop->mSemantic, prop->mIndex, &s);
-						std::string ss(s.C_Str());
-						std::replace(ss.begin(), ss.end(), '\\', '/');
-						bbmat << "\"" << ss.c_str() << "\"";
+	std::ostringstream stream(std::ios::out | std::ios::binary);
+	SMemoryFile file;
+	file.Name = fout;
 
-						bbmat << "}";
+	if (!model->Save(stream) || !StoreFileData(stream.str(), config, file.Data))
+	{
+		PRINT_ERROR("Could not save model \"%s\"!", name);
+		return BBMOD_ERR_SAVE_FAILED;
+	}
 
-						hasPrev = true;
-					}
-					g_unusedProps.clear();
+	out.push_back(std::move(file));
+	PRINT_SUCCESS("Model \"%s\" converted!", name);
 
-					bbmat << "\n    ]";
-				}
+	if (!config.DisableBones)
+	{
+		// Logs are only written next to converted files
+		std::ostream log(nullptr);
 
-				bbmat << "\n}\n";
+		int result = ConvertAnimations(
+			scene, model.get(), model.get(), fout.c_str(), config, log, nullptr, nullptr, nullptr, &out, progress);
 
-				PRINT_SUCCESS("Material saved to \"%s\"!", matFout.c_str());
+		if (result != BBMOD_SUCCESS)
+		{
+			return result;
+		}
+	}
 
-				bbmat.flush();
-				bbmat.close();
-			}
+	if (config.ExportMaterials)
+	{
+		for (uint32_t i = 0; i < scene->mNumMaterials; ++i)
+		{
+			aiMaterial* mat = scene->mMaterials[i];
+			std::ostringstream bbmat;
+			WriteMaterial(mat, config, bbmat);
+
+			SMemoryFile material;
+			material.Name = GetFilename(fout.c_str(), mat->GetName().C_Str(), ".bbmat", config.Prefix);
+			material.Data = bbmat.str();
+
+			PRINT_SUCCESS("Material \"%s\" converted!", material.Name.c_str());
+			out.push_back(std::move(material));
 		}
+	}
 
-		log.flush();
-		log.close();
+	if (progress)
+	{
+		progress->SetStage(BBMOD_STAGE_DONE);
 	}
 
 	return BBMOD_SUCCESS;
@@ -0,0 +1,135 @@
+#include <BBMOD/JobQueue.hpp>
+
+SJobQueue::~SJobQueue()
+{
+	// Destroying a joinable thread terminates the process
+	for (std::thread& worker : Workers)
+	{
+		if (worker.joinable())
+		{
+			worker.detach();
+		}
+	}
+}
+
+void SJobQueue::Stop()
+{
+	std::vector<std::thread> workers;
+
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Stopping = true;
+		for (auto& pair : Jobs)
+		{
+			pair.second->Progress.Cancel();
+		}
+		for (std::shared_ptr<SJob>& job : Queue)
+		{
+			job->Result = BBMOD_ERR_CANCELLED;
+			job->Status = BBMOD_JOB_FINISHED;
+		}
+		Queue.clear();
+		workers.swap(Workers);
+	}
+
+	Condition.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	std::lock_guard<std::mutex> lock(Mutex);
+	Stopping = false;
+}
+
+uint32_t SJobQueue::Start(const std::string& in, const std::string& out, const SConfig& config)
+{
+	std::shared_ptr<SJob> job = std::make_shared<SJob>();
+	job->In = in;
+	job->Out = out;
+	job->Config = config;
+
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+
+		job->Id = NextId++;
+		Jobs[job->Id] = job;
+		Queue.push_back(job);
+
+		while (Workers.size() < BBMOD_JOB_WORKER_COUNT)
+		{
+			Workers.emplace_back(&SJobQueue::Work, this);
+		}
+	}
+
+	Condition.notify_one();
+
+	return job->Id;
+}
+
+std::shared_ptr<SJob> SJobQueue::Find(uint32_t id)
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+	auto it = Jobs.find(id);
+	return (it != Jobs.end()) ? it->second : nullptr;
+}
+
+bool SJobQueue::Remove(uint32_t id)
+{
+	std::lock_guard<std::mutex> lock(Mutex);
+
+	auto it = Jobs.find(id);
+	if (it == Jobs.end())
+	{
+		return false;
+	}
+
+	std::shared_ptr<SJob> job = it->second;
+	job->Progress.Cancel();
+	Jobs.erase(it);
+
+	for (auto queued = Queue.begin(); queued != Queue.end(); ++queued)
+	{
+		if (*queued == job)
+		{
+			Queue.erase(queued);
+			break;
+		}
+	}
+
+	return true;
+}
+
+void SJobQueue::Work()
+{
+	while (true)
+	{
+		std::shared_ptr<SJob> job;
+
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			Condition.wait(lock, [this]() { return Stopping || !Queue.empty(); });
+
+			if (Stopping)
+			{
+				return;
+			}
+
+			job = Queue.front();
+			Queue.pop_front();
+		}
+
+		if (job->Progress.IsCancelled())
+		{
+			job->Result = BBMOD_ERR_CANCELLED;
+		}
+		else
+		{
+			job->Status = BBMOD_JOB_RUNNING;
+			job->Result = ConvertToBBMOD(job->In.c_str(), job->Out.c_str(), job->Config, &job->Progress);
+		}
+
+		job->Status = BBMOD_JOB_FINISHED;
+	}
+}
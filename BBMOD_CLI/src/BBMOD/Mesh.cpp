@@ -1,10 +1,13 @@
 #include <BBMOD/Mesh.hpp>
 #include <BBMOD/Model.hpp>
+#include <BBMOD/Quantization.hpp>
 #include <terminal.hpp>
 #include <utils.hpp>
 
 #include <assimp/scene.h>
 
+#include <algorithm>
+#include <cmath>
 #include <map>
 #include <vector>
 #include <string>
@@ -62,6 +65,102 @@ static inline void AssimpToVec3(aiVector3D& from, vec3_t to)
 	to[2] = from.z;
 }
 
+static inline int8_t QuantizeNormalDelta(float value)
+{
+	return (int8_t)std::min(std::max(roundf(value * 63.5f), -127.0f), 127.0f);
+}
+
+/** Converts morph targets of an Assimp mesh into sparse deltas of vertices of
+ * `mesh`. Vertices created from the same source vertex share the same delta. */
+static void ConvertMorphTargets(const aiMesh* aiMesh, SMesh* mesh, const SConfig& config)
+{
+	bool normals = mesh->VertexFormat->Normals && aiMesh->HasNormals();
+
+	for (uint32_t t = 0; t < aiMesh->mNumAnimMeshes; ++t)
+	{
+		const aiAnimMesh* animMesh = aiMesh->mAnimMeshes[t];
+
+		SMorphTarget target;
+		target.Name = animMesh->mName.C_Str();
+
+		bool targetNormals = normals && animMesh->HasNormals();
+		std::vector<float> positionDeltas;
+		std::vector<float> normalDeltas;
+
+		for (uint32_t i = 0; i < mesh->Data.size(); ++i)
+		{
+			uint32_t source = mesh->SourceIndices[i];
+
+			if (source >= animMesh->mNumVertices)
+			{
+				continue;
+			}
+
+			aiVector3D position = animMesh->HasPositions()
+				? animMesh->mVertices[source] - aiMesh->mVertices[source]
+				: aiVector3D();
+			aiVector3D normal = targetNormals
+				? animMesh->mNormals[source] - aiMesh->mNormals[source]
+				: aiVector3D();
+
+			if (config.FlipNormals)
+			{
+				normal *= -1.0f;
+			}
+
+			if (position.SquareLength() <= BBMOD_MORPH_TARGET_EPSILON * BBMOD_MORPH_TARGET_EPSILON
+				&& normal.SquareLength() <= BBMOD_MORPH_TARGET_EPSILON * BBMOD_MORPH_TARGET_EPSILON)
+			{
+				continue;
+			}
+
+			target.Indices.push_back(i);
+			positionDeltas.insert(positionDeltas.end(), { position.x, position.y, position.z });
+			normalDeltas.insert(normalDeltas.end(), { normal.x, normal.y, normal.z });
+		}
+
+		for (size_t i = 0; i < positionDeltas.size(); ++i)
+		{
+			int k = (int)(i % 3);
+			target.DeltaMin[k] = (i < 3) ? positionDeltas[i] : std::min(target.DeltaMin[k], positionDeltas[i]);
+			target.DeltaMax[k] = (i < 3) ? positionDeltas[i] : std::max(target.DeltaMax[k], positionDeltas[i]);
+		}
+
+		target.PositionDeltas.resize(positionDeltas.size());
+
+		for (size_t i = 0; i < positionDeltas.size(); ++i)
+		{
+			int k = (int)(i % 3);
+			target.PositionDeltas[i] = QuantizeRange16(positionDeltas[i], target.DeltaMin[k], target.DeltaMax[k]);
+		}
+
+		if (targetNormals)
+		{
+			target.NormalDeltas.resize(normalDeltas.size());
+
+			for (size_t i = 0; i < normalDeltas.size(); ++i)
+			{
+				target.NormalDeltas[i] = QuantizeNormalDelta(normalDeltas[i]);
+			}
+		}
+
+		mesh->MorphTargets.push_back(std::move(target));
+	}
+}
+
+SMesh::~SMesh()
+{
+	for (SVertex* vertex : Data)
+	{
+		delete vertex;
+	}
+
+	if (!Model || VertexFormat != Model->VertexFormat)
+	{
+		delete VertexFormat;
+	}
+}
+
 SMesh* SMesh::FromAssimp(const aiScene* scene, aiMesh* aiMesh, SModel* model, const SConfig& config)
 {
 	SMesh* mesh = new SMesh();
@@ -87,11 +186,16 @@ SMesh* SMesh::FromAssimp(const aiScene* scene, aiMesh* aiMesh, SModel* model, co
 	
 	SVertexFormat* vertexFormat = new SVertexFormat();
 	vertexFormat->Vertices = true;
-	vertexFormat->Normals = aiMesh->HasNormals() && !config.DisableNormals;
+	// Missing normals and tangents are generated later by GenerateTangentSpace
+	bool genNormals = config.NativeTangentSpace && config.GenNormals != BBMOD_NORMALS_NONE
+		&& (aiMesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE);
+	vertexFormat->Normals = (aiMesh->HasNormals() || genNormals) && !config.DisableNormals;
 	vertexFormat->TextureCoords = aiMesh->HasTextureCoords(0) && !config.DisableTextureCoords;
 	vertexFormat->TextureCoords2 = aiMesh->HasTextureCoords(1) && !config.DisableTextureCoords && !config.DisableTextureCoords2;
 	vertexFormat->Colors = aiMesh->HasVertexColors(0) && !config.DisableVertexColors;
-	vertexFormat->TangentW = aiMesh->HasTangentsAndBitangents() && !(config.DisableNormals || config.DisableTangentW);
+	bool genTangents = config.NativeTangentSpace && vertexFormat->Normals && vertexFormat->TextureCoords
+		&& (aiMesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE);
+	vertexFormat->TangentW = (aiMesh->HasTangentsAndBitangents() || genTangents) && !(config.DisableNormals || config.DisableTangentW);
 	vertexFormat->Bones = aiMesh->HasBones() && !config.DisableBones;
 	vertexFormat->Ids = false;
 	mesh->VertexFormat = vertexFormat;
@@ -312,13 +416,21 @@ SMesh* SMesh::FromAssimp(const aiScene* scene, aiMesh* aiMesh, SModel* model, co
 			}
 
 			mesh->Data.push_back(vertex);
+			mesh->SourceIndices.push_back(idx);
 		}
 	}
 
+	mesh->Name = aiMesh->mName.C_Str();
+
+	if (config.MorphTargets)
+	{
+		ConvertMorphTargets(aiMesh, mesh, config);
+	}
+
 	return mesh;
 }
 
-bool SVertex::Save(std::ofstream& file)
+bool SVertex::Save(std::ostream& file)
 {
 	SVertexFormat* vertexFormat = VertexFormat;
 
@@ -374,7 +486,7 @@ bool SVertex::Save(std::ofstream& file)
 	return true;
 }
 
-SVertex* SVertex::Load(std::ifstream& file, SVertexFormat* vertexFormat)
+SVertex* SVertex::Load(std::istream& file, SVertexFormat* vertexFormat)
 {
 	SVertex* vertex = new SVertex();
 	vertex->VertexFormat = vertexFormat;
@@ -431,7 +543,7 @@ SVertex* SVertex::Load(std::ifstream& file, SVertexFormat* vertexFormat)
 	return vertex;
 }
 
-bool SMesh::Save(std::ofstream& file)
+bool SMesh::Save(std::ostream& file)
 {
 	FILE_WRITE_DATA(file, MaterialIndex);
 
@@ -465,7 +577,7 @@ bool SMesh::Save(std::ofstream& file)
 	return true;
 }
 
-SMesh* SMesh::Load(std::ifstream& file, SVertexFormat* vertexFormat, SModel* model)
+SMesh* SMesh::Load(std::istream& file, SVertexFormat* vertexFormat, SModel* model)
 {
 	SMesh* mesh = new SMesh();
 	mesh->Model = model;
@@ -498,3 +610,95 @@ SMesh* SMesh::Load(std::ifstream& file, SVertexFormat* vertexFormat, SModel* mod
 
 	return mesh;
 }
+
+bool SMesh::WriteMorphTargets(std::ostream& file) const
+{
+	file.write(Name.c_str(), Name.size() + 1);
+
+	uint32_t targetCount = (uint32_t)MorphTargets.size();
+	FILE_WRITE_DATA(file, targetCount);
+
+	for (const SMorphTarget& target : MorphTargets)
+	{
+		file.write(target.Name.c_str(), target.Name.size() + 1);
+
+		uint32_t vertexCount = (uint32_t)target.Indices.size();
+		FILE_WRITE_DATA(file, vertexCount);
+
+		bool normals = !target.NormalDeltas.empty();
+		FILE_WRITE_DATA(file, normals);
+
+		FILE_WRITE_VEC3(file, target.DeltaMin);
+		FILE_WRITE_VEC3(file, target.DeltaMax);
+		FILE_WRITE_ARRAY(file, target.Indices.data(), target.Indices.size());
+		FILE_WRITE_ARRAY(file, target.PositionDeltas.data(), target.PositionDeltas.size());
+
+		if (normals)
+		{
+			FILE_WRITE_ARRAY(file, target.NormalDeltas.data(), target.NormalDeltas.size());
+		}
+	}
+
+	return file.good();
+}
+
+bool SMesh::ReadMorphTargets(std::istream& file)
+{
+	std::getline(file, Name, '\0');
+
+	uint32_t targetCount;
+	FILE_READ_DATA(file, targetCount);
+
+	MorphTargets.clear();
+
+	for (uint32_t t = 0; t < targetCount && file.good(); ++t)
+	{
+		SMorphTarget target;
+		std::getline(file, target.Name, '\0');
+
+		uint32_t vertexCount;
+		FILE_READ_DATA(file, vertexCount);
+
+		bool normals;
+		FILE_READ_DATA(file, normals);
+
+		FILE_READ_VEC3(file, target.DeltaMin);
+		FILE_READ_VEC3(file, target.DeltaMax);
+
+		if (!file || vertexCount > Data.size())
+		{
+			return false;
+		}
+
+		target.Indices.resize(vertexCount);
+		FILE_READ_ARRAY(file, target.Indices.data(), target.Indices.size());
+		target.PositionDeltas.resize((size_t)vertexCount * 3);
+		FILE_READ_ARRAY(file, target.PositionDeltas.data(), target.PositionDeltas.size());
+
+		if (normals)
+		{
+			target.NormalDeltas.resize((size_t)vertexCount * 3);
+			FILE_READ_ARRAY(file, target.NormalDeltas.data(), target.NormalDeltas.size());
+		}
+
+		MorphTargets.push_back(std::move(target));
+	}
+
+	return file.good();
+}
+
+void SMorphTarget::GetPositionDelta(size_t i, vec3_t out) const
+{
+	for (int k = 0; k < 3; ++k)
+	{
+		out[k] = DequantizeRange16(PositionDeltas[i * 3 + k], DeltaMin[k], DeltaMax[k]);
+	}
+}
+
+void SMorphTarget::GetNormalDelta(size_t i, vec3_t out) const
+{
+	for (int k = 0; k < 3; ++k)
+	{
+		out[k] = NormalDeltas.empty() ? 0.0f : (float)NormalDeltas[i * 3 + k] / 63.5f;
+	}
+}
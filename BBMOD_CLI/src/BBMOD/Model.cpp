@@ -1,11 +1,20 @@
 #include <BBMOD/Model.hpp>
+#include <BBMOD/Compression.hpp>
+#include <BBMOD/Parallel.hpp>
+#include <BBMOD/TangentSpace.hpp>
 
 #include <utils.hpp>
 
 #include <assimp/scene.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <set>
+#include <sstream>
 
 static inline void AssimpToMatrix(const aiMatrix4x4 from, matrix_t to)
 {
@@ -65,7 +74,7 @@ static SNode* CollectNodes(SModel* model, aiNode* nodeCurrent, const SConfig& co
 	return node;
 }
 
-SModel* SModel::FromAssimp(const aiScene* scene, const SConfig& config)
+SModel* SModel::FromAssimp(const aiScene* scene, const SConfig& config, SProgress* progress)
 {
 	SModel* model = new SModel();
 
@@ -105,119 +114,1339 @@ SModel* SModel::FromAssimp(const aiScene* scene, const SConfig& config)
 		model->NodeCount = model->BoneCount;
 	}
 
-	// Meshes
-	for (uint32_t i = 0; i < scene->mNumMeshes; ++i)
+	// Meshes are independent on each other and only read the skeleton, so
+	// they are converted on multiple threads
+	model->Meshes.resize(scene->mNumMeshes, nullptr);
+
+	std::atomic<uint32_t> meshesDone(0);
+
+	ParallelFor(scene->mNumMeshes, [&](size_t i) {
+		if (progress && progress->IsCancelled())
+		{
+			return;
+		}
+		SMesh* mesh = SMesh::FromAssimp(scene, scene->mMeshes[i], model, config);
+		if (config.NativeTangentSpace)
+		{
+			GenerateTangentSpace(mesh, scene->mMeshes[i]->HasNormals(),
+				scene->mMeshes[i]->HasTangentsAndBitangents(), config);
+		}
+		model->Meshes[i] = mesh;
+		if (progress)
+		{
+			progress->SetStep(++meshesDone, scene->mNumMeshes);
+		}
+	});
+
+	if (progress && progress->IsCancelled())
+	{
+		delete model;
+		return nullptr;
+	}
+
+	// Nodes
+	model->RootNode = CollectNodes(model, scene->mRootNode, config);
+
+	// Materials
+	for (uint32_t i = 0; i < scene->mNumMaterials; ++i)
+	{
+		aiMaterial* materialCurrent = scene->mMaterials[i];
+		model->MaterialNames.push_back(materialCurrent->GetName().C_Str());
+	}
+
+	model->FinishConversion(scene, config);
+
+	return model;
+}
+
+void SModel::FinishConversion(const aiScene* scene, const SConfig& config)
+{
+	if (config.TableOfContents)
+	{
+		VersionMinor = BBMOD_VERSION_MINOR_TOC;
+	}
+
+	for (SMesh* mesh : Meshes)
+	{
+		if (!mesh->MorphTargets.empty())
+		{
+			VersionMinor = BBMOD_VERSION_MINOR_TOC;
+		}
+	}
+
+	// Pruning
+	if (config.PruneSkeleton)
+	{
+		Prune(scene, config);
+	}
+
+	if (config.FlatNodeTable)
+	{
+		SortNodesTopologically();
+		FlatNodeTable = true;
+		VersionMinor = BBMOD_VERSION_MINOR_TOC;
+	}
+
+	// Bone LODs
+	if (config.BoneLodCount > 0 && BoneCount > 0)
+	{
+		ComputeBoneLods(config.BoneLodCount);
+		VersionMinor = BBMOD_VERSION_MINOR_TOC;
+	}
+}
+
+/** Returns true if any key of a channel differs from the node's transform. */
+static bool ChannelIsAnimated(const aiNodeAnim* channel, SNode* node)
+{
+	vec3_t position;
+	quat_t rotation;
+	dual_quaternion_get_translation(node->Transform, position);
+	dual_quaternion_get_rotation(node->Transform, rotation);
+	quaternion_normalize(rotation);
+
+	for (uint32_t i = 0; i < channel->mNumPositionKeys; ++i)
+	{
+		const aiVector3D& value = channel->mPositionKeys[i].mValue;
+		if (fabsf(value.x - position[0]) > 0.00001f
+			|| fabsf(value.y - position[1]) > 0.00001f
+			|| fabsf(value.z - position[2]) > 0.00001f)
+		{
+			return true;
+		}
+	}
+
+	for (uint32_t i = 0; i < channel->mNumRotationKeys; ++i)
+	{
+		const aiQuaternion& value = channel->mRotationKeys[i].mValue;
+		quat_t key = { value.x, value.y, value.z, value.w };
+		quaternion_normalize(key);
+		if (fabsf(quaternion_dot(key, rotation)) < 0.999999f)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** Returns true if a subtree contains a weighted bone, a mesh or a node which
+ * must be kept. */
+static bool MarkUsefulNodes(
+	SNode* node,
+	const std::vector<bool>& weighted,
+	const std::string& keepNodes,
+	std::set<SNode*>& useful)
+{
+	bool isUseful = !node->Meshes.empty()
+		|| (node->IsBone && (uint32_t)node->Index < weighted.size() && weighted[(uint32_t)node->Index])
+		|| MatchNamePatterns(node->Name, keepNodes);
+
+	for (SNode* child : node->Children)
+	{
+		if (MarkUsefulNodes(child, weighted, keepNodes, useful))
+		{
+			isUseful = true;
+		}
+	}
+
+	if (isUseful)
+	{
+		useful.insert(node);
+	}
+
+	return isUseful;
+}
+
+static void DeleteNode(SNode* node, std::map<std::string, bool>& importance)
+{
+	importance[node->Name] = false;
+	for (SNode* child : node->Children)
+	{
+		DeleteNode(child, importance);
+	}
+	delete node;
+}
+
+/** Returns nodes which replace given node in its parent's children. */
+static std::vector<SNode*> PruneNode(
+	SNode* node,
+	dual_quat_t pruned,
+	bool isRoot,
+	const std::set<SNode*>& useful,
+	const std::set<std::string>& animated,
+	const std::vector<bool>& weighted,
+	const std::string& keepNodes,
+	std::map<std::string, bool>& importance)
+{
+	std::vector<SNode*> result;
+
+	if (!isRoot && useful.find(node) == useful.end())
+	{
+		DeleteNode(node, importance);
+		return result;
+	}
+
+	bool keep = isRoot
+		|| !node->Meshes.empty()
+		|| (node->IsBone && (uint32_t)node->Index < weighted.size() && weighted[(uint32_t)node->Index])
+		|| animated.find(node->Name) != animated.end()
+		|| MatchNamePatterns(node->Name, keepNodes);
+
+	dual_quat_t transform;
+	dual_quaternion_multiply(node->Transform, pruned, transform, 0);
+
+	std::vector<SNode*> children;
+	children.swap(node->Children);
+
+	if (keep)
+	{
+		dual_quaternion_copy(transform, node->Transform);
+		dual_quaternion_copy(pruned, node->PrunedTransform);
+
+		dual_quat_t identity = DUAL_QUATERNION_IDENTITY;
+		for (SNode* child : children)
+		{
+			std::vector<SNode*> replacement = PruneNode(
+				child, identity, false, useful, animated, weighted, keepNodes, importance);
+			node->Children.insert(node->Children.end(), replacement.begin(), replacement.end());
+		}
+
+		result.push_back(node);
+		return result;
+	}
+
+	for (SNode* child : children)
+	{
+		std::vector<SNode*> replacement = PruneNode(
+			child, transform, false, useful, animated, weighted, keepNodes, importance);
+		result.insert(result.end(), replacement.begin(), replacement.end());
+	}
+
+	importance[node->Name] = false;
+	delete node;
+
+	return result;
+}
+
+static void CollectNodeList(SNode* node, std::vector<SNode*>& nodes)
+{
+	nodes.push_back(node);
+	for (SNode* child : node->Children)
+	{
+		CollectNodeList(child, nodes);
+	}
+}
+
+void SModel::Prune(const aiScene* scene, const SConfig& config)
+{
+	if (!RootNode)
+	{
+		return;
+	}
+
+	std::string keepNodes = config.KeepNodes;
+	if (!config.WorldSpaceNodes.empty())
+	{
+		keepNodes += (keepNodes.empty() ? "" : ",") + config.WorldSpaceNodes;
+	}
+
+	// Bones with weights
+	std::vector<bool> weighted(BoneCount, false);
+
+	for (SMesh* mesh : Meshes)
+	{
+		if (!mesh->VertexFormat || !mesh->VertexFormat->Bones)
+		{
+			continue;
+		}
+
+		for (SVertex* vertex : mesh->Data)
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				uint32_t bone = (uint32_t)vertex->Bones[i];
+				if (vertex->Weights[i] > 0.0f && bone < BoneCount)
+				{
+					weighted[bone] = true;
+				}
+			}
+		}
+	}
+
+	// Animated nodes
+	std::set<std::string> animated;
+
+	if (!config.DisableBones)
+	{
+		for (uint32_t i = 0; i < scene->mNumAnimations; ++i)
+		{
+			aiAnimation* animation = scene->mAnimations[i];
+			for (uint32_t j = 0; j < animation->mNumChannels; ++j)
+			{
+				aiNodeAnim* channel = animation->mChannels[j];
+				SNode* node = FindNodeByName(channel->mNodeName.C_Str(), RootNode);
+				if (node && ChannelIsAnimated(channel, node))
+				{
+					animated.insert(node->Name);
+				}
+			}
+		}
+	}
+
+	// Remove nodes
+	std::set<SNode*> useful;
+	MarkUsefulNodes(RootNode, weighted, keepNodes, useful);
+
+	dual_quat_t identity = DUAL_QUATERNION_IDENTITY;
+	PruneNode(RootNode, identity, true, useful, animated, weighted, keepNodes, NodeImportanceMap);
+
+	std::vector<SNode*> nodes;
+	CollectNodeList(RootNode, nodes);
+
+	// Re-index bones, keeping their order
+	std::vector<int32_t> boneMap(BoneCount, -1);
+
+	for (SNode* node : nodes)
+	{
+		if (node->IsBone && (uint32_t)node->Index < BoneCount)
+		{
+			boneMap[(uint32_t)node->Index] = 0;
+		}
+	}
+
+	int32_t boneCount = 0;
+
+	for (uint32_t i = 0; i < BoneCount; ++i)
+	{
+		if (boneMap[i] == 0 || (weighted[i] && !FindNodeByName(Skeleton[i]->Name, RootNode)))
+		{
+			boneMap[i] = boneCount++;
+		}
+		else
+		{
+			NodeImportanceMap[Skeleton[i]->Name] = false;
+			boneMap[i] = -1;
+		}
+	}
+
+	std::sort(nodes.begin(), nodes.end(), [](SNode* a, SNode* b) {
+		return a->Index < b->Index;
+	});
+
+	Reindex(boneMap, nodes);
+}
+
+void SModel::Reindex(const std::vector<int32_t>& boneMap, const std::vector<SNode*>& nodes)
+{
+	uint32_t boneCount = 0;
+
+	for (int32_t index : boneMap)
+	{
+		boneCount = std::max<uint32_t>(boneCount, (uint32_t)(index + 1));
+	}
+
+	std::vector<SBone*> skeleton(boneCount, nullptr);
+
+	for (uint32_t i = 0; i < BoneCount; ++i)
+	{
+		if (boneMap[i] >= 0)
+		{
+			Skeleton[i]->Index = (float)boneMap[i];
+			skeleton[boneMap[i]] = Skeleton[i];
+		}
+		else
+		{
+			delete Skeleton[i];
+		}
+	}
+
+	Skeleton.swap(skeleton);
+	BoneCount = boneCount;
+
+	for (SMesh* mesh : Meshes)
+	{
+		if (!mesh->VertexFormat || !mesh->VertexFormat->Bones)
+		{
+			continue;
+		}
+
+		for (SVertex* vertex : mesh->Data)
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				uint32_t bone = (uint32_t)vertex->Bones[i];
+				if (vertex->Weights[i] > 0.0f && bone < boneMap.size() && boneMap[bone] >= 0)
+				{
+					vertex->Bones[i] = (float)boneMap[bone];
+				}
+				else
+				{
+					vertex->Bones[i] = 0.0f;
+					vertex->Weights[i] = 0.0f;
+				}
+			}
+		}
+	}
+
+	NodeCount = BoneCount;
+
+	for (SNode* node : nodes)
+	{
+		if (node->IsBone)
+		{
+			node->Index = (float)boneMap[(uint32_t)node->Index];
+		}
+		else
+		{
+			node->Index = (float)NodeCount++;
+		}
+	}
+}
+
+void SModel::SortNodesTopologically()
+{
+	if (!RootNode)
+	{
+		return;
+	}
+
+	std::vector<SNode*> nodes;
+	CollectNodeList(RootNode, nodes);
+
+	std::vector<int32_t> boneMap(BoneCount, -1);
+	int32_t boneCount = 0;
+
+	for (SNode* node : nodes)
+	{
+		if (node->IsBone && (uint32_t)node->Index < BoneCount)
+		{
+			boneMap[(uint32_t)node->Index] = boneCount++;
+		}
+	}
+
+	// Bones which are not in the hierarchy go last
+	for (uint32_t i = 0; i < BoneCount; ++i)
+	{
+		if (boneMap[i] < 0)
+		{
+			boneMap[i] = boneCount++;
+		}
+	}
+
+	Reindex(boneMap, nodes);
+}
+
+/** Transforms a point by a dual quaternion made of a rotation and a translation. */
+static void TransformPoint(const dual_quat_t dq, const vec3_t point, vec3_t out)
+{
+	quat_t r;
+	dual_quaternion_get_rotation(dq, r);
+	quaternion_normalize(r);
+
+	vec3_t t;
+	dual_quaternion_get_translation(dq, t);
+
+	// v' = v + 2w(u x v) + 2u x (u x v)
+	float cx = r[1] * point[2] - r[2] * point[1];
+	float cy = r[2] * point[0] - r[0] * point[2];
+	float cz = r[0] * point[1] - r[1] * point[0];
+
+	out[0] = point[0] + 2.0f * (r[3] * cx + r[1] * cz - r[2] * cy) + t[0];
+	out[1] = point[1] + 2.0f * (r[3] * cy + r[2] * cx - r[0] * cz) + t[1];
+	out[2] = point[2] + 2.0f * (r[3] * cz + r[0] * cy - r[1] * cx) + t[2];
+}
+
+/** Finds the parent bone and the depth of each bone in the node hierarchy. */
+static void CollectBoneParents(
+	SNode* node,
+	int32_t parentBone,
+	uint32_t depth,
+	std::vector<int32_t>& parents,
+	std::vector<uint32_t>& depths)
+{
+	if (node->IsBone)
+	{
+		uint32_t index = (uint32_t)node->Index;
+		if (index < parents.size())
+		{
+			parents[index] = parentBone;
+			depths[index] = depth++;
+			parentBone = (int32_t)index;
+		}
+	}
+
+	for (SNode* child : node->Children)
+	{
+		CollectBoneParents(child, parentBone, depth, parents, depths);
+	}
+}
+
+void SModel::ComputeBoneLods(uint32_t count)
+{
+	BoneImportance.assign(BoneCount, 0.0f);
+	BoneLods.clear();
+
+	std::vector<int32_t> parents(BoneCount, -1);
+	std::vector<uint32_t> depths(BoneCount, 0);
+	if (RootNode)
+	{
+		CollectBoneParents(RootNode, -1, 0, parents, depths);
+	}
+
+	// Influence of a bone on a vertex is its weight times the distance of the
+	// vertex from the bone in bind pose, i.e. how far would the vertex move if
+	// the bone rotated and how much of that movement would be lost if the bone
+	// was replaced with its parent.
+	std::vector<std::vector<bool>> meshBones(Meshes.size(), std::vector<bool>(BoneCount, false));
+
+	for (size_t m = 0; m < Meshes.size(); ++m)
+	{
+		SMesh* mesh = Meshes[m];
+		if (!mesh->VertexFormat || !mesh->VertexFormat->Bones)
+		{
+			continue;
+		}
+
+		for (SVertex* vertex : mesh->Data)
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				uint32_t bone = (uint32_t)vertex->Bones[i];
+				float weight = vertex->Weights[i];
+				if (weight <= 0.0f || bone >= BoneCount)
+				{
+					continue;
+				}
+
+				meshBones[m][bone] = true;
+
+				vec3_t local;
+				TransformPoint(Skeleton[bone]->Offset, vertex->Position, local);
+				float distance = sqrtf(local[0] * local[0] + local[1] * local[1] + local[2] * local[2]);
+				BoneImportance[bone] = std::max(BoneImportance[bone], weight * distance);
+			}
+		}
+	}
+
+	// Propagate importance to ancestors, so that a bone is never removed
+	// before its descendants
+	std::vector<uint32_t> order(BoneCount);
+	for (uint32_t i = 0; i < BoneCount; ++i)
+	{
+		order[i] = i;
+	}
+
+	std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		return depths[a] > depths[b];
+	});
+
+	for (uint32_t bone : order)
+	{
+		if (parents[bone] >= 0)
+		{
+			float& parentImportance = BoneImportance[parents[bone]];
+			parentImportance = std::max(parentImportance, BoneImportance[bone]);
+		}
+	}
+
+	// Root bones first, then from the most important, ancestors before
+	// descendants
+	std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		bool aRoot = (parents[a] < 0);
+		bool bRoot = (parents[b] < 0);
+		if (aRoot != bRoot)
+		{
+			return aRoot;
+		}
+		if (BoneImportance[a] != BoneImportance[b])
+		{
+			return BoneImportance[a] > BoneImportance[b];
+		}
+		if (depths[a] != depths[b])
+		{
+			return depths[a] < depths[b];
+		}
+		return a < b;
+	});
+
+	uint32_t rootCount = 0;
+	for (uint32_t i = 0; i < BoneCount; ++i)
+	{
+		if (parents[i] < 0)
+		{
+			++rootCount;
+		}
+	}
+
+	for (uint32_t l = 1; l <= count; ++l)
+	{
+		SBoneLod lod;
+		lod.KeptCount = (uint32_t)ceil((double)BoneCount * (count + 1 - l) / (count + 1));
+		lod.KeptCount = std::max(lod.KeptCount, rootCount);
+
+		std::vector<bool> kept(BoneCount, false);
+		for (uint32_t i = 0; i < lod.KeptCount; ++i)
+		{
+			kept[order[i]] = true;
+		}
+
+		lod.BoneMap.resize(BoneCount);
+		for (uint32_t i = 0; i < BoneCount; ++i)
+		{
+			int32_t target = (int32_t)i;
+			while (!kept[target])
+			{
+				target = parents[target];
+			}
+			lod.BoneMap[i] = (uint32_t)target;
+		}
+
+		lod.MeshRemaps.resize(Meshes.size());
+		for (size_t m = 0; m < Meshes.size(); ++m)
+		{
+			for (uint32_t i = 0; i < BoneCount; ++i)
+			{
+				if (meshBones[m][i] && lod.BoneMap[i] != i)
+				{
+					lod.MeshRemaps[m].push_back(std::make_pair(i, lod.BoneMap[i]));
+				}
+			}
+		}
+
+		BoneLods.push_back(std::move(lod));
+	}
+}
+
+static void DeleteNodeTree(SNode* node)
+{
+	for (SNode* child : node->Children)
+	{
+		DeleteNodeTree(child);
+	}
+	delete node;
+}
+
+SModel::~SModel()
+{
+	for (SMesh* mesh : Meshes)
+	{
+		delete mesh;
+	}
+
+	if (RootNode)
+	{
+		DeleteNodeTree(RootNode);
+	}
+
+	for (SBone* bone : Skeleton)
+	{
+		delete bone;
+	}
+
+	delete VertexFormat;
+}
+
+SBone* SModel::FindBoneByName(std::string name) const
+{
+	for (SBone* bone : Skeleton)
+	{
+		if (bone->Name == name)
+		{
+			return bone;
+		}
+	}
+	return nullptr;
+}
+
+SBone* SModel::FindBoneByIndex(int index) const
+{
+	for (SBone* bone : Skeleton)
+	{
+		if (bone->Index == index)
+		{
+			return bone;
+		}
+	}
+	return nullptr;
+}
+
+SNode* SModel::FindNodeByName(std::string name, SNode* nodeCurrent) const
+{
+	if (nodeCurrent->Name == name)
+	{
+		return nodeCurrent;
+	}
+	for (SNode* child : nodeCurrent->Children)
+	{
+		if (SNode* node = FindNodeByName(name, child))
+		{
+			return node;
+		}
+	}
+	return nullptr;
+}
+
+bool SModel::Save(std::string path, const SConfig& config)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary);
+
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	if (config.Compress)
+	{
+		std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+
+		if (!Save(stream))
+		{
+			return false;
+		}
+
+		const std::string data = stream.str();
+
+		if (!WriteContainer(file, reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+			config.CompressionChunkSize, config.CompressionFilter))
+		{
+			return false;
+		}
+	}
+	else if (!Save(file))
+	{
+		return false;
+	}
+
+	file.flush();
+	file.close();
+
+	return true;
+}
+
+bool SModel::Save(std::ostream& file)
+{
+	uint64_t fileStart = (uint64_t)file.tellp();
+
+	file.write("BBMOD", sizeof(char) * 6);
+	FILE_WRITE_DATA(file, VersionMajor);
+	FILE_WRITE_DATA(file, VersionMinor);
+
+	if (VersionMinor >= BBMOD_VERSION_MINOR_TOC)
+	{
+		return SaveSections(file, fileStart);
+	}
+
+	/*if (!VertexFormat->Save(file))
+	{
+		return false;
+	}*/
+
+	std::vector<std::string> meshData;
+	if (!SaveMeshes(meshData))
+	{
+		return false;
+	}
+
+	uint32_t meshCount = (uint32_t)Meshes.size();
+	FILE_WRITE_DATA(file, meshCount);
+
+	for (const std::string& data : meshData)
+	{
+		file.write(data.data(), data.size());
+	}
+
+	FILE_WRITE_DATA(file, NodeCount);
+
+	if (!RootNode->Save(file))
+	{
+		return false;
+	}
+
+	FILE_WRITE_DATA(file, BoneCount);
+
+	for (SBone* bone : Skeleton)
+	{
+		if (!bone->Save(file))
+		{
+			return false;
+		}
+	}
+
+	uint32_t materialCount = (uint32_t)MaterialNames.size();
+	FILE_WRITE_DATA(file, materialCount);
+
+	for (std::string& materialName : MaterialNames)
+	{
+		const char* str = materialName.c_str();
+		file.write(str, strlen(str) + 1);
+	}
+
+	return file.good();
+}
+
+bool SModel::SaveMeshes(std::vector<std::string>& out) const
+{
+	out.assign(Meshes.size(), std::string());
+	std::atomic<bool> success(true);
+
+	ParallelFor(Meshes.size(), [&](size_t i) {
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!Meshes[i]->Save(stream))
+		{
+			success = false;
+			return;
+		}
+		out[i] = stream.str();
+	});
+
+	return success;
+}
+
+bool SModel::SaveSections(std::ostream& file, uint64_t fileStart)
+{
+	STableOfContents toc;
+
+	std::vector<std::string> meshData;
+	if (!SaveMeshes(meshData))
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < Meshes.size(); ++i)
+	{
+		toc.Add(BBMOD_SECTION_MESH, i, meshData[i]);
+	}
+
+	for (uint32_t i = 0; i < Meshes.size(); ++i)
+	{
+		if (Meshes[i]->MorphTargets.empty())
+		{
+			continue;
+		}
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!Meshes[i]->WriteMorphTargets(stream))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_MORPH_TARGETS, i, stream.str());
+	}
+
+	if (FlatNodeTable)
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_DATA(stream, NodeCount);
+		if (!SNodeTable::FromTree(RootNode).Save(stream))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_NODE_TABLE, 0, stream.str());
+	}
+	else
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_DATA(stream, NodeCount);
+		if (!RootNode->Save(stream))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_NODES, 0, stream.str());
+	}
+
+	if (SkeletonHash != 0)
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_DATA(stream, SkeletonHash);
+		FILE_WRITE_DATA(stream, BoneCount);
+		stream.write(SkeletonName.c_str(), SkeletonName.size() + 1);
+		toc.Add(BBMOD_SECTION_SKELETON_REFERENCE, 0, stream.str());
+	}
+	else
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!WriteSkeleton(stream))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_SKELETON, 0, stream.str());
+	}
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		uint32_t materialCount = (uint32_t)MaterialNames.size();
+		FILE_WRITE_DATA(stream, materialCount);
+		for (std::string& materialName : MaterialNames)
+		{
+			const char* str = materialName.c_str();
+			stream.write(str, strlen(str) + 1);
+		}
+		toc.Add(BBMOD_SECTION_MATERIALS, 0, stream.str());
+	}
+
+	if (!BoneLods.empty())
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		uint32_t lodCount = (uint32_t)BoneLods.size();
+		FILE_WRITE_DATA(stream, lodCount);
+		FILE_WRITE_DATA(stream, BoneCount);
+		stream.write(reinterpret_cast<const char*>(BoneImportance.data()), BoneCount * sizeof(float));
+		for (SBoneLod& lod : BoneLods)
+		{
+			FILE_WRITE_DATA(stream, lod.KeptCount);
+			stream.write(reinterpret_cast<const char*>(lod.BoneMap.data()), BoneCount * sizeof(uint32_t));
+			uint32_t meshCount = (uint32_t)lod.MeshRemaps.size();
+			FILE_WRITE_DATA(stream, meshCount);
+			for (auto& remaps : lod.MeshRemaps)
+			{
+				uint32_t pairCount = (uint32_t)remaps.size();
+				FILE_WRITE_DATA(stream, pairCount);
+				for (auto& pair : remaps)
+				{
+					FILE_WRITE_DATA(stream, pair.first);
+					FILE_WRITE_DATA(stream, pair.second);
+				}
+			}
+		}
+		toc.Add(BBMOD_SECTION_BONE_LODS, 0, stream.str());
+	}
+
+	return toc.Save(file, fileStart);
+}
+
+SModel* SModel::Load(std::string path, uint32_t parts)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+
+	if (!file.is_open())
+	{
+		return nullptr;
+	}
+
+	if (IsContainer(file))
+	{
+		SContainerReader reader;
+
+		if (!reader.Open(file))
+		{
+			return nullptr;
+		}
+
+		SContainerStreamBuf buffer(reader);
+		std::istream stream(&buffer);
+		return Load(stream, parts);
+	}
+
+	return Load(file, parts);
+}
+
+SModel* SModel::Load(std::istream& file, uint32_t parts)
+{
+	uint64_t fileStart = (uint64_t)file.tellg();
+
+	char header[6];
+	file.read(header, 6);
+
+	bool hasMinorVersion = false;
+
+	if (std::strcmp(header, "bbmod") == 0)
+	{
+	}
+	else if (std::strcmp(header, "BBMOD") == 0)
+	{
+		hasMinorVersion = true;
+	}
+	else
+	{
+		return nullptr;
+	}
+
+	uint8_t versionMajor;
+	FILE_READ_DATA(file, versionMajor);
+
+	if (versionMajor != BBMOD_VERSION_MAJOR)
+	{
+		return nullptr;
+	}
+
+	uint8_t versionMinor = 0;
+	if (hasMinorVersion)
+	{
+		FILE_READ_DATA(file, versionMinor);
+		if (versionMinor != BBMOD_VERSION_MINOR
+			&& versionMinor != BBMOD_VERSION_MINOR_TOC)
+		{
+			return nullptr;
+		}
+	}
+
+	SModel* model = new SModel();
+	model->VersionMajor = versionMajor;
+	model->VersionMinor = versionMinor;
+
+	if (versionMinor >= BBMOD_VERSION_MINOR_TOC)
+	{
+		if (!model->LoadSections(file, fileStart, parts))
+		{
+			return nullptr;
+		}
+		return model;
+	}
+
+	SVertexFormat* vertexFormat = nullptr;
+	if (!hasMinorVersion || versionMinor < 2)
+	{
+		vertexFormat = SVertexFormat::Load(file, versionMinor);
+		model->VertexFormat = vertexFormat;
+	}
+
+	uint32_t meshCount;
+	FILE_READ_DATA(file, meshCount);
+
+	for (uint32_t i = 0; i < meshCount; ++i)
+	{
+		SMesh* mesh = SMesh::Load(file, vertexFormat, model);
+		model->Meshes.push_back(mesh);
+	}
+
+	FILE_READ_DATA(file, model->NodeCount);
+
+	model->RootNode = SNode::Load(file);
+
+	FILE_READ_DATA(file, model->BoneCount);
+
+	for (uint32_t i = 0; i < model->BoneCount; ++i)
+	{
+		SBone* bone = SBone::Load(file);
+		model->Skeleton.push_back(bone);
+	}
+
+	uint32_t materialCount;
+	FILE_READ_DATA(file, materialCount);
+
+	for (uint32_t i = 0; i < materialCount; ++i)
+	{
+		std::string materialName;
+		std::getline(file, materialName, '\0');
+		model->MaterialNames.push_back(materialName);
+	}
+
+	return model;
+}
+
+bool SModel::LoadSections(std::istream& file, uint64_t fileStart, uint32_t parts)
+{
+	if (!TableOfContents.Load(file, fileStart))
 	{
-		aiMesh* meshCurrent = scene->mMeshes[i];
-		model->Meshes.push_back(SMesh::FromAssimp(scene, meshCurrent, model, config));
+		return false;
 	}
 
-	// Nodes
-	model->RootNode = CollectNodes(model, scene->mRootNode, config);
+	if (parts & BBMOD_LOAD_MESHES)
+	{
+		uint32_t meshCount = TableOfContents.Count(BBMOD_SECTION_MESH);
 
-	// Materials
-	for (uint32_t i = 0; i < scene->mNumMaterials; ++i)
+		for (uint32_t i = 0; i < meshCount; ++i)
+		{
+			SMesh* mesh = LoadMesh(file, i);
+			if (!mesh)
+			{
+				return false;
+			}
+			Meshes.push_back(mesh);
+		}
+	}
+
+	if (parts & BBMOD_LOAD_NODES)
 	{
-		aiMaterial* materialCurrent = scene->mMaterials[i];
-		model->MaterialNames.push_back(materialCurrent->GetName().C_Str());
+		if (TableOfContents.Seek(file, BBMOD_SECTION_NODE_TABLE))
+		{
+			const SSection* section = TableOfContents.Find(BBMOD_SECTION_NODE_TABLE);
+			SNodeTable table;
+			FILE_READ_DATA(file, NodeCount);
+			if (section->Size < sizeof(NodeCount)
+				|| !table.Load(file, TableOfContents.Count(BBMOD_SECTION_MESH), section->Size - sizeof(NodeCount)))
+			{
+				return false;
+			}
+			RootNode = table.ToTree();
+			FlatNodeTable = true;
+		}
+		else
+		{
+			if (!TableOfContents.Seek(file, BBMOD_SECTION_NODES))
+			{
+				return false;
+			}
+			FILE_READ_DATA(file, NodeCount);
+			RootNode = SNode::Load(file);
+		}
+
+		if (!RootNode)
+		{
+			return false;
+		}
 	}
 
-	return model;
-}
+	if (parts & BBMOD_LOAD_SKELETON)
+	{
+		if (TableOfContents.Seek(file, BBMOD_SECTION_SKELETON_REFERENCE))
+		{
+			FILE_READ_DATA(file, SkeletonHash);
+			FILE_READ_DATA(file, BoneCount);
+			std::getline(file, SkeletonName, '\0');
+		}
+		else
+		{
+			if (!TableOfContents.Seek(file, BBMOD_SECTION_SKELETON))
+			{
+				return false;
+			}
+			FILE_READ_DATA(file, BoneCount);
+			for (uint32_t i = 0; i < BoneCount; ++i)
+			{
+				Skeleton.push_back(SBone::Load(file));
+			}
+		}
+	}
 
-SBone* SModel::FindBoneByName(std::string name) const
-{
-	for (SBone* bone : Skeleton)
+	if (parts & BBMOD_LOAD_MATERIALS)
 	{
-		if (bone->Name == name)
+		if (!TableOfContents.Seek(file, BBMOD_SECTION_MATERIALS))
 		{
-			return bone;
+			return false;
+		}
+		uint32_t materialCount;
+		FILE_READ_DATA(file, materialCount);
+		for (uint32_t i = 0; i < materialCount; ++i)
+		{
+			std::string materialName;
+			std::getline(file, materialName, '\0');
+			MaterialNames.push_back(materialName);
 		}
 	}
-	return nullptr;
+
+	if ((parts & BBMOD_LOAD_SKELETON)
+		&& TableOfContents.Seek(file, BBMOD_SECTION_BONE_LODS))
+	{
+		uint32_t lodCount;
+		uint32_t boneCount;
+		FILE_READ_DATA(file, lodCount);
+		FILE_READ_DATA(file, boneCount);
+		BoneImportance.resize(boneCount);
+		file.read(reinterpret_cast<char*>(BoneImportance.data()), boneCount * sizeof(float));
+		for (uint32_t i = 0; i < lodCount && file.good(); ++i)
+		{
+			SBoneLod lod;
+			FILE_READ_DATA(file, lod.KeptCount);
+			lod.BoneMap.resize(boneCount);
+			file.read(reinterpret_cast<char*>(lod.BoneMap.data()), boneCount * sizeof(uint32_t));
+			uint32_t meshCount;
+			FILE_READ_DATA(file, meshCount);
+			lod.MeshRemaps.resize(meshCount);
+			for (uint32_t m = 0; m < meshCount && file.good(); ++m)
+			{
+				uint32_t pairCount;
+				FILE_READ_DATA(file, pairCount);
+				for (uint32_t p = 0; p < pairCount && file.good(); ++p)
+				{
+					std::pair<uint32_t, uint32_t> pair;
+					FILE_READ_DATA(file, pair.first);
+					FILE_READ_DATA(file, pair.second);
+					lod.MeshRemaps[m].push_back(pair);
+				}
+			}
+			BoneLods.push_back(std::move(lod));
+		}
+	}
+
+	return file.good();
 }
 
-SBone* SModel::FindBoneByIndex(int index) const
+SMesh* SModel::LoadMesh(std::istream& file, uint32_t index)
 {
+	if (!TableOfContents.Seek(file, BBMOD_SECTION_MESH, index))
+	{
+		return nullptr;
+	}
+	SMesh* mesh = SMesh::Load(file, nullptr, this);
+	if (mesh
+		&& TableOfContents.Seek(file, BBMOD_SECTION_MORPH_TARGETS, index)
+		&& !mesh->ReadMorphTargets(file))
+	{
+		delete mesh;
+		return nullptr;
+	}
+	return mesh;
+}
+
+bool SModel::NodeIsImportant(std::string name) const
+{
+	auto it = NodeImportanceMap.find(name);
+	return (it == NodeImportanceMap.end()) || it->second;
+}
+
+bool SModel::WriteSkeleton(std::ostream& file) const
+{
+	FILE_WRITE_DATA(file, BoneCount);
 	for (SBone* bone : Skeleton)
 	{
-		if (bone->Index == index)
+		if (!bone->Save(file))
 		{
-			return bone;
+			return false;
 		}
 	}
-	return nullptr;
+	return file.good();
 }
 
-SNode* SModel::FindNodeByName(std::string name, SNode* nodeCurrent) const
+/** Computes the 64-bit FNV-1a hash of given data. */
+static uint64_t HashData(const std::string& data, uint64_t hash = 14695981039346656037ull)
 {
-	if (nodeCurrent->Name == name)
+	for (unsigned char c : data)
 	{
-		return nodeCurrent;
+		hash ^= c;
+		hash *= 1099511628211ull;
 	}
-	for (SNode* child : nodeCurrent->Children)
+	return hash;
+}
+
+uint64_t SModel::ComputeSkeletonHash() const
+{
+	std::ostringstream nodes(std::ios::out | std::ios::binary);
+	FILE_WRITE_DATA(nodes, NodeCount);
+	SNodeTable::FromTree(RootNode).Save(nodes);
+
+	std::ostringstream bones(std::ios::out | std::ios::binary);
+	WriteSkeleton(bones);
+
+	uint64_t hash = HashData(bones.str(), HashData(nodes.str()));
+	return (hash != 0) ? hash : 1;
+}
+
+/** Returns true if a subtree contains a bone. */
+static bool HasBone(SNode* node)
+{
+	if (node->IsBone)
 	{
-		if (SNode* node = FindNodeByName(name, child))
+		return true;
+	}
+	for (SNode* child : node->Children)
+	{
+		if (HasBone(child))
 		{
-			return node;
+			return true;
 		}
 	}
-	return nullptr;
+	return false;
 }
 
-bool SModel::Save(std::string path)
+/** Copies bones, their ancestors and descendants, without meshes. */
+static SNode* CopyRig(SNode* node, bool insideBone)
 {
-	std::ofstream file(path, std::ios::out | std::ios::binary);
+	if (!insideBone && !HasBone(node))
+	{
+		return nullptr;
+	}
 
-	if (!file.is_open())
+	SNode* copy = new SNode();
+	copy->Name = node->Name;
+	copy->Index = node->Index;
+	copy->IsBone = node->IsBone;
+	dual_quaternion_copy(node->Transform, copy->Transform);
+	dual_quaternion_copy(node->PrunedTransform, copy->PrunedTransform);
+
+	for (SNode* child : node->Children)
 	{
-		return false;
+		if (SNode* childCopy = CopyRig(child, insideBone || node->IsBone))
+		{
+			copy->Children.push_back(childCopy);
+		}
 	}
 
-	file.write("BBMOD", sizeof(char) * 6);
-	FILE_WRITE_DATA(file, VersionMajor);
-	FILE_WRITE_DATA(file, VersionMinor);
+	return copy;
+}
 
-	/*if (!VertexFormat->Save(file))
+SModel* SModel::ExtractSkeleton() const
+{
+	SModel* skeleton = new SModel();
+	skeleton->VersionMinor = BBMOD_VERSION_MINOR_TOC;
+	skeleton->FlatNodeTable = true;
+	skeleton->BoneCount = BoneCount;
+
+	for (SBone* bone : Skeleton)
 	{
-		return false;
-	}*/
+		SBone* copy = new SBone();
+		copy->Name = bone->Name;
+		copy->Index = bone->Index;
+		dual_quaternion_copy(bone->Offset, copy->Offset);
+		skeleton->Skeleton.push_back(copy);
+	}
 
-	uint32_t meshCount = (uint32_t)Meshes.size();
-	FILE_WRITE_DATA(file, meshCount);
+	skeleton->RootNode = RootNode ? CopyRig(RootNode, false) : nullptr;
+	skeleton->NodeCount = skeleton->BoneCount;
 
-	for (SMesh* mesh : Meshes)
+	if (skeleton->RootNode)
 	{
-		if (!mesh->Save(file))
+		std::vector<SNode*> nodes;
+		CollectNodeList(skeleton->RootNode, nodes);
+		for (SNode* node : nodes)
 		{
-			return false;
+			if (!node->IsBone)
+			{
+				node->Index = (float)skeleton->NodeCount++;
+			}
 		}
 	}
 
-	FILE_WRITE_DATA(file, NodeCount);
+	skeleton->SkeletonHash = skeleton->ComputeSkeletonHash();
 
-	if (!RootNode->Save(file))
+	return skeleton;
+}
+
+bool SModel::SaveSkeleton(std::string path)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary);
+
+	if (!file.is_open() || !RootNode)
 	{
 		return false;
 	}
 
-	FILE_WRITE_DATA(file, BoneCount);
+	uint64_t fileStart = (uint64_t)file.tellp();
+
+	file.write("BBSKEL", sizeof(char) * 7);
+	FILE_WRITE_DATA(file, VersionMajor);
+	uint8_t versionMinor = BBMOD_VERSION_MINOR_TOC;
+	FILE_WRITE_DATA(file, versionMinor);
+
+	STableOfContents toc;
 
-	for (SBone* bone : Skeleton)
 	{
-		if (!bone->Save(file))
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_DATA(stream, NodeCount);
+		if (!SNodeTable::FromTree(RootNode).Save(stream))
 		{
 			return false;
 		}
+		toc.Add(BBMOD_SECTION_NODE_TABLE, 0, stream.str());
 	}
 
-	uint32_t materialCount = (uint32_t)MaterialNames.size();
-	FILE_WRITE_DATA(file, materialCount);
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		if (!WriteSkeleton(stream))
+		{
+			return false;
+		}
+		toc.Add(BBMOD_SECTION_SKELETON, 0, stream.str());
+	}
 
-	for (std::string& materialName : MaterialNames)
 	{
-		const char* str = materialName.c_str();
-		file.write(str, strlen(str) + 1);
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		SkeletonHash = ComputeSkeletonHash();
+		FILE_WRITE_DATA(stream, SkeletonHash);
+		toc.Add(BBMOD_SECTION_HASH, 0, stream.str());
+	}
+
+	if (!toc.Save(file, fileStart))
+	{
+		return false;
 	}
 
 	file.flush();
@@ -226,7 +1455,7 @@ bool SModel::Save(std::string path)
 	return true;
 }
 
-SModel* SModel::Load(std::string path)
+SModel* SModel::LoadSkeleton(std::string path)
 {
 	std::ifstream file(path, std::ios::in | std::ios::binary);
 
@@ -235,91 +1464,207 @@ SModel* SModel::Load(std::string path)
 		return nullptr;
 	}
 
-	char header[6];
-	file.read(header, 6);
+	uint64_t fileStart = (uint64_t)file.tellg();
 
-	bool hasMinorVersion = false;
+	char header[7];
+	file.read(header, 7);
 
-	if (std::strcmp(header, "bbmod") == 0)
+	uint8_t versionMajor;
+	uint8_t versionMinor;
+	FILE_READ_DATA(file, versionMajor);
+	FILE_READ_DATA(file, versionMinor);
+
+	if (!file
+		|| std::strcmp(header, "BBSKEL") != 0
+		|| versionMajor != BBMOD_VERSION_MAJOR
+		|| versionMinor != BBMOD_VERSION_MINOR_TOC)
 	{
+		return nullptr;
 	}
-	else if (std::strcmp(header, "BBMOD") == 0)
+
+	std::unique_ptr<SModel> skeleton = std::make_unique<SModel>();
+	skeleton->VersionMajor = versionMajor;
+	skeleton->VersionMinor = versionMinor;
+
+	uint64_t hash = 0;
+
+	if (!skeleton->LoadSections(file, fileStart, BBMOD_LOAD_NODES | BBMOD_LOAD_SKELETON)
+		|| !skeleton->TableOfContents.Seek(file, BBMOD_SECTION_HASH))
 	{
-		hasMinorVersion = true;
+		return nullptr;
 	}
-	else
+
+	FILE_READ_DATA(file, hash);
+	skeleton->SkeletonHash = skeleton->ComputeSkeletonHash();
+
+	// Bones do not store their names
+	std::vector<SNode*> nodes;
+	CollectNodeList(skeleton->RootNode, nodes);
+	for (SNode* node : nodes)
+	{
+		if (node->IsBone && (uint32_t)node->Index < skeleton->BoneCount)
+		{
+			skeleton->Skeleton[(uint32_t)node->Index]->Name = node->Name;
+		}
+	}
+
+	if (!file || hash != skeleton->SkeletonHash)
 	{
-		file.close();
 		return nullptr;
 	}
 
-	uint8_t versionMajor;
-	FILE_READ_DATA(file, versionMajor);
+	return skeleton.release();
+}
 
-	if (versionMajor != BBMOD_VERSION_MAJOR)
+/** Maps names of bones to names of their parent bones. */
+static void CollectParentBoneNames(SNode* node, const std::string& parent, std::map<std::string, std::string>& out)
+{
+	const std::string& parentNext = node->IsBone ? node->Name : parent;
+	if (node->IsBone)
 	{
-		file.close();
-		return nullptr;
+		out[node->Name] = parent;
+	}
+	for (SNode* child : node->Children)
+	{
+		CollectParentBoneNames(child, parentNext, out);
 	}
+}
 
-	uint8_t versionMinor = 0;
-	if (hasMinorVersion)
+std::vector<std::string> SModel::FindBindPoseMismatches(const SModel* skeleton) const
+{
+	std::vector<std::string> mismatches;
+
+	for (SBone* bone : Skeleton)
 	{
-		FILE_READ_DATA(file, versionMinor);
-		if (versionMinor != BBMOD_VERSION_MINOR)
+		SBone* other = skeleton->FindBoneByName(bone->Name);
+		if (!other)
 		{
-			file.close();
-			return nullptr;
+			continue;
+		}
+
+		vec3_t t1, t2;
+		quat_t r1, r2;
+		dual_quaternion_get_translation(bone->Offset, t1);
+		dual_quaternion_get_translation(other->Offset, t2);
+		dual_quaternion_get_rotation(bone->Offset, r1);
+		dual_quaternion_get_rotation(other->Offset, r2);
+		quaternion_normalize(r1);
+		quaternion_normalize(r2);
+
+		float distance = sqrtf(
+			(t1[0] - t2[0]) * (t1[0] - t2[0])
+			+ (t1[1] - t2[1]) * (t1[1] - t2[1])
+			+ (t1[2] - t2[2]) * (t1[2] - t2[2]));
+
+		if (distance > 0.001f || fabsf(quaternion_dot(r1, r2)) < 0.99999f)
+		{
+			mismatches.push_back(bone->Name);
 		}
 	}
 
-	SModel* model = new SModel();
-	model->VersionMajor = versionMajor;
-	model->VersionMinor = versionMinor;
+	return mismatches;
+}
 
-	SVertexFormat* vertexFormat = nullptr;
-	if (!hasMinorVersion || versionMinor < 2)
+bool SModel::ApplySkeleton(SModel* skeleton, std::string& error)
+{
+	if (!RootNode || !skeleton->RootNode)
 	{
-		vertexFormat = SVertexFormat::Load(file, versionMinor);
-		model->VertexFormat = vertexFormat;
+		error = "Missing node hierarchy.";
+		return false;
 	}
 
-	uint32_t meshCount;
-	FILE_READ_DATA(file, meshCount);
+	// Bone names and order
+	std::vector<int32_t> boneMap(BoneCount, -1);
 
-	for (uint32_t i = 0; i < meshCount; ++i)
+	for (uint32_t i = 0; i < BoneCount; ++i)
 	{
-		SMesh* mesh = SMesh::Load(file, vertexFormat, model);
-		model->Meshes.push_back(mesh);
+		SBone* bone = skeleton->FindBoneByName(Skeleton[i]->Name);
+		if (!bone)
+		{
+			error = "Bone \"" + Skeleton[i]->Name + "\" is not in the skeleton.";
+			return false;
+		}
+		boneMap[i] = (int32_t)bone->Index;
 	}
 
-	FILE_READ_DATA(file, model->NodeCount);
+	// Bone hierarchy
+	std::map<std::string, std::string> parents;
+	std::map<std::string, std::string> skeletonParents;
+	CollectParentBoneNames(RootNode, "", parents);
+	CollectParentBoneNames(skeleton->RootNode, "", skeletonParents);
 
-	model->RootNode = SNode::Load(file);
+	for (const auto& pair : parents)
+	{
+		const std::string& skeletonParent = skeletonParents[pair.first];
+		if (pair.second != skeletonParent)
+		{
+			error = "Bone \"" + pair.first + "\" is a child of \"" + pair.second
+				+ "\", but in the skeleton it is a child of \"" + skeletonParent + "\".";
+			return false;
+		}
+	}
 
-	FILE_READ_DATA(file, model->BoneCount);
+	std::vector<SNode*> nodes;
+	CollectNodeList(RootNode, nodes);
 
-	for (uint32_t i = 0; i < model->BoneCount; ++i)
+	Reindex(boneMap, nodes);
+
+	// Bones which the model does not have
+	Skeleton.resize(skeleton->BoneCount, nullptr);
+	BoneCount = skeleton->BoneCount;
+
+	for (uint32_t i = 0; i < BoneCount; ++i)
 	{
-		SBone* bone = SBone::Load(file);
-		model->Skeleton.push_back(bone);
+		if (!Skeleton[i])
+		{
+			SBone* bone = new SBone();
+			bone->Name = skeleton->Skeleton[i]->Name;
+			bone->Index = (float)i;
+			dual_quaternion_copy(skeleton->Skeleton[i]->Offset, bone->Offset);
+			Skeleton[i] = bone;
+		}
 	}
 
-	uint32_t materialCount;
-	FILE_READ_DATA(file, materialCount);
+	// Other nodes get the skeleton's indices if it has them
+	NodeCount = skeleton->NodeCount;
 
-	for (uint32_t i = 0; i < materialCount; ++i)
+	for (SNode* node : nodes)
 	{
-		std::string materialName;
-		std::getline(file, materialName, '\0');
-		model->MaterialNames.push_back(materialName);
+		SNode* skeletonNode = skeleton->FindNodeByName(node->Name, skeleton->RootNode);
+
+		if (!node->IsBone)
+		{
+			node->Index = (skeletonNode && !skeletonNode->IsBone)
+				? skeletonNode->Index
+				: (float)NodeCount++;
+		}
+
+		if (skeletonNode)
+		{
+			dual_quaternion_copy(node->PrunedTransform, skeletonNode->PrunedTransform);
+		}
+		else
+		{
+			skeleton->NodeImportanceMap[node->Name] = false;
+		}
 	}
 
-	file.close();
-	return model;
-}
+	for (const auto& pair : NodeImportanceMap)
+	{
+		if (!pair.second)
+		{
+			skeleton->NodeImportanceMap[pair.first] = false;
+		}
+	}
+
+	if (!BoneLods.empty())
+	{
+		ComputeBoneLods((uint32_t)BoneLods.size());
+	}
+
+	SkeletonHash = skeleton->SkeletonHash;
+	SkeletonName = skeleton->SkeletonName;
+	VersionMinor = BBMOD_VERSION_MINOR_TOC;
 
-bool SModel::NodeIsImportant(std::string name) const
-{
 	return true;
 }
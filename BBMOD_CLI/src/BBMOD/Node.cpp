@@ -2,7 +2,7 @@
 #include <utils.hpp>
 #include <iostream>
 
-bool SNode::Save(std::ofstream& file)
+bool SNode::Save(std::ostream& file)
 {
 	const char* str = Name.c_str();
 	file.write(str, strlen(str) + 1);
@@ -33,7 +33,7 @@ bool SNode::Save(std::ofstream& file)
 	return true;
 }
 
-SNode* SNode::Load(std::ifstream& file)
+SNode* SNode::Load(std::istream& file)
 {
 	SNode* node = new SNode();
 
@@ -66,3 +66,237 @@ SNode* SNode::Load(std::ifstream& file)
 
 	return node;
 }
+
+static void FlattenNode(SNode* node, int32_t parent, SNodeTable& table)
+{
+	int32_t row = (int32_t)table.Parents.size();
+
+	table.Parents.push_back(parent);
+	table.Indices.push_back((uint32_t)node->Index);
+	table.IsBone.push_back(node->IsBone ? 1 : 0);
+	table.Transforms.insert(table.Transforms.end(), node->Transform, node->Transform + 8);
+	table.MeshIndices.insert(table.MeshIndices.end(), node->Meshes.begin(), node->Meshes.end());
+	table.MeshStarts.push_back((uint32_t)table.MeshIndices.size());
+	table.NameOffsets.push_back((uint32_t)table.Names.size());
+	table.Names.append(node->Name.c_str(), node->Name.size() + 1);
+
+	for (SNode* child : node->Children)
+	{
+		FlattenNode(child, row, table);
+	}
+}
+
+SNodeTable SNodeTable::FromTree(SNode* root)
+{
+	SNodeTable table;
+	table.MeshStarts.push_back(0);
+	if (root)
+	{
+		FlattenNode(root, -1, table);
+	}
+	return table;
+}
+
+SNode* SNodeTable::ToTree() const
+{
+	std::vector<SNode*> nodes;
+
+	for (uint32_t i = 0; i < Parents.size(); ++i)
+	{
+		if (Parents[i] >= (int32_t)i || (i > 0 && Parents[i] < 0))
+		{
+			for (SNode* node : nodes)
+			{
+				delete node;
+			}
+			return nullptr;
+		}
+
+		SNode* node = new SNode();
+		node->Name = GetName(i);
+		node->Index = (float)Indices[i];
+		node->IsBone = (IsBone[i] != 0);
+		memcpy(node->Transform, &Transforms[i * 8], sizeof(float) * 8);
+		node->Meshes.assign(MeshIndices.begin() + MeshStarts[i], MeshIndices.begin() + MeshStarts[i + 1]);
+
+		if (Parents[i] >= 0)
+		{
+			nodes[Parents[i]]->Children.push_back(node);
+		}
+
+		nodes.push_back(node);
+	}
+
+	return nodes.empty() ? nullptr : nodes[0];
+}
+
+const char* SNodeTable::GetName(uint32_t row) const
+{
+	return Names.c_str() + NameOffsets[row];
+}
+
+bool SNodeTable::Save(std::ostream& file) const
+{
+	uint32_t nodeCount = (uint32_t)Parents.size();
+	FILE_WRITE_DATA(file, nodeCount);
+	file.write(reinterpret_cast<const char*>(Parents.data()), nodeCount * sizeof(int32_t));
+	file.write(reinterpret_cast<const char*>(Indices.data()), nodeCount * sizeof(uint32_t));
+	file.write(reinterpret_cast<const char*>(Transforms.data()), nodeCount * 8 * sizeof(float));
+	file.write(reinterpret_cast<const char*>(MeshStarts.data()), (nodeCount + 1) * sizeof(uint32_t));
+	file.write(reinterpret_cast<const char*>(MeshIndices.data()), MeshIndices.size() * sizeof(uint32_t));
+	file.write(reinterpret_cast<const char*>(NameOffsets.data()), nodeCount * sizeof(uint32_t));
+	uint32_t namesSize = (uint32_t)Names.size();
+	FILE_WRITE_DATA(file, namesSize);
+	file.write(Names.data(), namesSize);
+	file.write(reinterpret_cast<const char*>(IsBone.data()), nodeCount);
+	return file.good();
+}
+
+bool SNodeTable::Load(std::istream& file, uint32_t meshCount, uint64_t size)
+{
+	uint32_t nodeCount = 0;
+	FILE_READ_DATA(file, nodeCount);
+	if (!file)
+	{
+		return false;
+	}
+
+	// Node count, per node arrays, the extra mesh start and the names size
+	uint64_t fixedSize = sizeof(uint32_t)
+		+ (uint64_t)nodeCount * (sizeof(int32_t) + sizeof(uint32_t) + 8 * sizeof(float) + sizeof(uint32_t) + sizeof(uint32_t) + 1)
+		+ sizeof(uint32_t) + sizeof(uint32_t);
+	if (fixedSize > size)
+	{
+		return false;
+	}
+
+	Parents.resize(nodeCount);
+	Indices.resize(nodeCount);
+	Transforms.resize(nodeCount * 8);
+	MeshStarts.resize(nodeCount + 1);
+	NameOffsets.resize(nodeCount);
+	IsBone.resize(nodeCount);
+
+	file.read(reinterpret_cast<char*>(Parents.data()), nodeCount * sizeof(int32_t));
+	file.read(reinterpret_cast<char*>(Indices.data()), nodeCount * sizeof(uint32_t));
+	file.read(reinterpret_cast<char*>(Transforms.data()), nodeCount * 8 * sizeof(float));
+	file.read(reinterpret_cast<char*>(MeshStarts.data()), (nodeCount + 1) * sizeof(uint32_t));
+	if (!file || MeshStarts[0] != 0)
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < nodeCount; ++i)
+	{
+		if (MeshStarts[i] > MeshStarts[i + 1])
+		{
+			return false;
+		}
+	}
+
+	if ((uint64_t)MeshStarts[nodeCount] * sizeof(uint32_t) > size - fixedSize)
+	{
+		return false;
+	}
+
+	MeshIndices.resize(MeshStarts[nodeCount]);
+	file.read(reinterpret_cast<char*>(MeshIndices.data()), MeshIndices.size() * sizeof(uint32_t));
+	file.read(reinterpret_cast<char*>(NameOffsets.data()), nodeCount * sizeof(uint32_t));
+
+	for (uint32_t meshIndex : MeshIndices)
+	{
+		if (meshIndex >= meshCount)
+		{
+			return false;
+		}
+	}
+
+	uint32_t namesSize = 0;
+	FILE_READ_DATA(file, namesSize);
+	if (!file || namesSize > size - fixedSize - MeshIndices.size() * sizeof(uint32_t))
+	{
+		return false;
+	}
+	Names.resize(namesSize);
+	file.read(&Names[0], namesSize);
+	file.read(reinterpret_cast<char*>(IsBone.data()), nodeCount);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < nodeCount; ++i)
+	{
+		if (NameOffsets[i] >= namesSize)
+		{
+			return false;
+		}
+	}
+
+	return !Names.empty() ? Names.back() == '\0' : nodeCount == 0;
+}
+
+/** Matches a name against a single pattern with wildcards. */
+static bool MatchPattern(const char* name, const char* nameEnd, const char* pattern, const char* patternEnd)
+{
+	const char* starPattern = nullptr;
+	const char* starName = nullptr;
+
+	while (name != nameEnd)
+	{
+		if (pattern != patternEnd && (*pattern == '?' || *pattern == *name))
+		{
+			++name;
+			++pattern;
+		}
+		else if (pattern != patternEnd && *pattern == '*')
+		{
+			starPattern = pattern++;
+			starName = name;
+		}
+		else if (starPattern)
+		{
+			// Backtrack, let the last star consume one more character
+			pattern = starPattern + 1;
+			name = ++starName;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while (pattern != patternEnd && *pattern == '*')
+	{
+		++pattern;
+	}
+
+	return (pattern == patternEnd);
+}
+
+bool MatchNamePatterns(const std::string& name, const std::string& patterns)
+{
+	size_t start = 0;
+
+	while (start <= patterns.size())
+	{
+		size_t end = patterns.find(',', start);
+		if (end == std::string::npos)
+		{
+			end = patterns.size();
+		}
+
+		if (end > start
+			&& MatchPattern(
+				name.data(), name.data() + name.size(),
+				patterns.data() + start, patterns.data() + end))
+		{
+			return true;
+		}
+
+		start = end + 1;
+	}
+
+	return false;
+}
@@ -0,0 +1,95 @@
+#include <BBMOD/Progress.hpp>
+
+#include <algorithm>
+
+/** Where each BBMOD_STAGE_ starts within the conversion of a single file. */
+static const float gStageStart[] = {
+	0.0f,  // BBMOD_STAGE_NONE
+	0.0f,  // BBMOD_STAGE_LOAD
+	0.4f,  // BBMOD_STAGE_MESHES
+	0.6f,  // BBMOD_STAGE_SAVE
+	0.7f,  // BBMOD_STAGE_ANIMATIONS
+	1.0f,  // BBMOD_STAGE_DONE
+};
+
+void SProgress::Reset()
+{
+	Stage = BBMOD_STAGE_NONE;
+	Fraction = 0.0f;
+	FileIndex = 0;
+	FileCount = 1;
+	Cancelled = false;
+
+	std::lock_guard<std::mutex> lock(OutputsMutex);
+	Outputs.clear();
+}
+
+void SProgress::BeginFile(uint32_t index, uint32_t count)
+{
+	FileCount = std::max<uint32_t>(count, 1);
+	FileIndex = index;
+	SetStage(BBMOD_STAGE_LOAD);
+}
+
+void SProgress::SetStage(uint32_t stage)
+{
+	Fraction = 0.0f;
+	Stage = std::min<uint32_t>(stage, BBMOD_STAGE_DONE);
+}
+
+void SProgress::SetStep(uint32_t step, uint32_t count)
+{
+	Fraction = (count > 0) ? std::min((float)step / (float)count, 1.0f) : 1.0f;
+}
+
+float SProgress::GetTotal() const
+{
+	uint32_t stage = Stage;
+
+	if (stage == BBMOD_STAGE_DONE)
+	{
+		return 1.0f;
+	}
+
+	float start = gStageStart[stage];
+	float end = gStageStart[stage + 1];
+	float file = start + (end - start) * Fraction;
+
+	return std::min((FileIndex + file) / FileCount, 1.0f);
+}
+
+const char* SProgress::GetStageName(uint32_t stage)
+{
+	switch (stage)
+	{
+	case BBMOD_STAGE_LOAD:
+		return "Loading";
+
+	case BBMOD_STAGE_MESHES:
+		return "Converting meshes";
+
+	case BBMOD_STAGE_SAVE:
+		return "Saving";
+
+	case BBMOD_STAGE_ANIMATIONS:
+		return "Converting animations";
+
+	case BBMOD_STAGE_DONE:
+		return "Done";
+
+	default:
+		return "";
+	}
+}
+
+void SProgress::AddOutput(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(OutputsMutex);
+	Outputs.push_back(path);
+}
+
+std::vector<std::string> SProgress::GetOutputs() const
+{
+	std::lock_guard<std::mutex> lock(OutputsMutex);
+	return Outputs;
+}
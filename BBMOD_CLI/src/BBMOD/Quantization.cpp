@@ -0,0 +1,208 @@
+#include <BBMOD/Quantization.hpp>
+#include <BBMOD/Math.hpp>
+
+#include <cstring>
+
+uint16_t FloatToHalf(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000;
+	int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+	uint32_t mantissa = bits & 0x007FFFFF;
+
+	if (((bits >> 23) & 0xFF) == 0xFF)
+	{
+		// Inf or NaN
+		return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+	}
+
+	if (exponent >= 31)
+	{
+		// Overflow to inf
+		return (uint16_t)(sign | 0x7C00);
+	}
+
+	if (exponent <= 0)
+	{
+		// Subnormal or zero
+		if (exponent < -10)
+		{
+			return (uint16_t)sign;
+		}
+		mantissa |= 0x00800000;
+		uint32_t shift = (uint32_t)(14 - exponent);
+		uint32_t half = mantissa >> shift;
+		uint32_t rest = mantissa & ((1u << shift) - 1);
+		uint32_t middle = 1u << (shift - 1);
+		if (rest > middle || (rest == middle && (half & 1)))
+		{
+			++half;
+		}
+		return (uint16_t)(sign | half);
+	}
+
+	uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+	uint32_t rest = mantissa & 0x1FFF;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+	{
+		// Round to nearest even, may carry into the exponent
+		++half;
+	}
+	return (uint16_t)half;
+}
+
+float HalfToFloat(uint16_t value)
+{
+	uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+	uint32_t exponent = (value >> 10) & 0x1F;
+	uint32_t mantissa = value & 0x3FF;
+	uint32_t bits;
+
+	if (exponent == 0)
+	{
+		if (mantissa == 0)
+		{
+			bits = sign;
+		}
+		else
+		{
+			// Normalize a subnormal
+			exponent = 127 - 15 + 1;
+			while (!(mantissa & 0x400))
+			{
+				mantissa <<= 1;
+				--exponent;
+			}
+			mantissa &= 0x3FF;
+			bits = sign | (exponent << 23) | (mantissa << 13);
+		}
+	}
+	else if (exponent == 31)
+	{
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	}
+	else
+	{
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+/** Largest possible value of a quaternion component other than the largest one. */
+#define SMALLEST_THREE_RANGE 0.70710678f
+
+/**
+ * Finds the largest component of a quaternion and quantizes the others to
+ * given number of bits. Returns the components packed into a single integer.
+ */
+static uint64_t PackSmallestThree(const quat_t q, uint32_t bits)
+{
+	uint32_t largest = 0;
+	for (uint32_t i = 1; i < 4; ++i)
+	{
+		if (fabsf(q[i]) > fabsf(q[largest]))
+		{
+			largest = i;
+		}
+	}
+
+	float length = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+	float sign = (q[largest] < 0.0f) ? -1.0f : 1.0f;
+	float scale = (length > 0.0f) ? sign / length : 1.0f;
+	uint32_t maxValue = (1u << bits) - 1;
+
+	uint64_t packed = largest;
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		if (i == largest)
+		{
+			continue;
+		}
+		float value = q[i] * scale;
+		value = (value / SMALLEST_THREE_RANGE) * 0.5f + 0.5f;
+		value = (value < 0.0f) ? 0.0f : ((value > 1.0f) ? 1.0f : value);
+		packed = (packed << bits) | (uint64_t)(value * (float)maxValue + 0.5f);
+	}
+
+	return packed;
+}
+
+static void UnpackSmallestThree(uint64_t packed, uint32_t bits, quat_t q)
+{
+	uint32_t maxValue = (1u << bits) - 1;
+	uint32_t largest = (uint32_t)(packed >> (bits * 3)) & 3;
+	float sum = 0.0f;
+
+	for (int32_t i = 3, shift = 0; i >= 0; --i)
+	{
+		if ((uint32_t)i == largest)
+		{
+			continue;
+		}
+		float value = (float)((packed >> shift) & maxValue) / (float)maxValue;
+		q[i] = (value * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+		sum += q[i] * q[i];
+		shift += bits;
+	}
+
+	q[largest] = sqrtf((sum < 1.0f) ? (1.0f - sum) : 0.0f);
+}
+
+void QuaternionPack48(const quat_t q, uint8_t out[6])
+{
+	uint64_t packed = PackSmallestThree(q, 15);
+	for (uint32_t i = 0; i < 6; ++i)
+	{
+		out[i] = (uint8_t)(packed >> (i * 8));
+	}
+}
+
+void QuaternionUnpack48(const uint8_t in[6], quat_t q)
+{
+	uint64_t packed = 0;
+	for (uint32_t i = 0; i < 6; ++i)
+	{
+		packed |= (uint64_t)in[i] << (i * 8);
+	}
+	UnpackSmallestThree(packed, 15, q);
+}
+
+void QuaternionPack32(const quat_t q, uint8_t out[4])
+{
+	uint64_t packed = PackSmallestThree(q, 10);
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		out[i] = (uint8_t)(packed >> (i * 8));
+	}
+}
+
+void QuaternionUnpack32(const uint8_t in[4], quat_t q)
+{
+	uint64_t packed = 0;
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		packed |= (uint64_t)in[i] << (i * 8);
+	}
+	UnpackSmallestThree(packed, 10, q);
+}
+
+uint16_t QuantizeRange16(float value, float min, float max)
+{
+	if (max <= min)
+	{
+		return 0;
+	}
+	float factor = (value - min) / (max - min);
+	factor = (factor < 0.0f) ? 0.0f : ((factor > 1.0f) ? 1.0f : factor);
+	return (uint16_t)(factor * 65535.0f + 0.5f);
+}
+
+float DequantizeRange16(uint16_t value, float min, float max)
+{
+	return min + (max - min) * ((float)value / 65535.0f);
+}
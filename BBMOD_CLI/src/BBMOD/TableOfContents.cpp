@@ -0,0 +1,135 @@
+#include <BBMOD/TableOfContents.hpp>
+#include <utils.hpp>
+
+#include <cstring>
+
+/** Size of a single entry of a table of contents in bytes. */
+#define TOC_ENTRY_SIZE (4 + 4 + 8 + 8)
+
+static inline uint64_t Align(uint64_t value)
+{
+	return (value + BBMOD_SECTION_ALIGNMENT - 1) / BBMOD_SECTION_ALIGNMENT * BBMOD_SECTION_ALIGNMENT;
+}
+
+void STableOfContents::Add(const char* tag, uint32_t index, std::string data)
+{
+	SSection section;
+	std::memcpy(section.Tag, tag, 4);
+	section.Index = index;
+	section.Size = data.size();
+	Sections.push_back(section);
+	Data.push_back(std::move(data));
+}
+
+bool STableOfContents::Save(std::ostream& file, uint64_t fileStart)
+{
+	FileStart = fileStart;
+
+	uint64_t tableStart = (uint64_t)file.tellp() - fileStart;
+	uint32_t sectionCount = (uint32_t)Sections.size();
+	uint64_t offset = tableStart + sizeof(sectionCount) + sectionCount * TOC_ENTRY_SIZE;
+
+	for (SSection& section : Sections)
+	{
+		offset = Align(offset);
+		section.Offset = offset;
+		offset += section.Size;
+	}
+
+	FILE_WRITE_DATA(file, sectionCount);
+
+	for (SSection& section : Sections)
+	{
+		file.write(section.Tag, 4);
+		FILE_WRITE_DATA(file, section.Index);
+		FILE_WRITE_DATA(file, section.Offset);
+		FILE_WRITE_DATA(file, section.Size);
+	}
+
+	for (size_t i = 0; i < Sections.size(); ++i)
+	{
+		uint64_t position = (uint64_t)file.tellp() - fileStart;
+		static const char padding[BBMOD_SECTION_ALIGNMENT] = { 0 };
+		file.write(padding, Sections[i].Offset - position);
+		file.write(Data[i].data(), Data[i].size());
+	}
+
+	Data.clear();
+
+	return file.good();
+}
+
+bool STableOfContents::Load(std::istream& file, uint64_t fileStart)
+{
+	FileStart = fileStart;
+	Sections.clear();
+
+	uint32_t sectionCount;
+	FILE_READ_DATA(file, sectionCount);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < sectionCount; ++i)
+	{
+		SSection section;
+		file.read(section.Tag, 4);
+		FILE_READ_DATA(file, section.Index);
+		FILE_READ_DATA(file, section.Offset);
+		FILE_READ_DATA(file, section.Size);
+		Sections.push_back(section);
+	}
+
+	return file.good();
+}
+
+const SSection* STableOfContents::Find(const char* tag, uint32_t index) const
+{
+	for (const SSection& section : Sections)
+	{
+		if (std::memcmp(section.Tag, tag, 4) == 0 && section.Index == index)
+		{
+			return &section;
+		}
+	}
+	return nullptr;
+}
+
+uint32_t STableOfContents::Count(const char* tag) const
+{
+	uint32_t count = 0;
+	for (const SSection& section : Sections)
+	{
+		if (std::memcmp(section.Tag, tag, 4) == 0)
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+bool STableOfContents::Seek(std::istream& file, const char* tag, uint32_t index) const
+{
+	const SSection* section = Find(tag, index);
+	if (!section)
+	{
+		return false;
+	}
+	file.clear();
+	file.seekg((std::streamoff)(FileStart + section->Offset));
+	return file.good();
+}
+
+bool STableOfContents::Read(std::istream& file, const char* tag, uint32_t index, std::string& out) const
+{
+	const SSection* section = Find(tag, index);
+	if (!section || !Seek(file, tag, index))
+	{
+		return false;
+	}
+	out.resize((size_t)section->Size);
+	file.read(&out[0], out.size());
+	return file.good();
+}
@@ -0,0 +1,324 @@
+#include <BBMOD/TangentSpace.hpp>
+#include <BBMOD/Vector3.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+/** A key of a hash map made of raw bytes of up to nine floats or integers. */
+struct SHashKey
+{
+	uint32_t Data[9] = { 0 };
+
+	bool operator==(const SHashKey& other) const
+	{
+		return std::memcmp(Data, other.Data, sizeof(Data)) == 0;
+	}
+};
+
+struct SHashKeyHasher
+{
+	size_t operator()(const SHashKey& key) const
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for (uint32_t value : key.Data)
+		{
+			hash = (hash ^ value) * 1099511628211ull;
+		}
+		return (size_t)hash;
+	}
+};
+
+static inline void Vec3Sub(const float* a, const float* b, float* out)
+{
+	out[0] = a[0] - b[0];
+	out[1] = a[1] - b[1];
+	out[2] = a[2] - b[2];
+}
+
+static inline void Vec3Cross(const float* a, const float* b, float* out)
+{
+	float x = a[1] * b[2] - a[2] * b[1];
+	float y = a[2] * b[0] - a[0] * b[2];
+	float z = a[0] * b[1] - a[1] * b[0];
+	out[0] = x;
+	out[1] = y;
+	out[2] = z;
+}
+
+static inline float Vec3Dot(const float* a, const float* b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/** Normalizes a vector in place. Returns false if it has zero length. */
+static inline bool Vec3Normalize(float* v)
+{
+	float length = sqrtf(Vec3Dot(v, v));
+	if (length <= 0.0f || !std::isfinite(length))
+	{
+		return false;
+	}
+	v[0] /= length;
+	v[1] /= length;
+	v[2] /= length;
+	return true;
+}
+
+/** Writes any unit vector perpendicular to `n` into `out`. */
+static inline void Vec3Perpendicular(const float* n, float* out)
+{
+	float axis[3] = { 0.0f, 0.0f, 0.0f };
+	axis[(fabsf(n[0]) < 0.9f) ? 0 : 1] = 1.0f;
+	Vec3Cross(n, axis, out);
+	if (!Vec3Normalize(out))
+	{
+		out[0] = 1.0f;
+		out[1] = 0.0f;
+		out[2] = 0.0f;
+	}
+}
+
+void GenerateNormals(SMesh* mesh, bool smooth, bool invertWinding)
+{
+	if (mesh->PrimitiveType != pr_trianglelist)
+	{
+		return;
+	}
+
+	size_t faceCount = mesh->Data.size() / 3;
+	std::vector<float> faceNormals(faceCount * 3);
+
+	for (size_t f = 0; f < faceCount; ++f)
+	{
+		float e1[3];
+		float e2[3];
+		Vec3Sub(mesh->Data[f * 3 + 1]->Position, mesh->Data[f * 3]->Position, e1);
+		Vec3Sub(mesh->Data[f * 3 + 2]->Position, mesh->Data[f * 3]->Position, e2);
+
+		// Length of the cross product is twice the area of the face
+		float* n = &faceNormals[f * 3];
+		Vec3Cross(e1, e2, n);
+
+		if (invertWinding)
+		{
+			n[0] = -n[0];
+			n[1] = -n[1];
+			n[2] = -n[2];
+		}
+	}
+
+	if (!smooth)
+	{
+		for (size_t i = 0; i < faceCount * 3; ++i)
+		{
+			float* normal = mesh->Data[i]->Normal;
+			std::memcpy(normal, &faceNormals[(i / 3) * 3], sizeof(vec3_t));
+			Vec3Normalize(normal);
+		}
+		return;
+	}
+
+	float diagonal[3];
+	Vec3Sub(mesh->BboxMax, mesh->BboxMin, diagonal);
+	float cellSize = sqrtf(Vec3Dot(diagonal, diagonal)) * BBMOD_TANGENT_SPACE_EPSILON;
+	if (cellSize <= 0.0f)
+	{
+		cellSize = BBMOD_TANGENT_SPACE_EPSILON;
+	}
+
+	std::unordered_map<SHashKey, uint32_t, SHashKeyHasher> cells;
+	std::vector<uint32_t> cornerCells(faceCount * 3);
+	std::vector<float> sums;
+
+	cells.reserve(faceCount * 3);
+
+	for (size_t i = 0; i < faceCount * 3; ++i)
+	{
+		const float* position = mesh->Data[i]->Position;
+
+		SHashKey key;
+		for (int k = 0; k < 3; ++k)
+		{
+			key.Data[k] = (uint32_t)(int32_t)floorf(position[k] / cellSize + 0.5f);
+		}
+
+		auto it = cells.find(key);
+		if (it == cells.end())
+		{
+			it = cells.emplace(key, (uint32_t)(sums.size() / 3)).first;
+			sums.insert(sums.end(), { 0.0f, 0.0f, 0.0f });
+		}
+
+		uint32_t cell = it->second;
+		cornerCells[i] = cell;
+
+		const float* n = &faceNormals[(i / 3) * 3];
+		sums[cell * 3] += n[0];
+		sums[cell * 3 + 1] += n[1];
+		sums[cell * 3 + 2] += n[2];
+	}
+
+	for (size_t i = 0; i < faceCount * 3; ++i)
+	{
+		float* normal = mesh->Data[i]->Normal;
+		std::memcpy(normal, &sums[cornerCells[i] * 3], sizeof(vec3_t));
+
+		if (!Vec3Normalize(normal))
+		{
+			std::memcpy(normal, &faceNormals[(i / 3) * 3], sizeof(vec3_t));
+			Vec3Normalize(normal);
+		}
+	}
+}
+
+void GenerateTangents(SMesh* mesh)
+{
+	if (mesh->PrimitiveType != pr_trianglelist)
+	{
+		return;
+	}
+
+	size_t faceCount = mesh->Data.size() / 3;
+	size_t cornerCount = faceCount * 3;
+
+	std::unordered_map<SHashKey, uint32_t, SHashKeyHasher> groups;
+	std::vector<uint32_t> cornerGroups(cornerCount);
+	std::vector<float> sums;
+
+	groups.reserve(cornerCount);
+
+	for (size_t f = 0; f < faceCount; ++f)
+	{
+		SVertex* v[3] = { mesh->Data[f * 3], mesh->Data[f * 3 + 1], mesh->Data[f * 3 + 2] };
+
+		float e1[3];
+		float e2[3];
+		Vec3Sub(v[1]->Position, v[0]->Position, e1);
+		Vec3Sub(v[2]->Position, v[0]->Position, e2);
+
+		float du1 = v[1]->Texture[0] - v[0]->Texture[0];
+		float dv1 = v[1]->Texture[1] - v[0]->Texture[1];
+		float du2 = v[2]->Texture[0] - v[0]->Texture[0];
+		float dv2 = v[2]->Texture[1] - v[0]->Texture[1];
+		float det = du1 * dv2 - du2 * dv1;
+
+		// Directions of increasing U and V on the face
+		float tangent[3] = { 0.0f, 0.0f, 0.0f };
+		float bitangent[3] = { 0.0f, 0.0f, 0.0f };
+
+		if (fabsf(det) > FLT_EPSILON * FLT_EPSILON)
+		{
+			float r = 1.0f / det;
+			for (int k = 0; k < 3; ++k)
+			{
+				tangent[k] = (e1[k] * dv2 - e2[k] * dv1) * r;
+				bitangent[k] = (e2[k] * du1 - e1[k] * du2) * r;
+			}
+		}
+
+		for (int c = 0; c < 3; ++c)
+		{
+			const float* normal = v[c]->Normal;
+
+			float cross[3];
+			Vec3Cross(normal, tangent, cross);
+			bool flip = (Vec3Dot(cross, bitangent) < 0.0f);
+
+			SHashKey key;
+			std::memcpy(&key.Data[0], v[c]->Position, sizeof(float) * 3);
+			std::memcpy(&key.Data[3], normal, sizeof(float) * 3);
+			std::memcpy(&key.Data[6], v[c]->Texture, sizeof(float) * 2);
+			// Corners with a different handedness are never merged
+			key.Data[8] = flip ? 1u : 0u;
+
+			auto it = groups.find(key);
+			if (it == groups.end())
+			{
+				it = groups.emplace(key, (uint32_t)(sums.size() / 4)).first;
+				sums.insert(sums.end(), { 0.0f, 0.0f, 0.0f, flip ? -1.0f : 1.0f });
+			}
+
+			uint32_t group = it->second;
+			cornerGroups[f * 3 + c] = group;
+
+			// Project onto the tangent plane of the corner and weight by angle
+			float projected[3];
+			float d = Vec3Dot(normal, tangent);
+			for (int k = 0; k < 3; ++k)
+			{
+				projected[k] = tangent[k] - normal[k] * d;
+			}
+
+			if (!Vec3Normalize(projected))
+			{
+				continue;
+			}
+
+			float a[3];
+			float b[3];
+			Vec3Sub(v[(c + 1) % 3]->Position, v[c]->Position, a);
+			Vec3Sub(v[(c + 2) % 3]->Position, v[c]->Position, b);
+
+			if (!Vec3Normalize(a) || !Vec3Normalize(b))
+			{
+				continue;
+			}
+
+			float cosine = std::min(std::max(Vec3Dot(a, b), -1.0f), 1.0f);
+			float angle = acosf(cosine);
+
+			for (int k = 0; k < 3; ++k)
+			{
+				sums[group * 4 + k] += projected[k] * angle;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < cornerCount; ++i)
+	{
+		SVertex* vertex = mesh->Data[i];
+		const float* sum = &sums[cornerGroups[i] * 4];
+		const float* normal = vertex->Normal;
+
+		float d = Vec3Dot(normal, sum);
+		for (int k = 0; k < 3; ++k)
+		{
+			vertex->Tangent[k] = sum[k] - normal[k] * d;
+		}
+
+		if (!Vec3Normalize(vertex->Tangent))
+		{
+			Vec3Perpendicular(normal, vertex->Tangent);
+		}
+
+		vertex->BitangentSign = sum[3];
+	}
+}
+
+void GenerateTangentSpace(SMesh* mesh, bool hasNormals, bool hasTangents, const SConfig& config)
+{
+	if (mesh->VertexFormat->Normals && !hasNormals)
+	{
+		GenerateNormals(mesh, config.GenNormals >= BBMOD_NORMALS_SMOOTH, config.InvertWinding);
+
+		if (config.FlipNormals)
+		{
+			for (SVertex* vertex : mesh->Data)
+			{
+				vertex->Normal[0] = -vertex->Normal[0];
+				vertex->Normal[1] = -vertex->Normal[1];
+				vertex->Normal[2] = -vertex->Normal[2];
+			}
+		}
+	}
+
+	if (mesh->VertexFormat->TangentW && !hasTangents)
+	{
+		GenerateTangents(mesh);
+	}
+}
@@ -0,0 +1,543 @@
+#include <BBMOD/VertexAnimation.hpp>
+#include <BBMOD/DualQuaternion.hpp>
+#include <BBMOD/Model.hpp>
+#include <BBMOD/Parallel.hpp>
+#include <BBMOD/Quantization.hpp>
+#include <BBMOD/TableOfContents.hpp>
+#include <utils.hpp>
+
+#include <assimp/anim.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+static void CollectMeshNodes(SNode* node, std::vector<std::string>& meshNodes)
+{
+	for (uint32_t meshIndex : node->Meshes)
+	{
+		if (meshIndex < meshNodes.size() && meshNodes[meshIndex].empty())
+		{
+			meshNodes[meshIndex] = node->Name;
+		}
+	}
+	for (SNode* child : node->Children)
+	{
+		CollectMeshNodes(child, meshNodes);
+	}
+}
+
+void SVertexAnimationTexture::Layout(SModel* model)
+{
+	Model = model;
+	Meshes.clear();
+	Texels.clear();
+	MeshNodes.assign(model->Meshes.size(), "");
+	CollectMeshNodes(model->RootNode, MeshNodes);
+
+	std::vector<std::vector<uint32_t>> vertexTexels(model->Meshes.size());
+
+	for (uint32_t m = 0; m < model->Meshes.size(); ++m)
+	{
+		SMesh* mesh = model->Meshes[m];
+		SVertexAnimationMesh vatMesh;
+		vatMesh.FirstTexel = (uint32_t)Texels.size();
+
+		// Vertices created from the same source vertex always end up at the
+		// same position, so they share a texel
+		std::map<uint32_t, uint32_t> sourceTexels;
+
+		for (uint32_t i = 0; i < mesh->Data.size(); ++i)
+		{
+			uint32_t source = (i < mesh->SourceIndices.size()) ? mesh->SourceIndices[i] : i;
+			auto it = sourceTexels.find(source);
+
+			if (it == sourceTexels.end())
+			{
+				it = sourceTexels.emplace(source, (uint32_t)Texels.size()).first;
+				Texels.push_back(std::make_pair(m, i));
+			}
+
+			vertexTexels[m].push_back(it->second);
+		}
+
+		vatMesh.TexelCount = (uint32_t)Texels.size() - vatMesh.FirstTexel;
+		Meshes.push_back(vatMesh);
+	}
+
+	TexelCount = (uint32_t)Texels.size();
+	Width = std::max<uint32_t>(std::min<uint32_t>(TexelCount, BBMOD_VAT_MAX_WIDTH), 1);
+	RowsPerFrame = (TexelCount + Width - 1) / Width;
+
+	for (uint32_t m = 0; m < model->Meshes.size(); ++m)
+	{
+		SMesh* mesh = model->Meshes[m];
+		mesh->VertexFormat->TextureCoords2 = true;
+
+		for (uint32_t i = 0; i < mesh->Data.size(); ++i)
+		{
+			uint32_t texel = vertexTexels[m][i];
+			mesh->Data[i]->Texture2[0] = ((float)(texel % Width) + 0.5f) / (float)Width;
+			mesh->Data[i]->Texture2[1] = (float)(texel / Width);
+		}
+	}
+}
+
+bool SVertexAnimationTexture::Add(
+	const aiScene* scene,
+	const aiAnimation* aiAnimation,
+	SAnimation* animation,
+	const std::string& name)
+{
+	SModel* animationModel = animation->Model;
+
+	if (!Model || !animationModel)
+	{
+		return false;
+	}
+
+	uint32_t meshCount = (uint32_t)Model->Meshes.size();
+
+	// Find morph mesh channels by name of either the mesh or its node
+	std::vector<const aiMeshMorphAnim*> morphChannels(meshCount, nullptr);
+	std::vector<const aiMesh*> sourceMeshes(meshCount, nullptr);
+
+	if (scene && aiAnimation)
+	{
+		for (uint32_t m = 0; m < meshCount && m < scene->mNumMeshes; ++m)
+		{
+			const aiMesh* sourceMesh = scene->mMeshes[m];
+			if (sourceMesh->mNumAnimMeshes == 0)
+			{
+				continue;
+			}
+
+			for (uint32_t c = 0; c < aiAnimation->mNumMorphMeshChannels; ++c)
+			{
+				const aiMeshMorphAnim* channel = aiAnimation->mMorphMeshChannels[c];
+				std::string channelName = channel->mName.C_Str();
+				if (channelName == sourceMesh->mName.C_Str() || channelName == MeshNodes[m])
+				{
+					morphChannels[m] = channel;
+					sourceMeshes[m] = sourceMesh;
+					break;
+				}
+			}
+		}
+	}
+
+	double ticksPerFrame = (aiAnimation && animation->Duration > 0.0)
+		? aiAnimation->mDuration / animation->Duration
+		: 0.0;
+
+	// Meshes without bones are transformed by nodes of the animated model
+	std::vector<int32_t> meshNodes(meshCount, -1);
+
+	for (uint32_t m = 0; m < meshCount; ++m)
+	{
+		SNode* node = MeshNodes[m].empty()
+			? nullptr
+			: animationModel->FindNodeByName(MeshNodes[m], animationModel->RootNode);
+		meshNodes[m] = node ? (int32_t)node->Index : -1;
+	}
+
+	uint32_t frameCount = animation->GetFrameCount();
+	uint32_t nodeCount = animationModel->NodeCount;
+	uint32_t boneCount = animationModel->BoneCount;
+
+	ClipPositions.emplace_back((size_t)frameCount * TexelCount * 3);
+	ClipNormals.emplace_back(HasNormals ? (size_t)frameCount * TexelCount * 3 : 0);
+	std::vector<float>& positions = ClipPositions.back();
+	std::vector<float>& normals = ClipNormals.back();
+
+	std::vector<SAnimationNode*> nodeMap = animation->GetNodeMap();
+
+	ParallelFor(frameCount, [&](size_t frame) {
+		std::vector<float> frameWorld((size_t)nodeCount * 8);
+		std::vector<float> frameBone((size_t)boneCount * 8);
+		animation->SampleFrame(nodeMap, (double)frame, nullptr, frameWorld.data(), frameBone.data());
+
+		std::vector<std::vector<float>> morphWeights(meshCount);
+
+		for (uint32_t m = 0; m < meshCount; ++m)
+		{
+			if (morphChannels[m])
+			{
+				morphWeights[m].resize(sourceMeshes[m]->mNumAnimMeshes);
+				SAnimation::SampleMorphWeights(morphChannels[m], frame * ticksPerFrame, morphWeights[m]);
+			}
+		}
+
+		for (uint32_t t = 0; t < TexelCount; ++t)
+		{
+			uint32_t m = Texels[t].first;
+			uint32_t i = Texels[t].second;
+			SMesh* mesh = Model->Meshes[m];
+			SVertex* vertex = mesh->Data[i];
+
+			float p[3] = { vertex->Position[0], vertex->Position[1], vertex->Position[2] };
+			float n[3] = { vertex->Normal[0], vertex->Normal[1], vertex->Normal[2] };
+
+			if (morphChannels[m])
+			{
+				const aiMesh* sourceMesh = sourceMeshes[m];
+				uint32_t source = mesh->SourceIndices[i];
+
+				for (uint32_t k = 0; k < morphWeights[m].size(); ++k)
+				{
+					float w = morphWeights[m][k];
+					const aiAnimMesh* target = sourceMesh->mAnimMeshes[k];
+
+					if (w == 0.0f || !target->mVertices)
+					{
+						continue;
+					}
+
+					const aiVector3D& from = sourceMesh->mVertices[source];
+					const aiVector3D& to = target->mVertices[source];
+					p[0] += w * (to.x - from.x);
+					p[1] += w * (to.y - from.y);
+					p[2] += w * (to.z - from.z);
+
+					if (target->mNormals && sourceMesh->mNormals)
+					{
+						const aiVector3D& fromNormal = sourceMesh->mNormals[source];
+						const aiVector3D& toNormal = target->mNormals[source];
+						n[0] += w * (toNormal.x - fromNormal.x);
+						n[1] += w * (toNormal.y - fromNormal.y);
+						n[2] += w * (toNormal.z - fromNormal.z);
+					}
+				}
+			}
+
+			if (mesh->VertexFormat->Bones && boneCount > 0)
+			{
+				uint32_t indices[4];
+				for (int k = 0; k < 4; ++k)
+				{
+					indices[k] = std::min<uint32_t>((uint32_t)vertex->Bones[k], boneCount - 1);
+				}
+
+				dual_quat_t blend;
+				if (dual_quaternion_blend(frameBone.data(), indices, vertex->Weights, blend))
+				{
+					dual_quaternion_transform_point(blend, p, p);
+					dual_quaternion_rotate_vector(blend, n, n);
+				}
+			}
+			else if (meshNodes[m] >= 0 && (uint32_t)meshNodes[m] < nodeCount)
+			{
+				const float* dq = &frameWorld[meshNodes[m] * 8];
+				dual_quaternion_transform_point(dq, p, p);
+				dual_quaternion_rotate_vector(dq, n, n);
+			}
+
+			size_t offset = (frame * TexelCount + t) * 3;
+			std::memcpy(&positions[offset], p, sizeof(p));
+
+			if (HasNormals)
+			{
+				float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+				for (int k = 0; k < 3; ++k)
+				{
+					normals[offset + k] = (length > 0.0f) ? n[k] / length : 0.0f;
+				}
+			}
+		}
+	});
+
+	SVertexAnimationClip clip;
+	clip.Name = name;
+	clip.FrameCount = frameCount;
+	clip.TicsPerSecond = animation->TicsPerSecond;
+	Clips.push_back(clip);
+
+	return true;
+}
+
+void SVertexAnimationTexture::Build()
+{
+	if (ClipPositions.size() != Clips.size())
+	{
+		// Already built or loaded
+		return;
+	}
+
+	Height = 0;
+
+	for (SVertexAnimationClip& clip : Clips)
+	{
+		clip.StartRow = Height;
+		Height += clip.FrameCount * RowsPerFrame;
+	}
+
+	Positions.assign((size_t)Width * Height * 4, 0);
+	Normals.assign(HasNormals ? (size_t)Width * Height * 4 : 0, 0);
+
+	for (size_t c = 0; c < Clips.size(); ++c)
+	{
+		SVertexAnimationClip& clip = Clips[c];
+		const std::vector<float>& positions = ClipPositions[c];
+		const std::vector<float>& normals = ClipNormals[c];
+
+		for (int k = 0; k < 3; ++k)
+		{
+			clip.BoundsMin[k] = positions.empty() ? 0.0f : FLT_MAX;
+			clip.BoundsMax[k] = positions.empty() ? 0.0f : -FLT_MAX;
+		}
+
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			clip.BoundsMin[i % 3] = std::min(clip.BoundsMin[i % 3], positions[i]);
+			clip.BoundsMax[i % 3] = std::max(clip.BoundsMax[i % 3], positions[i]);
+		}
+
+		for (uint32_t f = 0; f < clip.FrameCount; ++f)
+		{
+			for (uint32_t t = 0; t < TexelCount; ++t)
+			{
+				size_t row = clip.StartRow + f * RowsPerFrame + t / Width;
+				size_t texel = (row * Width + t % Width) * 4;
+				size_t offset = ((size_t)f * TexelCount + t) * 3;
+
+				for (int k = 0; k < 3; ++k)
+				{
+					Positions[texel + k] = QuantizeRange16(positions[offset + k], clip.BoundsMin[k], clip.BoundsMax[k]);
+				}
+				Positions[texel + 3] = 65535;
+
+				if (HasNormals)
+				{
+					for (int k = 0; k < 3; ++k)
+					{
+						Normals[texel + k] = (uint8_t)roundf((normals[offset + k] * 0.5f + 0.5f) * 255.0f);
+					}
+					Normals[texel + 3] = 255;
+				}
+			}
+		}
+	}
+
+	ClipPositions.clear();
+	ClipNormals.clear();
+}
+
+void SVertexAnimationTexture::GetPosition(uint32_t clip, uint32_t frame, uint32_t texel, vec3_t out) const
+{
+	const SVertexAnimationClip& c = Clips[clip];
+	size_t row = c.StartRow + frame * RowsPerFrame + texel / Width;
+	size_t index = (row * Width + texel % Width) * 4;
+
+	for (int k = 0; k < 3; ++k)
+	{
+		out[k] = DequantizeRange16(Positions[index + k], c.BoundsMin[k], c.BoundsMax[k]);
+	}
+}
+
+bool SVertexAnimationTexture::Save(std::string path)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary);
+
+	if (!file.is_open() || !Save(file))
+	{
+		return false;
+	}
+
+	file.flush();
+	file.close();
+
+	return true;
+}
+
+bool SVertexAnimationTexture::Save(std::ostream& file)
+{
+	Build();
+
+	uint64_t fileStart = (uint64_t)file.tellp();
+
+	file.write("BBVTEX", sizeof(char) * 7);
+	FILE_WRITE_DATA(file, VersionMajor);
+	FILE_WRITE_DATA(file, VersionMinor);
+
+	STableOfContents toc;
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_DATA(stream, HasNormals);
+		FILE_WRITE_DATA(stream, TexelCount);
+		FILE_WRITE_DATA(stream, Width);
+		FILE_WRITE_DATA(stream, Height);
+		FILE_WRITE_DATA(stream, RowsPerFrame);
+		toc.Add(BBMOD_SECTION_VAT_HEADER, 0, stream.str());
+	}
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		uint32_t meshCount = (uint32_t)Meshes.size();
+		FILE_WRITE_DATA(stream, meshCount);
+
+		for (const SVertexAnimationMesh& mesh : Meshes)
+		{
+			FILE_WRITE_DATA(stream, mesh.FirstTexel);
+			FILE_WRITE_DATA(stream, mesh.TexelCount);
+		}
+
+		toc.Add(BBMOD_SECTION_VAT_MESHES, 0, stream.str());
+	}
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		uint32_t clipCount = (uint32_t)Clips.size();
+		FILE_WRITE_DATA(stream, clipCount);
+
+		for (const SVertexAnimationClip& clip : Clips)
+		{
+			stream.write(clip.Name.c_str(), clip.Name.size() + 1);
+			FILE_WRITE_DATA(stream, clip.StartRow);
+			FILE_WRITE_DATA(stream, clip.FrameCount);
+			FILE_WRITE_DATA(stream, clip.TicsPerSecond);
+			FILE_WRITE_VEC3(stream, clip.BoundsMin);
+			FILE_WRITE_VEC3(stream, clip.BoundsMax);
+		}
+
+		toc.Add(BBMOD_SECTION_VAT_CLIPS, 0, stream.str());
+	}
+
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_ARRAY(stream, Positions.data(), Positions.size());
+		toc.Add(BBMOD_SECTION_VAT_POSITIONS, 0, stream.str());
+	}
+
+	if (HasNormals)
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		FILE_WRITE_ARRAY(stream, Normals.data(), Normals.size());
+		toc.Add(BBMOD_SECTION_VAT_NORMALS, 0, stream.str());
+	}
+
+	return toc.Save(file, fileStart);
+}
+
+SVertexAnimationTexture* SVertexAnimationTexture::Load(std::string path)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+
+	if (!file.is_open())
+	{
+		return nullptr;
+	}
+
+	return Load(file);
+}
+
+SVertexAnimationTexture* SVertexAnimationTexture::Load(std::istream& file)
+{
+	uint64_t fileStart = (uint64_t)file.tellg();
+
+	char header[7];
+	file.read(header, 7);
+
+	uint8_t versionMajor;
+	uint8_t versionMinor;
+	FILE_READ_DATA(file, versionMajor);
+	FILE_READ_DATA(file, versionMinor);
+
+	if (!file
+		|| std::strcmp(header, "BBVTEX") != 0
+		|| versionMajor != BBMOD_VERSION_MAJOR
+		|| versionMinor != BBMOD_VERSION_MINOR_TOC)
+	{
+		return nullptr;
+	}
+
+	STableOfContents toc;
+
+	if (!toc.Load(file, fileStart)
+		|| !toc.Seek(file, BBMOD_SECTION_VAT_HEADER))
+	{
+		return nullptr;
+	}
+
+	SVertexAnimationTexture* vat = new SVertexAnimationTexture();
+	vat->VersionMajor = versionMajor;
+	vat->VersionMinor = versionMinor;
+
+	FILE_READ_DATA(file, vat->HasNormals);
+	FILE_READ_DATA(file, vat->TexelCount);
+	FILE_READ_DATA(file, vat->Width);
+	FILE_READ_DATA(file, vat->Height);
+	FILE_READ_DATA(file, vat->RowsPerFrame);
+
+	if (!file || !toc.Seek(file, BBMOD_SECTION_VAT_MESHES))
+	{
+		delete vat;
+		return nullptr;
+	}
+
+	uint32_t meshCount;
+	FILE_READ_DATA(file, meshCount);
+
+	for (uint32_t i = 0; i < meshCount && file; ++i)
+	{
+		SVertexAnimationMesh mesh;
+		FILE_READ_DATA(file, mesh.FirstTexel);
+		FILE_READ_DATA(file, mesh.TexelCount);
+		vat->Meshes.push_back(mesh);
+	}
+
+	if (!file || !toc.Seek(file, BBMOD_SECTION_VAT_CLIPS))
+	{
+		delete vat;
+		return nullptr;
+	}
+
+	uint32_t clipCount;
+	FILE_READ_DATA(file, clipCount);
+
+	for (uint32_t i = 0; i < clipCount && file; ++i)
+	{
+		SVertexAnimationClip clip;
+		std::getline(file, clip.Name, '\0');
+		FILE_READ_DATA(file, clip.StartRow);
+		FILE_READ_DATA(file, clip.FrameCount);
+		FILE_READ_DATA(file, clip.TicsPerSecond);
+		FILE_READ_VEC3(file, clip.BoundsMin);
+		FILE_READ_VEC3(file, clip.BoundsMax);
+		vat->Clips.push_back(clip);
+	}
+
+	if (!file || !toc.Seek(file, BBMOD_SECTION_VAT_POSITIONS))
+	{
+		delete vat;
+		return nullptr;
+	}
+
+	vat->Positions.resize((size_t)vat->Width * vat->Height * 4);
+	FILE_READ_ARRAY(file, vat->Positions.data(), vat->Positions.size());
+
+	if (vat->HasNormals)
+	{
+		if (!toc.Seek(file, BBMOD_SECTION_VAT_NORMALS))
+		{
+			delete vat;
+			return nullptr;
+		}
+
+		vat->Normals.resize((size_t)vat->Width * vat->Height * 4);
+		FILE_READ_ARRAY(file, vat->Normals.data(), vat->Normals.size());
+	}
+
+	if (!file)
+	{
+		delete vat;
+		return nullptr;
+	}
+
+	return vat;
+}
@@ -1,7 +1,7 @@
 #include <BBMOD/VertexFormat.hpp>
 #include <utils.hpp>
 
-bool SVertexFormat::Save(std::ofstream& file)
+bool SVertexFormat::Save(std::ostream& file)
 {
 	FILE_WRITE_DATA(file, Vertices);
 	FILE_WRITE_DATA(file, Normals);
@@ -14,7 +14,7 @@ bool SVertexFormat::Save(std::ofstream& file)
 	return true;
 }
 
-SVertexFormat* SVertexFormat::Load(std::ifstream& file, uint8_t versionMinor)
+SVertexFormat* SVertexFormat::Load(std::istream& file, uint8_t versionMinor)
 {
 	SVertexFormat* vertexFormat = new SVertexFormat();
 	FILE_READ_DATA(file, vertexFormat->Vertices);
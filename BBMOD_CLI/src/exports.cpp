@@ -1,6 +1,12 @@
 #include <BBMOD/Importer.hpp>
+#include <BBMOD/JobQueue.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
 #ifdef _WIN32
 #	include <d3d11.h>
 #endif
@@ -21,8 +27,27 @@ typedef const char* gmstring_t;
 
 typedef void* gmptr_t;
 
+// The default configuration, used by bbmod_dll_set_ and bbmod_dll_get_
+// functions and by configuration handle 0
 SConfig gConfig;
 
+// Configurations created with bbmod_dll_config_create and clone
+std::map<uint32_t, std::unique_ptr<SConfig>> gConfigs;
+
+uint32_t gNextConfig = 1;
+
+SProgress gProgress;
+
+// Conversion jobs, stopped with bbmod_dll_shutdown before the library is
+// unloaded
+SJobQueue gJobs;
+
+// Keeps strings returned to GameMaker alive until the next call
+std::string gString;
+
+// Files created by the last in-memory conversion
+std::vector<SMemoryFile> gMemoryFiles;
+
 #ifdef _WIN32
 ID3D11Device* gDevice;
 
@@ -302,7 +327,689 @@ GM_EXPORT gmreal_t bbmod_dll_set_enable_prefix(gmreal_t enable)
 	return BBMOD_SUCCESS;
 }
 
+GM_EXPORT gmreal_t bbmod_dll_get_compress()
+{
+	return (gmreal_t)gConfig.Compress;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_compress(gmreal_t enable)
+{
+	gConfig.Compress = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_compression_chunk_size()
+{
+	return (gmreal_t)gConfig.CompressionChunkSize;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_compression_chunk_size(gmreal_t size)
+{
+	gConfig.CompressionChunkSize = (uint32_t)std::clamp(size, 1.0, (gmreal_t)UINT32_MAX);
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_compression_filter()
+{
+	return (gmreal_t)gConfig.CompressionFilter;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_compression_filter(gmreal_t filter)
+{
+	gConfig.CompressionFilter = (uint32_t)std::clamp(filter, 0.0, (gmreal_t)BBMOD_FILTER_SHUFFLE_DELTA);
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_table_of_contents()
+{
+	return (gmreal_t)gConfig.TableOfContents;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_table_of_contents(gmreal_t enable)
+{
+	gConfig.TableOfContents = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_reduce_keys()
+{
+	return (gmreal_t)gConfig.ReduceKeys;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_reduce_keys(gmreal_t enable)
+{
+	gConfig.ReduceKeys = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_key_error_translation()
+{
+	return (gmreal_t)gConfig.KeyTranslationError;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_key_error_translation(gmreal_t error)
+{
+	gConfig.KeyTranslationError = (float)error;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_key_error_rotation()
+{
+	return (gmreal_t)gConfig.KeyRotationError;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_key_error_rotation(gmreal_t error)
+{
+	gConfig.KeyRotationError = (float)error;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_key_error_end_effector()
+{
+	return (gmreal_t)gConfig.KeyEndEffectorError;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_key_error_end_effector(gmreal_t error)
+{
+	gConfig.KeyEndEffectorError = (float)error;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_eliminate_constant_tracks()
+{
+	return (gmreal_t)gConfig.EliminateConstantTracks;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_eliminate_constant_tracks(gmreal_t enable)
+{
+	gConfig.EliminateConstantTracks = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_animation_quantization()
+{
+	return (gmreal_t)gConfig.AnimationQuantization;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_animation_quantization(gmreal_t quantization)
+{
+	gConfig.AnimationQuantization = (uint32_t)quantization;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_half_float_frames()
+{
+	return (gmreal_t)gConfig.HalfFloatFrames;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_half_float_frames(gmreal_t enable)
+{
+	gConfig.HalfFloatFrames = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_frame_index()
+{
+	return (gmreal_t)gConfig.FrameIndex;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_frame_index(gmreal_t enable)
+{
+	gConfig.FrameIndex = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_frame_block_size()
+{
+	return (gmreal_t)gConfig.FrameBlockSize;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_frame_block_size(gmreal_t frames)
+{
+	gConfig.FrameBlockSize = (frames < 1.0) ? 1 : (uint32_t)frames;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_compress_frame_blocks()
+{
+	return (gmreal_t)gConfig.CompressFrameBlocks;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_compress_frame_blocks(gmreal_t enable)
+{
+	gConfig.CompressFrameBlocks = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmstring_t bbmod_dll_get_world_space_nodes()
+{
+	return gConfig.WorldSpaceNodes.c_str();
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_world_space_nodes(gmstring_t nodes)
+{
+	gConfig.WorldSpaceNodes = nodes;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_animation_lod_tiers()
+{
+	return (gmreal_t)gConfig.AnimationLodTiers;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_animation_lod_tiers(gmreal_t count)
+{
+	gConfig.AnimationLodTiers = (uint32_t)count;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_bone_lod_count()
+{
+	return (gmreal_t)gConfig.BoneLodCount;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_bone_lod_count(gmreal_t count)
+{
+	gConfig.BoneLodCount = (uint32_t)count;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_prune_skeleton()
+{
+	return (gmreal_t)gConfig.PruneSkeleton;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_prune_skeleton(gmreal_t enable)
+{
+	gConfig.PruneSkeleton = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmstring_t bbmod_dll_get_keep_nodes()
+{
+	return gConfig.KeepNodes.c_str();
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_keep_nodes(gmstring_t nodes)
+{
+	gConfig.KeepNodes = nodes;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_flat_node_table()
+{
+	return (gmreal_t)gConfig.FlatNodeTable;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_flat_node_table(gmreal_t enable)
+{
+	gConfig.FlatNodeTable = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmstring_t bbmod_dll_get_shared_skeleton()
+{
+	return gConfig.SharedSkeleton.c_str();
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_shared_skeleton(gmstring_t path)
+{
+	gConfig.SharedSkeleton = path;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmstring_t bbmod_dll_get_reference_model()
+{
+	return gConfig.ReferenceModel.c_str();
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_reference_model(gmstring_t path)
+{
+	gConfig.ReferenceModel = path;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_animation_pack()
+{
+	return (gmreal_t)gConfig.AnimationPack;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_animation_pack(gmreal_t enable)
+{
+	gConfig.AnimationPack = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_animated_bounds()
+{
+	return (gmreal_t)gConfig.AnimatedBounds;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_animated_bounds(gmreal_t enable)
+{
+	gConfig.AnimatedBounds = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_bone_atlas()
+{
+	return (gmreal_t)gConfig.BoneAtlas;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_bone_atlas(gmreal_t format)
+{
+	gConfig.BoneAtlas = (uint32_t)format;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_vertex_animation()
+{
+	return (gmreal_t)gConfig.VertexAnimation;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_vertex_animation(gmreal_t enable)
+{
+	gConfig.VertexAnimation = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_vertex_animation_normals()
+{
+	return (gmreal_t)gConfig.VertexAnimationNormals;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_vertex_animation_normals(gmreal_t enable)
+{
+	gConfig.VertexAnimationNormals = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_morph_targets()
+{
+	return (gmreal_t)gConfig.MorphTargets;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_morph_targets(gmreal_t enable)
+{
+	gConfig.MorphTargets = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_native_tangent_space()
+{
+	return (gmreal_t)gConfig.NativeTangentSpace;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_native_tangent_space(gmreal_t enable)
+{
+	gConfig.NativeTangentSpace = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_native_glb()
+{
+	return (gmreal_t)gConfig.NativeGlb;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_set_native_glb(gmreal_t enable)
+{
+	gConfig.NativeGlb = (bool)enable;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_progress()
+{
+	return (gmreal_t)gProgress.GetTotal();
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_progress_stage()
+{
+	return (gmreal_t)gProgress.Stage;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_get_progress_stage_fraction()
+{
+	return (gmreal_t)gProgress.Fraction;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_cancel()
+{
+	gProgress.Cancel();
+	return BBMOD_SUCCESS;
+}
+
 GM_EXPORT gmreal_t bbmod_dll_convert(gmstring_t fin, gmstring_t fout)
 {
-	return ConvertToBBMOD(fin, fout, gConfig);
+	gProgress.Reset();
+	return ConvertToBBMOD(fin, fout, gConfig, &gProgress);
+}
+
+GM_EXPORT gmreal_t bbmod_dll_convert_async(gmstring_t fin, gmstring_t fout)
+{
+	return (gmreal_t)gJobs.Start(fin, fout, gConfig);
+}
+
+GM_EXPORT gmreal_t bbmod_dll_job_get_status(gmreal_t id)
+{
+	std::shared_ptr<SJob> job = gJobs.Find((uint32_t)id);
+	return job ? (gmreal_t)job->Status : (gmreal_t)BBMOD_JOB_NONE;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_job_get_progress(gmreal_t id)
+{
+	std::shared_ptr<SJob> job = gJobs.Find((uint32_t)id);
+	return job ? (gmreal_t)job->Progress.GetTotal() : 0.0;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_job_get_progress_stage(gmreal_t id)
+{
+	std::shared_ptr<SJob> job = gJobs.Find((uint32_t)id);
+	return job ? (gmreal_t)job->Progress.Stage : (gmreal_t)BBMOD_STAGE_NONE;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_job_get_result(gmreal_t id)
+{
+	std::shared_ptr<SJob> job = gJobs.Find((uint32_t)id);
+	if (!job || job->Status != BBMOD_JOB_FINISHED)
+	{
+		return BBMOD_FAILURE;
+	}
+	return (gmreal_t)job->Result;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_job_get_output_count(gmreal_t id)
+{
+	std::shared_ptr<SJob> job = gJobs.Find((uint32_t)id);
+	return job ? (gmreal_t)job->Progress.GetOutputs().size() : 0.0;
+}
+
+GM_EXPORT gmstring_t bbmod_dll_job_get_output(gmreal_t id, gmreal_t index)
+{
+	std::shared_ptr<SJob> job = gJobs.Find((uint32_t)id);
+	std::vector<std::string> outputs;
+	if (job)
+	{
+		outputs = job->Progress.GetOutputs();
+	}
+	gString = ((size_t)index < outputs.size()) ? outputs[(size_t)index] : "";
+	return gString.c_str();
+}
+
+GM_EXPORT gmreal_t bbmod_dll_job_cancel(gmreal_t id)
+{
+	std::shared_ptr<SJob> job = gJobs.Find((uint32_t)id);
+	if (!job)
+	{
+		return BBMOD_FAILURE;
+	}
+	job->Progress.Cancel();
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_job_free(gmreal_t id)
+{
+	return gJobs.Remove((uint32_t)id) ? BBMOD_SUCCESS : BBMOD_FAILURE;
+}
+
+// Waiting for workers is not possible while the library is being unloaded,
+// so this must be called before that
+GM_EXPORT gmreal_t bbmod_dll_shutdown()
+{
+	gJobs.Stop();
+	return BBMOD_SUCCESS;
+}
+
+/** Reads and writes a field of SConfig through bbmod_dll_config_ functions. */
+struct SConfigField
+{
+	gmreal_t (*Get)(const SConfig& config) = nullptr;
+
+	void (*Set)(SConfig& config, gmreal_t value) = nullptr;
+
+	std::string SConfig::* String = nullptr;
+};
+
+#define CONFIG_BOOL(name, member) \
+	{ name, { \
+		[](const SConfig& config) { return (gmreal_t)config.member; }, \
+		[](SConfig& config, gmreal_t value) { config.member = (bool)value; } } }
+
+#define CONFIG_UINT(name, member) \
+	{ name, { \
+		[](const SConfig& config) { return (gmreal_t)config.member; }, \
+		[](SConfig& config, gmreal_t value) { config.member = (uint32_t)value; } } }
+
+#define CONFIG_FLOAT(name, member) \
+	{ name, { \
+		[](const SConfig& config) { return (gmreal_t)config.member; }, \
+		[](SConfig& config, gmreal_t value) { config.member = (float)value; } } }
+
+#define CONFIG_STRING(name, member) \
+	{ name, { nullptr, nullptr, &SConfig::member } }
+
+// Fields are named after their bbmod_dll_set_ functions
+static const std::map<std::string, SConfigField> gConfigFields = {
+	CONFIG_BOOL("left_handed", LeftHanded),
+	CONFIG_BOOL("invert_winding", InvertWinding),
+	CONFIG_BOOL("disable_normal", DisableNormals),
+	CONFIG_BOOL("flip_normal", FlipNormals),
+	CONFIG_UINT("gen_normal", GenNormals),
+	CONFIG_BOOL("disable_uv", DisableTextureCoords),
+	CONFIG_BOOL("disable_uv2", DisableTextureCoords2),
+	CONFIG_BOOL("flip_uv_horizontally", FlipTextureHorizontally),
+	CONFIG_BOOL("flip_uv_vertically", FlipTextureVertically),
+	CONFIG_BOOL("disable_color", DisableVertexColors),
+	CONFIG_BOOL("disable_tangent", DisableTangentW),
+	CONFIG_BOOL("disable_bone", DisableBones),
+	CONFIG_BOOL("optimize_materials", OptimizeMaterials),
+	CONFIG_BOOL("optimize_meshes", OptimizeMeshes),
+	CONFIG_BOOL("optimize_nodes", OptimizeNodes),
+	CONFIG_BOOL("pre_transform", PreTransform),
+	CONFIG_BOOL("apply_scale", ApplyScale),
+	CONFIG_UINT("optimize_animations", AnimationOptimization),
+	{ "sampling_rate", {
+		[](const SConfig& config) { return (gmreal_t)config.SamplingRate; },
+		[](SConfig& config, gmreal_t value) { config.SamplingRate = std::max(floor((double)value), 1.0); } } },
+	CONFIG_BOOL("export_materials", ExportMaterials),
+	CONFIG_BOOL("zup", ConvertToZUp),
+	CONFIG_BOOL("enable_prefix", Prefix),
+	CONFIG_BOOL("compress", Compress),
+	{ "compression_chunk_size", {
+		[](const SConfig& config) { return (gmreal_t)config.CompressionChunkSize; },
+		[](SConfig& config, gmreal_t value) { config.CompressionChunkSize = (uint32_t)std::clamp(value, 1.0, (gmreal_t)UINT32_MAX); } } },
+	{ "compression_filter", {
+		[](const SConfig& config) { return (gmreal_t)config.CompressionFilter; },
+		[](SConfig& config, gmreal_t value) { config.CompressionFilter = (uint32_t)std::clamp(value, 0.0, (gmreal_t)BBMOD_FILTER_SHUFFLE_DELTA); } } },
+	CONFIG_BOOL("table_of_contents", TableOfContents),
+	CONFIG_BOOL("reduce_keys", ReduceKeys),
+	CONFIG_FLOAT("key_error_translation", KeyTranslationError),
+	CONFIG_FLOAT("key_error_rotation", KeyRotationError),
+	CONFIG_FLOAT("key_error_end_effector", KeyEndEffectorError),
+	CONFIG_BOOL("eliminate_constant_tracks", EliminateConstantTracks),
+	CONFIG_UINT("animation_quantization", AnimationQuantization),
+	CONFIG_BOOL("half_float_frames", HalfFloatFrames),
+	CONFIG_BOOL("frame_index", FrameIndex),
+	{ "frame_block_size", {
+		[](const SConfig& config) { return (gmreal_t)config.FrameBlockSize; },
+		[](SConfig& config, gmreal_t value) { config.FrameBlockSize = (value < 1.0) ? 1 : (uint32_t)value; } } },
+	CONFIG_BOOL("compress_frame_blocks", CompressFrameBlocks),
+	CONFIG_STRING("world_space_nodes", WorldSpaceNodes),
+	CONFIG_UINT("animation_lod_tiers", AnimationLodTiers),
+	CONFIG_UINT("bone_lod_count", BoneLodCount),
+	CONFIG_BOOL("prune_skeleton", PruneSkeleton),
+	CONFIG_STRING("keep_nodes", KeepNodes),
+	CONFIG_BOOL("flat_node_table", FlatNodeTable),
+	CONFIG_STRING("shared_skeleton", SharedSkeleton),
+	CONFIG_STRING("reference_model", ReferenceModel),
+	CONFIG_BOOL("animation_pack", AnimationPack),
+	CONFIG_BOOL("animated_bounds", AnimatedBounds),
+	CONFIG_UINT("bone_atlas", BoneAtlas),
+	CONFIG_BOOL("vertex_animation", VertexAnimation),
+	CONFIG_BOOL("vertex_animation_normals", VertexAnimationNormals),
+	CONFIG_BOOL("morph_targets", MorphTargets),
+	CONFIG_BOOL("native_tangent_space", NativeTangentSpace),
+	CONFIG_BOOL("native_glb", NativeGlb),
+};
+
+/** Returns a configuration by its handle or nullptr if it does not exist. */
+static SConfig* FindConfig(gmreal_t handle)
+{
+	if (handle == 0.0)
+	{
+		return &gConfig;
+	}
+	auto it = gConfigs.find((uint32_t)handle);
+	return (it != gConfigs.end()) ? it->second.get() : nullptr;
+}
+
+/** Returns a field of SConfig by its name or nullptr if it does not exist. */
+static const SConfigField* FindConfigField(gmstring_t name)
+{
+	auto it = gConfigFields.find(name);
+	return (it != gConfigFields.end()) ? &it->second : nullptr;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_config_create()
+{
+	uint32_t handle = gNextConfig++;
+	gConfigs[handle] = std::make_unique<SConfig>();
+	return (gmreal_t)handle;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_config_clone(gmreal_t handle)
+{
+	SConfig* config = FindConfig(handle);
+	if (!config)
+	{
+		return BBMOD_FAILURE;
+	}
+	uint32_t clone = gNextConfig++;
+	gConfigs[clone] = std::make_unique<SConfig>(*config);
+	return (gmreal_t)clone;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_config_destroy(gmreal_t handle)
+{
+	// The default configuration cannot be destroyed
+	if (handle == 0.0 || gConfigs.erase((uint32_t)handle) == 0)
+	{
+		return BBMOD_FAILURE;
+	}
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_config_get(gmreal_t handle, gmstring_t name)
+{
+	SConfig* config = FindConfig(handle);
+	const SConfigField* field = FindConfigField(name);
+	if (!config || !field || !field->Get)
+	{
+		return BBMOD_FAILURE;
+	}
+	return field->Get(*config);
+}
+
+GM_EXPORT gmreal_t bbmod_dll_config_set(gmreal_t handle, gmstring_t name, gmreal_t value)
+{
+	SConfig* config = FindConfig(handle);
+	const SConfigField* field = FindConfigField(name);
+	if (!config || !field || !field->Set)
+	{
+		return BBMOD_FAILURE;
+	}
+	field->Set(*config, value);
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmstring_t bbmod_dll_config_get_string(gmreal_t handle, gmstring_t name)
+{
+	SConfig* config = FindConfig(handle);
+	const SConfigField* field = FindConfigField(name);
+	gString = (config && field && field->String) ? (*config).*(field->String) : "";
+	return gString.c_str();
+}
+
+GM_EXPORT gmreal_t bbmod_dll_config_set_string(gmreal_t handle, gmstring_t name, gmstring_t value)
+{
+	SConfig* config = FindConfig(handle);
+	const SConfigField* field = FindConfigField(name);
+	if (!config || !field || !field->String)
+	{
+		return BBMOD_FAILURE;
+	}
+	(*config).*(field->String) = value;
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_config_convert(gmreal_t handle, gmstring_t fin, gmstring_t fout)
+{
+	SConfig* config = FindConfig(handle);
+	if (!config)
+	{
+		return BBMOD_FAILURE;
+	}
+	gProgress.Reset();
+	return ConvertToBBMOD(fin, fout, *config, &gProgress);
+}
+
+GM_EXPORT gmreal_t bbmod_dll_config_convert_async(gmreal_t handle, gmstring_t fin, gmstring_t fout)
+{
+	SConfig* config = FindConfig(handle);
+	if (!config)
+	{
+		return BBMOD_FAILURE;
+	}
+	return (gmreal_t)gJobs.Start(fin, fout, *config);
+}
+
+GM_EXPORT gmreal_t bbmod_dll_config_convert_buffer(
+	gmreal_t handle, gmptr_t data, gmreal_t size, gmstring_t hint, gmstring_t name)
+{
+	SConfig* config = FindConfig(handle);
+	if (!config || !data)
+	{
+		return BBMOD_FAILURE;
+	}
+	gMemoryFiles.clear();
+	gProgress.Reset();
+	return ConvertToBBMODInMemory(data, (size_t)size, hint, name, *config, gMemoryFiles, &gProgress);
+}
+
+GM_EXPORT gmreal_t bbmod_dll_convert_buffer(gmptr_t data, gmreal_t size, gmstring_t hint, gmstring_t name)
+{
+	return bbmod_dll_config_convert_buffer(0.0, data, size, hint, name);
+}
+
+GM_EXPORT gmreal_t bbmod_dll_buffer_get_count()
+{
+	return (gmreal_t)gMemoryFiles.size();
+}
+
+GM_EXPORT gmstring_t bbmod_dll_buffer_get_name(gmreal_t index)
+{
+	gString = ((size_t)index < gMemoryFiles.size()) ? gMemoryFiles[(size_t)index].Name : "";
+	return gString.c_str();
+}
+
+GM_EXPORT gmreal_t bbmod_dll_buffer_get_size(gmreal_t index)
+{
+	return ((size_t)index < gMemoryFiles.size()) ? (gmreal_t)gMemoryFiles[(size_t)index].Data.size() : 0.0;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_buffer_copy(gmreal_t index, gmptr_t dest)
+{
+	if ((size_t)index >= gMemoryFiles.size() || !dest)
+	{
+		return BBMOD_FAILURE;
+	}
+	const std::string& data = gMemoryFiles[(size_t)index].Data;
+	std::memcpy(dest, data.data(), data.size());
+	return BBMOD_SUCCESS;
+}
+
+GM_EXPORT gmreal_t bbmod_dll_buffer_free()
+{
+	gMemoryFiles.clear();
+	gMemoryFiles.shrink_to_fit();
+	return BBMOD_SUCCESS;
 }
@@ -4,7 +4,12 @@
 #include <filesystem>
 #include <string>
 #include <regex>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
 #include <cstdlib>
+#include <thread>
 
 // TODO: Implement class for argument parsing
 
@@ -12,6 +17,15 @@ const char* gUsage = "Usage: BBMOD.exe [-h|-v] input_path [output_path] [args...
 
 #define PRINT_BOOL(bValue) (bValue ? "true" : "false")
 
+SProgress gProgress;
+
+void HandleInterrupt(int)
+{
+	// Pressing Ctrl+C again terminates the process immediately
+	std::signal(SIGINT, SIG_DFL);
+	gProgress.Cancel();
+}
+
 void PrintHelp()
 {
 	SConfig config;
@@ -27,8 +41,40 @@ void PrintHelp()
 		<< "  output_path                          Where to save the converted model(s). If not specified, " << std::endl
 		<< "                                       then the input file path is used. Extensions .bbmod" << std::endl
 		<< "                                       and .bbanim are added automatically." << std::endl
+		<< "  -ab|--animated-bounds=true|false     Save bounding boxes of the animated model at each frame into" << std::endl
+		<< "                                       animations. Changes file format version to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.AnimatedBounds) << "." << std::endl
+		<< "  -alt|--animation-lod-tiers=count     Number of animation LODs saved alongside full rate frames. The first" << std::endl
+		<< "                                       has half the sampling rate, every next half the rate of the previous" << std::endl
+		<< "                                       one. Changes file format version to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is " << config.AnimationLodTiers << "." << std::endl
+		<< "  -ap|--animation-pack=true|false      Save all animations of a model, or of a directory of models, into a" << std::endl
+		<< "                                       single .bbpack file with a directory of clips sorted by name." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.AnimationPack) << "." << std::endl
 		<< "  -as|--apply-scale=true|false         Apply global scaling factor defined in the model file." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.ApplyScale) << "." << std::endl
+		<< "  -ba|--bone-atlas=0|1|2               Bake bone-space transforms of all animations of a model into a single" << std::endl
+		<< "                                       texture (.bbatlas) for instanced rendering." << std::endl
+		<< "                                         * 0 - Do not save a bone atlas." << std::endl
+		<< "                                         * 1 - RGBA32F texels." << std::endl
+		<< "                                         * 2 - RGBA16F texels." << std::endl
+		<< "                                       Default is " << config.BoneAtlas << "." << std::endl
+		<< "  -blc|--bone-lod-count=count          Number of bone LODs computed for animated models. Each LOD maps" << std::endl
+		<< "                                       bones with the least influence on vertices to their nearest kept ancestor." << std::endl
+		<< "                                       Changes file format version to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is " << config.BoneLodCount << "." << std::endl
+		<< "  -cf|--compression-filter=0|1|2       Configure the filter applied to data before compression." << std::endl
+		<< "                                         * 0 - No filter." << std::endl
+		<< "                                         * 1 - Group together bytes of 4-byte words." << std::endl
+		<< "                                         * 2 - Group together and delta encode bytes of 4-byte words." << std::endl
+		<< "                                       Default is " << config.CompressionFilter << "." << std::endl
+		<< "  -cfb|--compress-frame-blocks=true|false" << std::endl
+		<< "                                       Compress blocks of frames saved with --frame-index." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.CompressFrameBlocks) << "." << std::endl
+		<< "  -cmp|--compress=true|false           Compress output files into independently decompressible chunks." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.Compress) << "." << std::endl
+		<< "  -cs|--chunk-size=kib                 Configure the size of uncompressed chunks in KiB." << std::endl
+		<< "                                       Default is " << (config.CompressionChunkSize / 1024) << "." << std::endl
 		<< "  -db|--disable-bone=true|false        Enable/disable saving bones and animations." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.DisableBones) << "." << std::endl
 		<< "  -dc|--disable-color=true|false       Enable/disable saving vertex colors." << std::endl
@@ -42,12 +88,29 @@ void PrintHelp()
 		<< "                                       Default is " << PRINT_BOOL(config.DisableTextureCoords) << "." << std::endl
 		<< "  -duv2|--disable-uv2=true|false       Enable/disable saving of second texture coordinate layer." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.DisableTextureCoords2) << "." << std::endl
+		<< "  -ect|--eliminate-constant-tracks=true|false" << std::endl
+		<< "                                       Save animation tracks which do not change over the whole animation" << std::endl
+		<< "                                       (including unanimated nodes) only once. Changes file format version" << std::endl
+		<< "                                       to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.EliminateConstantTracks) << "." << std::endl
 		<< "  -em|--export-materials=true|false    Enable/disable export of materials to .bbmat files." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.ExportMaterials) << ". (experimental)" << std::endl
 		<< "  -ep|--enable-prefix=true|false       Prefix output files with model name." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.Prefix) << "." << std::endl
+		<< "  -fbs|--frame-block-size=frames       Number of frames in a block saved with --frame-index." << std::endl
+		<< "                                       Default is " << config.FrameBlockSize << "." << std::endl
+		<< "  -fi|--frame-index=true|false         Save animation frames in blocks with an index, which allows to read" << std::endl
+		<< "                                       any range of frames without reading the whole file. Takes" << std::endl
+		<< "                                       precedence over --eliminate-constant-tracks, --quantize-animations" << std::endl
+		<< "                                       and --half-float-frames. Changes file format version to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.FrameIndex) << "." << std::endl
 		<< "  -fn|--flip-normal=true|false         Enable/disable flipping normal vectors." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.FlipNormals) << "." << std::endl
+		<< "  -fnt|--flat-node-table=true|false" << std::endl
+		<< "                                       Save the node hierarchy as a flat table in parent-before-child order" << std::endl
+		<< "                                       and assign bone indices in the same order. Changes file format version" << std::endl
+		<< "                                       to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.FlatNodeTable) << "." << std::endl
 		<< "  -fuvx|--flip-uv-x=true|false         Enable/disable flipping texture coordinates horizontally." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.FlipTextureHorizontally) << "." << std::endl
 		<< "  -fuvy|--flip-uv-y=true|false         Enable/disable flipping texture coordinates vertically." << std::endl
@@ -57,10 +120,38 @@ void PrintHelp()
 		<< "                                         * 1 - Generate flat normal vectors." << std::endl
 		<< "                                         * 2 - Generate smooth normal vectors." << std::endl
 		<< "                                       Default is " << config.GenNormals << "." << std::endl
+		<< "  -hf|--half-float-frames=true|false   Save world-space and bone-space animation frames as half-precision" << std::endl
+		<< "                                       floats. Changes file format version to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.HalfFloatFrames) << "." << std::endl
 		<< "  -iw|--invert-winding=true|false      Invert winding order of vertices." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.InvertWinding) << "." << std::endl
+		<< "  -kee|--key-error-end-effector=value  Maximum world-space position error of any node of a reduced" << std::endl
+		<< "                                       animation, including error accumulated from its ancestors." << std::endl
+		<< "                                       Default is " << config.KeyEndEffectorError << "." << std::endl
+		<< "  -ker|--key-error-rotation=degrees    Maximum rotation error of a reduced animation key." << std::endl
+		<< "                                       Default is " << config.KeyRotationError << "." << std::endl
+		<< "  -ket|--key-error-translation=value   Maximum translation error of a reduced animation key." << std::endl
+		<< "                                       Default is " << config.KeyTranslationError << "." << std::endl
+		<< "  -kn|--keep-nodes=names               Comma-separated names of nodes which are never removed by" << std::endl
+		<< "                                       --prune-skeleton, e.g. sockets. Names can contain wildcards * and ?." << std::endl
+		<< "                                       Default is \"" << config.KeepNodes << "\"." << std::endl
 		<< "  -lh|--left-handed=true|false         Convert to left-handed coordinate system." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.LeftHanded) << "." << std::endl
+		<< "  -mt|--morph-targets=true|false       Save morph targets of meshes as sparse quantized deltas of vertices" << std::endl
+		<< "                                       which move and animations of their weights into animations. Changes" << std::endl
+		<< "                                       file format version to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.MorphTargets) << "." << std::endl
+		<< "  -ng|--native-glb=true|false          Convert meshes of GLB files straight from the file instead of using" << std::endl
+		<< "                                       Assimp's glTF importer. Nodes and meshes of these files are not" << std::endl
+		<< "                                       optimized (-on, -ome) and missing normals and tangents are generated" << std::endl
+		<< "                                       as with -nts. Files with unsupported features are still loaded by" << std::endl
+		<< "                                       Assimp, as are all files when -pt, -vat or -mt is enabled." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.NativeGlb) << "." << std::endl
+		<< "  -nts|--native-tangent-space=true|false" << std::endl
+		<< "                                       Generate missing normals and tangents on multiple threads instead" << std::endl
+		<< "                                       of using Assimp. Tangents are angle-weighted per corner and are not" << std::endl
+		<< "                                       guaranteed to match MikkTSpace." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.NativeTangentSpace) << "." << std::endl
 		<< "  -oa|--optimize-animations=0|1|2      Optimize animations." << std::endl
 		<< "                                         * 0 - No optimizations (node transform in parent-space)." << std::endl
 		<< "                                         * 1 - Node transform in world-space." << std::endl
@@ -72,12 +163,48 @@ void PrintHelp()
 		<< "                                       Default is " << PRINT_BOOL(config.OptimizeMeshes) << "." << std::endl
 		<< "  -oma|--optimize-materials=true|false Join redundant materials into one and remove unused materials." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.OptimizeMaterials) << "." << std::endl
+		<< "  -ps|--prune-skeleton=true|false      Remove bones without weights and nodes without meshes, which are not" << std::endl
+		<< "                                       animated, bake their transforms into children and re-index the rest." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.PruneSkeleton) << "." << std::endl
 		<< "  -pt|--pre-transform=true|false       Pre-transform model and collapse all nodes into one if possible." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.PreTransform) << "." << std::endl
+		<< "  -qa|--quantize-animations=0|1|2      Quantize animation tracks. Changes file format version to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                         * 0 - No quantization." << std::endl
+		<< "                                         * 1 - 48-bit rotations and 16-bit translations." << std::endl
+		<< "                                         * 2 - 32-bit rotations and 16-bit translations." << std::endl
+		<< "                                       Default is " << config.AnimationQuantization << "." << std::endl
+		<< "  -rk|--reduce-keys=true|false         Remove animation keys which can be reconstructed by interpolation." << std::endl
+		<< "                                       Requires --optimize-animations=0. Changes file format version" << std::endl
+		<< "                                       to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.ReduceKeys) << "." << std::endl
+		<< "  -rm|--reference-model=path           Path to a model (.bbmod) or a skeleton (.bbskel), against which are" << std::endl
+		<< "                                       resolved node indices of converted animations. When used, meshes are not" << std::endl
+		<< "                                       processed and only animations are saved, e.g. for mocap libraries." << std::endl
+		<< "                                       Default is \"" << config.ReferenceModel << "\"." << std::endl
 		<< "  -sr|--sampling-rate=fps              Configure the sampling rate (frames per second) of animations." << std::endl
 		<< "                                       Default is " << config.SamplingRate << "." << std::endl
+		<< "  -ss|--shared-skeleton=path           Path to a shared skeleton file (.bbskel). If it does not exist, it is" << std::endl
+		<< "                                       created from the model. Models and animations then reference it instead" << std::endl
+		<< "                                       of having their own skeleton. Changes file format version to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is \"" << config.SharedSkeleton << "\"." << std::endl
 		<< "  -su|--save-unused=true|false         Save unused material properties." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.SaveUnused) << "." << std::endl
+		<< "  -toc|--table-of-contents=true|false  Save files with a table of contents, which allows to read their" << std::endl
+		<< "                                       parts without decoding the rest. Changes file format version" << std::endl
+		<< "                                       to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.TableOfContents) << "." << std::endl
+		<< "  -vat|--vertex-animation=true|false   Bake positions of all vertices at each frame of animations into a vertex" << std::endl
+		<< "                                       animation texture (.bbvat). Lookup coordinates of vertices are saved" << std::endl
+		<< "                                       into the second UV channel." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.VertexAnimation) << "." << std::endl
+		<< "  -vatn|--vertex-animation-normals=true|false" << std::endl
+		<< "                                       Bake normals into vertex animation textures as well." << std::endl
+		<< "                                       Default is " << PRINT_BOOL(config.VertexAnimationNormals) << "." << std::endl
+		<< "  -wsn|--world-space-nodes=names       Comma-separated names of nodes, for which are world-space transforms" << std::endl
+		<< "                                       saved into animations, e.g. attachment sockets. Names can contain" << std::endl
+		<< "                                       wildcards * and ?. All other transforms are then saved only in bone" << std::endl
+		<< "                                       space. Changes file format version to " << BBMOD_VERSION_MAJOR << "." << BBMOD_VERSION_MINOR_TOC << "." << std::endl
+		<< "                                       Default is \"" << config.WorldSpaceNodes << "\"." << std::endl
 		<< "  -zup=true|false                      Convert model from Y-up to Z-up." << std::endl
 		<< "                                       Default is " << PRINT_BOOL(config.ConvertToZUp) << ". (experimental)" << std::endl
 		<< std::endl;
@@ -95,7 +222,8 @@ int main(int argc, const char* argv[])
 	bool showHelp = false;
 	SConfig config;
 
-	std::regex options_regex("(-[a-z0-9]+|--[a-z0-9\\-]+)=(true|false|[0-9]+)");
+	std::regex options_regex("(-[a-z0-9]+|--[a-z0-9\\-]+)=(true|false|[0-9]+(?:\\.[0-9]+)?)");
+	std::regex string_options_regex("(-kn|--keep-nodes|-rm|--reference-model|-ss|--shared-skeleton|-wsn|--world-space-nodes)=(.*)");
 	std::cmatch match;
 
 	for (int i = 1; i < argc; ++i)
@@ -113,19 +241,78 @@ int main(int argc, const char* argv[])
 					<< "Assimp version: 5.2.4" << std::endl;
 				return EXIT_SUCCESS;
 			}
+			else if (std::regex_match(argv[i], match, string_options_regex))
+			{
+				auto& o = match[1];
+				std::string sValue = match[2].str();
+
+				if (o == "-kn" || o == "--keep-nodes")
+				{
+					config.KeepNodes = sValue;
+				}
+				else if (o == "-rm" || o == "--reference-model")
+				{
+					config.ReferenceModel = sValue;
+				}
+				else if (o == "-ss" || o == "--shared-skeleton")
+				{
+					config.SharedSkeleton = sValue;
+				}
+				else if (o == "-wsn" || o == "--world-space-nodes")
+				{
+					config.WorldSpaceNodes = sValue;
+				}
+			}
 			else if (std::regex_match(argv[i], match, options_regex))
 			{
 				auto& o = match[1];
 				bool bValue = (match[2] == "true");
 				uint32_t iValue = (uint32_t)strtol(match[2].str().c_str(), (char**)NULL, 10);
+				float fValue = (float)strtod(match[2].str().c_str(), (char**)NULL);
 
 				if (false)
 				{
 				}
+				else if (o == "-ab" || o == "--animated-bounds")
+				{
+					config.AnimatedBounds = bValue;
+				}
+				else if (o == "-alt" || o == "--animation-lod-tiers")
+				{
+					config.AnimationLodTiers = iValue;
+				}
+				else if (o == "-ap" || o == "--animation-pack")
+				{
+					config.AnimationPack = bValue;
+				}
 				else if (o == "-as" || o == "--apply-scale")
 				{
 					config.ApplyScale = bValue;
 				}
+				else if (o == "-ba" || o == "--bone-atlas")
+				{
+					config.BoneAtlas = (iValue > BBMOD_ATLAS_RGBA16F) ? BBMOD_ATLAS_RGBA16F : iValue;
+				}
+				else if (o == "-blc" || o == "--bone-lod-count")
+				{
+					config.BoneLodCount = iValue;
+				}
+				else if (o == "-cf" || o == "--compression-filter")
+				{
+					config.CompressionFilter = (iValue > BBMOD_FILTER_SHUFFLE_DELTA) ? BBMOD_FILTER_SHUFFLE_DELTA : iValue;
+				}
+				else if (o == "-cmp" || o == "--compress")
+				{
+					config.Compress = bValue;
+				}
+				else if (o == "-cfb" || o == "--compress-frame-blocks")
+				{
+					config.CompressFrameBlocks = bValue;
+				}
+				else if (o == "-cs" || o == "--chunk-size")
+				{
+					config.CompressionChunkSize = std::clamp<uint32_t>(iValue, 1, UINT32_MAX / 1024) * 1024;
+				}
 				else if (o == "-db" || o == "--disable-bone")
 				{
 					config.DisableBones = bValue;
@@ -151,6 +338,10 @@ int main(int argc, const char* argv[])
 				{
 					config.DisableTextureCoords2 = bValue;
 				}
+				else if (o == "-ect" || o == "--eliminate-constant-tracks")
+				{
+					config.EliminateConstantTracks = bValue;
+				}
 				else if (o == "-em" || o == "--export-materials")
 				{
 					config.ExportMaterials = bValue;
@@ -159,10 +350,22 @@ int main(int argc, const char* argv[])
 				{
 					config.Prefix = bValue;
 				}
+				else if (o == "-fbs" || o == "--frame-block-size")
+				{
+					config.FrameBlockSize = (iValue < 1) ? 1 : iValue;
+				}
+				else if (o == "-fi" || o == "--frame-index")
+				{
+					config.FrameIndex = bValue;
+				}
 				else if (o == "-fn" || o == "--flip-normal")
 				{
 					config.FlipNormals = bValue;
 				}
+				else if (o == "-fnt" || o == "--flat-node-table")
+				{
+					config.FlatNodeTable = bValue;
+				}
 				else if (o == "-fuvx" || o == "--flip-uv-x")
 				{
 					config.FlipTextureHorizontally = bValue;
@@ -175,14 +378,42 @@ int main(int argc, const char* argv[])
 				{
 					config.GenNormals = iValue;
 				}
+				else if (o == "-hf" || o == "--half-float-frames")
+				{
+					config.HalfFloatFrames = bValue;
+				}
 				else if (o == "-iw" || o == "--invert-winding")
 				{
 					config.InvertWinding = bValue;
 				}
+				else if (o == "-kee" || o == "--key-error-end-effector")
+				{
+					config.KeyEndEffectorError = fValue;
+				}
+				else if (o == "-ker" || o == "--key-error-rotation")
+				{
+					config.KeyRotationError = fValue;
+				}
+				else if (o == "-ket" || o == "--key-error-translation")
+				{
+					config.KeyTranslationError = fValue;
+				}
 				else if (o == "-lh" || o == "--left-handed")
 				{
 					config.LeftHanded = bValue;
 				}
+				else if (o == "-mt" || o == "--morph-targets")
+				{
+					config.MorphTargets = bValue;
+				}
+				else if (o == "-ng" || o == "--native-glb")
+				{
+					config.NativeGlb = bValue;
+				}
+				else if (o == "-nts" || o == "--native-tangent-space")
+				{
+					config.NativeTangentSpace = bValue;
+				}
 				else if (o == "-oa" || o == "--optimize-animations")
 				{
 					config.AnimationOptimization = iValue;
@@ -199,10 +430,22 @@ int main(int argc, const char* argv[])
 				{
 					config.OptimizeMaterials = bValue;
 				}
+				else if (o == "-ps" || o == "--prune-skeleton")
+				{
+					config.PruneSkeleton = bValue;
+				}
 				else if (o == "-pt" || o == "--pre-transform")
 				{
 					config.PreTransform = bValue;
 				}
+				else if (o == "-qa" || o == "--quantize-animations")
+				{
+					config.AnimationQuantization = (iValue > BBMOD_QUANTIZE_32) ? BBMOD_QUANTIZE_32 : iValue;
+				}
+				else if (o == "-rk" || o == "--reduce-keys")
+				{
+					config.ReduceKeys = bValue;
+				}
 				else if (o == "-sr" || o == "--sampling-rate")
 				{
 					config.SamplingRate = (double)((iValue < 1) ? 1 : iValue);
@@ -211,6 +454,18 @@ int main(int argc, const char* argv[])
 				{
 					config.SaveUnused = bValue;
 				}
+				else if (o == "-toc" || o == "--table-of-contents")
+				{
+					config.TableOfContents = bValue;
+				}
+				else if (o == "-vat" || o == "--vertex-animation")
+				{
+					config.VertexAnimation = bValue;
+				}
+				else if (o == "-vatn" || o == "--vertex-animation-normals")
+				{
+					config.VertexAnimationNormals = bValue;
+				}
 				else if (o == "-zup")
 				{
 					config.ConvertToZUp = bValue;
@@ -253,7 +508,42 @@ int main(int argc, const char* argv[])
 		return EXIT_FAILURE;
 	}
 
-	int retval = ConvertToBBMOD(fin, fout ? fout : fin, config);
+	// Show a live progress line while converting, Ctrl+C cancels the conversion
+	std::signal(SIGINT, HandleInterrupt);
+
+	std::atomic<bool> finished(false);
+	std::thread progressThread;
+
+	if (IsTerminal())
+	{
+		progressThread = std::thread([&finished]() {
+			while (!finished)
+			{
+				uint32_t stage = gProgress.Stage;
+				if (stage != BBMOD_STAGE_NONE && stage != BBMOD_STAGE_DONE)
+				{
+					PRINT_PROGRESS("%3d%% %s %d%% (file %d of %d)",
+						(int)(gProgress.GetTotal() * 100.0f),
+						SProgress::GetStageName(stage),
+						(int)(gProgress.Fraction * 100.0f),
+						(int)gProgress.FileIndex + 1,
+						(int)gProgress.FileCount);
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			}
+		});
+	}
+
+	int retval = ConvertToBBMOD(fin, fout ? fout : fin, config, &gProgress);
+
+	finished = true;
+
+	if (progressThread.joinable())
+	{
+		progressThread.join();
+		ClearProgressLine();
+		fflush(stdout);
+	}
 
 	if (retval != BBMOD_SUCCESS)
 	{
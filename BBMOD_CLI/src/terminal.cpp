@@ -2,6 +2,9 @@
 
 #ifdef _WIN32
 #include <Windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
 #endif
 
 bool InitTerminal()
@@ -28,3 +31,12 @@ bool InitTerminal()
 #endif
 	return true;
 }
+
+bool IsTerminal()
+{
+#ifdef _WIN32
+	return _isatty(_fileno(stdout));
+#else
+	return isatty(fileno(stdout));
+#endif
+}
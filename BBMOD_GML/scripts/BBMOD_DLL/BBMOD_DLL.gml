@@ -47,6 +47,11 @@
 /// @private
 #macro __BBMOD_DLL_ERR_SAVE_FAILED 3
 
+/// @macro {Real} An error code returned from the DLL when model conversion
+/// is cancelled.
+/// @private
+#macro __BBMOD_DLL_ERR_CANCELLED 4
+
 /// @macro {Real} A value used to tell that no normals should be generated
 /// if the model does not have any.
 /// @see BBMOD_NORMALS_FLAT
@@ -65,6 +70,100 @@
 /// @see BBMOD_NORMALS_FLAT
 #macro BBMOD_NORMALS_SMOOTH 2
 
+/// @macro {Real} A value used to tell that no filter should be applied to data
+/// before compression.
+/// @see BBMOD_FILTER_SHUFFLE
+/// @see BBMOD_FILTER_SHUFFLE_DELTA
+#macro BBMOD_FILTER_NONE 0
+
+/// @macro {Real} A value used to tell that bytes of 4-byte words should be
+/// grouped together before compression.
+/// @see BBMOD_FILTER_NONE
+/// @see BBMOD_FILTER_SHUFFLE_DELTA
+#macro BBMOD_FILTER_SHUFFLE 1
+
+/// @macro {Real} A value used to tell that bytes of 4-byte words should be
+/// grouped together and delta encoded before compression.
+/// @see BBMOD_FILTER_NONE
+/// @see BBMOD_FILTER_SHUFFLE
+#macro BBMOD_FILTER_SHUFFLE_DELTA 2
+
+/// @macro {Real} A value used to tell that animation tracks should not be
+/// quantized.
+/// @see BBMOD_QUANTIZE_48
+/// @see BBMOD_QUANTIZE_32
+#macro BBMOD_QUANTIZE_NONE 0
+
+/// @macro {Real} A value used to tell that rotations in animation tracks
+/// should be packed into 48 bits and translations into 16 bits per component.
+/// @see BBMOD_QUANTIZE_NONE
+/// @see BBMOD_QUANTIZE_32
+#macro BBMOD_QUANTIZE_48 1
+
+/// @macro {Real} A value used to tell that rotations in animation tracks
+/// should be packed into 32 bits and translations into 16 bits per component.
+/// @see BBMOD_QUANTIZE_NONE
+/// @see BBMOD_QUANTIZE_48
+#macro BBMOD_QUANTIZE_32 2
+
+/// @macro {Real} A value used to tell that no bone atlas should be saved.
+/// @see BBMOD_ATLAS_RGBA32F
+/// @see BBMOD_ATLAS_RGBA16F
+#macro BBMOD_ATLAS_NONE 0
+
+/// @macro {Real} A value used to tell that a bone atlas should be saved with
+/// four 32-bit floats per texel.
+/// @see BBMOD_ATLAS_NONE
+/// @see BBMOD_ATLAS_RGBA16F
+#macro BBMOD_ATLAS_RGBA32F 1
+
+/// @macro {Real} A value used to tell that a bone atlas should be saved with
+/// four 16-bit floats per texel.
+/// @see BBMOD_ATLAS_NONE
+/// @see BBMOD_ATLAS_RGBA32F
+#macro BBMOD_ATLAS_RGBA16F 2
+
+/// @macro {Real} A conversion stage which tells that no conversion is running.
+/// @see BBMOD_DLL.get_progress_stage
+#macro BBMOD_STAGE_NONE 0
+
+/// @macro {Real} A conversion stage which tells that a model is being loaded.
+/// @see BBMOD_DLL.get_progress_stage
+#macro BBMOD_STAGE_LOAD 1
+
+/// @macro {Real} A conversion stage which tells that meshes are being converted.
+/// @see BBMOD_DLL.get_progress_stage
+#macro BBMOD_STAGE_MESHES 2
+
+/// @macro {Real} A conversion stage which tells that a model is being saved.
+/// @see BBMOD_DLL.get_progress_stage
+#macro BBMOD_STAGE_SAVE 3
+
+/// @macro {Real} A conversion stage which tells that animations are being converted.
+/// @see BBMOD_DLL.get_progress_stage
+#macro BBMOD_STAGE_ANIMATIONS 4
+
+/// @macro {Real} A conversion stage which tells that a conversion has finished.
+/// @see BBMOD_DLL.get_progress_stage
+#macro BBMOD_STAGE_DONE 5
+
+/// @macro {Real} A status of a conversion job which does not exist.
+/// @see BBMOD_DLL.job_get_status
+#macro BBMOD_JOB_NONE -1
+
+/// @macro {Real} A status of a conversion job which waits for a free worker.
+/// @see BBMOD_DLL.job_get_status
+#macro BBMOD_JOB_QUEUED 0
+
+/// @macro {Real} A status of a conversion job which is running.
+/// @see BBMOD_DLL.job_get_status
+#macro BBMOD_JOB_RUNNING 1
+
+/// @macro {Real} A status of a conversion job which has finished,
+/// successfully or not.
+/// @see BBMOD_DLL.job_get_status
+#macro BBMOD_JOB_FINISHED 2
+
 /* beautify ignore:end */
 
 /// @func BBMOD_DLL()
@@ -110,39 +209,67 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_disable_bone()
+	/// @func get_progress()
 	///
-	/// @desc Checks whether bones are disabled.
+	/// @desc Retrieves progress of the last conversion, including all files
+	/// of a directory.
 	///
-	/// @return {Bool} If `true` then bones are disabled.
+	/// @return {Real} The progress in range 0..1.
 	///
-	/// @see BBMOD_DLL.set_disable_bone
-	static get_disable_bone = function ()
+	/// @see BBMOD_DLL.get_progress_stage
+	static get_progress = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_disable_bone", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_progress", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_disable_bone(_disable)
+	/// @func get_progress_stage()
 	///
-	/// @desc Enables/disables bones and animations. These are by default
-	/// **enabled**.
+	/// @desc Retrieves the stage of the last conversion, e.g. the stage in
+	/// which it failed or was cancelled.
 	///
-	/// @param {Bool} _disable `true` to disable.
+	/// @return {Real} One of `BBMOD_STAGE_` macros.
+	///
+	/// @see BBMOD_DLL.get_progress_stage_fraction
+	static get_progress_stage = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_progress_stage", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func get_progress_stage_fraction()
+	///
+	/// @desc Retrieves progress of the current stage of the last conversion.
+	///
+	/// @return {Real} The progress of the stage in range 0..1.
+	///
+	/// @see BBMOD_DLL.get_progress_stage
+	static get_progress_stage_fraction = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_progress_stage_fraction", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func cancel()
+	///
+	/// @desc Requests the running conversion to stop at the next possible
+	/// occasion. The conversion then fails.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
-	///
-	/// @see BBMOD_DLL.get_disable_bone
-	static set_disable_bone = function (_disable)
+	static cancel = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_disable_bone", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _disable);
+			BBMOD_DLL_PATH, "bbmod_dll_cancel", dll_cdecl, ty_real, 0);
+		var _retval = external_call(_fn);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -150,79 +277,163 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_disable_color()
+	/// @func convert_async(_fin, _fout)
 	///
-	/// @desc Checks whether vertex colors are disabled.
+	/// @desc Starts converting a model into a BBMOD in the background, using
+	/// the current configuration. Up to two jobs are converted at once, others
+	/// wait in a queue.
 	///
-	/// @return {Bool} If `true` then vertex colors are disabled.
+	/// @param {String} _fin Path to the original model.
+	/// @param {String} _fout Path to the converted model.
 	///
-	/// @see BBMOD_DLL.set_disable_color
-	static get_disable_color = function ()
+	/// @return {Real} The ID of the conversion job.
+	///
+	/// @example
+	/// ```gml
+	/// // Create event
+	/// job = dll.convert_async("House.fbx", "House.bbmod");
+	///
+	/// // Step event
+	/// if (dll.job_get_status(job) == BBMOD_JOB_FINISHED)
+	/// {
+	///     var _success = dll.job_get_result(job);
+	///     dll.job_free(job);
+	/// }
+	/// ```
+	///
+	/// @see BBMOD_DLL.job_get_status
+	/// @see BBMOD_DLL.job_free
+	static convert_async = function (_fin, _fout)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_disable_color", dll_cdecl, ty_real, 0);
-		return external_call(_fn);
+			BBMOD_DLL_PATH, "bbmod_dll_convert_async", dll_cdecl, ty_real, 2, ty_string, ty_string);
+		return external_call(_fn, _fin, _fout);
 	};
 
-	/// @func set_disable_color(_disable)
+	/// @func job_get_status(_job)
 	///
-	/// @desc Enables/disables vertex colors. Vertex colors are by default
-	/// **enabled**.
+	/// @desc Retrieves the status of a conversion job.
 	///
-	/// @param {Bool} _disable `true` to disable.
+	/// @param {Real} _job The ID of the job.
 	///
-	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	/// @return {Real} One of `BBMOD_JOB_` macros.
+	static job_get_status = function (_job)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_job_get_status", dll_cdecl, ty_real, 1, ty_real);
+		return external_call(_fn, _job);
+	};
+
+	/// @func job_get_progress(_job)
 	///
-	/// @throws {BBMOD_Exception} If the operation fails.
+	/// @desc Retrieves progress of a conversion job.
 	///
-	/// @see BBMOD_DLL.get_disable_color
-	static set_disable_color = function (_disable)
+	/// @param {Real} _job The ID of the job.
+	///
+	/// @return {Real} The progress in range 0..1.
+	static job_get_progress = function (_job)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_disable_color", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _disable);
-		if (_retval != __BBMOD_DLL_SUCCESS)
+			BBMOD_DLL_PATH, "bbmod_dll_job_get_progress", dll_cdecl, ty_real, 1, ty_real);
+		return external_call(_fn, _job);
+	};
+
+	/// @func job_get_progress_stage(_job)
+	///
+	/// @desc Retrieves the current stage of a conversion job.
+	///
+	/// @param {Real} _job The ID of the job.
+	///
+	/// @return {Real} One of `BBMOD_STAGE_` macros.
+	static job_get_progress_stage = function (_job)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_job_get_progress_stage", dll_cdecl, ty_real, 1, ty_real);
+		return external_call(_fn, _job);
+	};
+
+	/// @func job_get_result(_job)
+	///
+	/// @desc Checks whether a finished conversion job was successful.
+	///
+	/// @param {Real} _job The ID of the job.
+	///
+	/// @return {Bool} Returns `true` if the model was converted or `false` if
+	/// the conversion failed, was cancelled or has not finished yet.
+	static job_get_result = function (_job)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_job_get_result", dll_cdecl, ty_real, 1, ty_real);
+		return (external_call(_fn, _job) == __BBMOD_DLL_SUCCESS);
+	};
+
+	/// @func job_get_outputs(_job)
+	///
+	/// @desc Retrieves paths to all files written by a conversion job so far,
+	/// e.g. models, animations and materials.
+	///
+	/// @param {Real} _job The ID of the job.
+	///
+	/// @return {Array<String>} An array of paths.
+	static job_get_outputs = function (_job)
+	{
+		static _fnCount = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_job_get_output_count", dll_cdecl, ty_real, 1, ty_real);
+		static _fnGet = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_job_get_output", dll_cdecl, ty_string, 2, ty_real, ty_real);
+		var _count = external_call(_fnCount, _job);
+		var _outputs = array_create(_count);
+		for (var i = 0; i < _count; ++i)
 		{
-			throw new BBMOD_Exception();
+			_outputs[i] = external_call(_fnGet, _job, i);
 		}
-		return self;
+		return _outputs;
 	};
 
-	/// @func get_disable_normal()
+	/// @func job_cancel(_job)
 	///
-	/// @desc Checks whether vertex normals are disabled.
+	/// @desc Requests a conversion job to stop at the next possible occasion.
+	/// The job then finishes unsuccessfully.
 	///
-	/// @return {Bool} If `true` then vertex normals are disabled.
+	/// @param {Real} _job The ID of the job.
 	///
-	/// @see BBMOD_DLL.set_disable_normal
-	static get_disable_normal = function ()
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the job does not exist.
+	static job_cancel = function (_job)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_disable_normal", dll_cdecl, ty_real, 0);
-		return external_call(_fn);
+			BBMOD_DLL_PATH, "bbmod_dll_job_cancel", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _job);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
 	};
 
-	/// @func set_disable_normal(_disable)
+	/// @func job_free(_job)
 	///
-	/// @desc Enables/disables vertex normals. Vertex normals are by default
-	/// **enabled**.
+	/// @desc Frees a conversion job. A job which has not finished yet is
+	/// cancelled. Its ID cannot be used anymore.
 	///
-	/// @param {Bool} _disable `true` to disable.
+	/// @param {Real} _job The ID of the job.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
-	/// @throws {BBMOD_Exception} If the operation fails.
-	///
-	/// @see BBMOD_DLL.get_disable_normal
-	static set_disable_normal = function (_disable)
+	/// @throws {BBMOD_Exception} If the job does not exist.
+	static job_free = function (_job)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_disable_normal", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _disable);
+			BBMOD_DLL_PATH, "bbmod_dll_job_free", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _job);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -230,39 +441,72 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_flip_normal()
+	/// @func config_create()
+	///
+	/// @desc Creates a new configuration with default settings, which can be
+	/// changed without affecting other configurations and conversions. The
+	/// `set_` and `get_` methods change the default configuration, which has
+	/// handle 0.
+	///
+	/// @return {Real} The handle of the configuration.
+	///
+	/// @example
+	/// ```gml
+	/// var _config = dll.config_create();
+	/// dll.config_set(_config, "sampling_rate", 30);
+	/// dll.config_set_string(_config, "shared_skeleton", "Character.bbskel");
+	/// var _job = dll.config_convert_async(_config, "Character.fbx", "Character.bbmod");
+	/// dll.config_destroy(_config);
+	/// ```
+	///
+	/// @see BBMOD_DLL.config_destroy
+	static config_create = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_config_create", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func config_clone(_config)
 	///
-	/// @desc Checks whether flipping vertex normals is enabled.
+	/// @desc Creates a copy of a configuration.
 	///
-	/// @return {Bool} Returns `true` if enabled.
+	/// @param {Real} _config The handle of the configuration to copy.
 	///
-	/// @see BBMOD_DLL.set_flip_normal
-	static get_flip_normal = function ()
+	/// @return {Real} The handle of the new configuration.
+	///
+	/// @throws {BBMOD_Exception} If the configuration does not exist.
+	static config_clone = function (_config)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_flip_normal", dll_cdecl, ty_real, 0);
-		return external_call(_fn);
+			BBMOD_DLL_PATH, "bbmod_dll_config_clone", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _config);
+		if (_retval == __BBMOD_DLL_FAILURE)
+		{
+			throw new BBMOD_Exception();
+		}
+		return _retval;
 	};
 
-	/// @func set_flip_normal(_flip)
+	/// @func config_destroy(_config)
 	///
-	/// @desc Enables/disables flipping vertex normals. This is by default
-	/// **disabled**.
+	/// @desc Destroys a configuration. The default configuration cannot be
+	/// destroyed. Conversions already started with the configuration are not
+	/// affected.
 	///
-	/// @param {Bool} _flip `true` to enable.
+	/// @param {Real} _config The handle of the configuration.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
-	/// @throws {BBMOD_Exception} If the operation fails.
-	///
-	/// @see BBMOD_DLL.get_flip_normal
-	static set_flip_normal = function (_flip)
+	/// @throws {BBMOD_Exception} If the configuration does not exist.
+	static config_destroy = function (_config)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_flip_normal", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _flip);
+			BBMOD_DLL_PATH, "bbmod_dll_config_destroy", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _config);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -270,46 +514,42 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_gen_normal()
+	/// @func config_get(_config, _name)
 	///
-	/// @desc Checks whether generating normal vectors is enabled.
+	/// @desc Retrieves a setting of a configuration.
 	///
-	/// @return {Real} Returns one of the `BBMOD_NORMALS_*` macros.
+	/// @param {Real} _config The handle of the configuration.
+	/// @param {String} _name The name of the setting, which is the name of its
+	/// `set_` method without the prefix, e.g. "sampling_rate".
 	///
-	/// @see BBMOD_DLL.set_gen_normal
-	/// @see BBMOD_NORMALS_NONE
-	/// @see BBMOD_NORMALS_FLAT
-	/// @see BBMOD_NORMALS_SMOOTH
-	static get_gen_normal = function ()
+	/// @return {Real} The value of the setting.
+	static config_get = function (_config, _name)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_gen_normal", dll_cdecl, ty_real, 0);
-		return external_call(_fn);
+			BBMOD_DLL_PATH, "bbmod_dll_config_get", dll_cdecl, ty_real, 2, ty_real, ty_string);
+		return external_call(_fn, _config, _name);
 	};
 
-	/// @func set_gen_normal(_normals)
+	/// @func config_set(_config, _name, _value)
 	///
-	/// @desc Configures generating normal vectors. This is by default
-	/// set to {@link BBMOD_NORMALS_SMOOTH}. Vertex normals are required
-	/// by the default shaders!
+	/// @desc Changes a setting of a configuration.
 	///
-	/// @param {Real} _normals Use one of the `BBMOD_NORMALS_*` macros.
+	/// @param {Real} _config The handle of the configuration.
+	/// @param {String} _name The name of the setting, which is the name of its
+	/// `set_` method without the prefix, e.g. "sampling_rate".
+	/// @param {Real} _value The new value of the setting.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
-	/// @throws {BBMOD_Exception} If the operation fails.
-	///
-	/// @see BBMOD_DLL.get_gen_normal
-	/// @see BBMOD_NORMALS_NONE
-	/// @see BBMOD_NORMALS_FLAT
-	/// @see BBMOD_NORMALS_SMOOTH
-	static set_gen_normal = function (_normals)
+	/// @throws {BBMOD_Exception} If the configuration or the setting does not
+	/// exist.
+	static config_set = function (_config, _name, _value)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_gen_normal", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _normals);
+			BBMOD_DLL_PATH, "bbmod_dll_config_set", dll_cdecl, ty_real, 3, ty_real, ty_string, ty_real);
+		var _retval = external_call(_fn, _config, _name, _value);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -317,39 +557,42 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_disable_tangent()
+	/// @func config_get_string(_config, _name)
 	///
-	/// @desc Checks whether tangent and bitangent vectors are disabled.
+	/// @desc Retrieves a string setting of a configuration, e.g.
+	/// "shared_skeleton".
 	///
-	/// @return {Bool} If `true` then tangent and bitangent vectors are disabled.
+	/// @param {Real} _config The handle of the configuration.
+	/// @param {String} _name The name of the setting.
 	///
-	/// @see BBMOD_DLL.set_disable_tangent
-	static get_disable_tangent = function ()
+	/// @return {String} The value of the setting.
+	static config_get_string = function (_config, _name)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_disable_tangent", dll_cdecl, ty_real, 0);
-		return external_call(_fn);
+			BBMOD_DLL_PATH, "bbmod_dll_config_get_string", dll_cdecl, ty_string, 2, ty_real, ty_string);
+		return external_call(_fn, _config, _name);
 	};
 
-	/// @func set_disable_tangent(_disable)
+	/// @func config_set_string(_config, _name, _value)
 	///
-	/// @desc Enables/disables tangent and bitangent vectors. These are by
-	/// default **enabled**.
+	/// @desc Changes a string setting of a configuration, e.g.
+	/// "shared_skeleton".
 	///
-	/// @param {Bool} _disable `true` to disable tangent and bitangent vectors.
+	/// @param {Real} _config The handle of the configuration.
+	/// @param {String} _name The name of the setting.
+	/// @param {String} _value The new value of the setting.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
-	/// @throws {BBMOD_Exception} If the operation fails.
-	///
-	/// @see BBMOD_DLL.get_disable_tangent
-	static set_disable_tangent = function (_disable)
+	/// @throws {BBMOD_Exception} If the configuration or the setting does not
+	/// exist.
+	static config_set_string = function (_config, _name, _value)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_disable_tangent", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _disable);
+			BBMOD_DLL_PATH, "bbmod_dll_config_set_string", dll_cdecl, ty_real, 3, ty_real, ty_string, ty_string);
+		var _retval = external_call(_fn, _config, _name, _value);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -357,79 +600,1747 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_disable_uv()
+	/// @func config_convert(_config, _fin, _fout)
 	///
-	/// @desc Checks whether texture coordinates are disabled.
+	/// @desc Converts a model into a BBMOD using given configuration.
 	///
-	/// @return {Bool} If `true` then texture coordinates are disabled.
+	/// @param {Real} _config The handle of the configuration.
+	/// @param {String} _fin Path to the original model.
+	/// @param {String} _fout Path to the converted model.
 	///
-	/// @see BBMOD_DLL.set_disable_uv
-	static get_disable_uv = function ()
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the model conversion fails.
+	static config_convert = function (_config, _fin, _fout)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_disable_uv", dll_cdecl, ty_real, 0);
-		return external_call(_fn);
+			BBMOD_DLL_PATH, "bbmod_dll_config_convert", dll_cdecl, ty_real, 3, ty_real, ty_string, ty_string);
+		var _retval = external_call(_fn, _config, _fin, _fout);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
 	};
 
-	/// @func set_disable_uv(_disable)
+	/// @func config_convert_async(_config, _fin, _fout)
 	///
-	/// @desc Enables/disables texture coordinates. Texture coordinates are by
-	/// default **enabled**.
+	/// @desc Starts converting a model into a BBMOD in the background using a
+	/// copy of given configuration.
 	///
-	/// @param {Bool} _disable `true` to disable texture coordinates.
+	/// @param {Real} _config The handle of the configuration.
+	/// @param {String} _fin Path to the original model.
+	/// @param {String} _fout Path to the converted model.
 	///
-	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	/// @return {Real} The ID of the conversion job.
 	///
-	/// @throws {BBMOD_Exception} If the operation fails.
+	/// @throws {BBMOD_Exception} If the configuration does not exist.
 	///
-	/// @see BBMOD_DLL.get_disable_uv
-	static set_disable_uv = function (_disable)
+	/// @see BBMOD_DLL.convert_async
+	static config_convert_async = function (_config, _fin, _fout)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_disable_uv", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _disable);
+			BBMOD_DLL_PATH, "bbmod_dll_config_convert_async", dll_cdecl, ty_real, 3, ty_real, ty_string, ty_string);
+		var _retval = external_call(_fn, _config, _fin, _fout);
+		if (_retval == __BBMOD_DLL_FAILURE)
+		{
+			throw new BBMOD_Exception();
+		}
+		return _retval;
+	};
+
+	/// @func convert_buffer(_buffer, _hint, _name[, _config])
+	///
+	/// @desc Converts a model stored in a buffer into a BBMOD without writing
+	/// any temporary files.
+	///
+	/// @param {Id.Buffer} _buffer A buffer with the original model.
+	/// @param {String} _hint The extension of the original model, e.g. "glb".
+	/// @param {String} _name The name of the model, used to name created
+	/// animations and materials.
+	/// @param {Real} [_config] The handle of the configuration to use. Defaults
+	/// to the default configuration.
+	///
+	/// @return {Array<Struct>} An array of structs with properties `Name`,
+	/// which is the name of a created file, and `Buffer`, which is a new buffer
+	/// with its content. The first file is always the model. Buffers must be
+	/// deleted when no longer needed!
+	///
+	/// @throws {BBMOD_Exception} If the conversion fails.
+	///
+	/// @note Models which reference external files (e.g. textures or .bin
+	/// files of .gltf models) cannot be converted this way.
+	static convert_buffer = function (_buffer, _hint, _name, _config = undefined)
+	{
+		static _fnConvert = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_config_convert_buffer", dll_cdecl, ty_real, 5,
+			ty_real, ty_string, ty_real, ty_string, ty_string);
+		static _fnCount = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_buffer_get_count", dll_cdecl, ty_real, 0);
+		static _fnName = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_buffer_get_name", dll_cdecl, ty_string, 1, ty_real);
+		static _fnSize = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_buffer_get_size", dll_cdecl, ty_real, 1, ty_real);
+		static _fnCopy = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_buffer_copy", dll_cdecl, ty_real, 2, ty_real, ty_string);
+		static _fnFree = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_buffer_free", dll_cdecl, ty_real, 0);
+
+		_config ??= 0;
+
+		var _retval = external_call(_fnConvert, _config,
+			buffer_get_address(_buffer), buffer_get_size(_buffer), _hint, _name);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
+			external_call(_fnFree);
 			throw new BBMOD_Exception();
 		}
-		return self;
+
+		var _count = external_call(_fnCount);
+		var _files = array_create(_count);
+		for (var i = 0; i < _count; ++i)
+		{
+			var _size = external_call(_fnSize, i);
+			var _file = buffer_create(max(_size, 1), buffer_fixed, 1);
+			external_call(_fnCopy, i, buffer_get_address(_file));
+			_files[i] = {
+				Name: external_call(_fnName, i),
+				Buffer: _file,
+			};
+		}
+		external_call(_fnFree);
+		return _files;
 	};
 
-	/// @func get_disable_uv2()
+	/// @func get_disable_bone()
+	///
+	/// @desc Checks whether bones are disabled.
+	///
+	/// @return {Bool} If `true` then bones are disabled.
+	///
+	/// @see BBMOD_DLL.set_disable_bone
+	static get_disable_bone = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_disable_bone", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_disable_bone(_disable)
+	///
+	/// @desc Enables/disables bones and animations. These are by default
+	/// **enabled**.
+	///
+	/// @param {Bool} _disable `true` to disable.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_disable_bone
+	static set_disable_bone = function (_disable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_disable_bone", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _disable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_disable_color()
+	///
+	/// @desc Checks whether vertex colors are disabled.
+	///
+	/// @return {Bool} If `true` then vertex colors are disabled.
+	///
+	/// @see BBMOD_DLL.set_disable_color
+	static get_disable_color = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_disable_color", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_disable_color(_disable)
+	///
+	/// @desc Enables/disables vertex colors. Vertex colors are by default
+	/// **enabled**.
+	///
+	/// @param {Bool} _disable `true` to disable.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_disable_color
+	static set_disable_color = function (_disable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_disable_color", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _disable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_disable_normal()
+	///
+	/// @desc Checks whether vertex normals are disabled.
+	///
+	/// @return {Bool} If `true` then vertex normals are disabled.
+	///
+	/// @see BBMOD_DLL.set_disable_normal
+	static get_disable_normal = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_disable_normal", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_disable_normal(_disable)
+	///
+	/// @desc Enables/disables vertex normals. Vertex normals are by default
+	/// **enabled**.
+	///
+	/// @param {Bool} _disable `true` to disable.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_disable_normal
+	static set_disable_normal = function (_disable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_disable_normal", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _disable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_flip_normal()
+	///
+	/// @desc Checks whether flipping vertex normals is enabled.
+	///
+	/// @return {Bool} Returns `true` if enabled.
+	///
+	/// @see BBMOD_DLL.set_flip_normal
+	static get_flip_normal = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_flip_normal", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_flip_normal(_flip)
+	///
+	/// @desc Enables/disables flipping vertex normals. This is by default
+	/// **disabled**.
+	///
+	/// @param {Bool} _flip `true` to enable.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_flip_normal
+	static set_flip_normal = function (_flip)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_flip_normal", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _flip);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_gen_normal()
+	///
+	/// @desc Checks whether generating normal vectors is enabled.
+	///
+	/// @return {Real} Returns one of the `BBMOD_NORMALS_*` macros.
+	///
+	/// @see BBMOD_DLL.set_gen_normal
+	/// @see BBMOD_NORMALS_NONE
+	/// @see BBMOD_NORMALS_FLAT
+	/// @see BBMOD_NORMALS_SMOOTH
+	static get_gen_normal = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_gen_normal", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_gen_normal(_normals)
+	///
+	/// @desc Configures generating normal vectors. This is by default
+	/// set to {@link BBMOD_NORMALS_SMOOTH}. Vertex normals are required
+	/// by the default shaders!
+	///
+	/// @param {Real} _normals Use one of the `BBMOD_NORMALS_*` macros.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_gen_normal
+	/// @see BBMOD_NORMALS_NONE
+	/// @see BBMOD_NORMALS_FLAT
+	/// @see BBMOD_NORMALS_SMOOTH
+	static set_gen_normal = function (_normals)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_gen_normal", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _normals);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_disable_tangent()
+	///
+	/// @desc Checks whether tangent and bitangent vectors are disabled.
+	///
+	/// @return {Bool} If `true` then tangent and bitangent vectors are disabled.
+	///
+	/// @see BBMOD_DLL.set_disable_tangent
+	static get_disable_tangent = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_disable_tangent", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_disable_tangent(_disable)
+	///
+	/// @desc Enables/disables tangent and bitangent vectors. These are by
+	/// default **enabled**.
+	///
+	/// @param {Bool} _disable `true` to disable tangent and bitangent vectors.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_disable_tangent
+	static set_disable_tangent = function (_disable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_disable_tangent", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _disable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_disable_uv()
+	///
+	/// @desc Checks whether texture coordinates are disabled.
+	///
+	/// @return {Bool} If `true` then texture coordinates are disabled.
+	///
+	/// @see BBMOD_DLL.set_disable_uv
+	static get_disable_uv = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_disable_uv", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_disable_uv(_disable)
+	///
+	/// @desc Enables/disables texture coordinates. Texture coordinates are by
+	/// default **enabled**.
+	///
+	/// @param {Bool} _disable `true` to disable texture coordinates.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_disable_uv
+	static set_disable_uv = function (_disable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_disable_uv", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _disable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_disable_uv2()
+	///
+	/// @desc Checks whether second UV channel is disabled.
+	///
+	/// @return {Bool} If `true` then second UV channel is disabled.
+	///
+	/// @see BBMOD_DLL.set_disable_uv2
+	static get_disable_uv2 = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_disable_uv2", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_disable_uv2(_disable)
+	///
+	/// @desc Enables/disables second UV channel. Second UV channel is by
+	/// default **enabled**.
+	///
+	/// @param {Bool} _disable `true` to disable second UV channel.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_disable_uv2
+	static set_disable_uv2 = function (_disable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_disable_uv2", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _disable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_flip_uv_horizontally()
+	///
+	/// @desc Checks whether flipping texture coordinates horizontally is
+	/// enabled.
+	///
+	/// @return {Bool} Returns `true` if enabled.
+	///
+	/// @see BBMOD_DLL.set_flip_uv_horizontally
+	static get_flip_uv_horizontally = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_flip_uv_horizontally", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_flip_uv_horizontally(_flip)
+	///
+	/// @desc Enables/disables flipping texture coordinates horizontally. This
+	/// is by default **disabled**.
+	///
+	/// @param {Bool} _flip `true` to enable.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_flip_uv_horizontally
+	static set_flip_uv_horizontally = function (_flip)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_flip_uv_horizontally", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _flip);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_flip_uv_vertically()
+	///
+	/// @desc Checks whether flipping texture coordinates vertically is enabled.
+	///
+	/// @return {Bool} Returns `true` if enabled.
+	///
+	/// @see BBMOD_DLL.set_flip_uv_vertically
+	static get_flip_uv_vertically = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_flip_uv_vertically", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_flip_uv_vertically(_flip)
+	///
+	/// @desc Enables/disables flipping texture coordinates vertically. This is
+	/// by default **disabled**.
+	///
+	/// @param {Bool} _flip `true` to enable.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_flip_uv_vertically
+	static set_flip_uv_vertically = function (_flip)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_flip_uv_vertically", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _flip);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_invert_winding()
+	///
+	/// @desc Checks whether inverse vertex winding is enabled.
+	///
+	/// @return {Bool} If `true` then inverse vertex winding is enabled.
+	///
+	/// @see BBMOD_DLL.set_invert_winding
+	static get_invert_winding = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_invert_winding", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_invert_winding(_invert)
+	///
+	/// @desc Enables/disables inverse vertex winding. This is by default
+	/// **disabled**.
+	///
+	/// @param {Bool} _invert `true` to invert winding.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_invert_winding
+	static set_invert_winding = function (_invert)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_invert_winding", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _invert);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_left_handed()
+	///
+	/// @desc Checks whether conversion to left-handed coordinate system is
+	/// enabled.
+	///
+	/// @return {Bool} If `true` then conversion to left-handed coordinate
+	/// system is enabled.
+	///
+	/// @see BBMOD_DLL.set_left_handed
+	static get_left_handed = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_left_handed", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_left_handed(_leftHanded)
+	///
+	/// @desc Enables/disables conversion to left-handed coordinate system.
+	/// This is by default **enabled**.
+	///
+	/// @param {Bool} _leftHanded `true` to enable conversion to left-handed
+	/// coordinate system.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_left_handed
+	static set_left_handed = function (_leftHanded)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_left_handed", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _leftHanded);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_optimize_nodes()
+	///
+	/// @desc Checks whether node optimization is enabled.
+	///
+	/// @return {Bool} If `true` then node optimization is enabled.
+	///
+	/// @see BBMOD_DLL.set_optimize_nodes
+	static get_optimize_nodes = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_optimize_nodes", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_optimize_nodes(_optimize)
+	///
+	/// @desc Enable/disable node optimization. When enabled, multiple
+	/// nodes (without bones, animations, ...) are joined into one.
+	/// This is by default **disabled**.
+	///
+	/// @param {Bool} _optimize `true` to enable node optimization.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_optimize_nodes
+	static set_optimize_nodes = function (_optimize)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_optimize_nodes", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _optimize);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_optimize_meshes()
+	///
+	/// @desc Checks whether mesh optimization is enabled.
+	///
+	/// @return {Bool} If `true` then mesh optimization is enabled.
+	///
+	/// @see BBMOD_DLL.set_optimize_meshes
+	static get_optimize_meshes = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_optimize_meshes", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_optimize_meshes(_optimize)
+	///
+	/// @desc Enables/disables mesh optimization. When enabled, multiple meshes
+	/// with the same material are joined into one to reduce draw calls. This is
+	/// by default **disabled**.
+	///
+	/// @param {Bool} _optimize `true` to enable mesh optimization.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_optimize_meshes
+	static set_optimize_meshes = function (_optimize)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_optimize_meshes", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _optimize);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_optimize_materials()
+	///
+	/// @desc Checks whether material optimization is enabled.
+	///
+	/// @return {Bool} If `true` then material optimization is enabled.
+	///
+	/// @see BBMOD_DLL.set_optimize_materials
+	static get_optimize_materials = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_optimize_materials", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_optimize_materials(_optimize)
+	///
+	/// @desc Enables/disables material optimization. When enabled, redundant
+	/// materials are joined into one and unused materials are removed.
+	/// This is by default **disabled**.
+	///
+	/// @param {Bool} _optimize `true` to enable material optimization.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_optimize_materials
+	static set_optimize_materials = function (_optimize)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_optimize_materials", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _optimize);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_apply_scale()
+	///
+	/// @desc Checks whether the "apply scale" option is enabled.
+	///
+	/// @return {Bool} If `true` then the "apply scale" option is enabled.
+	///
+	/// @see BBMOD_DLL.set_apply_scale
+	static get_apply_scale = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_apply_scale", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_apply_scale(_enable)
+	///
+	/// @desc Enables/disables the "apply scale" option, which applies global
+	/// scaling factor defined in the model file if enabled.
+	/// This is by default **disabled**.
+	///
+	/// @param {Bool} _enable `true` to enable the option.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_apply_scale
+	static set_apply_scale = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_apply_scale", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_pre_transform()
+	///
+	/// @desc Checks whether the "pre-transform" option is enabled.
+	///
+	/// @return {Bool} If `true` then the "pre-transform" option is enabled.
+	///
+	/// @see BBMOD_DLL.set_pre_transform
+	static get_pre_transform = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_pre_transform", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_pre_transform(_enable)
+	///
+	/// @desc Enables/disables the "pre-transform" option, which pre-transforms
+	/// the models and collapses all nodes into one if possible.
+	/// This is by default **disabled**.
+	///
+	/// @param {Bool} _enable `true` to enable the option.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_pre_transform
+	static set_pre_transform = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_pre_transform", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_optimize_animations()
+	///
+	/// @desc Retrieves the animation optimization level.
+	///
+	/// @return {Real} The animation optimization level. See section
+	/// [Animation optimization levels](./AnimationOptimizationLevels.html) for
+	/// more info.
+	///
+	/// @see BBMOD_DLL.set_optimize_animations
+	static get_optimize_animations = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_optimize_animations", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_optimize_animations(_level)
+	///
+	/// @desc Sets the animation optimization level.
+	/// This is by default set to **0**.
+	///
+	/// @param {Real} _level The new animation optimization level. See section
+	/// [Animation optimization levels](./AnimationOptimizationLevels.html) for
+	/// more info.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_optimize_animations
+	static set_optimize_animations = function (_level)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_optimize_animations", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, clamp(_level, 0, 2));
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_sampling_rate()
+	///
+	/// @desc Retrieves the animation samping rate (frames per second).
+	///
+	/// @return {Real} The animation sampling rate.
+	///
+	/// @see BBMOD_DLL.set_sampling_rate
+	static get_sampling_rate = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_sampling_rate", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_sampling_rate(_fps)
+	///
+	/// @desc Sets the animation sampling rate (frames per second).
+	/// This is by default set to **60**.
+	///
+	/// @param {Real} _fps The new animation sampling rate.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_sampling_rate
+	static set_sampling_rate = function (_fps)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_sampling_rate", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, max(floor(_fps), 1));
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_export_materials()
+	///
+	/// @desc Checks whether export of materials is enabled.
+	///
+	/// @return {Bool} If `true` then export of materials is enabled.
+	///
+	/// @note This is an experimental feature!
+	///
+	/// @see BBMOD_DLL.set_export_materials
+	static get_export_materials = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_export_materials", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_export_materials(_enable)
+	///
+	/// @desc Enables/disables export of materials. This is by default
+	/// **disabled**.
+	///
+	/// @param {Bool} _enable `true` to enable material export.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @note This is an experimental feature!
+	///
+	/// @see BBMOD_DLL.get_export_materials
+	static set_export_materials = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_export_materials", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_zup()
+	///
+	/// @desc Checks whether model is converted from Y-up to Z-up.
+	///
+	/// @return {Bool} If `true` then model is converted from Y-up to Z-up.
+	///
+	/// @note This is an experimental feature!
+	///
+	/// @see BBMOD_DLL.set_zup
+	static get_zup = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_zup", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_zup(_enable)
+	///
+	/// @desc Enables/disables conversion from Y-up to Z-up. This is by default
+	/// **disabled**.
+	///
+	/// @param {Bool} _enable `true` to enable conversion from Y-up to Z-up.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @note This is an experimental feature!
+	///
+	/// @see BBMOD_DLL.get_zup
+	static set_zup = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_zup", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_enable_prefix()
+	///
+	/// @desc Checks whether prefixing of output files with model name is
+	/// enabled.
+	///
+	/// @return {Bool} If `true` then prefixing of output files with model
+	/// name is enabled.
+	///
+	/// @see BBMOD_DLL.set_enable_prefix
+	static get_enable_prefix = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_enable_prefix", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_enable_prefix(_enable)
+	///
+	/// @desc Enables/disables prefixing of output files with model name. This
+	/// is by default **enabled**.
+	///
+	/// @param {Bool} _enable `true` to enable prefixing of output files with
+	/// model name.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_enable_prefix
+	static set_enable_prefix = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_enable_prefix", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_compress()
+	///
+	/// @desc Checks whether output files are compressed.
+	///
+	/// @return {Bool} If `true` then output files are compressed.
+	///
+	/// @note Compressed files are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_compress
+	static get_compress = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_compress", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_compress(_enable)
+	///
+	/// @desc Enables/disables compression of output BBMOD and BBANIM files into
+	/// a container of independently decompressible chunks. This is by default
+	/// **disabled**.
+	///
+	/// @param {Bool} _enable `true` to enable compression.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @note Compressed files are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_compress
+	static set_compress = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_compress", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_compression_chunk_size()
+	///
+	/// @desc Retrieves the size of uncompressed chunks in bytes.
+	///
+	/// @return {Real} The size of uncompressed chunks in bytes.
+	///
+	/// @see BBMOD_DLL.set_compression_chunk_size
+	static get_compression_chunk_size = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_compression_chunk_size", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_compression_chunk_size(_size)
+	///
+	/// @desc Configures the size of uncompressed chunks in bytes. This is by
+	/// default set to **262144** (256 KiB).
+	///
+	/// @param {Real} _size The size of uncompressed chunks in bytes.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_compression_chunk_size
+	static set_compression_chunk_size = function (_size)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_compression_chunk_size", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _size);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_compression_filter()
+	///
+	/// @desc Retrieves the filter applied to data before compression.
+	///
+	/// @return {Real} The filter applied to data before compression. See
+	/// `BBMOD_FILTER_` macros.
+	///
+	/// @see BBMOD_DLL.set_compression_filter
+	static get_compression_filter = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_compression_filter", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_compression_filter(_filter)
+	///
+	/// @desc Configures the filter applied to data before compression. This is
+	/// by default set to {@link BBMOD_FILTER_SHUFFLE_DELTA}.
+	///
+	/// @param {Real} _filter Use one of the `BBMOD_FILTER_` macros.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_compression_filter
+	static set_compression_filter = function (_filter)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_compression_filter", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _filter);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_table_of_contents()
+	///
+	/// @desc Checks whether files are saved with a table of contents.
+	///
+	/// @return {Bool} If `true` then files are saved with a table of contents.
+	///
+	/// @note Files with a table of contents are not yet supported by the GML
+	/// part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_table_of_contents
+	static get_table_of_contents = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_table_of_contents", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_table_of_contents(_enable)
+	///
+	/// @desc Enables/disables saving files with a table of contents, which
+	/// allows to read their parts without decoding the rest. This changes the
+	/// file format version to 3.5. This is by default **disabled**.
+	///
+	/// @param {Bool} _enable `true` to enable saving files with a table of
+	/// contents.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @note Files with a table of contents are not yet supported by the GML
+	/// part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_table_of_contents
+	static set_table_of_contents = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_table_of_contents", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_reduce_keys()
+	///
+	/// @desc Checks whether animation keys which can be reconstructed by
+	/// interpolation are removed.
+	///
+	/// @return {Bool} If `true` then animation keys are reduced.
+	///
+	/// @note Animations with reduced keys are not yet supported by the GML part
+	/// of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_reduce_keys
+	static get_reduce_keys = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_reduce_keys", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_reduce_keys(_enable)
+	///
+	/// @desc Enables/disables removing animation keys which can be
+	/// reconstructed by interpolating neighbouring keys within configured error
+	/// tolerances. Requires animation optimization level 0. This changes the
+	/// file format version to 3.5. This is by default **disabled**.
+	///
+	/// @param {Bool} _enable `true` to enable keyframe reduction.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @note Animations with reduced keys are not yet supported by the GML part
+	/// of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_reduce_keys
+	static set_reduce_keys = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_reduce_keys", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_key_error_translation()
+	///
+	/// @desc Retrieves the maximum translation error of a reduced animation
+	/// key.
+	///
+	/// @return {Real} The maximum translation error.
+	///
+	/// @see BBMOD_DLL.set_key_error_translation
+	static get_key_error_translation = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_key_error_translation", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_key_error_translation(_error)
+	///
+	/// @desc Configures the maximum translation error of a reduced animation
+	/// key. This is by default **0.001**.
+	///
+	/// @param {Real} _error The maximum translation error.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_key_error_translation
+	static set_key_error_translation = function (_error)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_key_error_translation", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _error);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_key_error_rotation()
+	///
+	/// @desc Retrieves the maximum rotation error of a reduced animation key.
+	///
+	/// @return {Real} The maximum rotation error in degrees.
+	///
+	/// @see BBMOD_DLL.set_key_error_rotation
+	static get_key_error_rotation = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_key_error_rotation", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_key_error_rotation(_error)
+	///
+	/// @desc Configures the maximum rotation error of a reduced animation key.
+	/// This is by default **0.1** degrees.
+	///
+	/// @param {Real} _error The maximum rotation error in degrees.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_key_error_rotation
+	static set_key_error_rotation = function (_error)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_key_error_rotation", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _error);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_key_error_end_effector()
+	///
+	/// @desc Retrieves the maximum world-space position error of any node of
+	/// a reduced animation.
+	///
+	/// @return {Real} The maximum end effector error.
+	///
+	/// @see BBMOD_DLL.set_key_error_end_effector
+	static get_key_error_end_effector = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_key_error_end_effector", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_key_error_end_effector(_error)
+	///
+	/// @desc Configures the maximum world-space position error of any node of
+	/// a reduced animation at any frame, including error accumulated from its
+	/// ancestors. This is by default **0.01**.
+	///
+	/// @param {Real} _error The maximum end effector error.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_key_error_end_effector
+	static set_key_error_end_effector = function (_error)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_key_error_end_effector", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _error);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_eliminate_constant_tracks()
+	///
+	/// @desc Checks whether animation tracks which do not change over the whole
+	/// animation are saved only once.
+	///
+	/// @return {Bool} If `true` then constant animation tracks are saved only
+	/// once.
+	///
+	/// @note Animations with eliminated constant tracks are not yet supported
+	/// by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_eliminate_constant_tracks
+	static get_eliminate_constant_tracks = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_eliminate_constant_tracks", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_eliminate_constant_tracks(_enable)
+	///
+	/// @desc Enables/disables saving animation tracks which do not change over
+	/// the whole animation (including unanimated nodes) only once instead of at
+	/// every frame. This changes the file format version to 3.5. This is by
+	/// default **disabled**.
+	///
+	/// @param {Bool} _enable `true` to enable constant track elimination.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @note Animations with eliminated constant tracks are not yet supported
+	/// by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_eliminate_constant_tracks
+	static set_eliminate_constant_tracks = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_eliminate_constant_tracks", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_animation_quantization()
+	///
+	/// @desc Retrieves the quantization of animation tracks.
+	///
+	/// @return {Real} The quantization of animation tracks. See
+	/// `BBMOD_QUANTIZE_` macros.
+	///
+	/// @note Quantized animations are not yet supported by the GML part of
+	/// BBMOD!
+	///
+	/// @see BBMOD_DLL.set_animation_quantization
+	static get_animation_quantization = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_animation_quantization", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_animation_quantization(_quantization)
+	///
+	/// @desc Configures the quantization of animation tracks. Rotations are
+	/// packed using the smallest three method and translations are quantized
+	/// against per-track ranges. This changes the file format version to 3.5.
+	/// This is by default `BBMOD_QUANTIZE_NONE`.
+	///
+	/// @param {Real} _quantization The quantization of animation tracks. Use
+	/// one of the `BBMOD_QUANTIZE_` macros.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @note Quantized animations are not yet supported by the GML part of
+	/// BBMOD!
+	///
+	/// @see BBMOD_DLL.get_animation_quantization
+	static set_animation_quantization = function (_quantization)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_animation_quantization", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _quantization);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_half_float_frames()
+	///
+	/// @desc Checks whether world-space and bone-space animation frames are
+	/// saved as half-precision floats.
+	///
+	/// @return {Bool} If `true` then world-space and bone-space frames are
+	/// saved as half-precision floats.
+	///
+	/// @note Animations with half-precision frames are not yet supported by the
+	/// GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_half_float_frames
+	static get_half_float_frames = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_half_float_frames", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_half_float_frames(_enable)
+	///
+	/// @desc Enables/disables saving world-space and bone-space animation
+	/// frames as half-precision floats. This changes the file format version to
+	/// 3.5. This is by default **disabled**.
+	///
+	/// @param {Bool} _enable `true` to enable half-precision frames.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @note Animations with half-precision frames are not yet supported by the
+	/// GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_half_float_frames
+	static set_half_float_frames = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_half_float_frames", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_frame_index()
+	///
+	/// @desc Checks whether animation frames are saved in blocks with an index.
+	///
+	/// @return {Bool} If `true` then animation frames are saved in blocks with
+	/// an index.
+	///
+	/// @note Animations with a frame index are not yet supported by the GML
+	/// part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_frame_index
+	static get_frame_index = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_frame_index", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_frame_index(_enable)
+	///
+	/// @desc Enables/disables saving animation frames in blocks with an index,
+	/// which allows to read any range of frames without reading the whole file.
+	/// Takes precedence over constant track elimination and quantization. This
+	/// changes the file format version to 3.5. This is by default **disabled**.
+	///
+	/// @param {Bool} _enable `true` to enable saving frames with an index.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @note Animations with a frame index are not yet supported by the GML
+	/// part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_frame_index
+	static set_frame_index = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_frame_index", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_frame_block_size()
+	///
+	/// @desc Retrieves the number of frames in a block of a frame index.
+	///
+	/// @return {Real} The number of frames in a block.
+	///
+	/// @see BBMOD_DLL.set_frame_block_size
+	static get_frame_block_size = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_frame_block_size", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_frame_block_size(_frames)
+	///
+	/// @desc Configures the number of frames in a block of a frame index. This
+	/// is by default **64**.
+	///
+	/// @param {Real} _frames The number of frames in a block.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_frame_block_size
+	static set_frame_block_size = function (_frames)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_frame_block_size", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _frames);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_compress_frame_blocks()
+	///
+	/// @desc Checks whether blocks of a frame index are compressed.
+	///
+	/// @return {Bool} If `true` then blocks of a frame index are compressed.
+	///
+	/// @see BBMOD_DLL.set_compress_frame_blocks
+	static get_compress_frame_blocks = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_compress_frame_blocks", dll_cdecl, ty_real, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_compress_frame_blocks(_enable)
+	///
+	/// @desc Enables/disables compressing blocks of a frame index independently
+	/// on each other. This is by default **enabled**.
+	///
+	/// @param {Bool} _enable `true` to enable compressing blocks of a frame
+	/// index.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @see BBMOD_DLL.get_compress_frame_blocks
+	static set_compress_frame_blocks = function (_enable)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_compress_frame_blocks", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_world_space_nodes()
+	///
+	/// @desc Retrieves names of nodes, for which are world-space transforms
+	/// saved into animations.
+	///
+	/// @return {String} Comma-separated names of nodes.
+	///
+	/// @note Animations with world-space nodes are not yet supported by the GML
+	/// part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_world_space_nodes
+	static get_world_space_nodes = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_get_world_space_nodes", dll_cdecl, ty_string, 0);
+		return external_call(_fn);
+	};
+
+	/// @func set_world_space_nodes(_nodes)
+	///
+	/// @desc Configures names of nodes, for which are world-space transforms
+	/// saved into animations, e.g. attachment sockets. Names can contain
+	/// wildcards `*` and `?`. When not empty, all other transforms are saved
+	/// only in bone space and the file format version changes to 3.5. This is
+	/// by default an empty string.
+	///
+	/// @param {String} _nodes Comma-separated names of nodes.
+	///
+	/// @return {Struct.BBMOD_DLL} Returns `self`.
+	///
+	/// @throws {BBMOD_Exception} If the operation fails.
+	///
+	/// @note Animations with world-space nodes are not yet supported by the GML
+	/// part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_world_space_nodes
+	static set_world_space_nodes = function (_nodes)
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_set_world_space_nodes", dll_cdecl, ty_real, 1, ty_string);
+		var _retval = external_call(_fn, _nodes);
+		if (_retval != __BBMOD_DLL_SUCCESS)
+		{
+			throw new BBMOD_Exception();
+		}
+		return self;
+	};
+
+	/// @func get_animation_lod_tiers()
 	///
-	/// @desc Checks whether second UV channel is disabled.
+	/// @desc Retrieves the number of animation LODs saved alongside full rate
+	/// frames.
 	///
-	/// @return {Bool} If `true` then second UV channel is disabled.
+	/// @return {Real} The number of animation LODs.
 	///
-	/// @see BBMOD_DLL.set_disable_uv2
-	static get_disable_uv2 = function ()
+	/// @note Animation LODs are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_animation_lod_tiers
+	static get_animation_lod_tiers = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_disable_uv2", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_animation_lod_tiers", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_disable_uv2(_disable)
+	/// @func set_animation_lod_tiers(_count)
 	///
-	/// @desc Enables/disables second UV channel. Second UV channel is by
-	/// default **enabled**.
+	/// @desc Configures the number of animation LODs saved alongside full rate
+	/// frames. The first LOD has half the sampling rate and every next one has
+	/// half the rate of the previous one. Error of each LOD compared to the
+	/// full rate is saved with it. This changes the file format version to 3.5.
+	/// This is by default **0**.
 	///
-	/// @param {Bool} _disable `true` to disable second UV channel.
+	/// @param {Real} _count The number of animation LODs.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_disable_uv2
-	static set_disable_uv2 = function (_disable)
+	/// @note Animation LODs are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_animation_lod_tiers
+	static set_animation_lod_tiers = function (_count)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_disable_uv2", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _disable);
+			BBMOD_DLL_PATH, "bbmod_dll_set_animation_lod_tiers", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _count);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -437,40 +2348,45 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_flip_uv_horizontally()
+	/// @func get_bone_lod_count()
 	///
-	/// @desc Checks whether flipping texture coordinates horizontally is
-	/// enabled.
+	/// @desc Retrieves the number of bone LODs computed for animated models.
 	///
-	/// @return {Bool} Returns `true` if enabled.
+	/// @return {Real} The number of bone LODs.
 	///
-	/// @see BBMOD_DLL.set_flip_uv_horizontally
-	static get_flip_uv_horizontally = function ()
+	/// @note Bone LODs are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_bone_lod_count
+	static get_bone_lod_count = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_flip_uv_horizontally", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_bone_lod_count", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_flip_uv_horizontally(_flip)
+	/// @func set_bone_lod_count(_count)
 	///
-	/// @desc Enables/disables flipping texture coordinates horizontally. This
-	/// is by default **disabled**.
+	/// @desc Configures the number of bone LODs computed for animated models.
+	/// Each LOD maps bones with the least influence on vertices to their
+	/// nearest kept ancestor. This changes the file format version to 3.5. This
+	/// is by default **0**.
 	///
-	/// @param {Bool} _flip `true` to enable.
+	/// @param {Real} _count The number of bone LODs.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_flip_uv_horizontally
-	static set_flip_uv_horizontally = function (_flip)
+	/// @note Bone LODs are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_bone_lod_count
+	static set_bone_lod_count = function (_count)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_flip_uv_horizontally", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _flip);
+			BBMOD_DLL_PATH, "bbmod_dll_set_bone_lod_count", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _count);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -478,39 +2394,41 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_flip_uv_vertically()
+	/// @func get_prune_skeleton()
 	///
-	/// @desc Checks whether flipping texture coordinates vertically is enabled.
+	/// @desc Checks whether unused bones and nodes are removed.
 	///
-	/// @return {Bool} Returns `true` if enabled.
+	/// @return {Bool} Returns `true` if unused bones and nodes are removed.
 	///
-	/// @see BBMOD_DLL.set_flip_uv_vertically
-	static get_flip_uv_vertically = function ()
+	/// @see BBMOD_DLL.set_prune_skeleton
+	static get_prune_skeleton = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_flip_uv_vertically", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_prune_skeleton", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_flip_uv_vertically(_flip)
+	/// @func set_prune_skeleton(_enable)
 	///
-	/// @desc Enables/disables flipping texture coordinates vertically. This is
-	/// by default **disabled**.
+	/// @desc Enables/disables removing bones without weights and nodes without
+	/// meshes, which are not animated. Their transforms are baked into their
+	/// children and remaining bones and nodes are re-indexed. This is by
+	/// default **disabled**.
 	///
-	/// @param {Bool} _flip `true` to enable.
+	/// @param {Bool} _enable `true` to enable pruning.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_flip_uv_vertically
-	static set_flip_uv_vertically = function (_flip)
+	/// @see BBMOD_DLL.get_prune_skeleton
+	static set_prune_skeleton = function (_enable)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_flip_uv_vertically", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _flip);
+			BBMOD_DLL_PATH, "bbmod_dll_set_prune_skeleton", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -518,39 +2436,40 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_invert_winding()
+	/// @func get_keep_nodes()
 	///
-	/// @desc Checks whether inverse vertex winding is enabled.
+	/// @desc Retrieves names of nodes which are never removed by pruning.
 	///
-	/// @return {Bool} If `true` then inverse vertex winding is enabled.
+	/// @return {String} Comma-separated names of nodes.
 	///
-	/// @see BBMOD_DLL.set_invert_winding
-	static get_invert_winding = function ()
+	/// @see BBMOD_DLL.set_keep_nodes
+	static get_keep_nodes = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_invert_winding", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_keep_nodes", dll_cdecl, ty_string, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_invert_winding(_invert)
+	/// @func set_keep_nodes(_nodes)
 	///
-	/// @desc Enables/disables inverse vertex winding. This is by default
-	/// **disabled**.
+	/// @desc Configures names of nodes which are never removed by pruning, e.g.
+	/// sockets. Names can contain wildcards `*` and `?`. This is by default an
+	/// empty string.
 	///
-	/// @param {Bool} _invert `true` to invert winding.
+	/// @param {String} _nodes Comma-separated names of nodes.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_invert_winding
-	static set_invert_winding = function (_invert)
+	/// @see BBMOD_DLL.get_keep_nodes
+	static set_keep_nodes = function (_nodes)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_invert_winding", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _invert);
+			BBMOD_DLL_PATH, "bbmod_dll_set_keep_nodes", dll_cdecl, ty_real, 1, ty_string);
+		var _retval = external_call(_fn, _nodes);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -558,42 +2477,46 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_left_handed()
+	/// @func get_flat_node_table()
 	///
-	/// @desc Checks whether conversion to left-handed coordinate system is
-	/// enabled.
+	/// @desc Checks whether the node hierarchy is saved as a flat table.
 	///
-	/// @return {Bool} If `true` then conversion to left-handed coordinate
-	/// system is enabled.
+	/// @return {Bool} Returns `true` if the node hierarchy is saved as a flat
+	/// table.
 	///
-	/// @see BBMOD_DLL.set_left_handed
-	static get_left_handed = function ()
+	/// @note Flat node tables are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_flat_node_table
+	static get_flat_node_table = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_left_handed", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_flat_node_table", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_left_handed(_leftHanded)
+	/// @func set_flat_node_table(_enable)
 	///
-	/// @desc Enables/disables conversion to left-handed coordinate system.
-	/// This is by default **enabled**.
+	/// @desc Enables/disables saving the node hierarchy as a flat table in
+	/// parent-before-child order, with bone indices assigned in the same order.
+	/// This changes the file format version to 3.5. This is by default
+	/// **disabled**.
 	///
-	/// @param {Bool} _leftHanded `true` to enable conversion to left-handed
-	/// coordinate system.
+	/// @param {Bool} _enable `true` to enable the flat node table.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_left_handed
-	static set_left_handed = function (_leftHanded)
+	/// @note Flat node tables are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_flat_node_table
+	static set_flat_node_table = function (_enable)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_left_handed", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _leftHanded);
+			BBMOD_DLL_PATH, "bbmod_dll_set_flat_node_table", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -601,40 +2524,48 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_optimize_nodes()
+	/// @func get_shared_skeleton()
 	///
-	/// @desc Checks whether node optimization is enabled.
+	/// @desc Retrieves the path to a shared skeleton file.
 	///
-	/// @return {Bool} If `true` then node optimization is enabled.
+	/// @return {String} The path to a shared skeleton file or an empty string.
 	///
-	/// @see BBMOD_DLL.set_optimize_nodes
-	static get_optimize_nodes = function ()
+	/// @note Shared skeletons are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_shared_skeleton
+	static get_shared_skeleton = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_optimize_nodes", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_shared_skeleton", dll_cdecl, ty_string, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_optimize_nodes(_optimize)
+	/// @func set_shared_skeleton(_path)
 	///
-	/// @desc Enable/disable node optimization. When enabled, multiple
-	/// nodes (without bones, animations, ...) are joined into one.
-	/// This is by default **disabled**.
+	/// @desc Configures the path to a shared skeleton file (.bbskel). If the
+	/// file does not exist, it is created from the converted model. Models and
+	/// animations then reference the skeleton instead of having their own,
+	/// which allows to play the same animations on multiple models. This
+	/// changes the file format version to 3.5. This is by default an empty
+	/// string.
 	///
-	/// @param {Bool} _optimize `true` to enable node optimization.
+	/// @param {String} _path The path to a shared skeleton file or an empty
+	/// string to disable.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_optimize_nodes
-	static set_optimize_nodes = function (_optimize)
+	/// @note Shared skeletons are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_shared_skeleton
+	static set_shared_skeleton = function (_path)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_optimize_nodes", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _optimize);
+			BBMOD_DLL_PATH, "bbmod_dll_set_shared_skeleton", dll_cdecl, ty_real, 1, ty_string);
+		var _retval = external_call(_fn, _path);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -642,40 +2573,44 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_optimize_meshes()
+	/// @func get_reference_model()
 	///
-	/// @desc Checks whether mesh optimization is enabled.
+	/// @desc Retrieves the path to a reference model used in the animation-only
+	/// mode.
 	///
-	/// @return {Bool} If `true` then mesh optimization is enabled.
+	/// @return {String} The path to a reference model or an empty string.
 	///
-	/// @see BBMOD_DLL.set_optimize_meshes
-	static get_optimize_meshes = function ()
+	/// @see BBMOD_DLL.set_reference_model
+	static get_reference_model = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_optimize_meshes", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_reference_model", dll_cdecl, ty_string, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_optimize_meshes(_optimize)
+	/// @func set_reference_model(_path)
 	///
-	/// @desc Enables/disables mesh optimization. When enabled, multiple meshes
-	/// with the same material are joined into one to reduce draw calls. This is
-	/// by default **disabled**.
+	/// @desc Configures the path to a model (.bbmod) or a skeleton (.bbskel),
+	/// against which are resolved node indices of converted animations. When
+	/// not empty, meshes are not processed and only animations are saved, which
+	/// makes conversion of mocap libraries much faster. This is by default an
+	/// empty string.
 	///
-	/// @param {Bool} _optimize `true` to enable mesh optimization.
+	/// @param {String} _path The path to a reference model or an empty string
+	/// to disable the animation-only mode.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_optimize_meshes
-	static set_optimize_meshes = function (_optimize)
+	/// @see BBMOD_DLL.get_reference_model
+	static set_reference_model = function (_path)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_optimize_meshes", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _optimize);
+			BBMOD_DLL_PATH, "bbmod_dll_set_reference_model", dll_cdecl, ty_real, 1, ty_string);
+		var _retval = external_call(_fn, _path);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -683,40 +2618,46 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_optimize_materials()
+	/// @func get_animation_pack()
 	///
-	/// @desc Checks whether material optimization is enabled.
+	/// @desc Checks whether animations are saved into a single animation pack.
 	///
-	/// @return {Bool} If `true` then material optimization is enabled.
+	/// @return {Bool} Returns `true` if animations are saved into a single
+	/// animation pack.
 	///
-	/// @see BBMOD_DLL.set_optimize_materials
-	static get_optimize_materials = function ()
+	/// @note Animation packs are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_animation_pack
+	static get_animation_pack = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_optimize_materials", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_animation_pack", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_optimize_materials(_optimize)
+	/// @func set_animation_pack(_enable)
 	///
-	/// @desc Enables/disables material optimization. When enabled, redundant
-	/// materials are joined into one and unused materials are removed.
-	/// This is by default **disabled**.
+	/// @desc Enables/disables saving all animations of a model, or of a
+	/// directory of models, into a single animation pack (.bbpack) instead of
+	/// separate .bbanim files. The pack has a directory of clips sorted by name
+	/// and metadata shared by all clips. This is by default disabled.
 	///
-	/// @param {Bool} _optimize `true` to enable material optimization.
+	/// @param {Bool} _enable Use `true` to enable animation packs.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_optimize_materials
-	static set_optimize_materials = function (_optimize)
+	/// @note Animation packs are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_animation_pack
+	static set_animation_pack = function (_enable)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_optimize_materials", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _optimize);
+			BBMOD_DLL_PATH, "bbmod_dll_set_animation_pack", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -724,39 +2665,47 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_apply_scale()
+	/// @func get_animated_bounds()
 	///
-	/// @desc Checks whether the "apply scale" option is enabled.
+	/// @desc Checks whether bounding boxes of the animated model at each frame
+	/// are saved into animations.
 	///
-	/// @return {Bool} If `true` then the "apply scale" option is enabled.
+	/// @return {Bool} Returns `true` if animated bounding boxes are saved.
 	///
-	/// @see BBMOD_DLL.set_apply_scale
-	static get_apply_scale = function ()
+	/// @note Animated bounding boxes are not yet supported by the GML part of
+	/// BBMOD!
+	///
+	/// @see BBMOD_DLL.set_animated_bounds
+	static get_animated_bounds = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_apply_scale", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_animated_bounds", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_apply_scale(_enable)
+	/// @func set_animated_bounds(_enable)
 	///
-	/// @desc Enables/disables the "apply scale" option, which applies global
-	/// scaling factor defined in the model file if enabled.
-	/// This is by default **disabled**.
+	/// @desc Enables/disables saving bounding boxes of the animated model at
+	/// each frame into animations. The boxes are computed by skinning all
+	/// vertices of the model and they are quantized to 16 bits per component.
+	/// This is by default disabled.
 	///
-	/// @param {Bool} _enable `true` to enable the option.
+	/// @param {Bool} _enable Use `true` to enable animated bounding boxes.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_apply_scale
-	static set_apply_scale = function (_enable)
+	/// @note Animated bounding boxes are not yet supported by the GML part of
+	/// BBMOD!
+	///
+	/// @see BBMOD_DLL.get_animated_bounds
+	static set_animated_bounds = function (_enable)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_apply_scale", dll_cdecl, ty_real, 1, ty_real);
+			BBMOD_DLL_PATH, "bbmod_dll_set_animated_bounds", dll_cdecl, ty_real, 1, ty_real);
 		var _retval = external_call(_fn, _enable);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
@@ -765,40 +2714,47 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_pre_transform()
+	/// @func get_bone_atlas()
 	///
-	/// @desc Checks whether the "pre-transform" option is enabled.
+	/// @desc Retrieves the format of a bone atlas, into which are baked
+	/// animations of a model.
 	///
-	/// @return {Bool} If `true` then the "pre-transform" option is enabled.
+	/// @return {Real} The format of a bone atlas. See `BBMOD_ATLAS_` macros.
 	///
-	/// @see BBMOD_DLL.set_pre_transform
-	static get_pre_transform = function ()
+	/// @note Bone atlases are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.set_bone_atlas
+	static get_bone_atlas = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_pre_transform", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_bone_atlas", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_pre_transform(_enable)
+	/// @func set_bone_atlas(_format)
 	///
-	/// @desc Enables/disables the "pre-transform" option, which pre-transforms
-	/// the models and collapses all nodes into one if possible.
-	/// This is by default **disabled**.
+	/// @desc Configures the format of a bone atlas (.bbatlas), into which are
+	/// baked bone-space transforms of all animations of a model for instanced
+	/// rendering. The atlas has a table of clips with their start rows, frame
+	/// counts and sampling rates. This is by default `BBMOD_ATLAS_NONE`.
 	///
-	/// @param {Bool} _enable `true` to enable the option.
+	/// @param {Real} _format The format of a bone atlas. Use one of the
+	/// `BBMOD_ATLAS_` macros.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_pre_transform
-	static set_pre_transform = function (_enable)
+	/// @note Bone atlases are not yet supported by the GML part of BBMOD!
+	///
+	/// @see BBMOD_DLL.get_bone_atlas
+	static set_bone_atlas = function (_format)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_pre_transform", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, _enable);
+			BBMOD_DLL_PATH, "bbmod_dll_set_bone_atlas", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _format);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -806,43 +2762,51 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_optimize_animations()
+	/// @func get_vertex_animation()
 	///
-	/// @desc Retrieves the animation optimization level.
+	/// @desc Checks whether animations of a model are baked into a vertex
+	/// animation texture.
 	///
-	/// @return {Real} The animation optimization level. See section
-	/// [Animation optimization levels](./AnimationOptimizationLevels.html) for
-	/// more info.
+	/// @return {Bool} Returns `true` if animations are baked into a vertex
+	/// animation texture.
 	///
-	/// @see BBMOD_DLL.set_optimize_animations
-	static get_optimize_animations = function ()
+	/// @note Vertex animation textures are not yet supported by the GML part of
+	/// BBMOD!
+	///
+	/// @see BBMOD_DLL.set_vertex_animation
+	static get_vertex_animation = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_optimize_animations", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_vertex_animation", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_optimize_animations(_level)
+	/// @func set_vertex_animation(_enable)
 	///
-	/// @desc Sets the animation optimization level.
-	/// This is by default set to **0**.
+	/// @desc Enables/disables baking positions of all vertices at each frame of
+	/// animations of a model into a vertex animation texture (.bbvat).
+	/// Positions are quantized to 16 bits against bounds of each clip, which
+	/// are saved with a table of clips. Lookup coordinates of vertices are
+	/// saved into their second UV channel. This is by default disabled.
 	///
-	/// @param {Real} _level The new animation optimization level. See section
-	/// [Animation optimization levels](./AnimationOptimizationLevels.html) for
-	/// more info.
+	/// @param {Bool} _enable Use `true` to enable baking vertex animation
+	/// textures.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_optimize_animations
-	static set_optimize_animations = function (_level)
+	/// @note Vertex animation textures are not yet supported by the GML part of
+	/// BBMOD!
+	///
+	/// @see BBMOD_DLL.get_vertex_animation
+	static set_vertex_animation = function (_enable)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_optimize_animations", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, clamp(_level, 0, 2));
+			BBMOD_DLL_PATH, "bbmod_dll_set_vertex_animation", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -850,39 +2814,40 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_sampling_rate()
+	/// @func get_vertex_animation_normals()
 	///
-	/// @desc Retrieves the animation samping rate (frames per second).
+	/// @desc Checks whether normals are baked into vertex animation textures.
 	///
-	/// @return {Real} The animation sampling rate.
+	/// @return {Bool} Returns `true` if normals are baked into vertex animation
+	/// textures.
 	///
-	/// @see BBMOD_DLL.set_sampling_rate
-	static get_sampling_rate = function ()
+	/// @see BBMOD_DLL.set_vertex_animation_normals
+	static get_vertex_animation_normals = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_sampling_rate", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_vertex_animation_normals", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_sampling_rate(_fps)
+	/// @func set_vertex_animation_normals(_enable)
 	///
-	/// @desc Sets the animation sampling rate (frames per second).
-	/// This is by default set to **60**.
+	/// @desc Enables/disables baking normals into vertex animation textures as
+	/// well. This is by default disabled.
 	///
-	/// @param {Real} _fps The new animation sampling rate.
+	/// @param {Bool} _enable Use `true` to enable baking normals.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_sampling_rate
-	static set_sampling_rate = function (_fps)
+	/// @see BBMOD_DLL.get_vertex_animation_normals
+	static set_vertex_animation_normals = function (_enable)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_sampling_rate", dll_cdecl, ty_real, 1, ty_real);
-		var _retval = external_call(_fn, max(floor(_fps), 1));
+			BBMOD_DLL_PATH, "bbmod_dll_set_vertex_animation_normals", dll_cdecl, ty_real, 1, ty_real);
+		var _retval = external_call(_fn, _enable);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
 			throw new BBMOD_Exception();
@@ -890,42 +2855,46 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_export_materials()
+	/// @func get_morph_targets()
 	///
-	/// @desc Checks whether export of materials is enabled.
+	/// @desc Checks whether morph targets of meshes are saved.
 	///
-	/// @return {Bool} If `true` then export of materials is enabled.
+	/// @return {Bool} Returns `true` if morph targets are saved.
 	///
-	/// @note This is an experimental feature!
+	/// @note Morph targets are not yet supported by the GML part of BBMOD!
 	///
-	/// @see BBMOD_DLL.set_export_materials
-	static get_export_materials = function ()
+	/// @see BBMOD_DLL.set_morph_targets
+	static get_morph_targets = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_export_materials", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_morph_targets", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_export_materials(_enable)
+	/// @func set_morph_targets(_enable)
 	///
-	/// @desc Enables/disables export of materials. This is by default
-	/// **disabled**.
+	/// @desc Enables/disables saving morph targets (blend shapes) of meshes.
+	/// Only vertices which move are stored, with position deltas quantized to
+	/// 16 bits and normal deltas quantized to 8 bits per component. Weights of
+	/// morph targets animated by animations are saved into animations, 16 bits
+	/// per frame, skipping targets which are not used. This is by default
+	/// disabled.
 	///
-	/// @param {Bool} _enable `true` to enable material export.
+	/// @param {Bool} _enable Use `true` to enable saving morph targets.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @note This is an experimental feature!
+	/// @note Morph targets are not yet supported by the GML part of BBMOD!
 	///
-	/// @see BBMOD_DLL.get_export_materials
-	static set_export_materials = function (_enable)
+	/// @see BBMOD_DLL.get_morph_targets
+	static set_morph_targets = function (_enable)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_export_materials", dll_cdecl, ty_real, 1, ty_real);
+			BBMOD_DLL_PATH, "bbmod_dll_set_morph_targets", dll_cdecl, ty_real, 1, ty_real);
 		var _retval = external_call(_fn, _enable);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
@@ -934,42 +2903,46 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_zup()
-	///
-	/// @desc Checks whether model is converted from Y-up to Z-up.
+	/// @func get_native_tangent_space()
 	///
-	/// @return {Bool} If `true` then model is converted from Y-up to Z-up.
+	/// @desc Checks whether missing normals and tangents are generated by BBMOD
+	/// DLL instead of Assimp.
 	///
-	/// @note This is an experimental feature!
+	/// @return {Bool} Returns `true` if normals and tangents are generated by
+	/// BBMOD DLL.
 	///
-	/// @see BBMOD_DLL.set_zup
-	static get_zup = function ()
+	/// @see BBMOD_DLL.set_native_tangent_space
+	static get_native_tangent_space = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_zup", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_native_tangent_space", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_zup(_enable)
+	/// @func set_native_tangent_space(_enable)
 	///
-	/// @desc Enables/disables conversion from Y-up to Z-up. This is by default
-	/// **disabled**.
+	/// @desc Enables/disables generating missing normals and tangents by BBMOD
+	/// DLL on multiple threads instead of by Assimp. Smooth normals are
+	/// computed from faces sharing a position found with spatial hashing and
+	/// tangents are summed per corner weighted by angle. This is not MikkTSpace,
+	/// so tangents may differ slightly from those used by normal map bakers.
+	/// Generation of normals is still configured with
+	/// {@link BBMOD_DLL.set_gen_normal}. This is by default disabled.
 	///
-	/// @param {Bool} _enable `true` to enable conversion from Y-up to Z-up.
+	/// @param {Bool} _enable Use `true` to enable native generation of normals
+	/// and tangents.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @note This is an experimental feature!
-	///
-	/// @see BBMOD_DLL.get_zup
-	static set_zup = function (_enable)
+	/// @see BBMOD_DLL.get_native_tangent_space
+	static set_native_tangent_space = function (_enable)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_zup", dll_cdecl, ty_real, 1, ty_real);
+			BBMOD_DLL_PATH, "bbmod_dll_set_native_tangent_space", dll_cdecl, ty_real, 1, ty_real);
 		var _retval = external_call(_fn, _enable);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
@@ -978,41 +2951,47 @@ function BBMOD_DLL() constructor
 		return self;
 	};
 
-	/// @func get_enable_prefix()
+	/// @func get_native_glb()
 	///
-	/// @desc Checks whether prefixing of output files with model name is
-	/// enabled.
+	/// @desc Checks whether GLB files are read directly by BBMOD DLL instead
+	/// of by Assimp's glTF importer.
 	///
-	/// @return {Bool} If `true` then prefixing of output files with model
-	/// name is enabled.
+	/// @return {Bool} Returns `true` if GLB files are read by BBMOD DLL.
 	///
-	/// @see BBMOD_DLL.set_enable_prefix
-	static get_enable_prefix = function ()
+	/// @see BBMOD_DLL.set_native_glb
+	static get_native_glb = function ()
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_get_enable_prefix", dll_cdecl, ty_real, 0);
+			BBMOD_DLL_PATH, "bbmod_dll_get_native_glb", dll_cdecl, ty_real, 0);
 		return external_call(_fn);
 	};
 
-	/// @func set_enable_prefix(_enable)
+	/// @func set_native_glb(_enable)
 	///
-	/// @desc Enables/disables prefixing of output files with model name. This
-	/// is by default **enabled**.
+	/// @desc Enables/disables converting meshes of GLB files directly by BBMOD
+	/// DLL instead of by Assimp's glTF importer, which is faster and uses less
+	/// memory for large files. Nodes and meshes of these files are not
+	/// optimized and missing normals and tangents are generated the same as
+	/// with native tangent space. Files which use features not supported by
+	/// the reader, like Draco compression or external buffers, are still
+	/// loaded by Assimp, as are all files when pre-transforming, vertex
+	/// animation textures or morph targets are enabled. This is by default
+	/// disabled.
 	///
-	/// @param {Bool} _enable `true` to enable prefixing of output files with
-	/// model name.
+	/// @param {Bool} _enable Use `true` to enable reading GLB files by BBMOD
+	/// DLL.
 	///
 	/// @return {Struct.BBMOD_DLL} Returns `self`.
 	///
 	/// @throws {BBMOD_Exception} If the operation fails.
 	///
-	/// @see BBMOD_DLL.get_enable_prefix
-	static set_enable_prefix = function (_enable)
+	/// @see BBMOD_DLL.get_native_glb
+	static set_native_glb = function (_enable)
 	{
 		gml_pragma("forceinline");
 		static _fn = external_define(
-			BBMOD_DLL_PATH, "bbmod_dll_set_enable_prefix", dll_cdecl, ty_real, 1, ty_real);
+			BBMOD_DLL_PATH, "bbmod_dll_set_native_glb", dll_cdecl, ty_real, 1, ty_real);
 		var _retval = external_call(_fn, _enable);
 		if (_retval != __BBMOD_DLL_SUCCESS)
 		{
@@ -1020,6 +2999,23 @@ function BBMOD_DLL() constructor
 		}
 		return self;
 	};
+
+	/// @func destroy()
+	///
+	/// @desc Cancels all conversion jobs and waits until they stop. Must be
+	/// called before the game ends if any jobs were started with
+	/// {@link BBMOD_DLL.convert_async} or
+	/// {@link BBMOD_DLL.config_convert_async}.
+	///
+	/// @return {Undefined} Returns `undefined`.
+	static destroy = function ()
+	{
+		gml_pragma("forceinline");
+		static _fn = external_define(
+			BBMOD_DLL_PATH, "bbmod_dll_shutdown", dll_cdecl, ty_real, 0);
+		external_call(_fn);
+		return undefined;
+	};
 }
 
 /// @func __bbmod_dll_is_supported()